@@ -0,0 +1,158 @@
+#!/bin/bash
+
+# Startup benchmark: time to read and initialize a large synthetic model
+# (HRUs, subbasin network, :HRUGroup and :SubBasinGroup lists, met gauges), simulated for a single time step
+# compares a reference and a new Raven executable
+#
+# usage: ./RavenStartupBench.sh [ref_exe] [new_exe] [num_HRUs] [num_gauges]
+#   defaults: _Executables/ref/Raven.exe, _Executables/new/Raven.exe, 100000, 1
+# each subbasin contains 4 HRUs; subbasin p drains to subbasin p/2 (binary tree network)
+# HRUs and gauges are scattered over a 1x1 degree area; gauge data are interpolated by nearest neighbour
+
+echo "timing raven startup..."
+
+# Location of Working directory (no end slash)
+workingdir=$PWD
+
+ref_exe=${1:-${workingdir}"/_Executables/ref/Raven.exe"}
+new_exe=${2:-${workingdir}"/_Executables/new/Raven.exe"}
+nHRUs=${3:-100000}
+nGauges=${4:-1}
+nGroups=10
+
+for exe in ${ref_exe} ${new_exe} ; do
+  if [ ! -e ${exe} ] ; then
+    echo "raven executable "${exe}" doesn't exist. TIMING FAILED."
+    exit 1
+  fi
+done
+
+modeldir=${workingdir}"/_StartupModel/"
+outdir=${workingdir}"/out_startup/"
+rm -rf ${modeldir} ; mkdir ${modeldir}
+
+# generate synthetic model ------------------------------------------
+groups=""
+for (( g=0 ; g < ${nGroups} ; g++ )) ; do groups=${groups}" Group"${g} ; done
+
+cat > ${modeldir}startup.rvi <<EOF
+:StartDate          2000-01-01 00:00:00
+:Duration           1
+:TimeStep           1.0
+:Method             ORDERED_SERIES
+:Routing            ROUTE_NONE
+:CatchmentRoute     ROUTE_DUMP
+:Evaporation        PET_CONSTANT
+:OW_Evaporation     PET_CONSTANT
+:SoilModel          SOIL_ONE_LAYER
+:DefineHRUGroups   ${groups}
+:Interpolation     INTERP_NEAREST_NEIGHBOR
+:HydrologicProcesses
+  :Precipitation    PRECIP_RAVEN   ATMOS_PRECIP MULTIPLE
+  :Infiltration     INF_RATIONAL   PONDED_WATER MULTIPLE
+  :Baseflow         BASE_LINEAR    SOIL[0]      SURFACE_WATER
+:EndHydrologicProcesses
+:SilentMode
+:SuppressOutput
+EOF
+
+cat > ${modeldir}startup.rvp <<EOF
+:SoilClasses
+  :Attributes
+  :Units
+  TOPSOIL
+:EndSoilClasses
+:SoilProfiles
+  DEFAULT_P, 1, TOPSOIL, 1.0
+:EndSoilProfiles
+:VegetationClasses
+  :Attributes, MAX_HT, MAX_LAI, MAX_LEAF_COND
+  :Units,      m,      none,    mm_per_s
+  VEG_ALL,     0.0,    0.0,     0.0
+:EndVegetationClasses
+:LandUseClasses
+  :Attributes, IMPERM, FOREST_COV
+  :Units,      frac,   frac
+  LU_ALL,      0.0,    0.0
+:EndLandUseClasses
+:SoilParameterList
+  :Parameters, POROSITY, BASEFLOW_COEFF
+  :Units,      none,     1/d
+  [DEFAULT],   0.4,      0.1
+:EndSoilParameterList
+:AvgAnnualRunoff 300
+:LandUseParameterList
+  :Parameters, PARTITION_COEFF
+  :Units,      none
+  [DEFAULT],   0.5
+:EndLandUseParameterList
+EOF
+
+awk -v nGauges=${nGauges} 'BEGIN{
+  srand(1);
+  for (g=1;g<=nGauges;g++){
+    printf ":Gauge G%d\n  :Latitude  %.5f\n  :Longitude %.5f\n  :Elevation 500.0\n",g,50.0+rand(),-120.0+rand();
+    print "  :Data PRECIP mm/d";
+    print "    2000-01-01 00:00:00 1.0 2";
+    print "    1.0";
+    print "    1.0";
+    print "  :EndData";
+    print "  :Data TEMP_DAILY_AVE C";
+    print "    2000-01-01 00:00:00 1.0 2";
+    print "    5.0";
+    print "    5.0";
+    print "  :EndData";
+    print ":EndGauge";
+  }
+}' > ${modeldir}startup.rvt
+
+echo "# default initial conditions" > ${modeldir}startup.rvc
+
+awk -v nHRUs=${nHRUs} -v nGroups=${nGroups} 'BEGIN{
+  srand(2);
+  nSB=int((nHRUs+3)/4);
+  print ":SubBasins";
+  print "  :Attributes, NAME, DOWNSTREAM_ID, PROFILE, REACH_LENGTH, GAUGED";
+  print "  :Units,      none, none,          none,    km,           none";
+  for (p=1;p<=nSB;p++){ down=(p==1) ? -1 : int(p/2); printf "  %d, SB%d, %d, NONE, _AUTO, 0\n",p,p,down; }
+  print ":EndSubBasins";
+  print ":HRUs";
+  print "  :Attributes, AREA, ELEVATION, LATITUDE, LONGITUDE, BASIN_ID, LAND_USE_CLASS, VEG_CLASS, SOIL_PROFILE, AQUIFER_PROFILE, TERRAIN_CLASS, SLOPE, ASPECT";
+  print "  :Units,      km2,  m,         deg,      deg,       none,     none,           none,      none,         none,            none,          deg,   deg";
+  for (k=1;k<=nHRUs;k++){ printf "  %d, 1.0, 500.0, %.5f, %.5f, %d, LU_ALL, VEG_ALL, DEFAULT_P, [NONE], [NONE], 0.0, 0.0\n",k,50.0+rand(),-120.0+rand(),int((k-1)/4)+1; }
+  print ":EndHRUs";
+  for (g=0;g<nGroups;g++){
+    printf ":HRUGroup Group%d\n",g;
+    line="";
+    for (k=g+1;k<=nHRUs;k+=nGroups){ line=line k ","; if (length(line)>200){print "  " line; line="";} }
+    if (line!=""){print "  " line;}
+    print ":EndHRUGroup";
+  }
+  print ":SubBasinGroup AllSubBasins";
+  line="";
+  for (p=1;p<=nSB;p++){ line=line p ","; if (length(line)>200){print "  " line; line="";} }
+  if (line!=""){print "  " line;}
+  print ":EndSubBasinGroup";
+}' > ${modeldir}startup.rvh
+
+# time startup ------------------------------------------------------
+cd ${modeldir}
+for exe in ${ref_exe} ${new_exe} ; do
+  rm -rf ${outdir} ; mkdir ${outdir}
+  tstart=$( date +%s.%N )
+  ${exe} startup -o ${outdir} > /dev/null 2>&1
+  tend=$( date +%s.%N )
+  echo "${exe} ${nHRUs} ${nGauges} ${tstart} ${tend}" | awk '{printf "%-60s %10d HRUs %8d gauges: %10.2f s\n",$1,$2,$3,$5-$4}'
+  if grep -q "^ERROR" ${outdir}"Raven_errors.txt" 2>/dev/null ; then
+    echo "  simulation failed: see "${outdir}"Raven_errors.txt"
+  fi
+done
+cd ${workingdir}
+
+rm -rf ${outdir} ${modeldir}
+
+echo "-------------------------------------------"
+echo "... TIMING DONE."
+echo "-------------------------------------------"
+
+exit 0
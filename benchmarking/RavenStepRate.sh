@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# Micro-benchmark of simulation speed (model time steps per wall-clock second)
+# compares a reference and a new Raven executable on the benchmarking test cases
+#
+# usage: ./RavenStepRate.sh [ref_exe] [new_exe] [num_repeats]
+#   defaults: _Executables/ref/Raven.exe, _Executables/new/Raven.exe, 3
+# the fastest of num_repeats runs of each case is reported; cases without :Duration report 0 steps
+
+echo "timing raven..."
+
+# Location of Working directory (no end slash)
+workingdir=$PWD
+
+ref_exe=${1:-${workingdir}"/_Executables/ref/Raven.exe"}
+new_exe=${2:-${workingdir}"/_Executables/new/Raven.exe"}
+nrepeat=${3:-3}
+
+for exe in ${ref_exe} ${new_exe} ; do
+  if [ ! -e ${exe} ] ; then
+    echo "raven executable "${exe}" doesn't exist. TIMING FAILED."
+    exit 1
+  fi
+done
+
+test_cases=(    "Alouette" "Alouette2" "York" "York2" "Irondequoit" "LOTW" "LaJoie" "Nith" "Revelstoke" "Salmon_GR4J" "Salmon_HBV" "Salmon_HMETS" "Salmon_MOHYSE" "Williston_Finlay")
+test_cases_rvi=("Alouette_ws" "Alouette2" "York_gridded_m_daily_i_daily" "York2_gridded_m_subdaily_i_subdaily" "Irondequoit" "LOWRL" "La_Joie_ws" "Nith" "Revelstoke_ws" "raven-gr4j-salmon" "raven-hbv-salmon" "raven-hmets-salmon" "raven-mohyse-salmon" "Williston_Finlay_ws")
+
+ntest_cases=$( echo "${#test_cases[@]}" )
+
+outdir=${workingdir}"/out_steprate/"
+
+# returns best wall-clock time [s] over nrepeat runs of executable $1 with rvi file $2
+best_time () {
+  best=""
+  for (( irep=0 ; irep < ${nrepeat} ; irep++ )) ; do
+    rm -rf ${outdir} ; mkdir ${outdir}
+    tstart=$( date +%s.%N )
+    $1 $2 -o ${outdir} > /dev/null 2>&1
+    tend=$( date +%s.%N )
+    best=$( echo "${tstart} ${tend} ${best}" | awk '{dt=$2-$1; if (($3=="") || (dt<$3)) {print dt} else {print $3}}' )
+  done
+  echo ${best}
+}
+
+printf "%-20s %10s %14s %14s %8s\n" "case" "nsteps" "ref [steps/s]" "new [steps/s]" "speedup"
+
+for (( icase=0 ; icase < ${ntest_cases} ; icase++ )) ; do
+
+  test_case=${test_cases[icase]}
+  rvi_file=${test_cases_rvi[icase]}
+
+  if [ ! -e ${workingdir}"/_InputFiles/"${test_case}"/"${rvi_file}".rvi" ] ; then
+    continue
+  fi
+  cd ${workingdir}"/_InputFiles/"${test_case}"/"
+
+  tref=$( best_time ${ref_exe} ${rvi_file} )
+  tnew=$( best_time ${new_exe} ${rvi_file} )
+
+  # number of time steps = :Duration / :TimeStep (time step given in days or as hh:mm:ss)
+  nsteps=$( awk 'tolower($1)==":duration" {dur=$2}
+                 tolower($1)==":timestep" {n=split($2,hms,":"); dt=(n==3) ? (hms[1]+hms[2]/60+hms[3]/3600)/24 : $2}
+                 END {if (dt>0) {printf "%d\n",dur/dt+0.5} else {print 0}}' ${rvi_file}.rvi )
+
+  echo "${test_case} ${nsteps} ${tref} ${tnew}" | awk '{printf "%-20s %10d %14.1f %14.1f %8.2f\n",$1,$2,$2/$3,$2/$4,$3/$4}'
+
+  cd ${workingdir}
+done
+
+rm -rf ${outdir}
+
+echo "-------------------------------------------"
+echo "... TIMING DONE."
+echo "-------------------------------------------"
+
+exit 0
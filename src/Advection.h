@@ -43,5 +43,6 @@ public:/*-------------------------------------------------------*/
                         double      *rates) const;
 
   void        GetParticipatingParamList   (string  *aP, class_type *aPC, int &nP) const;
+  bool        IsThreadSafe() const { return false; } //uses static work arrays shared between HRUs
 };
 #endif
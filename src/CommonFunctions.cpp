@@ -4,6 +4,7 @@
 //////////////////////////////////////////////////////////////////
 
 #include <time.h>
+#include <mutex>
 #include "RavenInclude.h"
 
 //////////////////////////////////////////////////////////////////
@@ -172,14 +173,26 @@ double DefaultParameterValue(bool is_template, bool is_computable)
 /// \param *xptr [in] Pointer to be added to array
 /// \param &size [in & out] Integer size of array
 /// \return Boolean indicating success of method
+/// \remark capacity of array grows in powers of two, so appending N pointers is O(N); capacity is
+/// implied by size, so arrays appended to must only be allocated by this routine
 //
+static int DynArrayCapacity(const int size)
+{
+  int cap=2;
+  while (cap<size+1){cap*=2;}
+  return cap;
+}
 bool DynArrayAppend(void **& pArr, void *xptr,int &size)
 {
   void **tmp=NULL;
   if (xptr==NULL){return false;}
   if ((pArr==NULL) && (size>0)) {return false;}
+  if ((pArr!=NULL) && (DynArrayCapacity(size)==DynArrayCapacity(size+1))){
+    pArr[size]=xptr; size++;                                  //room remaining: no reallocation
+    return true;
+  }
   size=size+1;                                                //increment size
-  tmp=new void *[size+1];                                     //allocate memory
+  tmp=new void *[DynArrayCapacity(size)];                     //allocate memory
   if (tmp==NULL){ExitGracefully("DynArrayAppend::Out of memory",OUT_OF_MEMORY);}
   for (int i=0; i<(size-1); i++){                             //copy array
 #ifdef _STRICTCHECK_
@@ -1311,6 +1324,37 @@ void SubstringReplace(string &str,const string &from,const string &to)
   }
 }
 
+static vector<string> *g_pWarningBuffer=NULL; ///< if not NULL, warnings are buffered here rather than written (see BufferWarnings())
+static mutex            g_warning_mutex;        ///< serializes warnings issued from OpenMP threads (e.g., concurrent subbasin routing)
+
+/////////////////////////////////////////////////////////////////
+/// \brief redirects subsequent warnings and advisories to pBuffer, as pairs of entries (errors filename, line),
+///  rather than writing them to Raven_errors.txt
+/// \details used by concurrent ensemble member processes, whose warnings are written by the ensemble driver in member order
+/// \param pBuffer [in] warning buffer, or NULL to write warnings directly (default)
+//
+void BufferWarnings(vector<string> *pBuffer)
+{
+  g_pWarningBuffer=pBuffer;
+}
+/////////////////////////////////////////////////////////////////
+/// \brief appends line to Raven_errors.txt file, or to warning buffer, if set
+/// \remark caller must hold g_warning_mutex
+/// \param line [in] line written
+//
+static void AppendWarningLine(const string &line)
+{
+  string filename=g_output_directory+"Raven_errors.txt";
+  if (g_pWarningBuffer!=NULL){
+    g_pWarningBuffer->push_back(filename);
+    g_pWarningBuffer->push_back(line);
+    return;
+  }
+  ofstream WARNINGS;
+  WARNINGS.open(filename.c_str(),ios::app);
+  WARNINGS<<line<<endl;
+  WARNINGS.close();
+}
 /////////////////////////////////////////////////////////////////
 /// \brief writes warning to screen and to Raven_errors.txt file
 /// \param warn [in] warning message printed
@@ -1318,11 +1362,9 @@ void SubstringReplace(string &str,const string &from,const string &to)
 void WriteWarning(const string warn, bool noisy)
 {
   if (!g_suppress_warnings){
-    ofstream WARNINGS;
-    WARNINGS.open((g_output_directory+"Raven_errors.txt").c_str(),ios::app);
+    lock_guard<mutex> lock(g_warning_mutex);
     if (noisy){cout<<"WARNING!: "<<warn<<endl;}
-    WARNINGS<<"WARNING : "<<warn<<endl;
-    WARNINGS.close();
+    AppendWarningLine("WARNING : "+warn);
   }
 }
 /////////////////////////////////////////////////////////////////
@@ -1332,11 +1374,9 @@ void WriteWarning(const string warn, bool noisy)
 void WriteAdvisory(const string warn, bool noisy)
 {
   if (!g_suppress_warnings){
-    ofstream WARNINGS;
-    WARNINGS.open((g_output_directory+"Raven_errors.txt").c_str(),ios::app);
+    lock_guard<mutex> lock(g_warning_mutex);
     if (noisy){cout<<"ADVISORY: "<<warn<<endl;}
-    WARNINGS<<"ADVISORY : "<<warn<<endl;
-    WARNINGS.close();
+    AppendWarningLine("ADVISORY : "+warn);
   }
 }
 ///////////////////////////////////////////////////////////////////
@@ -1354,6 +1394,17 @@ void HandleNetCDFErrors(int error_code){
   }
 #endif
 }
+#ifdef _RVNETCDF_
+///////////////////////////////////////////////////////////////////
+/// \brief Returns lock which must be held by any thread calling the NetCDF library
+/// \remark NetCDF-C is not thread-safe; gridded forcings are read in background threads (see CForcingGrid::StartPrefetch())
+//
+recursive_mutex &GetNetCDFMutex()
+{
+  static recursive_mutex nc_mutex;
+  return nc_mutex;
+}
+#endif
 ///////////////////////////////////////////////////////////////////
 /// \brief Return AUTO_COMPUTE tag if passed string is tagged, otherwise convert to double
 /// \param s [in] Input string
@@ -1827,7 +1878,7 @@ int SmartIntervalSearch(const double &x,const double *ax,const int N,const int i
 //
 double InterpolateCurve(const double x,const double *xx,const double *y,int N,bool extrapbottom)
 {
-  static int ilast=0;
+  static thread_local int ilast=0; //search hint only; thread-specific so that HRUs may be processed concurrently
   if(x<=xx[0])
   {
     if(extrapbottom) { return y[0]+(y[1]-y[0])/(xx[1]-xx[0])*(x-xx[0]); }
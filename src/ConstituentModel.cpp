@@ -15,8 +15,8 @@ coordinates information about constituent storage
 string FilenamePrepare(string filebase,const optStruct &Options); //Defined in StandardOutput.cpp
 bool IsContinuousConcObs(const CTimeSeriesABC *pObs,const long SBID,const int c); //Defined in StandardOutput.cpp
 void WriteNetCDFGlobalAttributes(const int out_ncid,const optStruct& Options,const string descript);
-int  NetCDFAddMetadata     (const int fileid,const int time_dimid,string shortname,string longname,string units);
-int  NetCDFAddMetadata2D   (const int fileid,const int time_dimid,int nbasins_dimid,string shortname,string longname,string units);
+int  NetCDFAddMetadata     (const int fileid,const int time_dimid,string shortname,string longname,string units,const int chunk_time=0,const int deflate_level=0);
+int  NetCDFAddMetadata2D   (const int fileid,const int time_dimid,int nbasins_dimid,string shortname,string longname,string units,const int chunk_time=0,const int deflate_level=0);
 void WriteNetCDFBasinList  (const int ncid,const int varid,const CModel* pModel,bool is_res,const optStruct& Options);
 void AddSingleValueToNetCDF(const int out_ncid,const string &label,const size_t time_index,const double &value);
 //////////////////////////////////////////////////////////////////
@@ -382,6 +382,7 @@ void   CConstituentModel::SetMlatHist(const int p,const int histsize,const doubl
     return;
   }
   for(int i=0;i<histsize;i++) { _aMlatHist[p][i]=aMlat[i]; }
+  _aMlatHist[p].Mirror();
   _aMlat_last[p]=MlatLast;
 }
 //////////////////////////////////////////////////////////////////
@@ -397,6 +398,7 @@ void   CConstituentModel::SetMinHist(const int p,const int histsize,const double
     return;
   }
   for(int i=0;i<histsize;i++) { _aMinHist[p][i]=aMin[i]; }
+  _aMinHist[p].Mirror();
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Set reservoir initial mass conditions
@@ -1679,6 +1681,61 @@ void CConstituentModel::WriteMajorOutput(ofstream &RVC) const
   RVC<<":EndBasinTransportVariables"<<endl;
 }
 //////////////////////////////////////////////////////////////////
+/// \brief appends in-channel and reservoir constituent mass of all subbasins to binary snapshot
+/// \details same contents as WriteMajorOutput(), at full precision
+/// \param &aSnap [out] snapshot payload
+//
+void CConstituentModel::WriteToSnapshot(vector<double> &aSnap) const
+{
+  for(int p=0;p<_pModel->GetNumSubBasins();p++)
+  {
+    const CSubBasin *pBasin=_pModel->GetSubBasin(p);
+    aSnap.push_back(_channel_storage[p]);
+    aSnap.push_back(_rivulet_storage[p]);
+    for(int i=0;i<pBasin->GetNumSegments();      i++) { aSnap.push_back(_aMout    [p][i]); } aSnap.push_back(_aMout_last[p]);
+    for(int i=0;i<pBasin->GetLatHistorySize();   i++) { aSnap.push_back(_aMlatHist[p][i]); } aSnap.push_back(_aMlat_last[p]);
+    for(int i=0;i<pBasin->GetInflowHistorySize();i++) { aSnap.push_back(_aMinHist [p][i]); }
+    if(pBasin->GetReservoir()!=NULL) {
+      aSnap.push_back(_aMout_res[p]); aSnap.push_back(_aMout_res_last[p]);
+      aSnap.push_back(_aMres    [p]); aSnap.push_back(_aMres_last    [p]);
+      aSnap.push_back(_aMsed    [p]); aSnap.push_back(_aMsed_last    [p]);
+    }
+    if (_type == ENTHALPY) {
+      const CEnthalpyModel *pEnth=(const CEnthalpyModel*)(this);
+      aSnap.push_back(pEnth->GetBedTemperature(p));
+    }
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief restores constituent mass written by WriteToSnapshot()
+/// \remark routing array sizes must already have been checked against snapshot structure block
+/// \param *aSnap [in] snapshot payload
+/// \param &i [in/out] index of first value of this constituent in aSnap; returned as index of next value
+//
+void CConstituentModel::ReadFromSnapshot(const double *aSnap, size_t &i)
+{
+  for(int p=0;p<_pModel->GetNumSubBasins();p++)
+  {
+    const CSubBasin *pBasin=_pModel->GetSubBasin(p);
+    _channel_storage[p]=aSnap[i++];
+    _rivulet_storage[p]=aSnap[i++];
+    for(int j=0;j<pBasin->GetNumSegments();      j++) { _aMout    [p][j]=aSnap[i++]; } _aMout_last[p]=aSnap[i++];
+    for(int j=0;j<pBasin->GetLatHistorySize();   j++) { _aMlatHist[p][j]=aSnap[i++]; } _aMlat_last[p]=aSnap[i++];
+    for(int j=0;j<pBasin->GetInflowHistorySize();j++) { _aMinHist [p][j]=aSnap[i++]; }
+    _aMlatHist[p].Mirror();
+    _aMinHist [p].Mirror();
+    if(pBasin->GetReservoir()!=NULL) {
+      _aMout_res[p]=aSnap[i++]; _aMout_res_last[p]=aSnap[i++];
+      _aMres    [p]=aSnap[i++]; _aMres_last    [p]=aSnap[i++];
+      _aMsed    [p]=aSnap[i++]; _aMsed_last    [p]=aSnap[i++];
+    }
+    if (_type == ENTHALPY) {
+      CEnthalpyModel *pEnth=(CEnthalpyModel*)(this);
+      pEnth->SetBedTemperature(p,aSnap[i++]);
+    }
+  }
+}
+//////////////////////////////////////////////////////////////////
 /// \brief clears all time series data for re-read of .rvt file
 /// \remark Called only in ensemble mode
 ///
@@ -35,6 +35,7 @@ CmvConvolution::CmvConvolution(convolution_type type,
   _type=type;
   _nConv++; //starts at -1
   _iTarget=to_index;
+  _aUHCache=NULL;
 
   if (!_smartmode){_nStores=MAX_CONVOL_STORES;}
 
@@ -62,13 +63,29 @@ CmvConvolution::CmvConvolution(convolution_type type,
 //////////////////////////////////////////////////////////////////
 /// \brief Implementation of the default destructor
 //
-CmvConvolution::~CmvConvolution(){}
+CmvConvolution::~CmvConvolution()
+{
+  delete [] _aUHCache; _aUHCache=NULL;
+}
 
 //////////////////////////////////////////////////////////////////
 /// \brief Initializes convolution object
 //
 void   CmvConvolution::Initialize(){}
 
+//////////////////////////////////////////////////////////////////
+/// \brief reserves unit hydrograph cache; each HRU unit hydrograph is generated upon first use
+/// \remark called from CModel::Initialize; if not called, unit hydrographs are regenerated every time step
+/// \param nHRUs [in] number of HRUs in model
+//
+void   CmvConvolution::StoreNumberOfHRUs(const int nHRUs)
+{
+  delete [] _aUHCache;
+  _aUHCache=new conv_unit_hydro [nHRUs];
+  ExitGracefullyIf(_aUHCache==NULL,"CmvConvolution::Initialize",OUT_OF_MEMORY);
+  for (int k=0;k<nHRUs;k++){_aUHCache[k].valid=false;}
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief unit S-hydrograph (cumulative hydrograph) for all options
 //
@@ -100,10 +117,34 @@ double CmvConvolution::LocalCumulDist(const double& t, const CHydroUnit* pHRU) c
   return 1.0;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief returns HRU parameters which determine unit hydrograph shape
+/// \param *pHRU [in] HRU
+/// \param &param1 [out] GR4J_X4 or gamma shape parameter
+/// \param &param2 [out] gamma scale parameter (zero for GR4J)
+//
+void   CmvConvolution::GetUnitHydroParams(const CHydroUnit *pHRU, double &param1, double &param2) const
+{
+  param1=param2=0.0;
+  if      ((_type==CONVOL_GR4J_1) || (_type==CONVOL_GR4J_2)){
+    param1=pHRU->GetSurfaceProps()->GR4J_x4;
+  }
+  else if (_type==CONVOL_GAMMA){
+    param1=pHRU->GetSurfaceProps()->gamma_shape;
+    param2=pHRU->GetSurfaceProps()->gamma_scale;
+  }
+  else if (_type==CONVOL_GAMMA_2){
+    param1=pHRU->GetSurfaceProps()->gamma_shape2;
+    param2=pHRU->GetSurfaceProps()->gamma_scale2;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief generates unit hydrograph based upon HRU parameters
+/// \remark called by GetRatesOfChange only when parameters of HRU (or time step) have changed since last call
+//
 void   CmvConvolution::GenerateUnitHydrograph(const CHydroUnit *pHRU, const optStruct &Options, double *aUnitHydro, int *aInterval, int &N) const
 {
-  //generates unit hydrograph based upon HRU parameters
-  //(called every timestep because it is potentially different in every HRU)
   double tstep=Options.timestep;
   double max_time(0);
 
@@ -284,12 +325,31 @@ void   CmvConvolution::GetRatesOfChange( const double      *state_vars,
   int i;
   double TS_old;
   double tstep=Options.timestep;
-  static double S         [MAX_CONVOL_STORES];
-  static double aUnitHydro[MAX_CONVOL_STORES];
-  static int    aInterval [MAX_CONVOL_STORES];
-
-  int N =0;
-  GenerateUnitHydrograph(pHRU,Options,&aUnitHydro[0],&aInterval[0],N); //THIS IS SLOW!! - create aUnitHydro as process array
+  double S[MAX_CONVOL_STORES];
+
+  //retrieve unit hydrograph, regenerated only if HRU parameters have changed (e.g., via transient parameter or class change)
+  //(each HRU entry is only accessed by the thread simulating that HRU)
+  int               N =0;
+  const double     *aUnitHydro;
+  const int        *aInterval;
+  double            param1,param2;
+  conv_unit_hydro   UH;
+  conv_unit_hydro  *pUH=&UH;
+  if (_aUHCache!=NULL){pUH=&_aUHCache[pHRU->GetGlobalIndex()];}
+  else                {pUH->valid=false;} //not initialized (e.g., in process group)
+
+  GetUnitHydroParams(pHRU,param1,param2);
+  if ((!pUH->valid) || (pUH->tstep!=tstep) || (pUH->param1!=param1) || (pUH->param2!=param2))
+  {
+    GenerateUnitHydrograph(pHRU,Options,pUH->aUnitHydro,pUH->aInterval,pUH->N);
+    pUH->tstep =tstep;
+    pUH->param1=param1;
+    pUH->param2=param2;
+    pUH->valid =true;
+  }
+  N         =pUH->N;
+  aUnitHydro=pUH->aUnitHydro;
+  aInterval =pUH->aInterval;
 
   //Calculate S[0] as change in convolution total storage
   TS_old=state_vars[iFrom[2*_nStores-1]]; //total storage after water added to convol stores earlier in process list
@@ -25,6 +25,20 @@ enum convolution_type
   CONVOL_GAMMA_2        ///< Gamma distribution unit hydrograph 2 - uses params alpha_Gamma2, beta_Gamma2
 };
 
+////////////////////////////////////////////////////////////////////
+/// \brief Unit hydrograph of a single HRU, with the parameter values and time step used to generate it
+//
+struct conv_unit_hydro
+{
+  bool   valid;                          ///< true if unit hydrograph has been generated
+  double tstep;                          ///< [d] model time step used to generate unit hydrograph
+  double param1;                         ///< GR4J_X4 or gamma shape used to generate unit hydrograph
+  double param2;                         ///< gamma scale used to generate unit hydrograph (unused for GR4J)
+  int    N;                              ///< number of unit hydrograph ordinates
+  double aUnitHydro[MAX_CONVOL_STORES];  ///< unit hydrograph ordinates [size: N]
+  int    aInterval [MAX_CONVOL_STORES];  ///< number of time steps spanned by each ordinate [size: N]
+};
+
 ////////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for loss of water from soil/groundwater to surface water
 //
@@ -38,12 +52,15 @@ private:/*------------------------------------------------------*/
 
   int               _iTarget;     ///< state variable index of outflow target
 
+  conv_unit_hydro  *_aUHCache;    ///< unit hydrograph of each HRU, regenerated only when its parameters change [size: nHRUs]
+
 
   static int        _nConv;       /// # of CONVOLUTION variables (a.k.a. processes) in model
 
   double LocalCumulDist(const double &t, const CHydroUnit *pHRU) const;
 
   void GenerateUnitHydrograph(const CHydroUnit *pHRU, const optStruct &Options, double *aUnitHydro, int *aIntervals, int &N) const;
+  void GetUnitHydroParams    (const CHydroUnit *pHRU, double &param1, double &param2) const;
 
 public:/*-------------------------------------------------------*/
   //Constructors/destructors:
@@ -53,6 +70,7 @@ public:/*-------------------------------------------------------*/
 
   //inherited functions
   void Initialize();
+  void StoreNumberOfHRUs(const int nHRUs);
   void GetRatesOfChange(const double              *state_vars,
                         const CHydroUnit  *pHRU,
                         const optStruct   &Options,
@@ -7,7 +7,6 @@ Copyright (c) 2008-2023 the Raven Development Team
 //external function declarations
 double UniformRandom();
 double GaussRandom();
-bool   ParseInitialConditions(CModel *&pModel,const optStruct &Options);
 
 //////////////////////////////////////////////////////////////////
 /// \brief DDS Ensemble Construcutor
@@ -22,12 +21,17 @@ CDDSEnsemble::CDDSEnsemble(const int num_members,const optStruct &Options)
   _pParamDists=NULL;
   _BestParams=NULL;
   _TestParams=NULL;
+  _aBatchParams=NULL;
   _Fbest=ALMOST_INF;
   _r_val=0.2;
 
   _calib_SBID=DOESNT_EXIST;
   _calib_Obj=DIAG_NASH_SUTCLIFFE;
   _calib_Period="ALL";
+
+  _early_termination=false;
+  _terminated=false;
+  _Fbound=ALMOST_INF;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -41,6 +45,10 @@ CDDSEnsemble::~CDDSEnsemble()
   delete[] _pParamDists; _nParamDists=0;
   delete[] _BestParams;
   delete[] _TestParams;
+  if(_aBatchParams!=NULL) {
+    for(int b=0;b<_nConcurrent;b++) { delete[] _aBatchParams[b]; }
+    delete[] _aBatchParams;
+  }
 }
 
 //////////////////////////////////////////////////////////////////
@@ -74,6 +82,14 @@ void CDDSEnsemble::SetCalibrationTarget(const long SBID,const diag_type object_d
   _calib_Period=period;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief sets whether members which cannot improve upon best solution are terminated early
+//
+void CDDSEnsemble::SetEarlyTermination(const bool terminate)
+{
+  _early_termination=terminate;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief initializes DDS caliobration run
 /// \param &Options [out] Global model options information
@@ -100,11 +116,24 @@ void CDDSEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
   {
     _BestParams[i]=_TestParams[i]=_pParamDists[i]->default_val;
   }
+  // members of concurrent batch are all set up before any result is received
+  if(_nConcurrent>1) {
+    _aBatchParams=new double *[_nConcurrent];
+    for(int b=0;b<_nConcurrent;b++) {
+      _aBatchParams[b]=new double[_nParamDists];
+    }
+  }
 
   // Create and open DDSOutput file
   //-----------------------------------------------
   string filename=Options.main_output_dir+"DDSOutput.csv";
   _DDSOUT.open(filename.c_str());
+
+  //- read initial conditions once if they cannot depend upon calibrated parameters
+  _checkpoint_ICs=(Options.stateinfo_filename=="") && (Options.flowinfo_filename=="");
+  for (int i=0;i<_nParamDists;i++){
+    if (AffectsInitialConditions(_pParamDists[i])){_checkpoint_ICs=false;}
+  }
 }
 
 /**********************************************************************
@@ -193,15 +222,40 @@ void CDDSEnsemble::UpdateModel(CModel *pModel,optStruct &Options,const int e)
                             _pParamDists[k]->class_group,
                             _TestParams[k]);
   }
-  //- Re-read initial conditions to update state variables----
-  if(!ParseInitialConditions(pModel,Options)) {
-    ExitGracefully("Cannot find or read .rvc file",BAD_DATA);
+  //- store test parameters until member result is received (batches start at multiples of _nConcurrent)
+  if(_aBatchParams!=NULL) {
+    for(int k=0;k<_nParamDists;k++) { _aBatchParams[e%_nConcurrent][k]=_TestParams[k]; }
   }
-  pModel->CalculateInitialWaterStorage(Options);
+  //- Reset state variables to initial conditions -------------
+  ResetInitialConditions(pModel,Options);
+
+  _terminated=false;
 
   //The model is run following this routine call...
 }
 //////////////////////////////////////////////////////////////////
+/// \brief called at end of each time step; determines whether ensemble member may be terminated early
+/// \details member is terminated once the lower bound on its objective function, calculated from the
+/// modeled values simulated so far, is worse than the best objective function. Such a member can never
+/// become the best solution, so the DDS search is unaffected. Only applies to objective functions
+/// which cannot improve as further observations are compared (e.g., NSE, RMSE)
+/// \param pModel [in] pointer to model instance simulating ensemble member
+/// \return true if member simulation should be stopped
+//
+bool CDDSEnsemble::TerminateMember(const CModel *pModel)
+{
+  if((!_early_termination) || (_terminated) || (_Fbest==ALMOST_INF)) { return _terminated; }
+
+  double bound;
+  if((pModel->GetObjFuncBound(_calib_SBID,_calib_Obj,_calib_Period,bound)) && (bound>_Fbest))
+  {
+    _terminated=true;
+    _Fbound    =bound;
+    cout<<"DDS: member terminated early; objective function cannot improve upon best solution"<<endl;
+  }
+  return _terminated;
+}
+//////////////////////////////////////////////////////////////////
 /// \brief called AFTER each model ensemble run
 /// \param pModel [out] pointer to global model instance
 /// \param &Options [out] Global model options information
@@ -209,7 +263,45 @@ void CDDSEnsemble::UpdateModel(CModel *pModel,optStruct &Options,const int e)
 //
 void CDDSEnsemble::FinishEnsembleRun(CModel *pModel,optStruct &Options,const time_struct &tt,const int e)
 {
-  double Ftest=pModel->GetObjFuncVal(_calib_SBID,_calib_Obj,_calib_Period);
+  UpdateBestSolution(e,GetTestObjFuncVal(pModel));
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns objective function value of completed model run
+/// \param pModel [in] pointer to model instance which has simulated ensemble member
+/// \return objective function value (or its lower bound, if member was terminated early)
+//
+double CDDSEnsemble::GetTestObjFuncVal(const CModel *pModel) const
+{
+  if(_terminated) { return _Fbound; } //lower bound; worse than best solution
+  return pModel->GetObjFuncVal(_calib_SBID,_calib_Obj,_calib_Period);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief called after concurrent member run; returns objective function value to ensemble driver
+/// \param pModel [in] pointer to model instance which has simulated ensemble member
+/// \param &result [out] single-valued array of objective function value
+//
+void CDDSEnsemble::GetMemberResult(CModel *pModel,optStruct &/*Options*/,const time_struct &/*tt*/,const int /*e*/,vector<double> &result)
+{
+  result.push_back(GetTestObjFuncVal(pModel));
+}
+//////////////////////////////////////////////////////////////////
+/// \brief called in place of FinishEnsembleRun for concurrent members, in member order
+/// \param e [in] ensembe member index
+/// \param &result [in] result returned by GetMemberResult()
+//
+void CDDSEnsemble::ReceiveMemberResult(CModel *pModel,optStruct &Options,const int e,const vector<double> &result)
+{
+  //_TestParams holds parameters of last member set up in batch; restore those of member e
+  for(int k=0;k<_nParamDists;k++) { _TestParams[k]=_aBatchParams[e%_nConcurrent][k]; }
+  UpdateBestSolution(e,result[0]);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief updates best solution using objective function value of ensemble member e
+/// \param e [in] ensembe member index
+/// \param Ftest [in] objective function value of ensemble member e
+//
+void CDDSEnsemble::UpdateBestSolution(const int e,const double &Ftest)
+{
 
   // update current (best) solution - optimization is minimization
   //----------------------------------------------
@@ -82,30 +82,33 @@ diag_type CDiagnostic::GetType() const
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Implementation of the CDiagnostic constructor
-/// \param typ [in] type of diagnostics
+/// \brief calculates base weights of observations within diagnostic period
+/// \details base weight is taken from weight time series (or 1.0), and is zero for blank observations
+/// and for observations beyond the threshold percentile of observations in the period
+/// \param pTSObs [in] observation time series
+/// \param pTSWeights [in] observation weight time series (or NULL)
+/// \param &nnstart [out] index of first observation in diagnostic period
+/// \param &nnend [out] index after last observation in diagnostic period
+/// \return array of base weights for each observation point [size: nnend]; entries prior to nnstart are unused
 //
-double CDiagnostic::CalculateDiagnostic(CTimeSeriesABC  *pTSMod,
-                                        CTimeSeriesABC  *pTSObs,
-                                        CTimeSeriesABC  *pTSWeights,
-                                        const double    &starttime,
-                                        const double    &endtime,
-                                        comparison       compare,
-                                        double           threshold,
-                                        const optStruct &Options) const
+double *CalculateBaseWeights(CTimeSeriesABC  *pTSObs,
+                             CTimeSeriesABC  *pTSWeights,
+                             const double    &starttime,
+                             const double    &endtime,
+                             comparison       compare,
+                             double           threshold,
+                             const optStruct &Options,
+                             int             &nnstart,
+                             int             &nnend)
 {
   int nn;
-  double N=0;
-  string filename =pTSObs->GetSourceFile();
   double obsval,modval;
-  double weight=1;
 
   int    skip  =0;
   if (!strcmp(pTSObs->GetName().c_str(), "HYDROGRAPH") && (Options.ave_hydrograph == true)){ skip = 1; }
-  double dt = Options.timestep;
 
-  int nnstart=pTSObs->GetTimeIndexFromModelTime(starttime)+skip; //works for avg. hydrographs
-  int nnend  =pTSObs->GetTimeIndexFromModelTime(endtime  )+1; //+1 is just because below loops expressed w.r.t N, not N-1
+  nnstart=pTSObs->GetTimeIndexFromModelTime(starttime)+skip; //works for avg. hydrographs
+  nnend  =pTSObs->GetTimeIndexFromModelTime(endtime  )+1; //+1 is just because below loops expressed w.r.t N, not N-1
 
   threshold=max(min(threshold,1.0),0.0);
 
@@ -153,46 +156,43 @@ double CDiagnostic::CalculateDiagnostic(CTimeSeriesABC  *pTSMod,
       if(obsval>thresh_obsval) {baseweight[nn]=0.0;}
     }
   }
-
-
-  switch (_type)
-  {
-  case(DIAG_NASH_SUTCLIFFE)://----------------------------------------------------
+  return baseweight;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the CDiagnostic constructor
+/// \param typ [in] type of diagnostics
+//
+double CDiagnostic::CalculateDiagnostic(CTimeSeriesABC  *pTSMod,
+                                        CTimeSeriesABC  *pTSObs,
+                                        CTimeSeriesABC  *pTSWeights,
+                                        const double    &starttime,
+                                        const double    &endtime,
+                                        comparison       compare,
+                                        double           threshold,
+                                        const optStruct &Options) const
+{
+  //diagnostics which are sums over observation points are calculated by a single pass of a diagnostic stream
+  if (CDiagnosticStream::IsStreamable(_type))
   {
-    double avgobs=0.0;
-    N=0;
+    CDiagnosticStream stream(pTSObs,pTSWeights,&_type,1,starttime,endtime,compare,threshold,Options);
+    return stream.GetDiagnostic(0,pTSObs,pTSMod,Options);
+  }
 
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight=baseweight[nn];
-      obsval =pTSObs->GetSampledValue(nn);
-      avgobs+=weight*obsval;
-      N     +=weight;
-    }
-    if(N>0.0) { avgobs/=N; }
+  int nn;
+  double N=0;
+  string filename =pTSObs->GetSourceFile();
+  double obsval,modval;
+  double weight=1;
 
-    double sum1(0.0),sum2(0.0);
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight=baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
+  int    skip  =0;
+  if (!strcmp(pTSObs->GetName().c_str(), "HYDROGRAPH") && (Options.ave_hydrograph == true)){ skip = 1; }
+  double dt = Options.timestep;
 
-      sum1 += weight*pow(obsval - modval,2);
-      sum2 += weight*pow(obsval - avgobs,2);
-    }
+  int nnstart,nnend;
+  double *baseweight=CalculateBaseWeights(pTSObs,pTSWeights,starttime,endtime,compare,threshold,Options,nnstart,nnend);
 
-    if(N>0)
-    {
-      return 1.0 - (sum1 / sum2);
-    }
-    else
-    {
-      string warn = "DIAG_NASH_SUTCLIFFE not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn,Options.noisy);
-      return -ALMOST_INF;
-    }
-  }
+  switch (_type)
+  {
   case(DIAG_NASH_SUTCLIFFE_DER)://----------------------------------------------------
   {
     nnend -= 1;     // Reduce nnend by 1 for derivative of NSE
@@ -372,29 +372,6 @@ double CDiagnostic::CalculateDiagnostic(CTimeSeriesABC  *pTSMod,
       return -ALMOST_INF;
     }
   }
-  case(DIAG_RMSE)://----------------------------------------------------
-  {
-    double sum=0.0;
-    N=0;
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight=baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
-
-      sum+=weight*pow(obsval-modval,2);
-      N  +=weight;
-    }
-    if(N>0.0) {
-      return sqrt(sum / N);
-    }
-    else
-    {
-      string warn = "DIA_RMSE not not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn,Options.noisy);
-      return -ALMOST_INF;
-    }
-  }
   case(DIAG_RMSE_DER)://----------------------------------------------------
   {
     double sum;
@@ -422,81 +399,6 @@ double CDiagnostic::CalculateDiagnostic(CTimeSeriesABC  *pTSMod,
       return -ALMOST_INF;
     }
   }
-  case(DIAG_PCT_BIAS)://-------------------------------------------------
-  {
-    double sum1(0.0),sum2(0.0);
-    N=0;
-    for (nn=nnstart;nn<nnend;nn++)
-    {
-      weight =baseweight[nn];
-      obsval=pTSObs->GetSampledValue(nn);
-      modval=pTSMod->GetSampledValue(nn);
-
-      sum1+=weight*(modval-obsval);
-      sum2+=weight*obsval;
-      N   +=weight;
-    }
-    if (N>0.0)
-    {
-      return 100.0*sum1/sum2;
-    }
-    else
-    {
-      string warn = "DIAG_PCT_BIAS not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn, Options.noisy);
-      return ALMOST_INF;
-    }
-  }
-  case(DIAG_ABS_PCT_BIAS)://-------------------------------------------------
-  {
-      double sum1(0.0), sum2(0.0);
-      N = 0;
-      for (nn = nnstart; nn < nnend; nn++)
-      {
-          weight = baseweight[nn];
-          obsval = pTSObs->GetSampledValue(nn);
-          modval = pTSMod->GetSampledValue(nn);
-
-          sum1 += weight * (modval - obsval);
-          sum2 += weight * obsval;
-          N += weight;
-      }
-      if (N > 0.0)
-      {
-          return fabs( 100.0 * sum1 / sum2);
-      }
-      else
-      {
-          string warn = "DIAG_ABS_PCT_BIAS not calculated. Missing non-zero weighted observations during simulation duration.";
-          WriteWarning(warn, Options.noisy);
-          return ALMOST_INF;
-      }
-  }
-  case(DIAG_ABSERR) ://----------------------------------------------------
-  {
-    double sum=0.0;
-    N = 0;
-
-    for (nn = nnstart; nn < nnend; nn++)
-    {
-      weight =baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
-
-      sum += weight*fabs(obsval - modval);
-      N   += weight;
-    }
-    if (N>0.0)
-    {
-      return sum / N;
-    }
-    else
-    {
-      string warn = "DIAG_ABSERR not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn, Options.noisy);
-      return -ALMOST_INF;
-    }
-  }
   case(DIAG_ABSMAX)://----------------------------------------------------
   {
     double maxerr = -ALMOST_INF;
@@ -928,62 +830,6 @@ double CDiagnostic::CalculateDiagnostic(CTimeSeriesABC  *pTSMod,
       return ALMOST_INF;
     }
   }
-  case(DIAG_KLING_GUPTA)://-----------------------------------------
-  case(DIAG_KLING_GUPTA_DEVIATION)://-------------------------------
-  {
-    double ObsAvg = 0;
-    double ModAvg = 0;
-    double ObsSum = 0;
-    double ModSum = 0;
-    double ObsStd = 0;
-    double ModStd = 0;
-    double Cov = 0;
-    N = 0;
-    for (nn = nnstart; nn < nnend; nn++) //mean
-    {
-      weight =baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
-
-      ObsSum += obsval*weight;
-      ModSum += modval*weight;
-      N += weight;
-    }
-    ObsAvg = ObsSum / N;
-    ModAvg = ModSum / N;
-
-    for (nn = nnstart; nn < nnend; nn++) //std deviation
-    {
-      weight =baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
-
-      ObsStd += pow((obsval - ObsAvg), 2)*weight;
-      ModStd += pow((modval - ModAvg), 2)*weight;
-      Cov += (obsval - ObsAvg) * (modval - ModAvg)*weight;
-    }
-
-    ObsStd = sqrt(ObsStd / N);   // Standard Deviation for Observed Flow
-    ModStd = sqrt(ModStd / N);   // Standard Deviation for Modelled Flow
-    Cov /= N;                    // Covariance between observed and modelled flows
-
-    double r     = Cov / ObsStd / ModStd; // pearson product-moment correlation coefficient
-    double Beta  = ModAvg / ObsAvg;
-    double Alpha = ModStd / ObsStd;
-
-    if (_type==DIAG_KLING_GUPTA_DEVIATION){Beta=1.0;} //remove penalty for difference in means
-
-    if ((N>0) && ((ObsAvg!=0.0) || (Beta==1.0)) && (ObsStd!=0.0) && (ModStd!=0.0))
-    {
-      return 1.0 - sqrt(pow((r - 1), 2) + pow((Alpha - 1), 2) + pow((Beta - 1), 2));
-    }
-    else
-    {
-      string warn = "DIAG_KLING_GUPTA not calculated. Missing non-zero weighted observations during simulation duration and/or zero standard deviation in modeled/observation data.";
-      WriteWarning(warn,Options.noisy);
-      return -ALMOST_INF;
-    }
-  }
   case(DIAG_KLING_GUPTA_DER)://-----------------------------------------
   {
     nnend -= 1;  // Reduce nnend by 1 for derivative of Kling Gupta
@@ -1132,52 +978,6 @@ case(DIAG_DAILY_KGE)://----------------------------------------------------
       return -ALMOST_INF;
     }
   }
-  case(DIAG_R4MS4E)://----------------------------------------------------
-  {
-    double sum=0.0;
-    N=0;
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight = baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
-
-      sum+=weight*pow(obsval-modval,4);
-      N  +=weight;
-    }
-    if(N>0.0) {
-      return pow( (sum/N), 0.25);
-    }
-    else
-    {
-      string warn = "DIAG_R4MS4E not not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn,Options.noisy);
-      return -ALMOST_INF;
-    }
-  }
-  case(DIAG_RTRMSE)://----------------------------------------------------
-  {
-    double sum=0.0;
-    N=0;
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight = baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
-
-      sum+=weight*pow( sqrt(obsval)-sqrt(modval), 2);
-      N  +=weight;
-    }
-    if(N>0.0) {
-      return sqrt(sum / N);
-    }
-    else
-    {
-      string warn = "DIAG_RTRMSE not not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn,Options.noisy);
-      return -ALMOST_INF;
-    }
-  }
   case(DIAG_RABSERR) ://----------------------------------------------------
   {
     double avgobs=0.0;
@@ -1253,49 +1053,280 @@ case(DIAG_DAILY_KGE)://----------------------------------------------------
     }
     return N/365/Options.timestep;
   }
-  case(DIAG_NSE4)://----------------------------------------------------
+  default:
   {
-    double avgobs=0.0;
-    N=0;
+    return 0.0;
+  }
+  }//end switch
 
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight = baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      avgobs+=weight*obsval;
-      N     +=weight;
-    }
-    if(N>0.0) { avgobs/=N; }
+  delete [] baseweight;
+}
+/*****************************************************************
+Diagnostic stream
+------------------------------------------------------------------
+*****************************************************************/
+//////////////////////////////////////////////////////////////////
+/// \brief returns contribution of single observation point to modeled-value term of streamable diagnostic
+/// \param typ [in] diagnostic type
+/// \param &weight [in] base weight of observation point
+/// \param &obsval [in] observed value
+/// \param &modval [in] modeled value
+//
+double StreamTerm(const diag_type typ,const double &weight,const double &obsval,const double &modval)
+{
+  switch(typ)
+  {
+  case(DIAG_NASH_SUTCLIFFE): {return weight*pow(obsval - modval,2);}
+  case(DIAG_RMSE):           {return weight*pow(obsval - modval,2);}
+  case(DIAG_PCT_BIAS):       {return weight*(modval - obsval);}
+  case(DIAG_ABS_PCT_BIAS):   {return weight*(modval - obsval);}
+  case(DIAG_ABSERR):         {return weight*fabs(obsval - modval);}
+  case(DIAG_R4MS4E):         {return weight*pow(obsval - modval,4);}
+  case(DIAG_RTRMSE):         {return weight*pow(sqrt(obsval)-sqrt(modval),2);}
+  case(DIAG_NSE4):           {return weight*pow(obsval - modval,4);}
+  default:                   {return 0.0;}
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the CDiagnosticStream constructor
+/// \details calculates observation weights and observation-only terms of each diagnostic
+/// \param pTSObs [in] observation time series (must be initialized)
+/// \param pTSWeights [in] observation weight time series (or NULL)
+/// \param aTypes [in] array of diagnostic types [size: nDiags]; types which are not streamable are ignored
+/// \param nDiags [in] number of diagnostics
+/// \param &starttime [in] start time of diagnostic period (in local model time)
+/// \param &endtime [in] end time of diagnostic period (in local model time)
+/// \param compare [in] threshold comparison criterion
+/// \param threshold [in] threshold percentage
+/// \param &Options [in] global model options
+//
+CDiagnosticStream::CDiagnosticStream(CTimeSeriesABC  *pTSObs,
+                                     CTimeSeriesABC  *pTSWeights,
+                                     const diag_type *aTypes,
+                                     const int        nDiags,
+                                     const double    &starttime,
+                                     const double    &endtime,
+                                     comparison       compare,
+                                     double           threshold,
+                                     const optStruct &Options)
+{
+  int nn;
+  double weight,obsval;
 
-    double sum1(0.0),sum2(0.0);
-    for(nn=nnstart;nn<nnend;nn++)
-    {
-      weight = baseweight[nn];
-      obsval = pTSObs->GetSampledValue(nn);
-      modval = pTSMod->GetSampledValue(nn);
+  _aWeight=CalculateBaseWeights(pTSObs,pTSWeights,starttime,endtime,compare,threshold,Options,_nnstart,_nnend);
 
-      sum1 += weight*pow(obsval - modval,4);
-      sum2 += weight*pow(obsval - avgobs,4);
-    }
+  _N=0.0;
+  _nonneg=true;
+  double avgobs=0.0;
+  for(nn=_nnstart;nn<_nnend;nn++)
+  {
+    weight=_aWeight[nn];
+    obsval=pTSObs->GetSampledValue(nn);
+    avgobs+=weight*obsval;
+    _N    +=weight;
+    if(weight<0.0) { _nonneg=false; }
+  }
+  if(_N>0.0) { avgobs/=_N; }
+  _avgobs=avgobs;
 
-    if(N>0)
-    {
-      return 1.0 - (sum1 / sum2);
-    }
-    else
+  _sumdobs=0.0;
+  for(nn=_nnstart;nn<_nnend;nn++)
+  {
+    _sumdobs+=_aWeight[nn]*(pTSObs->GetSampledValue(nn)-_avgobs);
+  }
+
+  _nDiags  =nDiags;
+  _aTypes  =new diag_type[_nDiags];
+  _aObsTerm=new double   [_nDiags];
+  _aSum    =new double  *[_nDiags];
+  for(int j=0;j<_nDiags;j++)
+  {
+    _aTypes  [j]=aTypes[j];
+    _aObsTerm[j]=0.0;
+    _aSum    [j]=new double [MAX_STREAM_TERMS];
+    for(nn=_nnstart;nn<_nnend;nn++)
     {
-      string warn = "DIAG_NSE4 not calculated. Missing non-zero weighted observations during simulation duration.";
-      WriteWarning(warn,Options.noisy);
-      return -ALMOST_INF;
+      weight=_aWeight[nn];
+      obsval=pTSObs->GetSampledValue(nn);
+      if     ( _aTypes[j]==DIAG_NASH_SUTCLIFFE) { _aObsTerm[j]+=weight*pow(obsval - avgobs,2); }
+      else if( _aTypes[j]==DIAG_NSE4          ) { _aObsTerm[j]+=weight*pow(obsval - avgobs,4); }
+      else if((_aTypes[j]==DIAG_PCT_BIAS) ||
+              (_aTypes[j]==DIAG_ABS_PCT_BIAS) ) { _aObsTerm[j]+=weight*obsval; }
+      else if((_aTypes[j]==DIAG_KLING_GUPTA) ||
+              (_aTypes[j]==DIAG_KLING_GUPTA_DEVIATION)) { _aObsTerm[j]+=weight*pow(obsval - avgobs,2); }
     }
   }
-  default:
+  Reset();
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the CDiagnosticStream destructor
+//
+CDiagnosticStream::~CDiagnosticStream()
+{
+  delete [] _aWeight;  _aWeight =NULL;
+  delete [] _aTypes;   _aTypes  =NULL;
+  delete [] _aObsTerm; _aObsTerm=NULL;
+  for(int j=0;j<_nDiags;j++) { delete [] _aSum[j]; }
+  delete [] _aSum;     _aSum    =NULL;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns true if diagnostic type may be calculated using a diagnostic stream
+/// \param typ [in] diagnostic type
+//
+bool CDiagnosticStream::IsStreamable(const diag_type typ)
+{
+  return ((typ==DIAG_NASH_SUTCLIFFE) || (typ==DIAG_RMSE)   || (typ==DIAG_PCT_BIAS) || (typ==DIAG_ABS_PCT_BIAS) ||
+          (typ==DIAG_ABSERR)         || (typ==DIAG_R4MS4E) || (typ==DIAG_RTRMSE)   || (typ==DIAG_NSE4)        ||
+          (typ==DIAG_KLING_GUPTA)    || (typ==DIAG_KLING_GUPTA_DEVIATION));
+}
+//////////////////////////////////////////////////////////////////
+/// \brief clears accumulated modeled-value terms
+/// \remark must be called before the modeled time series is restarted (e.g., at start of each ensemble member)
+//
+void CDiagnosticStream::Reset()
+{
+  _nnnext=_nnstart;
+  for(int j=0;j<_nDiags;j++) {
+    for(int m=0;m<MAX_STREAM_TERMS;m++) { _aSum[j][m]=0.0; }
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief adds contribution of single observation point to modeled-value terms of diagnostic j
+/// \param j [in] diagnostic index
+/// \param &weight [in] base weight of observation point
+/// \param &obsval [in] observed value
+/// \param &modval [in] modeled value
+/// \param *sum [in & out] modeled-value terms [size: MAX_STREAM_TERMS]
+//
+void CDiagnosticStream::AddTerms(const int j,const double &weight,const double &obsval,const double &modval,double *sum) const
+{
+  if((_aTypes[j]==DIAG_KLING_GUPTA) || (_aTypes[j]==DIAG_KLING_GUPTA_DEVIATION))
   {
-    return 0.0;
+    double dobs=obsval-_avgobs;
+    double dmod=modval-_avgobs;
+    sum[0]+=weight*dmod;
+    sum[1]+=weight*dmod*dmod;
+    sum[2]+=weight*dobs*dmod;
   }
-  }//end switch
+  else {
+    sum[0]+=StreamTerm(_aTypes[j],weight,obsval,modval);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief accumulates modeled-value terms of all modeled values with index below nn_final
+/// \details modeled values must not change once accumulated
+/// \param pTSObs [in] observation time series
+/// \param pTSMod [in] modeled time series corresponding to observations
+/// \param nn_final [in] index after last finalized modeled value
+//
+void CDiagnosticStream::Update(const CTimeSeriesABC *pTSObs,const CTimeSeriesABC *pTSMod,const int nn_final)
+{
+  int nnlast=min(nn_final,_nnend);
+  double obsval,modval;
+  for(int nn=_nnnext;nn<nnlast;nn++)
+  {
+    obsval=pTSObs->GetSampledValue(nn);
+    modval=pTSMod->GetSampledValue(nn);
+    for(int j=0;j<_nDiags;j++) {
+      AddTerms(j,_aWeight[nn],obsval,modval,_aSum[j]);
+    }
+  }
+  _nnnext=max(_nnnext,nnlast);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns value of diagnostic j from observation-only term and modeled-value terms
+/// \param j [in] diagnostic index
+/// \param *sum [in] modeled-value terms [size: MAX_STREAM_TERMS]
+/// \return diagnostic value, or -ALMOST_INF if Kling-Gupta efficiency cannot be calculated
+/// \remark sum of observation weights must be positive
+//
+double CDiagnosticStream::Finalize(const int j,const double *sum) const
+{
+  double N=_N;
+  switch(_aTypes[j])
+  {
+  case(DIAG_NASH_SUTCLIFFE): {return 1.0 - (sum[0] / _aObsTerm[j]);}
+  case(DIAG_RMSE):           {return sqrt(sum[0] / N);}
+  case(DIAG_PCT_BIAS):       {return 100.0*sum[0]/_aObsTerm[j];}
+  case(DIAG_ABS_PCT_BIAS):   {return fabs( 100.0 * sum[0] / _aObsTerm[j]);}
+  case(DIAG_ABSERR):         {return sum[0] / N;}
+  case(DIAG_R4MS4E):         {return pow( (sum[0]/N), 0.25);}
+  case(DIAG_RTRMSE):         {return sqrt(sum[0] / N);}
+  case(DIAG_NSE4):           {return 1.0 - (sum[0] / _aObsTerm[j]);}
+  case(DIAG_KLING_GUPTA):
+  case(DIAG_KLING_GUPTA_DEVIATION):
+  {
+    double dModAvg = sum[0] / N;                                        //mean modeled deviation from observation mean
+    double ModAvg  = _avgobs + dModAvg;
+    double ObsStd  = sqrt(_aObsTerm[j] / N);                            // Standard Deviation for Observed Flow
+    double ModStd  = sqrt(max(sum[1] / N - dModAvg*dModAvg,0.0));       // Standard Deviation for Modelled Flow
+    double Cov     = sum[2] / N - (_sumdobs / N)*dModAvg;               // Covariance between observed and modelled flows
 
-  delete [] baseweight;
+    double r     = Cov / ObsStd / ModStd; // pearson product-moment correlation coefficient
+    double Beta  = ModAvg / _avgobs;
+    double Alpha = ModStd / ObsStd;
+
+    if (_aTypes[j]==DIAG_KLING_GUPTA_DEVIATION){Beta=1.0;} //remove penalty for difference in means
+
+    if (((_avgobs!=0.0) || (Beta==1.0)) && (ObsStd!=0.0) && (ModStd!=0.0)){
+      return 1.0 - sqrt(pow((r - 1), 2) + pow((Alpha - 1), 2) + pow((Beta - 1), 2));
+    }
+    return -ALMOST_INF;
+  }
+  default:                   {return 0.0;}
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns value of diagnostic j over entire diagnostic period
+/// \details modeled values which have not yet been accumulated are read from modeled time series
+/// \param j [in] diagnostic index
+/// \param pTSObs [in] observation time series
+/// \param pTSMod [in] modeled time series corresponding to observations
+/// \param &Options [in] global model options
+//
+double CDiagnosticStream::GetDiagnostic(const int j,const CTimeSeriesABC *pTSObs,const CTimeSeriesABC *pTSMod,const optStruct &Options) const
+{
+  double sum[MAX_STREAM_TERMS];
+  for(int m=0;m<MAX_STREAM_TERMS;m++) { sum[m]=_aSum[j][m]; }
+  for(int nn=_nnnext;nn<_nnend;nn++)
+  {
+    AddTerms(j,_aWeight[nn],pTSObs->GetSampledValue(nn),pTSMod->GetSampledValue(nn),sum);
+  }
+  if(_N<=0.0)
+  {
+    string warn=CDiagnostic(_aTypes[j]).GetName()+" not calculated. Missing non-zero weighted observations during simulation duration.";
+    WriteWarning(warn,Options.noisy);
+    if((_aTypes[j]==DIAG_PCT_BIAS) || (_aTypes[j]==DIAG_ABS_PCT_BIAS)) { return ALMOST_INF; }
+    return -ALMOST_INF;
+  }
+  double diag=Finalize(j,sum);
+  if(((_aTypes[j]==DIAG_KLING_GUPTA) || (_aTypes[j]==DIAG_KLING_GUPTA_DEVIATION)) && (diag==-ALMOST_INF))
+  {
+    string warn = "DIAG_KLING_GUPTA not calculated. Missing non-zero weighted observations during simulation duration and/or zero standard deviation in modeled/observation data.";
+    WriteWarning(warn,Options.noisy);
+  }
+  return diag;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns bound on final value of diagnostic j from accumulated modeled values alone
+/// \details applies to diagnostics which are monotonic in their (non-negative) modeled-value term: the bound
+/// is an upper bound for NSE-type metrics and a lower bound for error metrics (e.g., RMSE)
+/// \param j [in] diagnostic index
+/// \param &bound [out] bound on final value of diagnostic
+/// \return true if bound is available
+//
+bool CDiagnosticStream::GetPartialBound(const int j,double &bound) const
+{
+  diag_type typ=_aTypes[j];
+  if((!_nonneg) || (_N<=0.0)) { return false; }
+  if((typ==DIAG_NASH_SUTCLIFFE) || (typ==DIAG_NSE4)) {
+    if(_aObsTerm[j]<=0.0) { return false; }
+  }
+  else if((typ!=DIAG_RMSE) && (typ!=DIAG_ABSERR) && (typ!=DIAG_R4MS4E) && (typ!=DIAG_RTRMSE)) {
+    return false;
+  }
+  bound=Finalize(j,_aSum[j]);
+  return true;
 }
 /*****************************************************************
 Constructor/Destructor
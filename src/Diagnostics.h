@@ -8,6 +8,8 @@
 #include "RavenInclude.h"
 #include "TimeSeries.h"
 
+const int MAX_STREAM_TERMS=3; ///< max number of modeled-value terms accumulated by a diagnostic stream (see CDiagnosticStream)
+
 enum diag_type {
   DIAG_NASH_SUTCLIFFE,
   DIAG_DAILY_NSE,
@@ -78,6 +80,59 @@ public:/*------------------------------------------------------*/
                              const optStruct &Options) const;
 };
 
+///////////////////////////////////////////////////////////////////
+/// \brief Streaming sufficient statistics of diagnostics for one observation time series over one diagnostic period
+/// \details Observation weights and all observation-only terms (e.g., sum of weights, NSE denominator) are
+/// calculated once, upon construction. Terms which depend upon modeled values are accumulated as each modeled
+/// value is finalized (see CModel::UpdateDiagnostics), in the same order as a full rescan of the time series,
+/// such that diagnostic values are identical to those calculated from the complete modeled time series.
+/// Only diagnostics which may be calculated from sums over observation points are supported (see IsStreamable()).
+/// The Kling-Gupta efficiency is calculated from the weighted sums of the deviations of observed and modeled
+/// values from the observation mean (known upon construction), of their squares and of their products
+//
+class CDiagnosticStream
+{
+private:/*------------------------------------------------------*/
+
+  int        _nnstart;   ///< index of first observation in diagnostic period
+  int        _nnend;     ///< index after last observation in diagnostic period
+  int        _nnnext;    ///< index of first modeled value not yet accumulated
+  double    *_aWeight;   ///< base weight of each observation, zero if blank or beyond threshold [size: _nnend]
+  double     _N;         ///< sum of observation weights
+  bool       _nonneg;    ///< true if all observation weights are non-negative
+
+  int        _nDiags;    ///< number of diagnostics
+  diag_type *_aTypes;    ///< diagnostic types [size: _nDiags]
+  double     _avgobs;    ///< weighted mean of observations
+  double     _sumdobs;   ///< weighted sum of deviations of observations from _avgobs (zero, but for roundoff)
+  double    *_aObsTerm;  ///< observation-only term of each diagnostic (e.g., NSE denominator) [size: _nDiags]
+  double   **_aSum;      ///< accumulated modeled-value terms of each diagnostic [size: _nDiags][MAX_STREAM_TERMS]
+
+  void   AddTerms(const int j,const double &weight,const double &obsval,const double &modval,double *sum) const;
+  double Finalize(const int j,const double *sum) const;
+
+public:/*------------------------------------------------------*/
+
+  CDiagnosticStream(CTimeSeriesABC  *pTSObs,
+                    CTimeSeriesABC  *pTSWeights,
+                    const diag_type *aTypes,
+                    const int        nDiags,
+                    const double    &starttime,
+                    const double    &endtime,
+                    comparison       compare,
+                    double           threshold,
+                    const optStruct &Options);
+  ~CDiagnosticStream();
+
+  static bool IsStreamable(const diag_type typ);
+
+  void   Reset          ();
+  void   Update         (const CTimeSeriesABC *pTSObs,const CTimeSeriesABC *pTSMod,const int nn_final);
+
+  double GetDiagnostic  (const int j,const CTimeSeriesABC *pTSObs,const CTimeSeriesABC *pTSMod,const optStruct &Options) const;
+  bool   GetPartialBound(const int j,double &bound) const;
+};
+
 ///////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for diagnostic period
 class CDiagPeriod
@@ -8,6 +8,7 @@ Copyright (c) 2008-2023 the Raven Development Team
 
 bool IsContinuousFlowObs(const CTimeSeriesABC* pObs,long SBID);
 bool ParseInitialConditions(CModel*& pModel,const optStruct& Options);
+void CheckInitialStateVars (CModel*& pModel,const optStruct& Options);
 bool ParseTimeSeriesFile(CModel*& pModel,const optStruct& Options);
 
 string FilenamePrepare(string filebase,const optStruct& Options); //Defined in StandardOutput.cpp
@@ -30,6 +31,10 @@ string FilenamePrepare(string filebase,const optStruct& Options); //Defined in S
 //  :AssimilatedState STREAMFLOW {SubBasinGroup} # only STREAMFLOW to be supported initially
 //  :AssimilatedState SNOW       {HRUGroup}
 //
+//  :LocalizationRadius [km] # optional; observations only update states within this distance along the river network
+//  :InMemoryMembers # optional; member states held in memory for assimilation rather than re-read from solution files
+//  :ConcurrentMembers [#] # optional; members simulated concurrently (implies :InMemoryMembers)
+//
 //  //plus, uses streamflow locations tagged for assimilation
 //  :AssimilateStreamflow [SBID1] # (optionally in .rvt file)
 //  :AssimilateStreamflow [SBID2]
@@ -70,6 +75,20 @@ CEnKFEnsemble::CEnKFEnsemble(const int num_members,const optStruct &Options)
 
   _window_size=1;
   _nTimeSteps =0;
+
+  _aObsIndices   =NULL;
+  _nObs          =0;
+  _loc_radius    =0.0;
+  _aStateBasin   =NULL;
+  _aObsBasin     =NULL;
+  _nSubBasins    =0;
+  _aDownstreamInd=NULL;
+  _aReachLength  =NULL;
+  _aNetworkOrder =NULL;
+
+  _in_memory     =false;
+  _aMemberStates =NULL;
+  _aMemberSeeds  =NULL;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief EnKF Ensemble Destrucutor
@@ -94,6 +113,13 @@ CEnKFEnsemble::~CEnKFEnsemble()
   delete [] _aAssimLayers;
   delete [] _aAssimGroupID;
   delete [] _aObsIndices;
+  delete [] _aStateBasin;
+  delete [] _aObsBasin;
+  delete [] _aDownstreamInd;
+  delete [] _aReachLength;
+  delete [] _aNetworkOrder;
+  delete [] _aMemberStates;
+  delete [] _aMemberSeeds;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief adds additional state observation perturbation - applied to ALL observations of this type
@@ -169,6 +195,17 @@ void CEnKFEnsemble::SetWindowSize(const int nTimesteps){ _window_size=nTimesteps
 //
 void CEnKFEnsemble::SetExtraRVTFile(string filename){_extra_rvt=filename;}
 
+//////////////////////////////////////////////////////////////////
+/// \brief set covariance localization radius
+/// \param radius [in] distance along river network [km] beyond which observations do not influence states (0.0 to disable localization)
+//
+void CEnKFEnsemble::SetLocalizationRadius(const double &radius){_loc_radius=max(radius,0.0);}
+//////////////////////////////////////////////////////////////////
+/// \brief sets whether member model states are held in memory for assimilation
+/// \param in_memory [in] true if states are held in memory, false if re-read from member solution files
+//
+void CEnKFEnsemble::SetInMemoryMembers(const bool in_memory){_in_memory=in_memory;}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Accessor - gets ensemble start time (in local model time)
 /// \param e [in] ensemble index
@@ -219,10 +256,10 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
   // determine total number of state variables
   // should closely echo contents of AddToStateMatrix/UpdateFromStateMatrix
   //-----------------------------------------------
-  int kk;
-  string tmp_names[2000];
+  int kk,p;
+  vector<string> tmp_names;
+  vector<int>    tmp_basins; //subbasin index of each state variable
   _nStateVars=0;
-  int ii=0;
   for(int i=0;i<_nAssimStates;i++)
   {
     kk=_aAssimGroupID[i];
@@ -230,19 +267,20 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
       for(int pp=0;pp<pModel->GetSubBasinGroup(kk)->GetNumSubbasins();pp++)
       {
         CSubBasin* pBasin=pModel->GetSubBasinGroup(kk)->GetSubBasin(pp);
+        p=pModel->GetSubBasinIndex(pBasin->GetID());
         _nStateVars+=pBasin->GetInflowHistorySize();
         _nStateVars+=pBasin->GetNumSegments();
         _nStateVars++; //Qlast
 
-        for (int n=0;n<pBasin->GetInflowHistorySize();n++){tmp_names[ii]="inflow_" +to_string(pp)+"_"+to_string(n); ii++; }
-        for (int n=0;n<pBasin->GetNumSegments();      n++){tmp_names[ii]="outflow_"+to_string(pp)+"_"+to_string(n); ii++; }
-        tmp_names[ii]="outflowlast_"+to_string(pp); ii++;
+        for (int n=0;n<pBasin->GetInflowHistorySize();n++){tmp_names.push_back("inflow_" +to_string(pp)+"_"+to_string(n)); tmp_basins.push_back(p); }
+        for (int n=0;n<pBasin->GetNumSegments();      n++){tmp_names.push_back("outflow_"+to_string(pp)+"_"+to_string(n)); tmp_basins.push_back(p); }
+        tmp_names.push_back("outflowlast_"+to_string(pp)); tmp_basins.push_back(p);
 
         if (pBasin->GetReservoir() != NULL)
         {
           _nStateVars+=2; //resflow + resflow_last
-          tmp_names[ii]="resflow_"    +to_string(pp); ii++;
-          tmp_names[ii]="resflowlast_"+to_string(pp); ii++;
+          tmp_names.push_back("resflow_"    +to_string(pp)); tmp_basins.push_back(p);
+          tmp_names.push_back("resflowlast_"+to_string(pp)); tmp_basins.push_back(p);
         }
       }
     }
@@ -250,11 +288,12 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
       for(int pp=0;pp<pModel->GetSubBasinGroup(kk)->GetNumSubbasins();pp++)
       {
         CSubBasin* pBasin=pModel->GetSubBasinGroup(kk)->GetSubBasin(pp);
+        p=pModel->GetSubBasinIndex(pBasin->GetID());
         if (pBasin->GetReservoir() != NULL)
         {
           _nStateVars+=2;
-          tmp_names[ii]="resstage_"    +to_string(pp); ii++;
-          tmp_names[ii]="resstagelast_"+to_string(pp); ii++;
+          tmp_names.push_back("resstage_"    +to_string(pp)); tmp_basins.push_back(p);
+          tmp_names.push_back("resstagelast_"+to_string(pp)); tmp_basins.push_back(p);
         }
       }
     }
@@ -263,15 +302,31 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
       for (int n=0;n<pModel->GetHRUGroup(kk)->GetNumHRUs();n++)
       {
         int k=pModel->GetHRUGroup(kk)->GetHRU(n)->GetID();
+        p=pModel->GetHRUGroup(kk)->GetHRU(n)->GetSubBasinIndex();
         string svname = CStateVariable::SVTypeToString(_aAssimStates[i],_aAssimLayers[i]);
-        tmp_names[ii]=svname+"_" +to_string(k); ii++;
+        tmp_names.push_back(svname+"_" +to_string(k)); tmp_basins.push_back(p);
       }
     }
   }
 
   _state_names=new string [ _nStateVars];
+  _aStateBasin=new int    [ _nStateVars];
   for (int i = 0; i < _nStateVars; i++) {
-    _state_names[i]=tmp_names[i];
+    _state_names[i]=tmp_names [i];
+    _aStateBasin[i]=tmp_basins[i];
+  }
+
+  // store river network topology, used for covariance localization
+  //-----------------------------------------------
+  _nSubBasins    =pModel->GetNumSubBasins();
+  _aDownstreamInd=new int    [_nSubBasins];
+  _aReachLength  =new double [_nSubBasins];
+  _aNetworkOrder =new int    [_nSubBasins];
+  ExitGracefullyIf(_aNetworkOrder==NULL,"CEnKFEnsemble::Initialize",OUT_OF_MEMORY);
+  for(p=0;p<_nSubBasins;p++) {
+    _aDownstreamInd[p]=pModel->GetDownstreamBasin(p);
+    _aReachLength  [p]=pModel->GetSubBasin(p)->GetReachLength()/M_PER_KM;
+    _aNetworkOrder [p]=pModel->GetOrderedSubBasinIndex(_nSubBasins-1-p); //routing order is upstream to downstream
   }
 
   //create empty _state_matrix
@@ -329,6 +384,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
 
   //allocate _output_matrix and _noise_matrix
   //-----------------------------------------------
+  _aObsBasin    =new int     [_nObsDatapoints];
   _obs_matrix   =new double *[_nEnKFMembers];
   _output_matrix=new double *[_nEnKFMembers];
   _noise_matrix =new double *[_nEnKFMembers];
@@ -373,6 +429,7 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
             else if (pPerturb->adj_type == ADJ_MULTIPLICATIVE){ _noise_matrix[e][j]=(eps*obsval)-obsval; }
           }
           _obs_matrix[e][j]=obsval+_noise_matrix[e][j];
+          _aObsBasin [j]   =pModel->GetSubBasinIndex(pTSObs->GetLocID());
           j++;
         }
       }
@@ -383,6 +440,30 @@ void CEnKFEnsemble::Initialize(const CModel* pModel,const optStruct &Options)
     }
   }
 
+  // in-memory members
+  // member end states are stored in memory (or returned from concurrent member processes) and updated directly;
+  // in spinup mode, the common initial conditions are also read once and restored from memory for each member
+  //-----------------------------------------------
+  if (_nConcurrent>1){_in_memory=true;}
+  if (_in_memory)
+  {
+    _aMemberStates=new vector<double> [_nEnKFMembers];
+    ExitGracefullyIf(_aMemberStates==NULL,"CEnKFEnsemble::Initialize(3)",OUT_OF_MEMORY);
+    _checkpoint_ICs=(_EnKF_mode==ENKF_SPINUP) && (Options.stateinfo_filename=="") && (Options.flowinfo_filename=="");
+  }
+
+  // concurrent members each draw forcing perturbations from their own random sequence,
+  // so that results do not depend upon the number of concurrent members
+  //-----------------------------------------------
+  if (_nConcurrent>1)
+  {
+    _aMemberSeeds=new unsigned int [_nEnKFMembers];
+    ExitGracefullyIf(_aMemberSeeds==NULL,"CEnKFEnsemble::Initialize(4)",OUT_OF_MEMORY);
+    for(int e=0;e<_nEnKFMembers;e++) {
+      _aMemberSeeds[e]=(unsigned int)(rand());
+    }
+  }
+
   // Create and open EnKFOutput file
   //-----------------------------------------------
   string filename= FilenamePrepare("EnKFOutput.csv",Options);
@@ -448,13 +529,15 @@ void CEnKFEnsemble::CloseTimeStepOps(CModel* pModel,optStruct& Options,const tim
 //////////////////////////////////////////////////////////////////
 /// \brief the EnKF assimilation matrix calculations for updating states
 /// Based upon Mandel, J., Efficient Implementation of the Ensemble Kalman Filter, Report, Univ of Colorado, 2006.
+/// \details P is factored (SVD) once and the factorization is reused for the innovations of all members.
+/// If a localization radius is set, P and the state-observation covariances are tapered (Schur product)
+/// by a function of the river network distance between subbasins, and the update is calculated in state space
 //
 void CEnKFEnsemble::AssimilationCalcs()
 {
   if (_nObsDatapoints==0){return; } //skips assimilation if no observations available
 
-  //return;
-  int i,j,k;
+  int i,j,k,l;
 
   //some shorthand to clean up local variable names
   int N       =_nEnKFMembers;   //# of enkf members
@@ -465,38 +548,22 @@ void CEnKFEnsemble::AssimilationCalcs()
   double** eQT=_noise_matrix; //outerr matrix is [NxNobs]
 
   double** HA;   //output matrix difference from ensemble mean [NobsxN]
-  double** HAT;  //HA transpose [NxNobs]
   double** A;    //prediction ensemble variation matrix [MxN]
-  double** P;    //inverted matrix term
-  double** eQ;
-  double** tmp;
-  double** MM;
-  double** Z;
-  double** X_deltaT;
-  double** X_delta;
-  double* ans =new double[Nobs];
-  double* diff=new double[Nobs];
+  double** P;    //inverted matrix term [NobsxNobs]
+  double** eQ;   //observation error matrix [NobsxN]
+  double** U;    //left singular vectors of P [NobsxNobs]
+  double** V;    //right singular vectors of P [NobsxNobs]
+  double** Y;    //inv(P)*(O_obs-O_sim) of each member [NxNobs]
+  double*  w   =new double[Nobs]; //singular values of P
+  double*  diff=new double[Nobs];
 
   AllocateMatrix(M,N,A);
   AllocateMatrix(Nobs,N,HA);
-  AllocateMatrix(N,Nobs,HAT);
   AllocateMatrix(Nobs,Nobs,P);
   AllocateMatrix(Nobs,N,eQ);
-  AllocateMatrix(Nobs,Nobs,tmp);
-  AllocateMatrix(Nobs,N,MM);
-  AllocateMatrix(N,N,Z);
-  AllocateMatrix(M,N,X_deltaT);
-  AllocateMatrix(N,M,X_delta);
-
-  /*cout << "_output_matrix[][]:" << endl;
-  for(int i=0;i<N;i++) {
-    for(int j=0;j<Nobs;j++) {cout<<_output_matrix[i][j]<<"| ";}cout<<endl;
-  }
-  cout<<"_obs_matrix[][]:"<<endl;
-  for(int i=0;i<N;i++) {
-    for(int j=0;j<Nobs;j++) {cout<<_obs_matrix[i][j]<<"| ";}cout<<endl;
-  } */
-
+  AllocateMatrix(Nobs,Nobs,U);
+  AllocateMatrix(Nobs,Nobs,V);
+  AllocateMatrix(N,Nobs,Y);
 
   //HA=O_sim-1/N*(O_sim*e_N1)*e_1N
   double outMean=0;
@@ -517,55 +584,134 @@ void CEnKFEnsemble::AssimilationCalcs()
       A[k][i]=X[i][k]-Xmean; // M x N
     }
   }
-  //cout<<"  -calculated HA, A matrices"<<endl;
 
   //P=1/(N-1)*HA*(HA)'+1/(N-1)*(eQ*eQ');
   // 1st term is covariance matrix of simulated output states
   // 2nd term is the covariance matrix (R) of ths measurement error
-  TransposeMat(HA,Nobs,N,HAT);
-  MatMult(HA,HAT,Nobs,N,Nobs,P);        //P is Nobs x Nobs
-  TransposeMat(eQT,N,Nobs,eQ);          //eQ is Nobs x N
-  MatMult(eQ,eQT,Nobs,N,Nobs,tmp);      //tmp is Nobs x Nobs
-  MatAdd(P,tmp,Nobs,Nobs,P);            //P is Nobs x Nobs
+  TransposeMat (eQT,N,Nobs,eQ);         //eQ is Nobs x N
+  MatMultTransB(HA,HA,Nobs,N,Nobs,P);   //P is Nobs x Nobs
+  MatMultTransB(eQ,eQ,Nobs,N,Nobs,U);   //U (Nobs x Nobs) is temporary storage until P is factored
+  MatAdd       (P,U,Nobs,Nobs,P);
   ScalarMatMult(P,1.0/(N-1),Nobs,Nobs,P);
 
-  //Z=HA'*(inv(P)*(O_obs-O_sim));
+  //localize P by network distance between observation locations
+  double *dist=NULL;
+  bool localize=(_loc_radius>0.0);
+  if (localize)
+  {
+    dist=new double [_nSubBasins];
+    for(j=0;j<Nobs;j++)
+    {
+      if ((j==0) || (_aObsBasin[j]!=_aObsBasin[j-1])){GetNetworkDistances(_aObsBasin[j],dist);}
+      for(l=0;l<Nobs;l++) { P[j][l]*=GetLocalizationWeight(dist[_aObsBasin[l]]); }
+    }
+  }
+
+  //Y=inv(P)*(O_obs-O_sim)' - P is factored once for all members
   double svd_tol=1e-8;
+  SVDDecompose(P,U,w,V,Nobs,svd_tol);
   for(i=0; i<N; i++)
   {
     for(j=0;j<Nobs;j++) { diff[j]=_obs_matrix[i][j]-_output_matrix[i][j]; }
-    SVD(P,diff,ans,Nobs,svd_tol);
-    for(j=0;j<Nobs;j++) { MM[j][i]=ans[j]; } //MM is Nobs x N
+    SVDBackSubstitute(U,w,V,diff,Y[i],Nobs);
   }
-  MatMult(HAT,MM,N,Nobs,N,Z);           //Z is N x N
-
-  //X_delta = 1/(N-1)*A*Z;
-  MatMult(A,Z,M,N,N,X_deltaT);          //X_deltaT is M x N
-  ScalarMatMult(X_deltaT,1.0/(N-1),M,N,X_deltaT);
-  TransposeMat (X_deltaT,M,N,X_delta);  //X_delta is N x M
-
-  //update state matrix Xa=X+X_delta
-  MatAdd(_state_matrix,X_delta,N,M,_state_matrix);
 
-  /*cout << "X_delta[][]" << endl;
-  for(int i=0;i<N;i++) {
-    for(int j=0;j<M;j++) {cout<<X_delta[i][j]<<"| ";}cout<<endl;
-  }*/
+  if (!localize)
+  {
+    //Z=HA'*Y' (ensemble space); stored as transpose, ZT=Y*HA [NxN]
+    double **ZT;
+    AllocateMatrix(N,N,ZT);
+    MatMult(Y,HA,N,Nobs,N,ZT);
+
+    //update state matrix Xa=X+X_delta, X_delta = 1/(N-1)*(A*Z)'
+    double s;
+    for(k=0;k<M;k++) {
+      for(i=0;i<N;i++) {
+        s=0.0;
+        for(l=0;l<N;l++) { s+=A[k][l]*ZT[i][l]; }
+        X[i][k]+=s*(1.0/(N-1));
+      }
+    }
+    DeleteMatrix(N,N,ZT);
+  }
+  else
+  {
+    //update state matrix Xa=X+X_delta, X_delta = (rho o (1/(N-1)*A*HA'))*Y' (state space)
+    // states beyond the localization radius of an observation are not affected by it
+    double c,rho;
+    for(j=0;j<Nobs;j++)
+    {
+      if ((j==0) || (_aObsBasin[j]!=_aObsBasin[j-1])){GetNetworkDistances(_aObsBasin[j],dist);}
+      for(k=0;k<M;k++)
+      {
+        rho=GetLocalizationWeight(dist[_aStateBasin[k]]);
+        if (rho==0.0){continue;}
+        c=0.0;
+        for(l=0;l<N;l++) { c+=A[k][l]*HA[j][l]; }
+        c*=rho/(N-1);
+        for(i=0;i<N;i++) { X[i][k]+=c*Y[i][j]; }
+      }
+    }
+    delete [] dist;
+  }
 
   //clean up
-  delete[] ans;
+  delete[] w;
   delete[] diff;
   DeleteMatrix(M,N,A);
   DeleteMatrix(Nobs,N,HA);
-  DeleteMatrix(N,Nobs,HAT);
   DeleteMatrix(Nobs,Nobs,P);
   DeleteMatrix(Nobs,N,eQ);
-  DeleteMatrix(Nobs,Nobs,tmp);
-  DeleteMatrix(Nobs,N,MM);
-  DeleteMatrix(N,N,Z);
-  DeleteMatrix(M,N,X_deltaT);
-  DeleteMatrix(N,M,X_delta);
+  DeleteMatrix(Nobs,Nobs,U);
+  DeleteMatrix(Nobs,Nobs,V);
+  DeleteMatrix(N,Nobs,Y);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief calculates distance along river network from subbasin p to all subbasins
+/// \details distance between two subbasins is the total length of reaches from the outlet of each
+/// down to the outlet of their first common downstream subbasin
+/// \param p [in] subbasin index
+/// \param dist [out] distance [km] from p to each subbasin, ALMOST_INF if not in same watershed [size: _nSubBasins]
+//
+void CEnKFEnsemble::GetNetworkDistances(const int p,double *dist) const
+{
+  int q,pp,pDown;
+  for(q=0;q<_nSubBasins;q++){dist[q]=ALMOST_INF;}
 
+  //subbasins downstream of p
+  double d=0.0;
+  q=p;
+  while(q!=DOESNT_EXIST)
+  {
+    dist[q]=d;
+    q=_aDownstreamInd[q];
+    if(q!=DOESNT_EXIST){d+=_aReachLength[q];}
+  }
+  //all others, from outlets to headwaters, such that downstream distance is always known first
+  for(pp=0;pp<_nSubBasins;pp++)
+  {
+    q    =_aNetworkOrder[pp];
+    pDown=_aDownstreamInd[q];
+    if((dist[q]==ALMOST_INF) && (pDown!=DOESNT_EXIST) && (dist[pDown]!=ALMOST_INF)){
+      dist[q]=dist[pDown]+_aReachLength[pDown];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns covariance localization weight
+/// \details Gaspari-Cohn fifth-order taper (Gaspari & Cohn, 1999), which decreases from 1 (dist=0) to 0 (dist>=_loc_radius)
+/// \param dist [in] distance along river network [km]
+/// \return localization weight [0..1]
+//
+double CEnKFEnsemble::GetLocalizationWeight(const double &dist) const
+{
+  if(_loc_radius<=0.0){return 1.0;}
+  double r=2.0*dist/_loc_radius;
+  if     (r>=2.0){return 0.0;}
+  else if(r<=1.0){return 1.0+r*r*(-5.0/3.0+r*(5.0/8.0+r*(0.5-0.25*r)));}
+  else           {return 4.0+r*(-5.0+r*(5.0/3.0+r*(5.0/8.0+r*(-0.5+r/12.0))))-2.0/(3.0*r);}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -755,8 +901,9 @@ void CEnKFEnsemble::UpdateModel(CModel *pModel,optStruct &Options,const int e)
     Options.rvc_filename=_orig_rvc_file;
   }
 
-  ParseInitialConditions(pModel,Options);
-  pModel->CalculateInitialWaterStorage(Options);
+  ResetInitialConditions(pModel,Options);
+
+  if (_aMemberSeeds!=NULL){srand(_aMemberSeeds[e]);}
 
   // read ensemble-member specific time series (e.g., upstream flows in model cascade), if present
   if (_extra_rvt != "") {
@@ -783,85 +930,162 @@ void CEnKFEnsemble::FinishEnsembleRun(CModel *pModel,optStruct &Options,const ti
 
   //grabs states and stores them in state matrix
   AddToStateMatrix(pModel,Options,e);
+  if (_in_memory){
+    _aMemberStates[e].clear();
+    pModel->GetModelState(_aMemberStates[e]);
+  }
+
+  if(e==_nEnKFMembers-1) //After all ensemble members have run
+  {
+    FinishAssimilation(pModel,Options,tt);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief called after concurrent member run; returns member states to ensemble driver
+/// \details result is [model time, state vector, simulated outputs, model state]
+/// \param pModel [in] pointer to model instance which has simulated ensemble member
+/// \param &Options [in] Global model options information
+/// \param &tt [in] time structure at end of simulation
+/// \param e [in] ensemble member index
+/// \param &result [out] array of member results
+//
+void CEnKFEnsemble::GetMemberResult(CModel *pModel,optStruct &Options,const time_struct &tt,const int e,vector<double> &result)
+{
+  if ((_EnKF_mode==ENKF_OPEN_LOOP) || (_EnKF_mode==ENKF_FORECAST) || (_EnKF_mode==ENKF_OPEN_FORECAST)){
+    return;
+  }
+  AddToStateMatrix(pModel,Options,e);
+
+  result.push_back(tt.model_time);
+  result.insert(result.end(),_state_matrix [e],_state_matrix [e]+_nStateVars);
+  result.insert(result.end(),_output_matrix[e],_output_matrix[e]+_nObsDatapoints);
+  pModel->GetModelState(result);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief called in place of FinishEnsembleRun for concurrent members, in member order
+/// \param pModel [out] pointer to global model instance
+/// \param &Options [out] Global model options information
+/// \param e [in] ensemble member index
+/// \param &result [in] result returned by GetMemberResult()
+//
+void CEnKFEnsemble::ReceiveMemberResult(CModel *pModel,optStruct &Options,const int e,const vector<double> &result)
+{
+  if ((_EnKF_mode==ENKF_OPEN_LOOP) || (_EnKF_mode==ENKF_FORECAST) || (_EnKF_mode==ENKF_OPEN_FORECAST)){
+    return;
+  }
+  ExitGracefullyIf(result.size()<(size_t)(1+_nStateVars+_nObsDatapoints),"CEnKFEnsemble::ReceiveMemberResult: incomplete member result",RUNTIME_ERR);
+
+  size_t i=1;
+  for(int j=0;j<_nStateVars;    j++){_state_matrix [e][j]=result[i]; i++;}
+  for(int j=0;j<_nObsDatapoints;j++){_output_matrix[e][j]=result[i]; i++;}
+  _aMemberStates[e].assign(result.begin()+i,result.end());
 
   if(e==_nEnKFMembers-1) //After all ensemble members have run
   {
-    _ENKFOUT<<"PRE-ASSIMILATION STATE MATRIX:"<<endl;
-    _ENKFOUT<<"member"<<",";
-    for (int i = 0; i<_nStateVars; i++) {
-      _ENKFOUT<<_state_names[i]<<",";
+    time_struct tt;
+    JulianConvert(result[0],Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
+    FinishAssimilation(pModel,Options,tt);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief performs assimilation once all members have run, then writes EnKF output and updated member solution files
+/// \param pModel [out] pointer to global model instance
+/// \param &Options [out] Global model options information
+/// \param &tt [in] time structure at end of simulation
+//
+void CEnKFEnsemble::FinishAssimilation(CModel *pModel,optStruct &Options,const time_struct &tt)
+{
+  _ENKFOUT<<"PRE-ASSIMILATION STATE MATRIX:"<<endl;
+  _ENKFOUT<<"member"<<",";
+  for (int i = 0; i<_nStateVars; i++) {
+    _ENKFOUT<<_state_names[i]<<",";
+  }
+  _ENKFOUT<<endl;
+  for(int e=0;e<_nEnKFMembers;e++) {
+    _ENKFOUT<<e+1<<",";
+    for(int i=0;i<_nStateVars;i++) {
+      _ENKFOUT<<_state_matrix[e][i]<<",";
     }
     _ENKFOUT<<endl;
-    for(int e=0;e<_nEnKFMembers;e++) {
-      _ENKFOUT<<e+1<<",";
-      for(int i=0;i<_nStateVars;i++) {
-        _ENKFOUT<<_state_matrix[e][i]<<",";
-      }
-      _ENKFOUT<<endl;
-    }
+  }
 
-    cout<<endl<<"ENKF: Performing Assimilation Calculations with "<<_nObsDatapoints<<" observation datapoints..."<<endl;
-    AssimilationCalcs();
+  cout<<endl<<"ENKF: Performing Assimilation Calculations with "<<_nObsDatapoints<<" observation datapoints..."<<endl;
+  AssimilationCalcs();
 
-    _ENKFOUT<<"POST-ASSIMILATION STATE MATRIX:"<<endl;
-    _ENKFOUT<<"member"<<",";
-    for (int i = 0; i<_nStateVars; i++) {
-      _ENKFOUT<<_state_names[i]<<",";
+  _ENKFOUT<<"POST-ASSIMILATION STATE MATRIX:"<<endl;
+  _ENKFOUT<<"member"<<",";
+  for (int i = 0; i<_nStateVars; i++) {
+    _ENKFOUT<<_state_names[i]<<",";
+  }
+  _ENKFOUT<<endl;
+  for(int e=0;e<_nEnKFMembers;e++) {
+    _ENKFOUT<<e+1<<",";
+    for(int i=0;i<_nStateVars;i++) {
+      _ENKFOUT<<_state_matrix[e][i]<<",";
     }
     _ENKFOUT<<endl;
-    for(int e=0;e<_nEnKFMembers;e++) {
-      _ENKFOUT<<e+1<<",";
-      for(int i=0;i<_nStateVars;i++) {
-        _ENKFOUT<<_state_matrix[e][i]<<",";
-      }
-      _ENKFOUT<<endl;
-    }
+  }
 
-    _ENKFOUT<<"NOISE MATRIX:"<<endl;
-    for(int e=0;e<_nEnKFMembers;e++) {
-      _ENKFOUT<<e+1<<",";
-      for(int i=0;i<_nObsDatapoints;i++) {
-        _ENKFOUT<<_noise_matrix[e][i]<<",";
-      }
-      _ENKFOUT<<endl;
+  _ENKFOUT<<"NOISE MATRIX:"<<endl;
+  for(int e=0;e<_nEnKFMembers;e++) {
+    _ENKFOUT<<e+1<<",";
+    for(int i=0;i<_nObsDatapoints;i++) {
+      _ENKFOUT<<_noise_matrix[e][i]<<",";
     }
-    _ENKFOUT<<"OBSERVATION MATRIX:"<<endl;
-    for(int e=0;e<_nEnKFMembers;e++) {
-      _ENKFOUT<<e+1<<",";
-      for(int i=0;i<_nObsDatapoints;i++) {
-        _ENKFOUT<<_obs_matrix[e][i]<<",";
-      }
-      _ENKFOUT<<endl;
+    _ENKFOUT<<endl;
+  }
+  _ENKFOUT<<"OBSERVATION MATRIX:"<<endl;
+  for(int e=0;e<_nEnKFMembers;e++) {
+    _ENKFOUT<<e+1<<",";
+    for(int i=0;i<_nObsDatapoints;i++) {
+      _ENKFOUT<<_obs_matrix[e][i]<<",";
     }
-    _ENKFOUT<<"SIMULATED OUTPUT MATRIX:"<<endl;
-    for(int e=0;e<_nEnKFMembers;e++) {
-      _ENKFOUT<<e+1<<",";
-      for(int i=0;i<_nObsDatapoints;i++) {
-        _ENKFOUT<<_output_matrix[e][i]<<",";
-      }
-      _ENKFOUT<<endl;
+    _ENKFOUT<<endl;
+  }
+  _ENKFOUT<<"SIMULATED OUTPUT MATRIX:"<<endl;
+  for(int e=0;e<_nEnKFMembers;e++) {
+    _ENKFOUT<<e+1<<",";
+    for(int i=0;i<_nObsDatapoints;i++) {
+      _ENKFOUT<<_output_matrix[e][i]<<",";
     }
-    _ENKFOUT.close();
+    _ENKFOUT<<endl;
+  }
+  _ENKFOUT.close();
 
-    //Write EnKF-updated solution files
-    // requires full re-reading of ensemble member solution files
-    string solfile;
-    cout<<"ENKF: Writing  Solution Files..."<<endl;
-    for(int ee=0;ee<_nEnKFMembers;ee++)
-    {
-      Options.output_dir=_aOutputDirs[ee];
-      Options.run_name  =_aRunNames  [ee];
+  //Write EnKF-updated solution files
+  // requires full re-reading of ensemble member solution files, unless member states are held in memory
+  string solfile;
+  cout<<"ENKF: Writing  Solution Files..."<<endl;
+  for(int ee=0;ee<_nEnKFMembers;ee++)
+  {
+    Options.output_dir=_aOutputDirs[ee];
+    Options.run_name  =_aRunNames  [ee];
 
-      if(Options.run_name=="") { solfile="solution.rvc"; }
-      else                     { solfile=Options.run_name+"_"+"solution.rvc"; }
-      Options.rvc_filename=_aOutputDirs[ee]+solfile;
+    if(Options.run_name=="") { solfile="solution.rvc"; }
+    else                     { solfile=Options.run_name+"_"+"solution.rvc"; }
+    Options.rvc_filename=_aOutputDirs[ee]+solfile;
 
+    if (_in_memory)
+    {
+      size_t i=0;
+      ExitGracefullyIf(_aMemberStates[ee].empty(),"CEnKFEnsemble::FinishAssimilation: missing member state",RUNTIME_ERR);
+      pModel->SetModelState(_aMemberStates[ee].data(),i);
+      ExitGracefullyIf(i!=_aMemberStates[ee].size(),"CEnKFEnsemble::FinishAssimilation: inconsistent member state",RUNTIME_ERR);
+      for(int k=0;k<pModel->GetNumHRUs();k++) { //cumulative precip & evap are not read from solution files
+        for(int j=0;j<pModel->GetNumStateVars();j++) {
+          if((pModel->GetStateVarType(j)==ATMOS_PRECIP) || (pModel->GetStateVarType(j)==ATMOSPHERE)) {pModel->GetHydroUnit(k)->SetStateVarValue(j,0.0);}
+        }
+      }
+      CheckInitialStateVars(pModel,Options);
+      _aMemberStates[ee].clear();
+    }
+    else {
       ParseInitialConditions(pModel,Options);
+    }
 
-      //Update state vector in model
-      UpdateFromStateMatrix(pModel,Options,ee);
+    //Update state vector in model
+    UpdateFromStateMatrix(pModel,Options,ee);
 
-      pModel->WriteMajorOutput(Options,tt,"solution_EnKF",false);
-    }
+    pModel->WriteMajorOutput(Options,tt,"solution_EnKF",false);
   }
 }
@@ -62,22 +62,40 @@ private:
   int           *_aObsIndices;      //< indices of CModel::pObsTS array corresponding to assimilation time series [size:_nObs]
   int            _nObs;             //< number of time series to be assimilated
 
+  double         _loc_radius;       ///< covariance localization radius [km] along river network (or 0.0 if covariances are not localized)
+  int           *_aStateBasin;      ///< subbasin index of each assimilated state variable [size: _nStateVars]
+  int           *_aObsBasin;        ///< subbasin index of each observation datapoint [size: _nObsDatapoints]
+  int            _nSubBasins;       ///< number of subbasins in model
+  int           *_aDownstreamInd;   ///< index of downstream subbasin (or DOESNT_EXIST) [size: _nSubBasins]
+  double        *_aReachLength;     ///< reach length of each subbasin [km] [size: _nSubBasins]
+  int           *_aNetworkOrder;    ///< subbasin indices ordered from outlets to headwaters [size: _nSubBasins]
+
+  bool            _in_memory;       ///< true if member model states are held in memory for assimilation, rather than re-read from solution files (default: false)
+  vector<double> *_aMemberStates;   ///< model state of each member at end of simulation, if _in_memory [size: _nEnKFMembers]
+  unsigned int   *_aMemberSeeds;    ///< random seed of each member, if members are simulated concurrently [size: _nEnKFMembers]
+
   ofstream      _ENKFOUT;           ///< output file stream
 
   void AssimilationCalcs();         //< determines the final state matrix after assimilation
+  void   GetNetworkDistances (const int p,double *dist) const;
+  double GetLocalizationWeight(const double &dist) const;
   void UpdateFromStateMatrix(CModel *pModel,optStruct& Options,const int e);
   void AddToStateMatrix     (CModel* pModel,optStruct& Options,const int e);
+  void FinishAssimilation   (CModel* pModel,optStruct& Options,const time_struct &tt);
 public:
   CEnKFEnsemble(const int num_members,const optStruct &Options);
   ~CEnKFEnsemble();
 
   double GetStartTime(const int e) const;
   EnKF_mode GetEnKFMode() const;
+  bool   SupportsConcurrentMembers() const {return true;}
 
   void SetEnKFMode           (EnKF_mode mode);
   void SetWarmRunname        (string runname);
   void SetWindowSize         (const int nTimesteps);
   void SetExtraRVTFile       (string filename);
+  void SetLocalizationRadius (const double &radius);
+  void SetInMemoryMembers    (const bool in_memory);
   void AddObsPerturbation    (sv_type      type, disttype distrib, double *distpars, adjustment adj);
   void AddAssimilationState  (sv_type sv, int layer, int assim_groupID);
 
@@ -86,5 +104,7 @@ public:
   void StartTimeStepOps      (CModel* pModel,optStruct& Options,const time_struct &tt,const int e);
   void CloseTimeStepOps      (CModel* pModel,optStruct& Options,const time_struct &tt,const int e); //called at end of each timestep
   void FinishEnsembleRun     (CModel *pModel,optStruct &Options,const time_struct &tt,const int e);
+  void GetMemberResult       (CModel *pModel,optStruct &Options,const time_struct &tt,const int e,vector<double> &result);
+  void ReceiveMemberResult   (CModel *pModel,optStruct &Options,const int e,const vector<double> &result);
 };
 #endif
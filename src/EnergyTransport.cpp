@@ -652,6 +652,7 @@ void CEnthalpyModel::Initialize(const optStruct& Options)
       {
         _aMinHist[p][i]=aQin[i]*SEC_PER_DAY*hv;
       }
+      _aMinHist[p].Mirror();
 
       if (pBasin->GetReservoir()!=NULL)
       {
@@ -70,6 +70,9 @@ CForcingGrid::CForcingGrid(string       ForcingType,
 
   //initialized in ReallocateArraysInForcingGrid
   _aVal                = NULL;
+  _pValueSource        = NULL;
+  _constant_vals       = false;
+  _owns_weights        = true;
 
   // initialized in AllocateWeightArray,SetIdxNonZeroGridCells()
   _GridWeight          = NULL;
@@ -94,12 +97,32 @@ CForcingGrid::CForcingGrid(string       ForcingType,
   _AttVarNames[2]      ="NONE";
   _AttVarNames[3]      ="NONE";
 
+#ifdef _RVNETCDF_
+  //initialized in OpenNetCDF() and ReadData()
+  _ncid                = -9;
+  _ncid_e              = DOESNT_EXIST;
+  _varid_f             = -9;
+  _fillval             = NETCDF_BLANK_VALUE;
+  _missval             = NETCDF_BLANK_VALUE;
+  _add_offset          = 0.0;
+  _scale_factor        = 1.0;
+  _aRawBuf             = NULL;
+  _aRawNext            = NULL;
+  _iChunkNext          = -1;
+  _retvalNext          = 0;
+  _nReadRuns           = 0;
+  _aRunRow             = NULL;
+  _aRunCol             = NULL;
+  _aRunLen             = NULL;
+#endif
 }
 ///////////////////////////////////////////////////////////////////
-/// \brief Copy constructor.
+/// \brief copies all scalar attributes (dimensions, time axis, corrections, etc.) of grid
+/// \details arrays (values, weights, cell attributes) are not copied
 ///
-/// \param ForcingType   [in] an existing grid
-CForcingGrid::CForcingGrid( const CForcingGrid &grid )
+/// \param grid [in] an existing grid
+//
+void CForcingGrid::CopyAttributes( const CForcingGrid &grid )
 {
   _ForcingType                 = grid._ForcingType                     ;
   _filename                    = grid._filename                        ;
@@ -123,6 +146,7 @@ CForcingGrid::CForcingGrid( const CForcingGrid &grid )
   _start_year                  = grid._start_year                      ;
   _tag                         = grid._tag                             ;
   _interval                    = grid._interval                        ;
+  _steps_per_day               = grid._steps_per_day                   ;
   _dim_order                   = grid._dim_order                       ;
   _is_derived                  = true                                  ;
   _nPulses                     = grid._nPulses                         ;
@@ -137,6 +161,50 @@ CForcingGrid::CForcingGrid( const CForcingGrid &grid )
   for (int ii=0; ii<12; ii++) {_aMinTemp[ii] = grid._aMinTemp[ii];}
   for (int ii=0; ii<12; ii++) {_aMaxTemp[ii] = grid._aMaxTemp[ii];}
   for (int ii=0; ii<12; ii++) {_aAvePET [ii] = grid._aAvePET [ii];}
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief allocates and copies cell attribute arrays (latitude, longitude, elevation, station IDs) of grid
+/// \remark _nNonZeroWeightedGridCells must already be set
+///
+/// \param grid [in] an existing grid
+//
+void CForcingGrid::CopyCellAttributes( const CForcingGrid &grid )
+{
+  _aLatitude=NULL;_aLongitude=NULL;_aElevation=NULL;_aStationIDs=NULL;
+  if(grid._aLatitude!=NULL) {
+    _aLatitude=new double [_nNonZeroWeightedGridCells];
+    ExitGracefullyIf(_aLatitude==NULL,"CForcingGrid::CopyCellAttributes(1)",OUT_OF_MEMORY);
+    for(int c=0; c<_nNonZeroWeightedGridCells; c++) {_aLatitude[c]=grid._aLatitude[c];}
+  }
+  if(grid._aLongitude!=NULL) {
+    _aLongitude=new double[_nNonZeroWeightedGridCells];
+    ExitGracefullyIf(_aLongitude==NULL,"CForcingGrid::CopyCellAttributes(2)",OUT_OF_MEMORY);
+    for(int c=0; c<_nNonZeroWeightedGridCells; c++) { _aLongitude[c]=grid._aLongitude[c]; }
+  }
+  if(grid._aElevation!=NULL) {
+    _aElevation=new double[_nNonZeroWeightedGridCells];
+    ExitGracefullyIf(_aElevation==NULL,"CForcingGrid::CopyCellAttributes(3)",OUT_OF_MEMORY);
+    for(int c=0; c<_nNonZeroWeightedGridCells; c++) { _aElevation[c]=grid._aElevation[c]; }
+  }
+  if(grid._aStationIDs!=NULL) {
+    _aStationIDs=new string[_nNonZeroWeightedGridCells];
+    ExitGracefullyIf(_aStationIDs==NULL,"CForcingGrid::CopyCellAttributes(4)",OUT_OF_MEMORY);
+    for(int c=0; c<_nNonZeroWeightedGridCells; c++) { _aStationIDs[c]=grid._aStationIDs[c]; }
+  }
+
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Copy constructor.
+///
+/// \param ForcingType   [in] an existing grid
+CForcingGrid::CForcingGrid( const CForcingGrid &grid )
+{
+  CopyAttributes(grid);
+  _owns_weights                = true;
+  _pValueSource                = NULL;
+  _constant_vals               = false;
 
   _aVal=NULL;
   _aVal = new double *[_ChunkSize];
@@ -178,28 +246,75 @@ CForcingGrid::CForcingGrid( const CForcingGrid &grid )
     _IdxNonZeroGridCells[ic]=grid._IdxNonZeroGridCells[ic];              // copy the value
   }
 
-  _aLatitude=NULL;_aLongitude=NULL;_aElevation=NULL;_aStationIDs=NULL;
-  if(grid._aLatitude!=NULL) {
-    _aLatitude=new double [_nNonZeroWeightedGridCells];
-    ExitGracefullyIf(_aLatitude==NULL,"CForcingGrid::Copy Constructor(4)",OUT_OF_MEMORY);
-    for(int c=0; c<_nNonZeroWeightedGridCells; c++) {_aLatitude[c]=grid._aLatitude[c];}
-  }
-  if(grid._aLongitude!=NULL) {
-    _aLongitude=new double[_nNonZeroWeightedGridCells];
-    ExitGracefullyIf(_aLongitude==NULL,"CForcingGrid::Copy Constructor(5)",OUT_OF_MEMORY);
-    for(int c=0; c<_nNonZeroWeightedGridCells; c++) { _aLongitude[c]=grid._aLongitude[c]; }
-  }
-  if(grid._aElevation!=NULL) {
-    _aElevation=new double[_nNonZeroWeightedGridCells];
-    ExitGracefullyIf(_aElevation==NULL,"CForcingGrid::Copy Constructor(6)",OUT_OF_MEMORY);
-    for(int c=0; c<_nNonZeroWeightedGridCells; c++) { _aElevation[c]=grid._aElevation[c]; }
-  }
-  if(grid._aStationIDs!=NULL) {
-    _aStationIDs=new string[_nNonZeroWeightedGridCells];
-    ExitGracefullyIf(_aStationIDs==NULL,"CForcingGrid::Copy Constructor(7)",OUT_OF_MEMORY);
-    for(int c=0; c<_nNonZeroWeightedGridCells; c++) { _aStationIDs[c]=grid._aStationIDs[c]; }
-  }
+  CopyCellAttributes(grid);
 
+#ifdef _RVNETCDF_
+  //derived grids are never read from file
+  _ncid                = -9;
+  _ncid_e              = DOESNT_EXIST;
+  _varid_f             = -9;
+  _fillval             = grid._fillval;
+  _missval             = grid._missval;
+  _add_offset          = grid._add_offset;
+  _scale_factor        = grid._scale_factor;
+  _aRawBuf             = NULL;
+  _aRawNext            = NULL;
+  _iChunkNext          = -1;
+  _retvalNext          = 0;
+  _nReadRuns           = 0;
+  _aRunRow             = NULL;
+  _aRunCol             = NULL;
+  _aRunLen             = NULL;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Derived grid constructor.
+/// \details Weights and cell indices (_GridWeight, _GridWtCellIDs, _nWeights, _CellIDToIdx and
+///          _IdxNonZeroGridCells) are shared with (not copied from) pParent, which must outlive this grid;
+///          these arrays must remain fixed (and are, once the :GridWeights have been read).
+///          Cell attributes (latitude, longitude, elevation, station IDs) are copied, since the parent
+///          re-reads (and reallocates) these whenever its first chunk is re-read.
+///          Values are not allocated - ReallocateArraysInForcingGrid(), ShareValues() or
+///          AllocateConstantArrays() must be called once the time discretization is set
+///
+/// \param pParent [in] an existing grid
+//
+CForcingGrid::CForcingGrid( const CForcingGrid *pParent )
+{
+  CopyAttributes(*pParent);
+  _owns_weights        = false;
+  _pValueSource        = NULL;
+  _constant_vals       = false;
+
+  _aVal                = NULL;
+
+  _GridWeight          = pParent->_GridWeight;
+  _GridWtCellIDs       = pParent->_GridWtCellIDs;
+  _CellIDToIdx         = pParent->_CellIDToIdx;
+  _nWeights            = pParent->_nWeights;
+  _IdxNonZeroGridCells = pParent->_IdxNonZeroGridCells;
+
+  CopyCellAttributes(*pParent);
+
+#ifdef _RVNETCDF_
+  //derived grids are never read from file
+  _ncid                = -9;
+  _ncid_e              = DOESNT_EXIST;
+  _varid_f             = -9;
+  _fillval             = pParent->_fillval;
+  _missval             = pParent->_missval;
+  _add_offset          = pParent->_add_offset;
+  _scale_factor        = pParent->_scale_factor;
+  _aRawBuf             = NULL;
+  _aRawNext            = NULL;
+  _iChunkNext          = -1;
+  _retvalNext          = 0;
+  _nReadRuns           = 0;
+  _aRunRow             = NULL;
+  _aRunCol             = NULL;
+  _aRunLen             = NULL;
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -208,19 +323,39 @@ CForcingGrid::CForcingGrid( const CForcingGrid &grid )
 CForcingGrid::~CForcingGrid()
 {
   if (DESTRUCTOR_DEBUG){cout<<"    DELETING GRIDDED DATA"<<endl;}
-  if(_aVal!=NULL) {
-    for(int it=0; it<_ChunkSize; it++) { delete[] _aVal[it];      _aVal[it]=NULL; }      delete[] _aVal;_aVal= NULL;
+#ifdef _RVNETCDF_
+  WaitForPrefetch();
+  CloseNetCDF();
+  delete [] _aRawBuf;               _aRawBuf             = NULL;
+  delete [] _aRawNext;              _aRawNext            = NULL;
+  delete [] _aRunRow;               _aRunRow             = NULL;
+  delete [] _aRunCol;               _aRunCol             = NULL;
+  delete [] _aRunLen;               _aRunLen             = NULL;
+#endif
+  if((_aVal!=NULL) && (_pValueSource==NULL)) {
+    if(_constant_vals) { delete[] _aVal[0]; }
+    else               { for(int it=0; it<_ChunkSize; it++) { delete[] _aVal[it];      _aVal[it]=NULL; } }
+    delete[] _aVal;
   }
+  _aVal=NULL;
+  _pValueSource=NULL;
 
-  for(int k=0; k<_nHydroUnits; k++) {
-    delete[] _GridWeight[k];    _GridWeight   [k]=NULL;
-    delete[] _GridWtCellIDs[k]; _GridWtCellIDs[k]=NULL;
+  if(_owns_weights) { //otherwise, weights and cell indices belong to parent grid
+    for(int k=0; k<_nHydroUnits; k++) {
+      delete[] _GridWeight[k];    _GridWeight   [k]=NULL;
+      delete[] _GridWtCellIDs[k]; _GridWtCellIDs[k]=NULL;
+    }
+    delete [] _GridWeight;
+    delete [] _GridWtCellIDs;
+    delete [] _CellIDToIdx;
+    delete [] _nWeights;
+    delete [] _IdxNonZeroGridCells;
   }
-  delete [] _GridWeight;            _GridWeight          = NULL;
-  delete [] _GridWtCellIDs;         _GridWtCellIDs       = NULL;
-  delete [] _CellIDToIdx;           _CellIDToIdx         = NULL;
-  delete [] _nWeights;              _nWeights            = NULL;
-  delete [] _IdxNonZeroGridCells;   _IdxNonZeroGridCells = NULL;
+  _GridWeight          = NULL;
+  _GridWtCellIDs       = NULL;
+  _CellIDToIdx         = NULL;
+  _nWeights            = NULL;
+  _IdxNonZeroGridCells = NULL;
   delete [] _aLatitude;             _aLatitude           = NULL;
   delete [] _aLongitude;            _aLongitude          = NULL;
   delete [] _aElevation;            _aElevation          = NULL;
@@ -577,6 +712,43 @@ void CForcingGrid::ReallocateArraysInForcingGrid( )
   }
 }
 
+///////////////////////////////////////////////////////////////////
+/// \brief makes this grid a view of the values of pSource, e.g., rainfall derived from precipitation
+/// \details no values are stored or copied; this grid always holds the chunk most recently read (or
+///          generated) by pSource, which must outlive this grid and must not reallocate its values
+/// \note   pSource must have same interval, chunk size and non-zero weighted cells as this grid
+///
+/// \param pSource [in] grid whose values are viewed
+//
+void CForcingGrid::ShareValues(const CForcingGrid *pSource)
+{
+  ExitGracefullyIf(_aVal!=NULL,"CForcingGrid::ShareValues: values already allocated",RUNTIME_ERR);
+  ExitGracefullyIf((pSource->_ChunkSize!=_ChunkSize) || (pSource->_nNonZeroWeightedGridCells!=_nNonZeroWeightedGridCells) || (pSource->_interval!=_interval),
+                   "CForcingGrid::ShareValues: grids must have same time discretization and grid cells",RUNTIME_ERR);
+  ExitGracefullyIf(pSource->_aVal==NULL,"CForcingGrid::ShareValues: source grid values not yet allocated",RUNTIME_ERR);
+  while(pSource->_pValueSource!=NULL) { pSource=pSource->_pValueSource; } //view grid which actually stores values
+  _pValueSource=pSource;
+  _aVal        =pSource->_aVal;
+  _iChunk      =pSource->_iChunk;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief allocates a single row of values (one per non-zero weighted cell) shared by all time points
+///          of the chunk, e.g., for a snowfall grid which is zero throughout
+///
+/// \param val [in] constant value
+//
+void CForcingGrid::AllocateConstantArrays(const double &val)
+{
+  ExitGracefullyIf(_aVal!=NULL,"CForcingGrid::AllocateConstantArrays: values already allocated",RUNTIME_ERR);
+  double *aRow=new double [_nNonZeroWeightedGridCells];
+  _aVal       =new double*[_ChunkSize];
+  ExitGracefullyIf(_aVal==NULL,"CForcingGrid::AllocateConstantArrays",OUT_OF_MEMORY);
+  for (int ic=0; ic<_nNonZeroWeightedGridCells;ic++){aRow[ic]=val;}
+  for (int it=0; it<_ChunkSize; it++)               {_aVal[it]=aRow;}
+  _constant_vals=true;
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief  Updates class variable _aVal containing current chunk of data \\
 ///         chunk = 0         --> data[          0*_chunksize : 1*_chunksize-1][:][:] \\
@@ -595,6 +767,14 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
 {
   bool new_chunk_read=false;  // true if new chunk was read, otherwise false
 
+  // values viewed from another grid - nothing to read; chunk is new if source read a new chunk
+  // -------------------------------
+  if (_pValueSource!=NULL){
+    new_chunk_read=(_iChunk!=_pValueSource->_iChunk);
+    _iChunk=_pValueSource->_iChunk;
+    return new_chunk_read;
+  }
+
 #ifdef _RVNETCDF_
 
   int     ir,ic,it;
@@ -624,6 +804,18 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       }
     }
 
+    // allocate raw chunk buffers (current + prefetched) using maximum chunk size
+    // -------------------------------
+    int dim1,dim2,dim3;
+    GetChunkDims(_ChunkSize,dim1,dim2,dim3);
+    _aRawBuf =new double [dim1*dim2*dim3];
+    _aRawNext=new double [dim1*dim2*dim3];
+    ExitGracefullyIf(_aRawNext==NULL,"CForcingGrid::ReadData : raw buffers",OUT_OF_MEMORY);
+
+    // choose between reading whole window or only row-runs of non-zero weighted cells
+    // -------------------------------
+    BuildReadPlan(Options);
+
     // set _is_derived_data to False because data are truely read from a file
     // -------------------------------
     _is_derived = false;
@@ -640,23 +832,12 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
   if(_iChunk != iChunk_new)
   {
     // local variables
-
-    int     ncid;          // file unit
     int     dim1;          // length of 1st dimension in NetCDF data
     int     dim2;          // length of 2nd dimension in NetCDF data
     int     dim3;          // length of 3rd dimension in NetCDF data
-
-    int     varid_f;       // id of forcing variable read
-    double  missval;       // value of "missing_value" attribute of forcing variable
-    double  fillval;       // value of "_FillValue"    attribute of forcing variable
-    double  add_offset;    // value of "add_offset"    attribute of forcing variable
-    double  scale_factor;  // value of "scale_factor"  attribute of forcing variable
-    size_t  att_len;       // length of the attribute's text
-    nc_type att_type;      // type of attribute
     int     retval;        // error value for NetCDF routines
     int     iChunkSize;    // size of current chunk; always equal _ChunkSize except for last chunk in file (might be shorter)
 
-
     if(Options.noisy){
       cout<<endl<<" Start reading new chunk... iChunk = "<<iChunk_new<<" (var = "<<_varname.c_str()<<", forcing: "<<ForcingToString(_ForcingType) << ")"<<endl;
       time_struct tt_tmp;
@@ -673,101 +854,60 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
 
     // determine chunk size
     // -------------------------------
-    iChunkSize = min(_ChunkSize,int((Options.duration - global_model_time) / _interval));
+    iChunkSize = GetChunkLength(Options,_iChunk);
 
-    // Open NetCDF file, Get the id of the forcing data, varid_f
+    // Open NetCDF file (only once per run) - reads forcing variable id and attributes
     // -------------------------------
-    string filename_e=_filename;
-    SubstringReplace(filename_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
-
-    retval = nc_open(filename_e.c_str(),NC_NOWRITE,&ncid);      HandleNetCDFErrors(retval);
+    OpenNetCDF(Options);
 
-    string varname_e=_varname;
-    SubstringReplace(varname_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
-
-    retval = nc_inq_varid(ncid,varname_e.c_str(),&varid_f);     HandleNetCDFErrors(retval);
-
-    // find "_FillValue" of forcing data
-    // -------------------------------
-    fillval = NETCDF_BLANK_VALUE; //Default
-    retval = nc_inq_att(ncid, varid_f, "_FillValue", &att_type, &att_len);
-    if (retval != NC_ENOTATT) {
-      HandleNetCDFErrors(retval);
-      retval = nc_get_att_double(ncid, varid_f, "_FillValue", &fillval);       HandleNetCDFErrors(retval);// read attribute value
-    }
-
-    // find "missing_value" of forcing data
-    // -------------------------------
-    missval = NETCDF_BLANK_VALUE; //Default
-    retval = nc_inq_att(ncid, varid_f, "missing_value", &att_type, &att_len);
-    if (retval != NC_ENOTATT) {
-      HandleNetCDFErrors(retval);
-      retval = nc_get_att_double(ncid, varid_f, "missing_value", &missval);     HandleNetCDFErrors(retval);// read attribute value
-    }
-
-    // check for attributes "add_offset" of forcing data
-    // -------------------------------
-    add_offset = 0.0;
-    retval = nc_inq_att(ncid, varid_f, "add_offset", &att_type, &att_len);
-    if (retval != NC_ENOTATT) {
-      HandleNetCDFErrors(retval);
-      retval = nc_get_att_double(ncid, varid_f, "add_offset", &add_offset);       HandleNetCDFErrors(retval);// read attribute value
-    }
-
-    // check for attributes "scale_factor" of forcing data
-    // -------------------------------
-    scale_factor = 1.0;
-    retval = nc_inq_att(ncid, varid_f, "scale_factor", &att_type, &att_len);
-    if (retval != NC_ENOTATT) {
-      HandleNetCDFErrors(retval);
-      retval = nc_get_att_double(ncid, varid_f, "scale_factor", &scale_factor);       HandleNetCDFErrors(retval);// read attribute value
-    }
+    double missval      = _missval;
+    double fillval      = _fillval;
+    double add_offset   = _add_offset;
+    double scale_factor = _scale_factor;
     if (Options.noisy){
       cout << "iChunksize:  = " << iChunkSize   << endl;
       cout << "add_offset   = " << add_offset   << endl;
       cout << "scale_factor = " << scale_factor << endl;
     }
 
-    // allocate aTmp matrix
+    // Read chunk of data - use chunk prefetched in background, if available
     // -------------------------------
-    dim1 = 1; dim2 = 1; dim3 = 1;
-
-    if ( _is_3D ) {
-      switch(_dim_order)
-      {
-      case(1):
-        dim1 = _WinLength[0]; dim2 = _WinLength[1]; dim3 = iChunkSize;    break; // dimensions are (x,y,t)
-      case(2):
-        dim1 = _WinLength[1]; dim2 = _WinLength[0]; dim3 = iChunkSize;    break; // dimensions are (y,x,t)
-      case(3):
-        dim1 = _WinLength[0]; dim2 = iChunkSize;    dim3 = _WinLength[1]; break; // dimensions are (x,t,y)
-      case(4):
-        dim1 = iChunkSize;    dim2 = _WinLength[0]; dim3 = _WinLength[1]; break; // dimensions are (t,x,y)
-      case(5):
-        dim1 = _WinLength[1]; dim2 = iChunkSize;    dim3 = _WinLength[0]; break; // dimensions are (y,t,x)
-      case(6):
-        dim1 = iChunkSize;    dim2 = _WinLength[1]; dim3 = _WinLength[0]; break; // dimensions are (t,y,x)
-      }
+    if (_iChunkNext==_iChunk){
+      WaitForPrefetch();
+      double *tmp=_aRawBuf; _aRawBuf=_aRawNext; _aRawNext=tmp; //pointer swap - no copy
+      retval=_retvalNext;
     }
     else {
-      switch(_dim_order)
-      {
-      case(1):
-        dim1 = _GridDims[0]; dim2 = iChunkSize;   dim3 = 1; break; // dimensions are (station,t)
-      case(2):
-        dim1 = iChunkSize;   dim2 = _GridDims[0]; dim3 = 1; break; // dimensions are (t, station)
+      WaitForPrefetch(); //discard stale prefetch (e.g., model time jumped over a chunk)
+      retval=ReadChunkRaw(_iChunk,iChunkSize,_aRawBuf); //(this is the bottleneck of this code)
+    }
+    _iChunkNext=-1;
+    HandleNetCDFErrors(retval);
+    new_chunk_read = true;
+
+    GetChunkDims(iChunkSize,dim1,dim2,dim3);
+    if (Options.noisy) {
+      cout<<"  bytes read:  "<<GetBytesPerChunk(iChunkSize)<<" ("<<((_nReadRuns==0) ? "dense window" : to_string(_nReadRuns)+" row-runs")<<")"<<endl;
+      size_t nc_start[3];
+      GetChunkStart(_iChunk,nc_start);
+      if (_is_3D){
+        cout<<" CForcingGrid::ReadData - is3D"<<endl;
+        cout<<"  Dim of chunk read: dim3 = "<<dim3<<"   dim2 = "<<dim2<<"   dim1 = "<<dim1<<endl;
+        cout<<"  start  chunk: ("<<nc_start[0]<<","<<nc_start[1]<<","<<nc_start[2]<<")"<<endl;
+        cout<<"  length  chunk: ("<<dim1<<","<<dim2<<","<<dim3<<")"<<endl;
+      }
+      else{
+        cout<<" CForcingGrid::ReadData - !is3D"<<endl;
+        cout<<"  Dim of chunk read: dim2 = "<<dim2<<"   dim1 = "<<dim1<<endl;
+        cout<<"  start  chunk: (" <<nc_start [0]<<","<<nc_start [1]<<")"<<endl;
+        cout<<"  length  chunk: ("<<dim1<<","<<dim2<<")"<<endl;
       }
     }
 
     // -------------------------------
-    // emulate VLA 3D array storage - store 3D array as vector using Row Major Order
+    // emulate VLA 3D array storage - 3D array is stored in _aRawBuf as vector using Row Major Order
     // -------------------------------
-    double *aVec=NULL;
-    aVec=new double[dim1*dim2*dim3];//stores actual data
-    ExitGracefullyIf(aVec==NULL,"CForcingGrid::ReadData : aVec",OUT_OF_MEMORY);
-    for(int i=0; i<dim1*dim2*dim3; i++) {
-      aVec[i]=NETCDF_BLANK_VALUE;
-    }
+    double *aVec=_aRawBuf;
 
     double ***aTmp3D=NULL; //stores pointers to rows/columns of 3D data
     double  **aTmp2D=NULL; //stores pointers to rows/columns of 2D data
@@ -791,112 +931,9 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       }
     }
 
-    // Read chunk of data.
-    // -------------------------------
-    if ( _is_3D )
-    {
-      int       start_point = _ChunkSize * _iChunk+(int)(_t_corr/_interval);;//JRC_TIME_FIX:
-      size_t    nc_start [3];
-      size_t    nc_length[3];
-      ptrdiff_t nc_stride[3];
-
-      nc_length[0] = (size_t)(dim1); nc_stride[0] = 1;
-      nc_length[1] = (size_t)(dim2); nc_stride[1] = 1;
-      nc_length[2] = (size_t)(dim3); nc_stride[2] = 1;
-
-      switch(_dim_order) {
-      case(1): // dimensions are (x,y,t)
-        nc_start[0]  = (size_t)(_WinStart[0]);  nc_start[1]  = (size_t)(_WinStart[1]);  nc_start[2]  = (size_t)(start_point);
-        break;
-      case(2): // dimensions are (y,x,t)
-        nc_start[0]  = (size_t)(_WinStart[1]);  nc_start[1]  = (size_t)(_WinStart[0]);  nc_start[2]  = (size_t)(start_point);
-        break;
-      case(3): // dimensions are (x,t,y)
-        nc_start[0]  = (size_t)(_WinStart[0]);  nc_start[1]  = (size_t)(start_point);   nc_start[2]  = (size_t)(_WinStart[1]);
-        break;
-      case(4): // dimensions are (t,x,y)
-        nc_start[0]  = (size_t)(start_point);   nc_start[1]  = (size_t)(_WinStart[0]);  nc_start[2]  = (size_t)(_WinStart[1]);
-        break;
-      case(5): // dimensions are (y,t,x)
-        nc_start[0]  = (size_t)(_WinStart[1]);  nc_start[1]  = (size_t)(start_point);   nc_start[2]  = (size_t)(_WinStart[0]);
-        break;
-      case(6): // dimensions are (t,y,x)
-        nc_start[0]  = (size_t)(start_point);   nc_start[1]  = (size_t)(_WinStart[1]);  nc_start[2]  = (size_t)(_WinStart[0]);
-        break;
-      }
-
-      //Read giant chunk of data from NetCDF (this is the bottleneck of this code)
-      retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp3D[0][0][0]);   HandleNetCDFErrors(retval);
-      new_chunk_read = true;
-
-      if (Options.noisy) {
-        cout<<" CForcingGrid::ReadData - is3D"<<endl;
-        cout<<"  Dim of chunk read: dim3 = "<<dim3<<"   dim2 = "<<dim2<<"   dim1 = "<<dim1<<endl;
-        cout<<"  start  chunk: ("<<nc_start[0]<<","<<nc_start[1]<<","<<nc_start[2]<<")"<<endl;
-        cout<<"  length  chunk: ("<<nc_length[0]<<","<<nc_length[1]<<","<<nc_length[2]<<")"<<endl;
-        cout<<"  stride  chunk: ("<<nc_stride[0]<<","<<nc_stride[1]<<","<<nc_stride[2]<<")"<<endl;
-      }
-    }
-    else //2D
-    {
-      int       start_point = _ChunkSize * _iChunk+(int)(_t_corr/_interval);//JRC_TIME_FIX:
-      size_t    nc_start[2];
-      size_t    nc_length[2];
-      ptrdiff_t nc_stride[2];
-
-      nc_length[0] = (size_t)(dim1); nc_stride[0] = 1;
-      nc_length[1] = (size_t)(dim2); nc_stride[1] = 1;
-
-      switch(_dim_order) {
-        case(1): // dimensions are (station,t)
-          nc_start[0]  = 0;
-          nc_start[1]  = (size_t)(start_point);
-          break;
-        case(2): // dimensions are (t,station)
-          nc_start[0]  = (size_t)(start_point);
-          nc_start[1]  = 0;
-          break;
-      }
-
-      //Read from NetCDF (this is the bottleneck of this code)
-      retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp2D[0][0]);
-      HandleNetCDFErrors(retval);
-      new_chunk_read = true;
-
-      if (Options.noisy) {
-        cout<<" CForcingGrid::ReadData - !is3D"<<endl;
-        cout<<"  Dim of chunk read: dim2 = "<<dim2<<"   dim1 = "<<dim1<<endl;
-        cout<<"  start  chunk: (" <<nc_start [0]<<","<<nc_start [1]<<")"<<endl;
-        cout<<"  length  chunk: ("<<nc_length[0]<<","<<nc_length[1]<<")"<<endl;
-        cout<<"  stride  chunk: ("<<nc_stride[0]<<","<<nc_stride[1]<<")"<<endl;
-      }
-    }
-
-    // Re-scale NetCDF variables based on their internal add-offset and scale_factor
-    // MANDATORY to do before any value of these data are used
-    // -------------------------------
-    if ( _is_3D ) {
-      for (it=0;it<dim1;it++){
-        for (ir=0;ir<dim2;ir++){
-	        for (ic=0;ic<dim3;ic++){
-	          aTmp3D[it][ir][ic] = aTmp3D[it][ir][ic] * scale_factor + add_offset;
-            //if  ((it==0) || (it==dim1-1)) {cout<<setprecision(4)<<setw(9)<<aTmp3D[it][ir][ic]<<" ";}
-	        }
-        //if ((it==0) || (it==dim1-1)) { cout << endl; }
-        }
-       //if  ((it==0) || (it==dim1-1)) {cout<<endl<<endl;}
-      }
-    }
-    else {
-      for (it=0;it<dim1;it++){
-	      for (ir=0;ir<dim2;ir++){
-	        aTmp2D[it][ir] = aTmp2D[it][ir] * scale_factor + add_offset;
-	      }
-      }
-    }
-
-
     // Copy all data from aTmp array to member array _aVal.
+    // NetCDF variables are re-scaled based on their internal add-offset and scale_factor
+    // (MANDATORY to do before any value of these data are used); only cells with non-zero weight are touched
     // -------------------------------
     double val;
     if ( _is_3D )
@@ -906,7 +943,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
             CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[icol-_WinStart[0]][irow-_WinStart[1]][it];
+            val=aTmp3D[icol-_WinStart[0]][irow-_WinStart[1]][it]*scale_factor+add_offset;
             if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
             if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
             _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
@@ -918,7 +955,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
 		        CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-		        val=aTmp3D[irow-_WinStart[1]][icol-_WinStart[0]][it];
+		        val=aTmp3D[irow-_WinStart[1]][icol-_WinStart[0]][it]*scale_factor+add_offset;
             if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
             if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
             _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
@@ -929,7 +966,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
             CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[icol-_WinStart[0]][it][irow-_WinStart[1]];
+            val=aTmp3D[icol-_WinStart[0]][it][irow-_WinStart[1]]*scale_factor+add_offset;
             if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
             if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
             _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
@@ -940,7 +977,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
             CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[it][icol-_WinStart[0]][irow-_WinStart[1]];
+            val=aTmp3D[it][icol-_WinStart[0]][irow-_WinStart[1]]*scale_factor+add_offset;
             if(!((Options.deltaresFEWS) && (it==0))) {
               if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
               if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
@@ -953,7 +990,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
             CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[irow-_WinStart[1]][it][icol-_WinStart[0]];
+            val=aTmp3D[irow-_WinStart[1]][it][icol-_WinStart[0]]*scale_factor+add_offset;
             if(val==missval) { CheckValue3D(val,missval,it,irow,icol); }
             if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
             _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
@@ -964,7 +1001,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         for (it=0; it<iChunkSize; it++){                      // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){    // loop over non-zero weighted grid cells
             CellIdxToRowCol(_IdxNonZeroGridCells[ic],irow,icol);
-            val=aTmp3D[it][irow-_WinStart[1]][icol-_WinStart[0]];
+            val=aTmp3D[it][irow-_WinStart[1]][icol-_WinStart[0]]*scale_factor+add_offset;
             if(val==missval) { CheckValue3D(val,missval,it,irow,icol);}
             if(val==fillval) { CheckValue3D(val,fillval,it,irow,icol); }
             _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
@@ -977,7 +1014,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       if (_dim_order == 1) {
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            val=aTmp2D[_IdxNonZeroGridCells[ic]][it];
+            val=aTmp2D[_IdxNonZeroGridCells[ic]][it]*scale_factor+add_offset;
             if(val==missval) { CheckValue2D(val,missval,_IdxNonZeroGridCells[ic],it); }   // throw error  if value to read in equals "missing_value"
             if(val==fillval) { CheckValue2D(val,fillval,_IdxNonZeroGridCells[ic],it); }   // throw error  if value to read in equals "_FillValue"
             _aVal[it][ic]=_LinTrans_a*val+_LinTrans_b;
@@ -987,7 +1024,7 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       else if (_dim_order == 2) {
         for (it=0; it<iChunkSize; it++){                     // loop over time points in buffer
           for (ic=0; ic<_nNonZeroWeightedGridCells; ic++){   // loop over non-zero weighted grid cells
-            val=aTmp2D[it][_IdxNonZeroGridCells[ic]];
+            val=aTmp2D[it][_IdxNonZeroGridCells[ic]]*scale_factor+add_offset;
             if(val==missval)  { CheckValue2D(val,missval,it,_IdxNonZeroGridCells[ic]); }  // throw error if value to read in equals "missing_value"
             if(val==fillval)  { CheckValue2D(val,fillval,it,_IdxNonZeroGridCells[ic]); }  // throw error if value to read in equals "_FillValue"
             if(rvn_isnan(val)){ CheckValue2D(val,NAN,    it,_IdxNonZeroGridCells[ic]); }
@@ -1001,7 +1038,6 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
     // -------------------------------
     if ( _is_3D ) {for (it=0;it<dim1;it++){delete [] aTmp3D[it];} delete [] aTmp3D;}
     else          {delete [] aTmp2D;}
-    delete [] aVec;
 
     // read attribute grids - lat, long, elevation of grid cells
     // -------------------------------
@@ -1021,10 +1057,13 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
         dim1 = _GridDims[0]; dim2 = 1;
       }
 
-      ReadAttGridFromNetCDF(ncid,_AttVarNames[0],dim1,dim2,_aLatitude);
-      ReadAttGridFromNetCDF(ncid,_AttVarNames[1],dim1,dim2,_aLongitude);
-      ReadAttGridFromNetCDF(ncid,_AttVarNames[2],dim1,dim2,_aElevation);
-      //ReadAttGridFromNetCDF2(ncid,_AttVarNames[3],dim1,dim2,_aStationIDs);
+      {
+        lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex()); //prefetch of next chunk may be using _ncid
+        ReadAttGridFromNetCDF(_ncid,_AttVarNames[0],dim1,dim2,_aLatitude);
+        ReadAttGridFromNetCDF(_ncid,_AttVarNames[1],dim1,dim2,_aLongitude);
+        ReadAttGridFromNetCDF(_ncid,_AttVarNames[2],dim1,dim2,_aElevation);
+        //ReadAttGridFromNetCDF2(_ncid,_AttVarNames[3],dim1,dim2,_aStationIDs);
+      }
 
       if (_aElevation!=NULL){
         /*int irow,icol;
@@ -1038,10 +1077,12 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
       }
     }
 
+    // start reading following chunk in background while model runs through this one
+    // NetCDF file is kept open until grid is destroyed (see CloseNetCDF())
     // -------------------------------
-    // Close NetCDF file
-    // -------------------------------
-    retval = nc_close(ncid);       HandleNetCDFErrors(retval);
+    if ((_iChunk+1<_nChunk) && (GetChunkLength(Options,_iChunk+1)>0)) {
+      StartPrefetch(Options,_iChunk+1);
+    }
 
   }// end if(_iChunk != iChunk_new)
 
@@ -1051,6 +1092,383 @@ bool CForcingGrid::ReadData(const optStruct   &Options,
 
 }
 
+#ifdef _RVNETCDF_
+///////////////////////////////////////////////////////////////////
+/// \brief Opens NetCDF file and reads id and attributes of forcing variable
+/// \details File is opened only once and kept open for the whole run; it is only reopened
+///          if the ensemble member (which may appear as wildcard in the file name) changes
+/// \param &Options [in] Global model options information
+//
+void CForcingGrid::OpenNetCDF(const optStruct &Options)
+{
+  if ((_ncid!=-9) && (_ncid_e==g_current_e)){return;}
+
+  WaitForPrefetch();
+  _iChunkNext=-1;
+  CloseNetCDF();
+
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex());
+
+  int     retval;        // error value for NetCDF routines
+  size_t  att_len;       // length of the attribute's text
+  nc_type att_type;      // type of attribute
+
+  // Open NetCDF file, Get the id of the forcing data, varid_f
+  // -------------------------------
+  string filename_e=_filename;
+  SubstringReplace(filename_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
+
+  retval = nc_open(filename_e.c_str(),NC_NOWRITE,&_ncid);      HandleNetCDFErrors(retval);
+  _ncid_e=g_current_e;
+
+  string varname_e=_varname;
+  SubstringReplace(varname_e,"*",to_string(g_current_e+1)); //replaces wildcard for ensemble runs
+
+  retval = nc_inq_varid(_ncid,varname_e.c_str(),&_varid_f);     HandleNetCDFErrors(retval);
+
+  // find "_FillValue" of forcing data
+  // -------------------------------
+  _fillval = NETCDF_BLANK_VALUE; //Default
+  retval = nc_inq_att(_ncid, _varid_f, "_FillValue", &att_type, &att_len);
+  if (retval != NC_ENOTATT) {
+    HandleNetCDFErrors(retval);
+    retval = nc_get_att_double(_ncid, _varid_f, "_FillValue", &_fillval);       HandleNetCDFErrors(retval);// read attribute value
+  }
+
+  // find "missing_value" of forcing data
+  // -------------------------------
+  _missval = NETCDF_BLANK_VALUE; //Default
+  retval = nc_inq_att(_ncid, _varid_f, "missing_value", &att_type, &att_len);
+  if (retval != NC_ENOTATT) {
+    HandleNetCDFErrors(retval);
+    retval = nc_get_att_double(_ncid, _varid_f, "missing_value", &_missval);     HandleNetCDFErrors(retval);// read attribute value
+  }
+
+  // check for attributes "add_offset" of forcing data
+  // -------------------------------
+  _add_offset = 0.0;
+  retval = nc_inq_att(_ncid, _varid_f, "add_offset", &att_type, &att_len);
+  if (retval != NC_ENOTATT) {
+    HandleNetCDFErrors(retval);
+    retval = nc_get_att_double(_ncid, _varid_f, "add_offset", &_add_offset);       HandleNetCDFErrors(retval);// read attribute value
+  }
+
+  // check for attributes "scale_factor" of forcing data
+  // -------------------------------
+  _scale_factor = 1.0;
+  retval = nc_inq_att(_ncid, _varid_f, "scale_factor", &att_type, &att_len);
+  if (retval != NC_ENOTATT) {
+    HandleNetCDFErrors(retval);
+    retval = nc_get_att_double(_ncid, _varid_f, "scale_factor", &_scale_factor);       HandleNetCDFErrors(retval);// read attribute value
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Closes NetCDF file, if open
+/// \remark any background read must be finished (see WaitForPrefetch())
+//
+void CForcingGrid::CloseNetCDF()
+{
+  if (_ncid==-9){return;}
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex());
+  int retval = nc_close(_ncid);   HandleNetCDFErrors(retval);
+  _ncid  =-9;
+  _ncid_e=DOESNT_EXIST;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Returns number of time points read in chunk iChunk (equal to _ChunkSize except for last chunk of simulation)
+/// \details The length is computed from the model time at the start of the chunk, i.e., the time of the first
+///          point of the hyperslab read (see GetChunkStart()), rather than from the model time at which the
+///          chunk is first needed, which is unknown when the chunk is prefetched. The two differ only when a
+///          chunk is entered after its start time (e.g., model time step longer than data interval); in this
+///          case the last chunk now extends to the end of the simulation, rather than being cut short by the
+///          difference, which left the final data points of the simulation blank
+/// \param &Options [in] Global model options information
+/// \param iChunk   [in] chunk index
+//
+int CForcingGrid::GetChunkLength(const optStruct &Options,const int iChunk) const
+{
+  double t_start=(double)(iChunk)*_ChunkSize*_interval; //model time at start of chunk
+  return min(_ChunkSize,int((Options.duration - t_start) / _interval));
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Returns dimensions of NetCDF hyperslab of chunk with iChunkSize time points, in NetCDF dimension order
+//
+void CForcingGrid::GetChunkDims(const int iChunkSize,int &dim1,int &dim2,int &dim3) const
+{
+  dim1 = 1; dim2 = 1; dim3 = 1;
+
+  if ( _is_3D ) {
+    switch(_dim_order)
+    {
+    case(1):
+      dim1 = _WinLength[0]; dim2 = _WinLength[1]; dim3 = iChunkSize;    break; // dimensions are (x,y,t)
+    case(2):
+      dim1 = _WinLength[1]; dim2 = _WinLength[0]; dim3 = iChunkSize;    break; // dimensions are (y,x,t)
+    case(3):
+      dim1 = _WinLength[0]; dim2 = iChunkSize;    dim3 = _WinLength[1]; break; // dimensions are (x,t,y)
+    case(4):
+      dim1 = iChunkSize;    dim2 = _WinLength[0]; dim3 = _WinLength[1]; break; // dimensions are (t,x,y)
+    case(5):
+      dim1 = _WinLength[1]; dim2 = iChunkSize;    dim3 = _WinLength[0]; break; // dimensions are (y,t,x)
+    case(6):
+      dim1 = iChunkSize;    dim2 = _WinLength[1]; dim3 = _WinLength[0]; break; // dimensions are (t,y,x)
+    }
+  }
+  else {
+    switch(_dim_order)
+    {
+    case(1):
+      dim1 = _GridDims[0]; dim2 = iChunkSize;   dim3 = 1; break; // dimensions are (station,t)
+    case(2):
+      dim1 = iChunkSize;   dim2 = _GridDims[0]; dim3 = 1; break; // dimensions are (t, station)
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Returns start indices of NetCDF hyperslab of chunk iChunk, in NetCDF dimension order
+//
+void CForcingGrid::GetChunkStart(const int iChunk,size_t *nc_start) const
+{
+  int start_point = _ChunkSize * iChunk+(int)(_t_corr/_interval);//JRC_TIME_FIX:
+
+  nc_start[0]=nc_start[1]=nc_start[2]=0;
+  if ( _is_3D )
+  {
+    switch(_dim_order) {
+    case(1): // dimensions are (x,y,t)
+      nc_start[0]  = (size_t)(_WinStart[0]);  nc_start[1]  = (size_t)(_WinStart[1]);  nc_start[2]  = (size_t)(start_point);
+      break;
+    case(2): // dimensions are (y,x,t)
+      nc_start[0]  = (size_t)(_WinStart[1]);  nc_start[1]  = (size_t)(_WinStart[0]);  nc_start[2]  = (size_t)(start_point);
+      break;
+    case(3): // dimensions are (x,t,y)
+      nc_start[0]  = (size_t)(_WinStart[0]);  nc_start[1]  = (size_t)(start_point);   nc_start[2]  = (size_t)(_WinStart[1]);
+      break;
+    case(4): // dimensions are (t,x,y)
+      nc_start[0]  = (size_t)(start_point);   nc_start[1]  = (size_t)(_WinStart[0]);  nc_start[2]  = (size_t)(_WinStart[1]);
+      break;
+    case(5): // dimensions are (y,t,x)
+      nc_start[0]  = (size_t)(_WinStart[1]);  nc_start[1]  = (size_t)(start_point);   nc_start[2]  = (size_t)(_WinStart[0]);
+      break;
+    case(6): // dimensions are (t,y,x)
+      nc_start[0]  = (size_t)(start_point);   nc_start[1]  = (size_t)(_WinStart[1]);  nc_start[2]  = (size_t)(_WinStart[0]);
+      break;
+    }
+  }
+  else //2D
+  {
+    switch(_dim_order) {
+      case(1): // dimensions are (station,t)
+        nc_start[0]  = 0;
+        nc_start[1]  = (size_t)(start_point);
+        break;
+      case(2): // dimensions are (t,station)
+        nc_start[0]  = (size_t)(start_point);
+        nc_start[1]  = 0;
+        break;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Returns positions of column (x or station), row (y) and time dimension in NetCDF dimension order
+/// \param ix [out] position of column/station dimension
+/// \param iy [out] position of row dimension (DOESNT_EXIST for 2D station data)
+/// \param it [out] position of time dimension
+//
+void CForcingGrid::GetDimPositions(int &ix,int &iy,int &it) const
+{
+  ix=0; iy=1; it=2;
+  if (_is_3D) {
+    switch(_dim_order)
+    {
+    case(1): ix=0; iy=1; it=2; break; // dimensions are (x,y,t)
+    case(2): iy=0; ix=1; it=2; break; // dimensions are (y,x,t)
+    case(3): ix=0; it=1; iy=2; break; // dimensions are (x,t,y)
+    case(4): it=0; ix=1; iy=2; break; // dimensions are (t,x,y)
+    case(5): iy=0; it=1; ix=2; break; // dimensions are (y,t,x)
+    case(6): it=0; iy=1; ix=2; break; // dimensions are (t,y,x)
+    }
+  }
+  else {
+    iy=DOESNT_EXIST;
+    if (_dim_order==1){ix=0; it=1;} // dimensions are (station,t)
+    else              {it=0; ix=1;} // dimensions are (t,station)
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Returns number of bytes read from NetCDF for a chunk of iChunkSize time points using current read plan
+//
+double CForcingGrid::GetBytesPerChunk(const int iChunkSize) const
+{
+  double ncells=0;
+  if (_nReadRuns==0) {
+    int dim1,dim2,dim3;
+    GetChunkDims(iChunkSize,dim1,dim2,dim3);
+    ncells=(double)(dim1)*dim2*dim3/iChunkSize;
+  }
+  else {
+    for (int r=0;r<_nReadRuns;r++){ncells+=_aRunLen[r];}
+  }
+  return ncells*iChunkSize*sizeof(double);
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Decides whether chunks are read as whole grid window (dense) or as row-runs of non-zero weighted cells (sparse)
+/// \details Non-zero weighted cells are grouped into runs along each row; gaps between cells are read
+///          rather than skipped if reading them is cheaper than issuing another request. The sparse plan is
+///          used only if its estimated cost (bytes read + NETCDF_REQUEST_COST per request) is less than
+///          that of reading the whole window in one request.
+/// \param &Options [in] Global model options information
+//
+void CForcingGrid::BuildReadPlan(const optStruct &Options)
+{
+  int    row,col,r;
+  int    colstart       = (_is_3D) ? _WinStart[0]  : 0;
+  int    rowstart       = (_is_3D) ? _WinStart[1]  : 0;
+  double bytes_per_cell = sizeof(double)*_ChunkSize;                      // one cell, whole chunk
+  int    max_gap        = (int)(NETCDF_REQUEST_COST/bytes_per_cell);      // skipping smaller gaps costs more than reading them
+
+  delete [] _aRunRow; delete [] _aRunCol; delete [] _aRunLen;
+  _aRunRow=NULL; _aRunCol=NULL; _aRunLen=NULL;
+  _nReadRuns=0;
+  if (_nNonZeroWeightedGridCells==0){return;}
+
+  _aRunRow=new int [_nNonZeroWeightedGridCells]; //upper bound on number of runs
+  _aRunCol=new int [_nNonZeroWeightedGridCells];
+  _aRunLen=new int [_nNonZeroWeightedGridCells];
+  ExitGracefullyIf(_aRunLen==NULL,"CForcingGrid::BuildReadPlan",OUT_OF_MEMORY);
+
+  //_IdxNonZeroGridCells is sorted by cell ID, i.e., by row, then column
+  for (int ic=0; ic<_nNonZeroWeightedGridCells; ic++)
+  {
+    CellIdxToRowCol(_IdxNonZeroGridCells[ic],row,col);
+    row-=rowstart;
+    col-=colstart;
+    r=_nReadRuns-1;
+    if ((r>=0) && (_aRunRow[r]==row) && (col-(_aRunCol[r]+_aRunLen[r])<=max_gap)) {
+      _aRunLen[r]=col-_aRunCol[r]+1; //extend current run
+    }
+    else {
+      _aRunRow[_nReadRuns]=row;
+      _aRunCol[_nReadRuns]=col;
+      _aRunLen[_nReadRuns]=1;
+      _nReadRuns++;
+    }
+  }
+
+  // cost model
+  // -------------------------------
+  double dense_cost  = GetBytesPerChunk(_ChunkSize)+NETCDF_REQUEST_COST;
+  int    nRuns       = _nReadRuns;
+  _nReadRuns=0;
+  double sparse_cost = 0.0;
+  for (r=0;r<nRuns;r++){sparse_cost+=_aRunLen[r]*bytes_per_cell+NETCDF_REQUEST_COST;}
+
+  if (sparse_cost<dense_cost){_nReadRuns=nRuns;}
+
+  if (Options.noisy){
+    cout<<" CForcingGrid::BuildReadPlan ("<<_varname<<"): "<<nRuns<<" row-runs, est. cost sparse="<<sparse_cost<<" dense="<<dense_cost<<" bytes";
+    cout<<" -> "<<((_nReadRuns==0) ? "reading dense window" : "reading row-runs")<<endl;
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Reads raw (unscaled) NetCDF hyperslab of chunk iChunk into aVec
+/// \details Called either from ReadData() or from background prefetch thread; only uses
+///          members which are fixed during simulation. Does not exit on error.
+///          The NetCDF lock is taken for each individual request (the whole window in a dense read,
+///          or one row-run in a sparse read), so that NetCDF output written by the main thread
+///          (see CModel::WriteMinorOutput()) is not blocked until all row-runs of the chunk are read.
+///          The requests issued match those priced by BuildReadPlan()
+/// \param iChunk     [in] chunk index
+/// \param iChunkSize [in] number of time points in chunk
+/// \param aVec       [out] hyperslab stored in row major order [size: dim1*dim2*dim3]
+/// \return NetCDF error code
+//
+int CForcingGrid::ReadChunkRaw(const int iChunk,const int iChunkSize,double *aVec)
+{
+  int       dim1,dim2,dim3;
+  size_t    nc_start [3];
+  size_t    nc_length[3];
+  ptrdiff_t nc_stride[3];
+
+  GetChunkDims (iChunkSize,dim1,dim2,dim3);
+  GetChunkStart(iChunk,nc_start);
+
+  nc_length[0] = (size_t)(dim1); nc_stride[0] = 1;
+  nc_length[1] = (size_t)(dim2); nc_stride[1] = 1;
+  nc_length[2] = (size_t)(dim3); nc_stride[2] = 1;
+
+  if (_nReadRuns==0) // dense: whole window in one request
+  {
+    for(int i=0; i<dim1*dim2*dim3; i++) {
+      aVec[i]=NETCDF_BLANK_VALUE;
+    }
+    lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex()); //NetCDF library is not thread-safe
+    return nc_get_vars_double(_ncid,_varid_f,nc_start,nc_length,nc_stride,aVec);
+  }
+
+  // sparse: each row-run is mapped directly to its location in the window array,
+  // so that aVec has same layout as in dense read (cells outside runs are not touched)
+  // -------------------------------
+  int       ix,iy,it;
+  int       retval=0;
+  size_t    run_start [3];
+  size_t    run_length[3];
+  ptrdiff_t imap[3];      // memory strides of window array, in NetCDF dimension order
+  imap[0]=dim2*dim3; imap[1]=dim3; imap[2]=1;
+  GetDimPositions(ix,iy,it);
+
+  for (int r=0; r<_nReadRuns; r++)
+  {
+    for (int d=0;d<3;d++){run_start[d]=nc_start[d]; run_length[d]=nc_length[d]; }
+    run_start [ix]+=_aRunCol[r];
+    run_length[ix] =_aRunLen[r];
+    if (iy!=DOESNT_EXIST){
+      run_start [iy]+=_aRunRow[r];
+      run_length[iy] =1;
+    }
+    ptrdiff_t offset=_aRunCol[r]*imap[ix];
+    if (iy!=DOESNT_EXIST){offset+=_aRunRow[r]*imap[iy];}
+
+    lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex()); //NetCDF library is not thread-safe
+    retval=nc_get_varm_double(_ncid,_varid_f,run_start,run_length,nc_stride,imap,&aVec[offset]);
+    if (retval!=0){break;}
+  }
+  return retval;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Starts reading raw hyperslab of chunk iChunk into _aRawNext in a background thread
+/// \param &Options [in] Global model options information
+/// \param iChunk   [in] chunk to prefetch
+//
+void CForcingGrid::StartPrefetch(const optStruct &Options,const int iChunk)
+{
+  WaitForPrefetch();
+  _iChunkNext=iChunk;
+  _retvalNext=0;
+  int iChunkSize=GetChunkLength(Options,iChunk);
+  _prefetcher=std::thread([this,iChunk,iChunkSize](){
+    _retvalNext=ReadChunkRaw(iChunk,iChunkSize,_aRawNext);
+  });
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Blocks until background read (if any) is complete
+//
+void CForcingGrid::WaitForPrefetch()
+{
+  if (_prefetcher.joinable()){_prefetcher.join();}
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////
 /// \brief   Enables queries of time series values using model time
 /// \details Calculates _t_corr, correction to global model time, checks for overlap
@@ -1494,6 +1912,8 @@ void CForcingGrid::SetValue( const int ic, const int it, const double aVal) {
     ExitGracefully("CForcingGrid::SetValue:invalid index",RUNTIME_ERR);}
   if(ic>=_nNonZeroWeightedGridCells) {
     ExitGracefully("CForcingGrid::SetValue:invalid index",RUNTIME_ERR);}
+  if((_pValueSource!=NULL) || (_constant_vals)) {
+    ExitGracefully("CForcingGrid::SetValue:values are shared and may not be set",RUNTIME_ERR);}
 #endif
   _aVal[it][ic] = aVal;
 }
@@ -2002,6 +2422,54 @@ double CForcingGrid::GetValue_max(const int ic, const double &t, const int nstep
 //
 string CForcingGrid::GetFilename() const {return _filename; }
 
+///////////////////////////////////////////////////////////////////
+/// \brief Returns memory used by grid
+/// \details arrays viewed from or shared with another grid are reported as shared_bytes only;
+///          shared_bytes is therefore the memory saved relative to a deep copy of the parent grid
+/// \param val_bytes    [out] memory of values owned by grid, including raw NetCDF chunk buffers [bytes]
+/// \param wt_bytes     [out] memory of weights, cell indices and cell attributes owned by grid [bytes]
+/// \param shared_bytes [out] memory of values and weights shared with other grids [bytes]
+//
+void CForcingGrid::GetMemoryUsage(double &val_bytes,double &wt_bytes,double &shared_bytes) const
+{
+  int    nNZ=_nNonZeroWeightedGridCells;
+  int    ncells;
+  if (_is_3D) { ncells = _GridDims[0] * _GridDims[1];}
+  else        { ncells = _GridDims[0];}
+
+  double vals=0.0,full_vals=0.0,wts=0.0;
+  if(_aVal!=NULL) {
+    full_vals=(double)(_ChunkSize)*(sizeof(double*)+nNZ*sizeof(double));
+    if     (_pValueSource!=NULL) { vals=0.0; }
+    else if(_constant_vals)      { vals=(double)(_ChunkSize)*sizeof(double*)+nNZ*sizeof(double); }
+    else                         { vals=full_vals; }
+  }
+#ifdef _RVNETCDF_
+  if(_aRawBuf!=NULL) {
+    int dim1,dim2,dim3;
+    GetChunkDims(_ChunkSize,dim1,dim2,dim3);
+    vals+=2.0*dim1*dim2*dim3*sizeof(double); //current and prefetched chunk
+  }
+#endif
+  if(_nWeights!=NULL) {
+    for(int k=0; k<_nHydroUnits; k++) {
+      wts+=_nWeights[k]*(sizeof(double)+sizeof(int))+sizeof(double*)+sizeof(int*)+sizeof(int);
+    }
+  }
+  if(_CellIDToIdx        !=NULL) { wts+=ncells*sizeof(int); }
+  if(_IdxNonZeroGridCells!=NULL) { wts+=nNZ*sizeof(int);    }
+
+  double atts=0.0; //cell attributes are always owned
+  if(_aLatitude          !=NULL) { atts+=nNZ*sizeof(double); }
+  if(_aLongitude         !=NULL) { atts+=nNZ*sizeof(double); }
+  if(_aElevation         !=NULL) { atts+=nNZ*sizeof(double); }
+  if(_aStationIDs        !=NULL) { atts+=nNZ*sizeof(string); }
+
+  val_bytes   =vals;
+  wt_bytes    =((_owns_weights) ? wts : 0.0)+atts;
+  shared_bytes=(full_vals-min(vals,full_vals))+((_owns_weights) ? 0.0 : wts);
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief Returns snowfall correction factor
 /// \param None
@@ -12,6 +12,7 @@
 
 #ifdef _RVNETCDF_
 #include <netcdf.h>
+#include <thread>
 #endif
 
 ///////////////////////////////////////////////////////////////////
@@ -57,6 +58,10 @@ private:/*------------------------------------------------------*/
   int          _steps_per_day;               ///< number of data intervals per day (pre-calculated for speed) =1.0/_interval
   bool         _is_derived;                  ///< true if forcing grid is derived from input forcings (e.g. t_ave from t_min and t_max)
   ///                                        ///< false if forcing grid is truely read from NetCDF file (e.g. t_min or t_max)
+  bool         _owns_weights;                ///< true if weight and cell index arrays belong to this grid;
+  ///                                        ///< false if they are shared with the (input) grid this grid was derived from
+  const CForcingGrid *_pValueSource;         ///< grid whose _aVal rows are viewed by this grid (NULL if values are stored by this grid)
+  bool         _constant_vals;               ///< true if all rows of _aVal point to a single row (grid is constant in time)
 
   double     **_aVal;                        ///< Array of magnitudes of pulses (variable units)
   ///                                        ///< [size _ChunkSize, _nNonZeroWeightedGridCells]
@@ -107,10 +112,46 @@ private:/*------------------------------------------------------*/
   double*      _aElevation;                  ///< fixed array of cell representative elevations, if provided (size: _IdxNonZeroGridCells)
   string*      _aStationIDs;                 ///< fixed array of cell station/cell IDS (size:_IdxNonZeroGridCells)
 
+#ifdef _RVNETCDF_
+  int          _ncid;                        ///< NetCDF file handle, kept open for the whole run (-9 if not open)
+  int          _ncid_e;                      ///< ensemble member for which _ncid was opened (filename may contain member wildcard)
+  int          _varid_f;                     ///< id of forcing variable in _ncid
+  double       _fillval;                     ///< value of "_FillValue"    attribute of forcing variable
+  double       _missval;                     ///< value of "missing_value" attribute of forcing variable
+  double       _add_offset;                  ///< value of "add_offset"    attribute of forcing variable
+  double       _scale_factor;                ///< value of "scale_factor"  attribute of forcing variable
+
+  double      *_aRawBuf;                     ///< raw NetCDF hyperslab of current chunk [size: _ChunkSize*window cells]
+  double      *_aRawNext;                    ///< raw NetCDF hyperslab of chunk _iChunkNext, filled in background
+  int          _iChunkNext;                  ///< chunk held (or being read) in _aRawNext (-1 if none)
+  int          _retvalNext;                  ///< NetCDF error code returned by background read
+
+  int          _nReadRuns;                   ///< number of row-runs read per chunk (0 if whole window is read in one request)
+  int         *_aRunRow;                     ///< window-relative row of each row-run [size: _nReadRuns]
+  int         *_aRunCol;                     ///< window-relative first column (or station) of each row-run [size: _nReadRuns]
+  int         *_aRunLen;                     ///< number of cells in each row-run [size: _nReadRuns]
+  std::thread  _prefetcher;                  ///< background thread reading chunk _iChunkNext into _aRawNext
+
+  void   OpenNetCDF     (const optStruct &Options);
+  void   BuildReadPlan  (const optStruct &Options);
+  void   CloseNetCDF    ();
+  int    GetChunkLength (const optStruct &Options,const int iChunk) const;
+  void   GetChunkDims   (const int iChunkSize,int &dim1,int &dim2,int &dim3) const;
+  void   GetChunkStart  (const int iChunk,size_t *nc_start) const;
+  void   GetDimPositions(int &ix,int &iy,int &it) const;
+  double GetBytesPerChunk(const int iChunkSize) const;
+  int    ReadChunkRaw   (const int iChunk,const int iChunkSize,double *aVec);
+  void   StartPrefetch  (const optStruct &Options,const int iChunk);
+  void   WaitForPrefetch();
+#endif
+
   void   CellIdxToRowCol(const int        cellid,
                          int              &row,
                          int              &column) const;             ///< returns row and column index of cell ID
 
+  void   CopyAttributes    (const CForcingGrid &grid);
+  void   CopyCellAttributes(const CForcingGrid &grid);
+
   void   ReadAttGridFromNetCDF (const int ncid,const string varname,const int nrows,const int ncols,double *&values);
   void   ReadAttGridFromNetCDF2(const int ncid,const string varname,const int nrows,const int ncols,string *values);
 
@@ -129,6 +170,9 @@ public:/*------------------------------------------------------*/
   // copy constructor
   CForcingGrid( const CForcingGrid &grid );
 
+  // derived grid constructor - shares weights and cell indices of parent grid, values are not allocated
+  CForcingGrid( const CForcingGrid *pParent );
+
   ~CForcingGrid();
 
   // Parses all information from NetCDF file and sets variables like grid dimensions and buffer size
@@ -143,6 +187,12 @@ public:/*------------------------------------------------------*/
   // mainly used when sub-daily grids have to be added to model
   void ReallocateArraysInForcingGrid( );
 
+  // Views values of another grid with the same interval and chunk size (no values stored)
+  void ShareValues(const CForcingGrid *pSource);
+
+  // Allocates a single row of values used for all time points (grid constant in time)
+  void AllocateConstantArrays(const double &val);
+
   // ReadData populates _aVal or does nothing if no new chunk need to be read (= current modeling time step is within current chunk)
   bool   ReadData(const optStruct   &Options,
                   const double global_model_time);
@@ -242,6 +292,9 @@ public:/*------------------------------------------------------*/
   double       DailyTempCorrection(const double t)                const; ///< Daily temperature correction [C]
   int          GetTimeIndex(const double &t, const double &tstep) const; ///< get time index corresponding to t+tstep/2
   string       GetFilename()                                      const; ///< return forcing filename
+  void         GetMemoryUsage(double &val_bytes,
+                              double &wt_bytes,
+                              double &shared_bytes)               const; ///< memory owned (values, weights) and shared with other grids [bytes]
 
   double       GetCellLatitude       (const int l) const;        ///< returns Latitude of cell l (or 0, if not available)
   double       GetCellLongitude      (const int l) const;        ///< returns Longitude of cell l (or 0, if not available)
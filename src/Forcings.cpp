@@ -42,6 +42,7 @@ void ZeroOutForcings(force_struct &F)
   F.ET_radia=0.0;
   F.SW_radia=0.0;
   F.SW_radia_subcan=0.0;
+  F.SW_radia_unc=0.0;
   F.LW_incoming=0.0;
   F.SW_radia_net=0.0;
   F.LW_radia_net=0.0;
@@ -78,7 +79,7 @@ void CopyDailyForcingItems(force_struct& Ffrom, force_struct& Fto)
   Fto.day_length     = Ffrom.day_length;
   Fto.day_angle      = Ffrom.day_angle;
 
-  //Fto.SW_radia_unc   = Ffrom.SW_radia_unc;
+  Fto.SW_radia_unc   = Ffrom.SW_radia_unc; //needed by SW_RAD_UBCWM, which only recalculates radiation when day changes
   //Fto.ET_radia       = Ffrom.ET_radia;
   //Fto.ET_radia_flat  = Ffrom.ET_radia_flat;
 
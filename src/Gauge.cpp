@@ -318,21 +318,35 @@ void     CGauge::SetMeasurementHt     (const double &ht){_meas_ht=ht;}
 bool     CGauge::SetGaugeProperty          (const string prop_tag, const double &value)
 {
   string label_n = StringToUppercase(prop_tag);
-  if      (!label_n.compare("RAINFALL_CORR"   ))  {_rainfall_corr=value;}
-  else if (!label_n.compare("SNOWFALL_CORR"   ))  {_snowfall_corr=value;}
-  else if (!label_n.compare("TEMP_CORR"       ))  { _temperature_corr=value; }
-  else if (!label_n.compare("ELEVATION"       ))  {_elevation=value;}
-  else if (!label_n.compare("CLOUD_MIN_RANGE" ))  {_cloud_min_temp=value;}
-  else if (!label_n.compare("CLOUD_MAX_RANGE" ))  {_cloud_max_temp=value;}
-  else if (!label_n.compare("LATITUDE"        ))  {_Loc.latitude=value;}
-  else if (!label_n.compare("LONGITUDE"       ))  {_Loc.longitude=value;}
-  else{
+  double *px=GetGaugePropertyAddress(label_n);
+  if (px==NULL){
     WriteWarning("CGauge::SetGaugeProperty: unrecognized gauge property "+prop_tag,false);
     return false;//bad string
   }
+  *px=value;
   return true;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns address of gauge property
+/// \note used to resolve parameters once (e.g., transient parameters) rather than by name every time step
+/// \param prop_tag [in] Property Identifier (string)
+/// \return pointer to gauge property, or NULL if prop_tag is unrecognized
+//
+double  *CGauge::GetGaugePropertyAddress   (const string prop_tag)
+{
+  string label_n = StringToUppercase(prop_tag);
+  if      (!label_n.compare("RAINFALL_CORR"   )){return &(_rainfall_corr);}
+  else if (!label_n.compare("SNOWFALL_CORR"   )){return &(_snowfall_corr);}
+  else if (!label_n.compare("TEMP_CORR"       )){return &(_temperature_corr);}
+  else if (!label_n.compare("ELEVATION"       )){return &(_elevation);}
+  else if (!label_n.compare("CLOUD_MIN_RANGE" )){return &(_cloud_min_temp);}
+  else if (!label_n.compare("CLOUD_MAX_RANGE" )){return &(_cloud_max_temp);}
+  else if (!label_n.compare("LATITUDE"        )){return &(_Loc.latitude);}
+  else if (!label_n.compare("LONGITUDE"       )){return &(_Loc.longitude);}
+  return NULL;
+}
+
 /*****************************************************************
    Add Precip, Temperature Time Series
 *****************************************************************/
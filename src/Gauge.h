@@ -89,6 +89,7 @@ public:/*-------------------------------------------------------*/
   void     SetElevation       (const double &e);
   void     SetMeasurementHt   (const double &ht);
   bool     SetGaugeProperty   (const string prop_tag, const double &value);
+  double  *GetGaugePropertyAddress(const string prop_tag);
 
   void     AddTimeSeries        (CTimeSeries *pTS, const forcing_type ftype);
 
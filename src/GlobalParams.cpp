@@ -485,83 +485,111 @@ void  CGlobalParams::SetGlobalProperty (global_struct &G,
     if(!name.compare(_aGPNames[i])){_aGPvalues[i]=value; }
   }*/
 
-  if      (!name.compare("SNOW_SWI"            )){G.snow_SWI=value;}
-  else if (!name.compare("SNOW_SWI_MIN"        )){G.snow_SWI_min=value; }
-  else if (!name.compare("SNOW_SWI_MAX"        )){G.snow_SWI_max=value; }
-  else if (!name.compare("SWI_REDUCT_COEFF"    )){G.SWI_reduct_coeff=value; }
-  else if (!name.compare("SNOW_TEMPERATURE"    )){G.snow_temperature=value;}
-  else if (!name.compare("SNOW_ROUGHNESS"      )){G.snow_roughness=value;}
-  else if (!name.compare("RAINSNOW_TEMP"       )){G.rainsnow_temp=value;}
-  else if (!name.compare("RAINSNOW_DELTA"      )){G.rainsnow_delta=value;}
-  else if (!name.compare("ADIABATIC_LAPSE"     )){G.adiabatic_lapse=value;}
-  else if (!name.compare("WET_ADIABATIC_LAPSE" )){G.wet_adiabatic_lapse=value;}
-  else if (!name.compare("PRECIP_LAPSE"        )){G.precip_lapse=value;}
-
-  else if (!name.compare("TOC_MULTIPLIER"          )){G.TOC_multiplier=value;}
-  else if (!name.compare("TIME_TO_PEAK_MULTIPLIER" )){G.TIME_TO_PEAK_multiplier=value;}
-  else if (!name.compare("GAMMA_SHAPE_MULTIPLIER"  )){G.GAMMA_SHAPE_multiplier=value;}
-  else if (!name.compare("GAMMA_SCALE_MULTIPLIER"  )){G.GAMMA_SCALE_multiplier=value;}
-
   //WARNING: this sets *all* 12 SW correction parameters to "value".
-  else if (!name.compare("UBC_SW_N_CORR"       )){for (int i=0;i<12;i++){G.UBC_n_corr[i]=value;}}
+  if      (!name.compare("UBC_SW_N_CORR"       )){for (int i=0;i<12;i++){G.UBC_n_corr[i]=value;}}
   else if (!name.compare("UBC_SW_S_CORR"       )){for (int i=0;i<12;i++){G.UBC_s_corr[i]=value;}}
-
-  else if (!name.compare("MAX_SNOW_ALBEDO"     )){G.max_snow_albedo=value;}
-  else if (!name.compare("MIN_SNOW_ALBEDO"     )){G.min_snow_albedo=value;}
-  else if (!name.compare("ALB_DECAY_COLD"      )){G.alb_decay_cold=value;}
-  else if (!name.compare("ALB_DECAY_MELT"      )){G.alb_decay_melt=value;}
-  else if (!name.compare("BARE_GROUND_ALBEDO"  )){G.bare_ground_albedo=value;}
-  else if (!name.compare("SNOWFALL_ALBTHRESH"  )){G.snowfall_albthresh=value;}
-
-  else if (!name.compare("UBC_ALBASE"          )){G.UBC_snow_params.ALBASE=value;}
-  else if (!name.compare("UBC_ALBREC"          )){G.UBC_snow_params.ALBREC=value;}
-  else if (!name.compare("UBC_ALBSNW"          )){G.UBC_snow_params.ALBSNW=value;}
-  else if (!name.compare("UBC_MAX_CUM_MELT"    )){G.UBC_snow_params.MAX_CUM_MELT=value;}
-  else if (!name.compare("UBC_GW_SPLIT"        )){G.UBC_GW_split=value;}
-  else if (!name.compare("UBC_FLASH_PONDING"   )){G.UBC_flash_ponding=value;}
-  else if (!name.compare("UBC_EXPOSURE_FACT"   )){G.UBC_exposure_fact=value;}
-  else if (!name.compare("UBC_CLOUD_PENET"     )){G.UBC_cloud_penet=value;}
-  else if (!name.compare("UBC_LW_FOREST_FACT"  )){G.UBC_LW_forest_fact=value;}
-
-  else if (!name.compare("UBC_A0PELA"  )){G.UBC_lapse_params.A0PELA=value;}
-  else if (!name.compare("UBC_A0PPTP"  )){G.UBC_lapse_params.A0PPTP=value;}
-  else if (!name.compare("UBC_A0STAB"  )){G.UBC_lapse_params.A0STAB=value;}
-  else if (!name.compare("UBC_A0TLXM"  )){G.UBC_lapse_params.A0TLXM=value;}
-  else if (!name.compare("UBC_A0TLNH"  )){G.UBC_lapse_params.A0TLNH=value;}
-  else if (!name.compare("UBC_A0TLNM"  )){G.UBC_lapse_params.A0TLNM=value;}
-  else if (!name.compare("UBC_A0TLXH"  )){G.UBC_lapse_params.A0TLXH=value;}
-  else if (!name.compare("UBC_E0LHI"   )){G.UBC_lapse_params.E0LHI=value;}
-  else if (!name.compare("UBC_E0LLOW"  )){G.UBC_lapse_params.E0LLOW=value;}
-  else if (!name.compare("UBC_E0LMID"  )){G.UBC_lapse_params.E0LMID=value;}
-  else if (!name.compare("UBC_P0GRADL" )){G.UBC_lapse_params.P0GRADL=value;}
-  else if (!name.compare("UBC_P0GRADM" )){G.UBC_lapse_params.P0GRADM=value;}
-  else if (!name.compare("UBC_P0GRADU" )){G.UBC_lapse_params.P0GRADU=value;}
-  else if (!name.compare("UBC_P0TEDL"  )){G.UBC_lapse_params.P0TEDL=value;}
-  else if (!name.compare("UBC_P0TEDU"  )){G.UBC_lapse_params.P0TEDU=value;}
-  else if (!name.compare("UBC_MAX_RANGE_TEMP"  )){G.UBC_lapse_params.max_range_temp=value;}
-
-  else if (!name.compare("AIRSNOW_COEFF"       )){G.airsnow_coeff=value;}
-  else if (!name.compare("AVG_ANNUAL_SNOW"     )){G.avg_annual_snow=value;}
-  else if (!name.compare("AVG_ANNUAL_RUNOFF"   )){G.avg_annual_runoff=value;}
-  else if (!name.compare("INIT_STREAM_TEMP"    )){G.init_stream_temp=value;}
-  else if (!name.compare("MAX_SWE_SURFACE"     )){G.max_SWE_surface=value;}
-  else if (!name.compare("MOHYSE_PET_COEFF"    )){G.MOHYSE_PET_coeff=value;}
-  else if (!name.compare("MAX_REACH_SEGLENGTH" )){G.max_reach_seglength=value;}
-  else if (!name.compare("RESERVOIR_RELAX"     )){G.reservoir_relax=value; }
-  else if (!name.compare("ASSIMILATION_FACT"   )){G.assimilation_fact=value; }
-  else if (!name.compare("ASSIM_UPSTREAM_DECAY")){G.assim_upstream_decay=value; }
-  else if (!name.compare("ASSIM_TIME_DECAY"    )){G.assim_time_decay=value; }
-  else if (!name.compare("RESERVOIR_DEMAND_MULT")){G.reservoir_demand_mult=value; }
-  else if (!name.compare("WINDVEL_ICEPT"       )){G.windvel_icept=value; }
-  else if (!name.compare("WINDVEL_SCALE"       )){G.windvel_scale=value; }
-  else if (!name.compare("HBVEC_LAPSE_RATE"    )){G.HBVEC_lapse_rate=value; }
-  else if (!name.compare("HBVEC_LAPSE_UPPER"   )){G.HBVEC_lapse_upper=value; }
-  else if (!name.compare("HBVEC_LAPSE_ELEV"    )){G.HBVEC_lapse_elev=value; }
   else{
-    WriteWarning("CGlobalParams::SetGlobalProperty: Unrecognized/invalid global parameter name ("+name+") in .rvp file",false);
-
+    double *px=GetGlobalPropertyAddress(G,name);
+    if (px!=NULL){*px=value;}
+    else{
+      WriteWarning("CGlobalParams::SetGlobalProperty: Unrecognized/invalid global parameter name ("+name+") in .rvp file",false);
+    }
   }
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Returns the address of the global property corresponding to param_name
+/// \param param_name [in] Parameter identifier
+/// \return pointer to global property, or NULL if param_name is not a scalar global property
+//
+double *CGlobalParams::GetGlobalPropertyAddress(const string &param_name)
+{
+  return GetGlobalPropertyAddress(G,param_name);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Returns the address of the global property corresponding to param_name
+/// \note used to resolve parameters once (e.g., transient parameters) rather than by name every time step;
+/// monthly properties (UBC_SW_N_CORR, UBC_SW_S_CORR) have no single address and return NULL
+/// \param &G [in] Global Property structure
+/// \param param_name [in] Parameter identifier
+/// \return pointer to global property in G, or NULL if param_name is not a scalar global property
+//
+double *CGlobalParams::GetGlobalPropertyAddress(global_struct &G,
+                                                const string   param_name)
+{
+  string name;
+  name = StringToUppercase(param_name);
+
+  if      (!name.compare("SNOW_SWI"            )){return &(G.snow_SWI);}
+  else if (!name.compare("SNOW_SWI_MIN"        )){return &(G.snow_SWI_min);}
+  else if (!name.compare("SNOW_SWI_MAX"        )){return &(G.snow_SWI_max);}
+  else if (!name.compare("SWI_REDUCT_COEFF"    )){return &(G.SWI_reduct_coeff);}
+  else if (!name.compare("SNOW_TEMPERATURE"    )){return &(G.snow_temperature);}
+  else if (!name.compare("SNOW_ROUGHNESS"      )){return &(G.snow_roughness);}
+  else if (!name.compare("RAINSNOW_TEMP"       )){return &(G.rainsnow_temp);}
+  else if (!name.compare("RAINSNOW_DELTA"      )){return &(G.rainsnow_delta);}
+  else if (!name.compare("ADIABATIC_LAPSE"     )){return &(G.adiabatic_lapse);}
+  else if (!name.compare("WET_ADIABATIC_LAPSE" )){return &(G.wet_adiabatic_lapse);}
+  else if (!name.compare("PRECIP_LAPSE"        )){return &(G.precip_lapse);}
+
+  else if (!name.compare("TOC_MULTIPLIER"          )){return &(G.TOC_multiplier);}
+  else if (!name.compare("TIME_TO_PEAK_MULTIPLIER" )){return &(G.TIME_TO_PEAK_multiplier);}
+  else if (!name.compare("GAMMA_SHAPE_MULTIPLIER"  )){return &(G.GAMMA_SHAPE_multiplier);}
+  else if (!name.compare("GAMMA_SCALE_MULTIPLIER"  )){return &(G.GAMMA_SCALE_multiplier);}
+
+  else if (!name.compare("MAX_SNOW_ALBEDO"     )){return &(G.max_snow_albedo);}
+  else if (!name.compare("MIN_SNOW_ALBEDO"     )){return &(G.min_snow_albedo);}
+  else if (!name.compare("ALB_DECAY_COLD"      )){return &(G.alb_decay_cold);}
+  else if (!name.compare("ALB_DECAY_MELT"      )){return &(G.alb_decay_melt);}
+  else if (!name.compare("BARE_GROUND_ALBEDO"  )){return &(G.bare_ground_albedo);}
+  else if (!name.compare("SNOWFALL_ALBTHRESH"  )){return &(G.snowfall_albthresh);}
+
+  else if (!name.compare("UBC_ALBASE"          )){return &(G.UBC_snow_params.ALBASE);}
+  else if (!name.compare("UBC_ALBREC"          )){return &(G.UBC_snow_params.ALBREC);}
+  else if (!name.compare("UBC_ALBSNW"          )){return &(G.UBC_snow_params.ALBSNW);}
+  else if (!name.compare("UBC_MAX_CUM_MELT"    )){return &(G.UBC_snow_params.MAX_CUM_MELT);}
+  else if (!name.compare("UBC_GW_SPLIT"        )){return &(G.UBC_GW_split);}
+  else if (!name.compare("UBC_FLASH_PONDING"   )){return &(G.UBC_flash_ponding);}
+  else if (!name.compare("UBC_EXPOSURE_FACT"   )){return &(G.UBC_exposure_fact);}
+  else if (!name.compare("UBC_CLOUD_PENET"     )){return &(G.UBC_cloud_penet);}
+  else if (!name.compare("UBC_LW_FOREST_FACT"  )){return &(G.UBC_LW_forest_fact);}
+
+  else if (!name.compare("UBC_A0PELA"  )){return &(G.UBC_lapse_params.A0PELA);}
+  else if (!name.compare("UBC_A0PPTP"  )){return &(G.UBC_lapse_params.A0PPTP);}
+  else if (!name.compare("UBC_A0STAB"  )){return &(G.UBC_lapse_params.A0STAB);}
+  else if (!name.compare("UBC_A0TLXM"  )){return &(G.UBC_lapse_params.A0TLXM);}
+  else if (!name.compare("UBC_A0TLNH"  )){return &(G.UBC_lapse_params.A0TLNH);}
+  else if (!name.compare("UBC_A0TLNM"  )){return &(G.UBC_lapse_params.A0TLNM);}
+  else if (!name.compare("UBC_A0TLXH"  )){return &(G.UBC_lapse_params.A0TLXH);}
+  else if (!name.compare("UBC_E0LHI"   )){return &(G.UBC_lapse_params.E0LHI);}
+  else if (!name.compare("UBC_E0LLOW"  )){return &(G.UBC_lapse_params.E0LLOW);}
+  else if (!name.compare("UBC_E0LMID"  )){return &(G.UBC_lapse_params.E0LMID);}
+  else if (!name.compare("UBC_P0GRADL" )){return &(G.UBC_lapse_params.P0GRADL);}
+  else if (!name.compare("UBC_P0GRADM" )){return &(G.UBC_lapse_params.P0GRADM);}
+  else if (!name.compare("UBC_P0GRADU" )){return &(G.UBC_lapse_params.P0GRADU);}
+  else if (!name.compare("UBC_P0TEDL"  )){return &(G.UBC_lapse_params.P0TEDL);}
+  else if (!name.compare("UBC_P0TEDU"  )){return &(G.UBC_lapse_params.P0TEDU);}
+  else if (!name.compare("UBC_MAX_RANGE_TEMP"  )){return &(G.UBC_lapse_params.max_range_temp);}
+
+  else if (!name.compare("AIRSNOW_COEFF"       )){return &(G.airsnow_coeff);}
+  else if (!name.compare("AVG_ANNUAL_SNOW"     )){return &(G.avg_annual_snow);}
+  else if (!name.compare("AVG_ANNUAL_RUNOFF"   )){return &(G.avg_annual_runoff);}
+  else if (!name.compare("INIT_STREAM_TEMP"    )){return &(G.init_stream_temp);}
+  else if (!name.compare("MAX_SWE_SURFACE"     )){return &(G.max_SWE_surface);}
+  else if (!name.compare("MOHYSE_PET_COEFF"    )){return &(G.MOHYSE_PET_coeff);}
+  else if (!name.compare("MAX_REACH_SEGLENGTH" )){return &(G.max_reach_seglength);}
+  else if (!name.compare("RESERVOIR_RELAX"     )){return &(G.reservoir_relax);}
+  else if (!name.compare("ASSIMILATION_FACT"   )){return &(G.assimilation_fact);}
+  else if (!name.compare("ASSIM_UPSTREAM_DECAY")){return &(G.assim_upstream_decay);}
+  else if (!name.compare("ASSIM_TIME_DECAY"    )){return &(G.assim_time_decay);}
+  else if (!name.compare("RESERVOIR_DEMAND_MULT")){return &(G.reservoir_demand_mult);}
+  else if (!name.compare("WINDVEL_ICEPT"       )){return &(G.windvel_icept);}
+  else if (!name.compare("WINDVEL_SCALE"       )){return &(G.windvel_scale);}
+  else if (!name.compare("HBVEC_LAPSE_RATE"    )){return &(G.HBVEC_lapse_rate);}
+  else if (!name.compare("HBVEC_LAPSE_UPPER"   )){return &(G.HBVEC_lapse_upper);}
+  else if (!name.compare("HBVEC_LAPSE_ELEV"    )){return &(G.HBVEC_lapse_elev);}
+
+  return NULL;
+}
 
 //////////////////////////////////////////////////////////////////
 /// \brief gets global property corresponding to param_name
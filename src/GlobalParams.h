@@ -38,6 +38,8 @@ public:/*-------------------------------------------------------*/
   static double GetGlobalProperty        (const global_struct &G, string  param_name, const bool strict=true);
 
   static double *GetAddress(const string param_name);
+  static double *GetGlobalPropertyAddress(const string &param_name);
+  static double *GetGlobalPropertyAddress(global_struct &G, const string param_name);
 
   static void SummarizeToScreen();
 };
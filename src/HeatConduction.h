@@ -55,6 +55,7 @@ public:/*-------------------------------------------------------*/
                         double      *rates) const;
 
   void        GetParticipatingParamList(string  *aP,class_type *aPC,int &nP) const;
+  bool        IsThreadSafe() const { return false; } //uses static work arrays shared between HRUs
   static void GetParticipatingStateVarList(sv_type *aSV,int *aLev,int &nSV);
 
 };
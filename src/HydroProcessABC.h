@@ -76,6 +76,7 @@ public:/*-------------------------------------------------------*/
   process_type         GetProcessType()       const;
 
   virtual int          GetNumLatConnections() const { return 0; }
+  virtual bool         IsThreadSafe()         const { return true; } ///< true if GetRatesOfChange() may be called concurrently for different HRUs
 
   bool                 ShouldApply(const CHydroUnit*pHRU) const;
   //functions
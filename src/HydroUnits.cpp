@@ -86,6 +86,7 @@ CHydroUnit::CHydroUnit(const CModelABC        *pMod,
   for (i=0;i<_pModel->GetNumStateVars();i++){
     _aStateVar[i]=0.0;
   }
+  _SVIsView=false;
 
   ZeroOutForcings(_Forcings);
 
@@ -115,7 +116,7 @@ CHydroUnit::CHydroUnit(const CModelABC        *pMod,
 CHydroUnit::~CHydroUnit()
 {
   if (DESTRUCTOR_DEBUG){cout<<"    DELETING HYDROUNIT"<<endl;}
-  delete [] _aStateVar; _aStateVar=NULL;
+  if (!_SVIsView){delete [] _aStateVar;} _aStateVar=NULL;
 }
 /*****************************************************************
    Accessors
@@ -346,6 +347,23 @@ void    CHydroUnit::SetStateVarValue      (const int i, const double &val)
   _aStateVar[i]=val;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Redirects HRU state variable array to a view into the model state matrix
+/// \remarks called by CModel::AllocateStateMatrix() and CModel::SwapStateMatrix() only
+///
+/// \param aSV [in] pointer to row of model state matrix [size: nStateVars] (not owned by HRU)
+/// \param copy [in] if true, current state variable values are copied into view
+//
+void    CHydroUnit::SetStateVarView       (double *aSV, const bool copy)
+{
+  if (copy){
+    for (int i=0;i<_pModel->GetNumStateVars();i++){aSV[i]=_aStateVar[i];}
+  }
+  if (!_SVIsView){delete [] _aStateVar;}
+  _aStateVar=aSV;
+  _SVIsView =true;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Disables HRU
 //
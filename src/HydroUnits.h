@@ -35,6 +35,7 @@ private:/*------------------------------------------------------*/
 
   //Model State variables:
   double                  *_aStateVar;  ///< Array of *current value* of state variable i with size CModel::nStateVars [mm] for water storage, permafrost depth, snow depth, [MJ/m^2] for energy storage
+  bool                     _SVIsView;  ///< true if _aStateVar is a view into the model state matrix (not owned by HRU)
 
   //Model Forcing functions:
   force_struct              _Forcings;  ///< *current values* of forcing functions for time step (precip, temp, etc.)
@@ -150,6 +151,7 @@ public:/*-------------------------------------------------------*/
 
   //Manipulator functions (used in initialization)
   void          Initialize              (const int UTM_zone);
+  void          SetStateVarView         (double *aSV, const bool copy=true);
 
   //Manipulator functions (used in solution method)
   void          SetStateVarValue        (const int           i,
@@ -0,0 +1,135 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------*/
+#include "KDTree.h"
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the k-d tree constructor
+/// \param *x [in] x-coordinates of points [size: nPoints]
+/// \param *y [in] y-coordinates of points [size: nPoints]
+/// \param *ID [in] user ID of each point (e.g., gauge index) [size: nPoints]
+/// \param nPoints [in] number of points
+//
+CKDTree::CKDTree(const double *x, const double *y, const int *ID, const int nPoints)
+{
+  _nPoints=nPoints;
+  _aX =new double [max(_nPoints,1)];
+  _aY =new double [max(_nPoints,1)];
+  _aID=new int    [max(_nPoints,1)];
+  ExitGracefullyIf(_aID==NULL,"CKDTree constructor",OUT_OF_MEMORY);
+  for (int i=0;i<_nPoints;i++){
+    _aX[i]=x[i]; _aY[i]=y[i]; _aID[i]=ID[i];
+  }
+  Build(0,_nPoints,0);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the k-d tree destructor
+//
+CKDTree::~CKDTree()
+{
+  delete [] _aX;  _aX=NULL;
+  delete [] _aY;  _aY=NULL;
+  delete [] _aID; _aID=NULL;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns number of points in tree
+//
+int CKDTree::GetNumPoints() const{return _nPoints;}
+
+//////////////////////////////////////////////////////////////////
+/// \brief recursively reorders points in [lo,hi) so that the median (along x for even depth, y for odd) is at the midpoint,
+/// with smaller coordinates before and larger coordinates after
+//
+void CKDTree::Build(const int lo, const int hi, const int depth)
+{
+  if (hi-lo<=1){return;}
+  int mid=(lo+hi)/2;
+  const double *c=(depth%2==0) ? _aX : _aY;
+
+  //quickselect of median over index range (swaps all three arrays in step)
+  int l=lo,r=hi-1;
+  while (l<r)
+  {
+    double pivot=c[(l+r)/2];
+    int i=l,j=r;
+    while (i<=j)
+    {
+      while (c[i]<pivot){i++;}
+      while (c[j]>pivot){j--;}
+      if (i<=j){
+        swap(_aX [i],_aX [j]);
+        swap(_aY [i],_aY [j]);
+        swap(_aID[i],_aID[j]);
+        i++; j--;
+      }
+    }
+    if      (mid<=j){r=j;}
+    else if (mid>=i){l=i;}
+    else            {break;}
+  }
+  Build(lo   ,mid,depth+1);
+  Build(mid+1,hi ,depth+1);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief recursive k-nearest search over index range [lo,hi)
+/// \details aID/aDist2 hold the nFound (<=k) nearest points found so far, sorted by distance then ID
+//
+void CKDTree::SearchNearest(const int lo, const int hi, const int depth,
+                            const double &x, const double &y, const int k,
+                            int *aID, double *aDist2, int &nFound) const
+{
+  if (hi<=lo){return;}
+  int mid=(lo+hi)/2;
+
+  //insert node point into sorted list of nearest
+  double dx=x-_aX[mid];
+  double dy=y-_aY[mid];
+  double d2=dx*dx+dy*dy;
+  int    id=_aID[mid];
+  if ((nFound<k) || (d2<aDist2[nFound-1]) || ((d2==aDist2[nFound-1]) && (id<aID[nFound-1])))
+  {
+    int i=min(nFound,k-1);
+    while ((i>0) && ((aDist2[i-1]>d2) || ((aDist2[i-1]==d2) && (aID[i-1]>id)))){
+      aDist2[i]=aDist2[i-1];
+      aID   [i]=aID   [i-1];
+      i--;
+    }
+    aDist2[i]=d2;
+    aID   [i]=id;
+    if (nFound<k){nFound++;}
+  }
+
+  //search near side first, then far side only if splitting plane is within current k-th distance
+  double diff=(depth%2==0) ? dx : dy;
+  if (diff<0){
+    SearchNearest(lo,mid,depth+1,x,y,k,aID,aDist2,nFound);
+    if ((nFound<k) || (diff*diff<=aDist2[nFound-1])){SearchNearest(mid+1,hi,depth+1,x,y,k,aID,aDist2,nFound);}
+  }
+  else{
+    SearchNearest(mid+1,hi,depth+1,x,y,k,aID,aDist2,nFound);
+    if ((nFound<k) || (diff*diff<=aDist2[nFound-1])){SearchNearest(lo,mid,depth+1,x,y,k,aID,aDist2,nFound);}
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns the k points nearest to (x,y)
+/// \param &x [in] x-coordinate of query location
+/// \param &y [in] y-coordinate of query location
+/// \param k [in] number of points requested
+/// \param *aID [out] IDs of nearest points, sorted by increasing distance (ties by increasing ID) [size: k]
+/// \param *aDist2 [out] squared distances of nearest points [size: k]
+/// \return number of points found (min(k,number of points))
+//
+int CKDTree::GetNearest(const double &x, const double &y, const int k,
+                        int *aID, double *aDist2) const
+{
+  int nFound=0;
+  if (k<=0){return 0;}
+  SearchNearest(0,_nPoints,0,x,y,k,aID,aDist2,nFound);
+  return nFound;
+}
@@ -0,0 +1,44 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------
+  class definitions:
+  CKDTree
+  ----------------------------------------------------------------*/
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include "RavenInclude.h"
+
+///////////////////////////////////////////////////////////////////
+/// \brief Static 2-D k-d tree spatial index over a set of points (e.g., gauge locations)
+/// \details Points are stored as a balanced, implicit tree (median of each index range is the node),
+/// built once in O(N log N). Supports k-nearest neighbour queries in O(log N) (typical).
+/// Each point retains a user-supplied ID (e.g., gauge index g) which is returned by queries
+/// \remark ties in distance are broken by smallest ID, so results are independent of tree structure
+//
+class CKDTree
+{
+private:/*------------------------------------------------------*/
+
+  int     _nPoints;  ///< number of points in tree
+  double *_aX;       ///< x-coordinate of each point, in tree order [size: _nPoints]
+  double *_aY;       ///< y-coordinate of each point, in tree order [size: _nPoints]
+  int    *_aID;      ///< user ID of each point, in tree order [size: _nPoints]
+
+  void Build        (const int lo, const int hi, const int depth);
+  void SearchNearest(const int lo, const int hi, const int depth,
+                     const double &x, const double &y, const int k,
+                     int *aID, double *aDist2, int &nFound) const;
+
+public:/*-------------------------------------------------------*/
+  //Constructors:
+  CKDTree(const double *x, const double *y, const int *ID, const int nPoints);
+  ~CKDTree();
+
+  int  GetNumPoints() const;
+
+  int  GetNearest(const double &x, const double &y, const int k,
+                  int *aID, double *aDist2) const;
+};
+#endif
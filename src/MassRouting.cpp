@@ -14,8 +14,8 @@ routing of mass/energy in catchment and channel
 void CConstituentModel::InitializeRoutingVars()
 {
   int nSB=_pModel->GetNumSubBasins();
-  _aMinHist       =new double *[nSB];
-  _aMlatHist      =new double *[nSB];
+  _aMinHist       =new ring_history [nSB];
+  _aMlatHist      =new ring_history [nSB];
   _aMout          =new double *[nSB];
   _aMout_last     =new double  [nSB];
   _aMres          =new double  [nSB];
@@ -36,12 +36,10 @@ void CConstituentModel::InitializeRoutingVars()
     int nSegments=_pModel->GetSubBasin(p)->GetNumSegments();
 
     _aMout[p]=NULL;
-    _aMinHist [p]=new double[nMinHist];
-    _aMlatHist[p]=new double[nMlatHist];
+    _aMinHist [p].Allocate(nMinHist, 0.0);
+    _aMlatHist[p].Allocate(nMlatHist,0.0);
     _aMout    [p]=new double[nSegments];
     ExitGracefullyIf(_aMout[p]==NULL,"CConstituentModel::InitializeRoutingVars(2)",OUT_OF_MEMORY);
-    for(int i=0; i<nMinHist; i++) { _aMinHist [p][i]=0.0; }
-    for(int i=0; i<nMlatHist;i++) { _aMlatHist[p][i]=0.0; }
     for(int i=0; i<nSegments;i++) { _aMout    [p][i]=0.0; }
     _aMout_last     [p]=0.0;
     _aMres          [p]=0.0;
@@ -66,8 +64,8 @@ void CConstituentModel::DeleteRoutingVars()
   if(_aMinHist!=NULL) {
     for(int p=0;p<nSB;p++)
     {
-      delete[] _aMinHist[p];
-      delete[] _aMlatHist[p];
+      _aMinHist [p].Clear();
+      _aMlatHist[p].Clear();
       delete[] _aMout[p];
     }
     delete[] _aMinHist;        _aMinHist  =NULL;
@@ -94,11 +92,7 @@ void CConstituentModel::DeleteRoutingVars()
 //
 void   CConstituentModel::SetMassInflows(const int p,const double Minnew)
 {
-  int nMinHist=_pModel->GetSubBasin(p)->GetInflowHistorySize();
-  for(int n=nMinHist-1;n>0;n--) {
-    _aMinHist[p][n]=_aMinHist[p][n-1];
-  }
-  _aMinHist[p][0]=Minnew;
+  _aMinHist[p].Push(Minnew);
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Updates aMinnew, array of mass loadings, to handle fixed concentration/temperature or specified mass inflow conditions
@@ -197,11 +191,7 @@ double   CConstituentModel::GetMassAddedFromInflowSources(const double &t,const
 //
 void   CConstituentModel::SetLateralInfluxes(const int p,const double Mlat)
 {
-  int nMlatHist=_pModel->GetSubBasin(p)->GetLatHistorySize();
-  for(int n=nMlatHist-1;n>0;n--) {
-    _aMlatHist[p][n]=_aMlatHist[p][n-1];
-  }
-  _aMlatHist[p][0]=Mlat;
+  _aMlatHist[p].Push(Mlat);
 
 }
 
@@ -251,7 +241,7 @@ void   CConstituentModel::RouteMass(const int          p,          // SB index
   if((Options.routing==ROUTE_PLUG_FLOW) || (Options.routing==ROUTE_DIFFUSIVE_WAVE))
   {
     // (sometimes fancy) convolution
-    ApplyConvolutionRouting(p,aRouteHydro,aQinHist,_aMinHist[p],nSegments,nMinHist,Options.timestep,aMout_new);
+    ApplyConvolutionRouting(p,aRouteHydro,aQinHist,_aMinHist[p].Hist(),nSegments,nMinHist,Options.timestep,aMout_new);
   }
   //==============================================================
   else if(Options.routing==ROUTE_NONE)
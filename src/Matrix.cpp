@@ -47,6 +47,29 @@ void   MatMult(Ironclad2DArray A,Ironclad2DArray B,const int N,const int M,const
 	}
 }
 
+/************************************************************************
+ MatMultTransB:
+	Multiplies NxM matrix A times transpose of PxM matrix B. Returns C (NxP)
+	equivalent to MatMult(A,B',...), but rows of A and B are traversed
+	contiguously in blocks of MATMULT_BLOCK rows, so each block of B is reused
+	from cache; sums are accumulated in the same order as MatMult
+-----------------------------------------------------------------------*/
+void   MatMultTransB(Ironclad2DArray A,Ironclad2DArray B,const int N,const int M,const int P,Writeable2DArray C)
+{
+	double s;
+	for(int n0=0; n0<N; n0+=MATMULT_BLOCK) {
+		for(int p0=0; p0<P; p0+=MATMULT_BLOCK) {
+			for(int n=n0; n<min(n0+MATMULT_BLOCK,N); n++) {
+				for(int p=p0; p<min(p0+MATMULT_BLOCK,P); p++) {
+					s=0.0;
+					for(int m=0; m<M; m++) { s+=A[n][m]*B[p][m]; }
+					C[n][p]=s;
+				}
+			}
+		}
+	}
+}
+
 /************************************************************************
  ScalarMatMult:
 	Multiplies NxM matrix A times scalara multiplier. Returns C (NxM)
@@ -136,14 +159,17 @@ inline double    pythag(const double a,const double b) {
 	else { return (absb==0.0 ? 0.0 : absb*sqrt(1.0+(absa/absb)*(absa/absb))); }
 }
 /************************************************************************
- Singular Value Decomposition:
-Returns solution, x and rank
-	this operation destroys the A matrix
+ SVDDecompose:
+	Singular value decomposition of square matrix AA=A*diag(w)*v'
+	A, w and v must be allocated by the caller [size x size, size, size x size]
+	A is overwritten with the left singular vectors (AA is unchanged)
+	singular values less than SVTolerance*max(w) are set to zero
 	from Numerical Recipes (Press et al)
 -----------------------------------------------------------------------*/
-bool SVD(Ironclad2DArray AA,
-				 Ironclad1DArray b,
-				 Writeable1DArray x,
+bool SVDDecompose(Ironclad2DArray AA,
+				 Writeable2DArray A,
+				 Writeable1DArray w,
+				 Writeable2DArray v,
 				 const int size,
 				 const double SVTolerance)
 {
@@ -154,11 +180,10 @@ bool SVD(Ironclad2DArray AA,
 	int m=size;
 	int n=size;
 	double* tmp=new double[n];
-	double* w  =new double[n];
-	double** v=NULL;
-	AllocateMatrix(n,n,v);
-	double **A=NULL;
-	AllocateMatrix(n,n,A);
+	for(i=0;i<n;i++) {
+		w[i]=0.0;
+		for(j=0;j<n;j++) { v[i][j]=0.0; }
+	}
 	CopyMatrix(AA,n,n,A);
 	/*	cout <<endl;
 		for (j=0;j<size;j++){
@@ -357,11 +382,35 @@ bool SVD(Ironclad2DArray AA,
 	}
 	for(j=0; j<n; j++) { if(w[j]!=0) { lowerswap(minw,w[j]); } } //reevaluate min
 
-	//back substitute
+	delete[] tmp;
+
+	//cout <<"SVD CONDITION #: " <<maxw/minw<<endl;
+	return true; //should be dependent upon condition number (max wj/minwj) should be low
+}
+/************************************************************************
+ SVDBackSubstitute:
+	Returns solution, x, of A*x=b, using decomposition A=U*diag(w)*v'
+	from SVDDecompose; terms with zeroed singular values are excluded
+	(i.e., pseudo-inverse solution). The decomposition is not modified, so
+	may be reused for any number of right hand sides b
+-----------------------------------------------------------------------*/
+void SVDBackSubstitute(Ironclad2DArray U,
+				 Ironclad1DArray w,
+				 Ironclad2DArray v,
+				 Ironclad1DArray b,
+				 Writeable1DArray x,
+				 const int size)
+{
+	int i,j,jj;
+	double s;
+	int m=size;
+	int n=size;
+	double* tmp=new double[n];
+
 	for(j=0; j<n; j++) {
 		s=0.0;
 		if(w[j]!=0.0) {
-			for(i=0; i<m; i++) { s+=A[i][j]*b[i]; }
+			for(i=0; i<m; i++) { s+=U[i][j]*b[i]; }
 			s/=w[j];
 		}
 		tmp[j]=s;
@@ -372,19 +421,32 @@ bool SVD(Ironclad2DArray AA,
 		for(jj=0;jj<n;jj++) { s+=v[j][jj]*tmp[jj]; }
 		x[j]=s;
 	}
+	delete[] tmp;
+}
+/************************************************************************
+ Singular Value Decomposition:
+Returns solution, x and rank
+	from Numerical Recipes (Press et al)
+	to solve for several right hand sides b with the same matrix, use
+	SVDDecompose once, then SVDBackSubstitute for each b
+-----------------------------------------------------------------------*/
+bool SVD(Ironclad2DArray AA,
+				 Ironclad1DArray b,
+				 Writeable1DArray x,
+				 const int size,
+				 const double SVTolerance)
+{
+	double*  w=new double[size];
+	double** v=NULL;
+	double** A=NULL;
+	AllocateMatrix(size,size,v);
+	AllocateMatrix(size,size,A);
 
-	/*	for (j=0;j<size;j++){
-			cout << "| "<<x[j]<<" | "<< w[j]<<endl;
-		}*/
-
-		//calculate error
+	bool good=SVDDecompose(AA,A,w,v,size,SVTolerance);
+	SVDBackSubstitute(A,w,v,b,x,size);
 
-		//cout << "n: "<<n<< " m: "<<m<<endl;
-	delete[] tmp;
 	delete[] w;
-	DeleteMatrix(n,n,v);
-	DeleteMatrix(n,n,A);
-
-	//cout <<"SVD CONDITION #: " <<maxw/minw<<endl;
-	return true; //should be dependent upon condition number (max wj/minwj) should be low
+	DeleteMatrix(size,size,v);
+	DeleteMatrix(size,size,A);
+	return good;
 }
@@ -15,6 +15,8 @@ typedef const double* const* Unchangeable2DArray;
 typedef       double** const Writeable2DArray;
 typedef const double* const* const Ironclad2DArray;
 
+const int MATMULT_BLOCK=64; ///< number of matrix rows per cache block in MatMultTransB
+
 void   MatVectMult    (Ironclad2DArray  A,
 											 Ironclad1DArray  x,
 											 const int N,
@@ -31,6 +33,12 @@ void   MatMult        (Ironclad2DArray  A,
 											 const int				M,
 											 const int				P,
 											 Writeable2DArray C);
+void   MatMultTransB  (Ironclad2DArray  A,
+											 Ironclad2DArray  B,
+											 const int				N,
+											 const int				M,
+											 const int				P,
+											 Writeable2DArray C);
 void   ScalarMatMult  (Ironclad2DArray  A,
 	                     const double &muliplier,
 											 const int				N,
@@ -56,4 +64,16 @@ bool						  SVD(Ironclad2DArray A,
 											Writeable1DArray x,
 											const int        size,
 											const double     SVTolerance);
+bool     SVDDecompose(Ironclad2DArray  AA,
+											Writeable2DArray A,
+											Writeable1DArray w,
+											Writeable2DArray v,
+											const int        size,
+											const double     SVTolerance);
+void SVDBackSubstitute(Ironclad2DArray U,
+											Ironclad1DArray  w,
+											Ironclad2DArray  v,
+											Ironclad1DArray  b,
+											Writeable1DArray x,
+											const int        size);
 #endif
@@ -28,14 +28,15 @@ CModel::CModel(const int        nsoillayers,
   _nForcingGrids=0;   _pForcingGrids=NULL;
   _nProcesses=0;      _pProcesses=NULL;
   _nCustomOutputs=0;  _pCustomOutputs=NULL;
-  _nTransParams=0;    _pTransParams=NULL;
+  _nTransParams=0;    _pTransParams=NULL;    _aTransParamAddr=NULL;
   _nClassChanges=0;   _pClassChanges=NULL;
   _nParamOverrides=0; _pParamOverrides=NULL;
-  _nObservedTS=0;     _pObservedTS=NULL; _pModeledTS=NULL; _aObsIndex=NULL;
+  _nObservedTS=0;     _pObservedTS=NULL; _pModeledTS=NULL; _aObsIndex=NULL; _aObsBinding=NULL;
   _nObsWeightTS =0;   _pObsWeightTS=NULL;
   _nDiagnostics=0;    _pDiagnostics=NULL;
   _nDiagPeriods=0;    _pDiagPeriods=NULL;
   _nAggDiagnostics=0; _pAggDiagnostics=NULL;
+  _nDiagStreams=0;    _pDiagStreams=NULL;
   _nPerturbations=0;  _pPerturbations=NULL;
 
   _nTotalConnections=0;
@@ -46,6 +47,7 @@ CModel::CModel(const int        nsoillayers,
   _aSubBasinOrder =NULL; _maxSubBasinOrder=0;
   _aOrderedSBind  =NULL;
   _aDownstreamInds=NULL;
+  _aLevelStart    =NULL;
 
   _aDAscale       =NULL; //Initialized in InitializeDataAssimilation
   _aDAlength      =NULL;
@@ -61,6 +63,13 @@ CModel::CModel(const int        nsoillayers,
   _FORCINGS_ncid=-9;
   _RESSTAGE_ncid=-9;
   _RESMB_ncid   =-9;
+  _pHYDRO_ncbuf   =NULL;
+  _pRESSTAGE_ncbuf=NULL;
+  _pSTORAGE_ncbuf =NULL;
+  _pFORCINGS_ncbuf=NULL;
+  _pRESMB_ncbuf   =NULL;
+  _aHydroObsIndex =NULL;
+  _aStageObsIndex =NULL;
 
   _PETBlends_N=0;
   _PETBlends_type=NULL;
@@ -102,13 +111,14 @@ CModel::CModel(const int        nsoillayers,
   }
   _lake_sv=0; //by default, rain on lake goes direct to surface storage [0]
 
+  _SVStride=0;
+  for (int b=0;b<N_STATE_BUFFERS;b++){_aStateMatrix[b]=NULL; _aStateMatrixMem[b]=NULL;} //allocated in Initialize
+
 
   CHydroProcessABC::SetModel(this);
   CLateralExchangeProcessABC::SetModel(this);
 
-  _aGaugeWeights    =NULL; //Initialized in Initialize
-  _aGaugeWtTemp     =NULL;
-  _aGaugeWtPrecip   =NULL;
+  //_GaugeWeights, _GaugeWtTemp, _GaugeWtPrecip initialized in Initialize
   _aCumulativeBal   =NULL;
   _aFlowBal         =NULL;
   _aCumulativeLatBal=NULL;
@@ -159,6 +169,7 @@ CModel::~CModel()
   for (j=0;j<_nDiagnostics;  j++){delete _pDiagnostics  [j];} delete [] _pDiagnostics;  _pDiagnostics=NULL;
   for (j=0;j<_nDiagPeriods;  j++){delete _pDiagPeriods  [j];} delete [] _pDiagPeriods;  _pDiagPeriods=NULL;
   for (j=0;j<_nAggDiagnostics; j++){delete _pAggDiagnostics[j];} delete [] _pAggDiagnostics; _pAggDiagnostics=NULL;
+  for (j=0;j<_nDiagStreams;  j++){delete _pDiagStreams  [j];} delete [] _pDiagStreams;  _pDiagStreams=NULL;
 
   if (_aCumulativeBal!=NULL){
     for (k=0;k<_nHydroUnits;   k++){delete [] _aCumulativeBal[k];} delete [] _aCumulativeBal; _aCumulativeBal=NULL;
@@ -168,21 +179,22 @@ CModel::~CModel()
   }
   if (_aCumulativeLatBal!=NULL){delete [] _aCumulativeLatBal; _aCumulativeLatBal=NULL;}
   if (_aFlowLatBal      !=NULL){delete [] _aFlowLatBal;       _aFlowLatBal=NULL;}
-  if (_aGaugeWeights!=NULL){
-    for (k=0;k<_nHydroUnits;   k++){delete [] _aGaugeWeights[k]; } delete [] _aGaugeWeights;  _aGaugeWeights=NULL;
-  }
-  if (_aGaugeWtPrecip!=NULL){
-    for (k=0;k<_nHydroUnits;   k++){delete [] _aGaugeWtPrecip[k]; } delete [] _aGaugeWtPrecip;  _aGaugeWtPrecip=NULL;
-  }
-  if (_aGaugeWtTemp!=NULL){
-    for (k=0;k<_nHydroUnits;   k++){delete [] _aGaugeWtTemp[k]; } delete [] _aGaugeWtTemp;  _aGaugeWtTemp=NULL;
-  }
+  _GaugeWeights.Clear();
+  _GaugeWtPrecip.Clear();
+  _GaugeWtTemp.Clear();
+  _ForcingStore.Clear();
+  _FluxIndex.Clear();
+  for (int b=0;b<N_STATE_BUFFERS;b++){delete [] _aStateMatrixMem[b]; _aStateMatrixMem[b]=NULL; _aStateMatrix[b]=NULL;}
   if (_aShouldApplyProcess!=NULL){
     for (k=0;k<_nProcesses;   k++){delete [] _aShouldApplyProcess[k]; } delete [] _aShouldApplyProcess;  _aShouldApplyProcess=NULL;
   }
   for (kk=0;kk<_nHRUGroups;kk++)  {delete _pHRUGroups[kk];    } delete [] _pHRUGroups;      _pHRUGroups  =NULL;
   for (kk=0;kk<_nSBGroups;kk++ )  {delete _pSBGroups[kk];     } delete [] _pSBGroups;       _pSBGroups  =NULL;
   for (j=0;j<_nTransParams;j++)   {delete _pTransParams[j];   } delete [] _pTransParams;    _pTransParams=NULL;
+  delete [] _aTransParamAddr; _aTransParamAddr=NULL;
+  delete [] _WshedAgg.aAvgStateVar; _WshedAgg.aAvgStateVar=NULL;
+  delete [] _aHydroObsIndex;  _aHydroObsIndex =NULL;
+  delete [] _aStageObsIndex;  _aStageObsIndex =NULL;
   for (j=0;j<_nClassChanges;j++)  {delete _pClassChanges[j];  } delete [] _pClassChanges;   _pClassChanges=NULL;
   for (j=0;j<_nParamOverrides;j++){delete _pParamOverrides[j];} delete [] _pParamOverrides; _pParamOverrides=NULL;
 
@@ -198,8 +210,10 @@ CModel::~CModel()
   delete [] _aSubBasinOrder; _aSubBasinOrder=NULL;
   delete [] _aOrderedSBind;  _aOrderedSBind=NULL;
   delete [] _aDownstreamInds;_aDownstreamInds=NULL;
+  delete [] _aLevelStart;    _aLevelStart=NULL;
   delete [] _aOutputTimes;   _aOutputTimes=NULL;
   delete [] _aObsIndex;      _aObsIndex=NULL;
+  delete [] _aObsBinding;    _aObsBinding=NULL;
 
   delete [] _aDAscale;       _aDAscale=NULL;
   delete [] _aDAlength;      _aDAlength=NULL;
@@ -292,6 +306,40 @@ int CModel::GetNumSoilLayers  () const{return _nSoilVars;}
 //
 int CModel::GetNumProcesses   () const{return _nProcesses;}
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if HRU-scale processes may be simulated concurrently in different HRUs
+/// \remark local parameter overrides modify shared class properties within the HRU loop, so preclude threading
+///
+/// \return true if MassEnergyBalance HRU loop may be multithreaded
+//
+bool CModel::IsHRULoopThreadSafe() const
+{
+  if (_nParamOverrides>0){return false;}
+  for (int j=0;j<_nProcesses;j++){
+    if (!_pProcesses[j]->IsThreadSafe()){return false;}
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns true if subbasins within the same routing level may be routed concurrently
+/// \remark reservoir control structures may be conditioned on the state of any subbasin, flow assimilation
+/// modifies global mass balance accumulators, and coupled GW-river exchange is not thread-safe
+///
+/// \param &Options [in] Global model options information
+/// \return true if MassEnergyBalance routing loop may be multithreaded
+//
+bool CModel::IsRoutingThreadSafe(const optStruct &Options) const
+{
+  if (Options.assimilate_flow                  ){return false;}
+  if (Options.modeltype==MODELTYPE_COUPLED     ){return false;}
+  for (int p=0;p<_nSubBasins;p++){
+    CReservoir *pRes=_pSubBasins[p]->GetReservoir();
+    if ((pRes!=NULL) && (pRes->GetNumControlStructures()>0)){return false;}
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns total modeled watershed area
 ///
@@ -383,6 +431,29 @@ CHydroUnit *CModel::GetHydroUnit(const int k) const
   return _pHydroUnits[k];
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns model-owned state matrix b
+/// \remark b=0 is the current model state, viewed by the HRUs; others are solver work buffers
+///
+/// \param b [in] state matrix index (0 to N_STATE_BUFFERS-1)
+/// \return pointer to contiguous state matrix [size: nHRUs*GetStateMatrixStride()]; state variable i of HRU k is at [k*stride+i]
+//
+double *CModel::GetStateMatrix(const int b) const
+{
+#ifdef _STRICTCHECK_
+  ExitGracefullyIf((b<0) || (b>=N_STATE_BUFFERS),"CModel GetStateMatrix::improper index",BAD_DATA);
+#endif
+  return _aStateMatrix[b];
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns row length of state matrices (number of state variables, padded to whole cache lines)
+//
+int CModel::GetStateMatrixStride() const
+{
+  return _SVStride;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns specific HRU with HRU identifier HRUID
 ///
@@ -391,14 +462,9 @@ CHydroUnit *CModel::GetHydroUnit(const int k) const
 //
 CHydroUnit *CModel::GetHRUByID(const int HRUID) const
 {
-  static int last_k=0;
-  //smart find
-  int k;
-  for (int i=0;i<_nHydroUnits;i++){
-    k=NearSearchIndex(i,last_k,_nHydroUnits);
-    if (HRUID==_pHydroUnits[k]->GetID()){ last_k=k; return _pHydroUnits[k];}
-  }
-  return NULL;
+  unordered_map<long,int>::const_iterator it=_HRUIndexByID.find(HRUID);
+  if (it==_HRUIndexByID.end()){return NULL;}
+  return _pHydroUnits[it->second];
 }
 
 //////////////////////////////////////////////////////////////////
@@ -423,12 +489,9 @@ CHRUGroup  *CModel::GetHRUGroup(const int kk) const
 //
 CHRUGroup  *CModel::GetHRUGroup(const string name) const
 {
-  for (int kk=0;kk<_nHRUGroups;kk++){
-    if (!name.compare(_pHRUGroups[kk]->GetName())){
-      return _pHRUGroups[kk];
-    }
-  }
-  return NULL;
+  unordered_map<string,int>::const_iterator it=_HRUGroupIndex.find(name);
+  if (it==_HRUGroupIndex.end()){return NULL;}
+  return _pHRUGroups[it->second];
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Returns true if HRU with global index k is in specified HRU Group
@@ -487,15 +550,10 @@ int         CModel::GetDownstreamBasin(const int p) const
 //
 CSubBasin  *CModel::GetSubBasinByID(const long SBID) const
 {
-  static int last_p=0;
-  int p;
   if (SBID < 0) { return NULL; }
-  //smart find
-  for (int i=0;i<_nSubBasins;i++){
-    p = NearSearchIndex(i, last_p, _nSubBasins);
-    if (_pSubBasins[p]->GetID()==SBID){last_p=p; return _pSubBasins[p];}
-  }
-  return NULL;
+  unordered_map<long,int>::const_iterator it=_SBIndexByID.find(SBID);
+  if (it==_SBIndexByID.end()){return NULL;}
+  return _pSubBasins[it->second];
 }
 
 //////////////////////////////////////////////////////////////////
@@ -506,15 +564,10 @@ CSubBasin  *CModel::GetSubBasinByID(const long SBID) const
 //
 int         CModel::GetSubBasinIndex(const long SBID) const
 {
-  static int last_p = 0;
-  int p;
   if (SBID<0){return DOESNT_EXIST;}
-  //smart find
-  for (int i = 0; i < _nSubBasins; i++) {
-    p = NearSearchIndex(i, last_p, _nSubBasins);
-    if (_pSubBasins[p]->GetID() == SBID) { last_p = p; return p; }
-  }
-  return INDEX_NOT_FOUND;
+  unordered_map<long,int>::const_iterator it=_SBIndexByID.find(SBID);
+  if (it==_SBIndexByID.end()){return INDEX_NOT_FOUND;}
+  return it->second;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Returns array of pointers to subbasins upstream of subbasin SBID, including that subbasin
@@ -606,12 +659,9 @@ CSubbasinGroup  *CModel::GetSubBasinGroup(const int pp) const
 //
 CSubbasinGroup  *CModel::GetSubBasinGroup(const string name) const
 {
-  for(int pp=0;pp<_nSBGroups;pp++) {
-    if(!name.compare(_pSBGroups[pp]->GetName())) {
-      return _pSBGroups[pp];
-    }
-  }
-  return NULL;
+  unordered_map<string,int>::const_iterator it=_SBGroupIndex.find(name);
+  if (it==_SBGroupIndex.end()){return NULL;}
+  return _pSBGroups[it->second];
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Returns true if subbasin with subbasin ID SBID is in specified subbasin Group
@@ -752,10 +802,9 @@ int         CModel::GetLakeStorageIndex() const{return _lake_sv;}
 //
 int  CModel::GetGaugeIndexFromName (const string name) const
 {
-  for (int g=0;g<_nGauges;g++){
-    if (name==_pGauges[g]->GetName()){return g;}
-  }
-  return DOESNT_EXIST;
+  unordered_map<string,int>::const_iterator it=_GaugeIndex.find(name);
+  if (it==_GaugeIndex.end()){return DOESNT_EXIST;}
+  return it->second;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -821,6 +870,8 @@ double CModel::GetLatFlow(const int qs,const optStruct &Options) const
 /// \param i [in] index of storage compartment
 /// \param to [in] true if evaluating cumulative flux to storage compartment, false for 'from'
 /// \return cumulative flux to storage compartment i in hru K
+/// \remark only the connections to/from i and the lateral connections of HRU k are visited (see InitializeFluxIndex);
+/// these are merged by process index, such that the sum is accumulated in process connection order
 //
 double CModel::GetCumulativeFlux(const int k, const int i, const bool to) const
 {
@@ -828,28 +879,23 @@ double CModel::GetCumulativeFlux(const int k, const int i, const bool to) const
   ExitGracefullyIf((k<0) || (k>=_nHydroUnits),"CModel::GetCumulativeFlux: bad HRU index",RUNTIME_ERR);
   ExitGracefullyIf((i<0) || (i>=_nStateVars),"CModel::GetCumulativeFlux: bad state var index",RUNTIME_ERR);
 #endif
-  int js=0;
+  const flux_index &F=_FluxIndex;
+  const int *conn=(to) ? F.to_conn  : F.from_conn;
+  int        n   =(to) ? F.to_start[i]   : F.from_start[i];
+  int        nend=(to) ? F.to_start[i+1] : F.from_start[i+1];
+  int        m   =F.lat_start[k];
+  int        mend=F.lat_start[k+1];
   double sum=0;
   double area=_pHydroUnits[k]->GetArea();
-  int jss=0;
-  for(int j = 0; j < _nProcesses; j++)
+  while ((n<nend) || (m<mend))
   {
-    for(int q = 0; q < _pProcesses[j]->GetNumConnections(); q++)//each process may have multiple connections
-    {
-      if(( to) && (_pProcesses[j]->GetToIndices()[q]   == i)){ sum+=_aCumulativeBal[k][js]; }
-      if((!to) && (_pProcesses[j]->GetFromIndices()[q] == i)){ sum+=_aCumulativeBal[k][js]; }
-      js++;
+    if ((m>=mend) || ((n<nend) && (F.conn_proc[conn[n]]<=F.lat_proc[m]))){//in-HRU connections of process j precede its lateral connections
+      sum+=_aCumulativeBal[k][conn[n]];
+      n++;
     }
-
-    if(_pProcesses[j]->GetNumLatConnections()>0)
-    {
-      CLateralExchangeProcessABC *pProc=(CLateralExchangeProcessABC*)_pProcesses[j];
-      for(int q = 0; q < _pProcesses[j]->GetNumLatConnections(); q++)//each process may have multiple connections
-      {
-        if(( to) && (pProc->GetToHRUIndices()[q]  ==k) && (pProc->GetLateralToIndices()[q]  ==i)){sum+=_aCumulativeLatBal[jss]/area; }
-        if((!to) && (pProc->GetFromHRUIndices()[q]==k) && (pProc->GetLateralFromIndices()[q]==i)){sum+=_aCumulativeLatBal[jss]/area; }
-        jss++;
-      }
+    else{
+      if ((F.lat_to[m]==to) && (F.lat_sv[m]==i)){sum+=_aCumulativeLatBal[F.lat_conn[m]]/area; }
+      m++;
     }
   }
 
@@ -869,21 +915,23 @@ double CModel::GetCumulFluxBetween(const int k,const int iFrom,const int iTo) co
   ExitGracefullyIf((k<0) || (k>=_nHydroUnits),"CModel::GetCumulativeFlux: bad HRU index",RUNTIME_ERR);
   ExitGracefullyIf((iFrom<0) || (iTo>=_nStateVars),"CModel::GetCumulativeFlux: bad state var index",RUNTIME_ERR);
 #endif
-  int q,js=0;
+  //merges connections to iTo (from iFrom) and from iTo (to iFrom), both in connection order
+  const flux_index &F=_FluxIndex;
+  int n   =F.to_start  [iTo], nend=F.to_start  [iTo+1];
+  int m   =F.from_start[iTo], mend=F.from_start[iTo+1];
+  int js;
   double sum=0;
-  const int *iFromp;
-  const int *iTop;
-  int nConn;
-  for(int j = 0; j < _nProcesses; j++)
+  while ((n<nend) || (m<mend))
   {
-    iFromp=_pProcesses[j]->GetFromIndices();
-    iTop  =_pProcesses[j]->GetToIndices();
-    nConn =_pProcesses[j]->GetNumConnections();
-    for (q = 0; q < nConn; q++)//each process may have multiple connections
-    {
-      if( (iTop  [q]== iTo) && (iFromp[q]== iFrom)){ sum+=_aCumulativeBal[k][js]; }
-      if( (iFromp[q]== iTo) && (iTop  [q]== iFrom)){ sum-=_aCumulativeBal[k][js]; }
-      js++;
+    if ((m>=mend) || ((n<nend) && (F.to_conn[n]<=F.from_conn[m]))){
+      js=F.to_conn[n];
+      if (F.conn_from[js]==iFrom){ sum+=_aCumulativeBal[k][js]; }
+      n++;
+    }
+    else{
+      js=F.from_conn[m];
+      if (F.conn_to  [js]==iFrom){ sum-=_aCumulativeBal[k][js]; }
+      m++;
     }
   }
 
@@ -1171,6 +1219,77 @@ double CModel::GetTotalRivuletStorage() const
 
   return sum/(_WatershedArea*M2_PER_KM2)*MM_PER_METER;
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Computes all watershed-wide aggregates reported in minor output (_WshedAgg) in one sweep over HRUs and one over subbasins
+/// \details Area-weighted sums of every state variable, precipitation and snowfall are accumulated sequentially within blocks of
+/// WSHED_AGG_BLOCK HRUs, read directly from the current state matrix. Blocks are processed in parallel if :NumThreads>1, then
+/// block sums are combined by pairwise summation in a fixed order, so that results do not depend upon the number of threads.
+/// For models with up to WSHED_AGG_BLOCK HRUs, results are identical to GetAvgStateVar(), GetAveragePrecip(), GetAverageSnowfall(),
+/// GetTotalChannelStorage(), GetTotalReservoirStorage() and GetTotalRivuletStorage()
+//
+void CModel::UpdateWatershedAggregates()
+{
+  int i,b;
+  const int nCols  =_nStateVars+2;   //state variables, precip, snowfall
+  const int nBlocks=max((_nHydroUnits+WSHED_AGG_BLOCK-1)/WSHED_AGG_BLOCK,1);
+  int nThreads=1;
+  if (_pOptStruct!=NULL){nThreads=max(_pOptStruct->num_threads,1);}
+
+  if (_WshedAgg.nStateVars!=_nStateVars){
+    delete [] _WshedAgg.aAvgStateVar;
+    _WshedAgg.nStateVars  =_nStateVars;
+    _WshedAgg.aAvgStateVar=new double [_nStateVars];
+  }
+  vector<double> aBlockSum((size_t)(nBlocks)*nCols,0.0);
+
+  //sequential sums within blocks of HRUs
+  //--------------------------------------------------------------
+  #pragma omp parallel for num_threads(nThreads) schedule(static) if((nThreads>1) && (nBlocks>1))
+  for (b=0;b<nBlocks;b++)
+  {
+    double *sum=&aBlockSum[(size_t)(b)*nCols];
+    int kend=min((b+1)*WSHED_AGG_BLOCK,_nHydroUnits);
+    for (int k=b*WSHED_AGG_BLOCK;k<kend;k++)
+    {
+      const CHydroUnit *pHRU=_pHydroUnits[k];
+      if (!pHRU->IsEnabled()){continue;}
+      double              area=pHRU->GetArea();
+      const double       *S   =_aStateMatrix[0]+(size_t)(k)*_SVStride;
+      const force_struct *F   =pHRU->GetForcingFunctions();
+      for (int j=0;j<_nStateVars;j++){sum[j]+=(S[j]*area);}
+      sum[_nStateVars  ]+=F->precip*area;
+      sum[_nStateVars+1]+=(F->precip*F->snow_frac)*area;
+    }
+  }
+
+  //pairwise combination of block sums (result in block 0)
+  //--------------------------------------------------------------
+  for (int stride=1;stride<nBlocks;stride*=2)
+  {
+    for (b=0;b+stride<nBlocks;b+=2*stride)
+    {
+      double       *sum =&aBlockSum[(size_t)(b       )*nCols];
+      const double *sum2=&aBlockSum[(size_t)(b+stride)*nCols];
+      for (i=0;i<nCols;i++){sum[i]+=sum2[i];}
+    }
+  }
+  for (i=0;i<_nStateVars;i++){_WshedAgg.aAvgStateVar[i]=aBlockSum[i]/_WatershedArea;}
+  _WshedAgg.precip  =aBlockSum[_nStateVars  ]/_WatershedArea;
+  _WshedAgg.snowfall=aBlockSum[_nStateVars+1]/_WatershedArea;
+
+  //channel, reservoir and rivulet storage
+  //--------------------------------------------------------------
+  double chan(0),res(0),riv(0);
+  for (int p=0;p<_nSubBasins;p++)
+  {
+    chan+=_pSubBasins[p]->GetChannelStorage();  //[m3]
+    res +=_pSubBasins[p]->GetReservoirStorage();//[m3]
+    riv +=_pSubBasins[p]->GetRivuletStorage();  //[m3]
+  }
+  _WshedAgg.channel_stor  =chan/(_WatershedArea*M2_PER_KM2)*MM_PER_METER;
+  _WshedAgg.reservoir_stor=res /(_WatershedArea*M2_PER_KM2)*MM_PER_METER;
+  _WshedAgg.rivulet_stor  =riv /(_WatershedArea*M2_PER_KM2)*MM_PER_METER;
+}
 
 
 /*****************************************************************
@@ -1186,6 +1305,7 @@ void CModel::AddHRU(CHydroUnit *pHRU)
 {
   if (!DynArrayAppend((void**&)(_pHydroUnits),(void*)(pHRU),_nHydroUnits)){
     ExitGracefully("CModel::AddHRU: adding NULL HRU",BAD_DATA);}
+  _HRUIndexByID.insert(make_pair((long)(pHRU->GetID()),_nHydroUnits-1)); //retains first if repeated; caught in Initialize
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1195,14 +1315,12 @@ void CModel::AddHRU(CHydroUnit *pHRU)
 //
 void CModel::AddHRUGroup(CHRUGroup *pHRUGroup)
 {
-  for(int kk=0;kk<_nHRUGroups;kk++){
-    if(pHRUGroup->GetName()==_pHRUGroups[kk]->GetName()){
-      WriteWarning("CModel::AddHRUGroups: cannot add two HRU groups with the same name. Group "+pHRUGroup->GetName()+ " is duplicated in input.",true);
-      break;
-    }
+  if (_HRUGroupIndex.count(pHRUGroup->GetName())>0){
+    WriteWarning("CModel::AddHRUGroups: cannot add two HRU groups with the same name. Group "+pHRUGroup->GetName()+ " is duplicated in input.",true);
   }
   if (!DynArrayAppend((void**&)(_pHRUGroups),(void*)(pHRUGroup),_nHRUGroups)){
     ExitGracefully("CModel::AddHRUGroup: adding NULL HRU Group",BAD_DATA);}
+  _HRUGroupIndex.insert(make_pair(pHRUGroup->GetName(),_nHRUGroups-1));
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1214,6 +1332,7 @@ void CModel::AddSubBasin(CSubBasin *pSB)
 {
   if (!DynArrayAppend((void**&)(_pSubBasins),(void*)(pSB),_nSubBasins)){
     ExitGracefully("CModel::AddSubBasin: adding NULL HRU",BAD_DATA);}
+  _SBIndexByID.insert(make_pair(pSB->GetID(),_nSubBasins-1)); //retains first if repeated; caught in Initialize
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1223,15 +1342,13 @@ void CModel::AddSubBasin(CSubBasin *pSB)
 //
 void CModel::AddSubBasinGroup(CSubbasinGroup *pSBGroup)
 {
-  for(int pp=0;pp<_nSBGroups;pp++) {
-    if(pSBGroup->GetName()==_pSBGroups[pp]->GetName()) {
-      WriteWarning("CModel::AddSubBasinGroup: cannot add two Subbasin groups with the same name. Group "+pSBGroup->GetName()+ " is duplicated in input.",true);
-      break;
-    }
+  if(_SBGroupIndex.count(pSBGroup->GetName())>0) {
+    WriteWarning("CModel::AddSubBasinGroup: cannot add two Subbasin groups with the same name. Group "+pSBGroup->GetName()+ " is duplicated in input.",true);
   }
   if(!DynArrayAppend((void**&)(_pSBGroups),(void*)(pSBGroup),_nSBGroups)) {
     ExitGracefully("CModel::AddSubBasinGroup: adding NULL SubBasin Group",BAD_DATA);
   }
+  _SBGroupIndex.insert(make_pair(pSBGroup->GetName(),_nSBGroups-1));
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1243,6 +1360,7 @@ void CModel::AddGauge  (CGauge *pGage)
 {
   if (!DynArrayAppend((void**&)(_pGauges),(void*)(pGage),_nGauges)){
     ExitGracefully("CModel::AddGauge: adding NULL Gauge",BAD_DATA);}
+  _GaugeIndex.insert(make_pair(pGage->GetName(),_nGauges-1));
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1264,6 +1382,7 @@ void CModel::AddForcingGrid  (CForcingGrid *pGrid, forcing_type typ)
     }
     _pForcingGrids[f]=pGrid;
   }
+  _ForcingPlan.valid=false; //grid list changed; plan must be rebuilt
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1312,14 +1431,26 @@ void CModel::AddPropertyClassChange(const string      HRUgroup,
     ExitGracefullyIf(pCC->HRU_groupID == DOESNT_EXIST,warning.c_str(),BAD_DATA_WARN); return;
   }
   pCC->newclass=new_class;
-  if ((tclass == CLASS_LANDUSE) && (CLandUseClass::StringToLUClass(new_class) == NULL)){
-    ExitGracefully("CModel::AddPropertyClassChange: invalid land use class specified",BAD_DATA_WARN);return;
+  pCC->pLUClass =NULL;
+  pCC->pVegClass=NULL;
+  pCC->HRUtype  =HRU_INVALID_TYPE;
+  if (tclass == CLASS_LANDUSE){
+    pCC->pLUClass=CLandUseClass::StringToLUClass(new_class);
+    if (pCC->pLUClass == NULL){
+      ExitGracefully("CModel::AddPropertyClassChange: invalid land use class specified",BAD_DATA_WARN);return;
+    }
   }
-  if ((tclass == CLASS_VEGETATION) && (CVegetationClass::StringToVegClass(new_class) == NULL)){
-    ExitGracefully("CModel::AddPropertyClassChange: invalid vegetation class specified",BAD_DATA_WARN);return;
+  if (tclass == CLASS_VEGETATION){
+    pCC->pVegClass=CVegetationClass::StringToVegClass(new_class);
+    if (pCC->pVegClass == NULL){
+      ExitGracefully("CModel::AddPropertyClassChange: invalid vegetation class specified",BAD_DATA_WARN);return;
+    }
   }
-  if ((tclass == CLASS_HRUTYPE) && (StringToHRUType(new_class) == HRU_INVALID_TYPE)){
-    ExitGracefully("CModel::AddPropertyClassChange: invalid HRU type specified",BAD_DATA_WARN);return;
+  if (tclass == CLASS_HRUTYPE){
+    pCC->HRUtype=StringToHRUType(new_class);
+    if (pCC->HRUtype == HRU_INVALID_TYPE){
+      ExitGracefully("CModel::AddPropertyClassChange: invalid HRU type specified",BAD_DATA_WARN);return;
+    }
   }
 
   pCC->tclass=tclass;
@@ -1588,6 +1719,51 @@ void CModel::SetEnsembleMode(CEnsemble *pEnsemble) {
   _pEnsemble=pEnsemble;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Allocates contiguous, cache-line-aligned state matrices and makes HRU state arrays views into the current one
+/// \remark called once from Initialize, after all state variables and HRUs are known; state values already set in HRUs are retained
+//
+void CModel::AllocateStateMatrix()
+{
+  const int nPerLine=STATE_MATRIX_ALIGN/(int)(sizeof(double));
+  size_t    size;
+  int       b,i,k;
+
+  _SVStride=((_nStateVars+nPerLine-1)/nPerLine)*nPerLine;
+  size     =(size_t)(_nHydroUnits)*(size_t)(_SVStride);
+
+  for (b=0;b<N_STATE_BUFFERS;b++)
+  {
+    delete [] _aStateMatrixMem[b];
+    _aStateMatrixMem[b]=new double [size+nPerLine];
+    ExitGracefullyIf(_aStateMatrixMem[b]==NULL,"CModel::AllocateStateMatrix",OUT_OF_MEMORY);
+    _aStateMatrix[b]=(double*)((((size_t)(_aStateMatrixMem[b]))+STATE_MATRIX_ALIGN-1)/STATE_MATRIX_ALIGN*STATE_MATRIX_ALIGN);
+    for (i=0;i<(int)(size);i++){_aStateMatrix[b][i]=0.0;}
+  }
+  for (k=0;k<_nHydroUnits;k++){
+    _pHydroUnits[k]->SetStateVarView(_aStateMatrix[0]+k*_SVStride);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Makes state matrix b the current model state by pointer swap with state matrix 0
+/// \remark HRU state arrays are redirected to the rows of the new current state matrix; no state values are copied
+///
+/// \param b [in] index of state matrix which becomes the current state (1 to N_STATE_BUFFERS-1)
+//
+void CModel::SwapStateMatrix(const int b)
+{
+#ifdef _STRICTCHECK_
+  ExitGracefullyIf((b<=0) || (b>=N_STATE_BUFFERS),"CModel SwapStateMatrix::improper index",BAD_DATA);
+#endif
+  double *tmp;
+  tmp=_aStateMatrix   [0]; _aStateMatrix   [0]=_aStateMatrix   [b]; _aStateMatrix   [b]=tmp;
+  tmp=_aStateMatrixMem[0]; _aStateMatrixMem[0]=_aStateMatrixMem[b]; _aStateMatrixMem[b]=tmp;
+  for (int k=0;k<_nHydroUnits;k++){
+    _pHydroUnits[k]->SetStateVarView(_aStateMatrix[0]+k*_SVStride,false);
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Sets PET blend values
 //
@@ -1848,12 +2024,19 @@ void CModel::UpdateTransientParams(const optStruct   &Options,
   int nn=(int)((tt.model_time+REAL_SMALL)/Options.timestep);//current timestep index
   for (int j=0;j<_nTransParams;j++)
   {
-    class_type ctype=_pTransParams[j]->GetParameterClassType();
-    string     pname=_pTransParams[j]->GetParameterName();
-    string     cname=_pTransParams[j]->GetParameterClass();
     double     value=_pTransParams[j]->GetTimeSeries()->GetSampledValue(nn);
+    if (value==RAV_BLANK_DATA){continue;}
+
+    if ((_aTransParamAddr!=NULL) && (_aTransParamAddr[j]!=NULL)){
+      *(_aTransParamAddr[j])=value; //precompiled in InitializeTransientParams()
+    }
+    else{
+      class_type ctype=_pTransParams[j]->GetParameterClassType();
+      string     pname=_pTransParams[j]->GetParameterName();
+      string     cname=_pTransParams[j]->GetParameterClass();
 
-    UpdateParameter(ctype,pname,cname,value);
+      UpdateParameter(ctype,pname,cname,value);
+    }
   }
 
   //--update land use and HRU types-----------------------------------------------
@@ -1872,18 +2055,15 @@ void CModel::UpdateTransientParams(const optStruct   &Options,
 
         if      (_pClassChanges[j]->tclass == CLASS_LANDUSE)
         {
-          CLandUseClass *lult_class= CLandUseClass::StringToLUClass(_pClassChanges[j]->newclass);
-          _pHydroUnits[k]->ChangeLandUse(lult_class);
+          _pHydroUnits[k]->ChangeLandUse(_pClassChanges[j]->pLUClass);
         }
         else if (_pClassChanges[j]->tclass == CLASS_VEGETATION)
         {
-          CVegetationClass *veg_class= CVegetationClass::StringToVegClass(_pClassChanges[j]->newclass);
-          _pHydroUnits[k]->ChangeVegetation(veg_class);
+          _pHydroUnits[k]->ChangeVegetation(_pClassChanges[j]->pVegClass);
         }
         else if (_pClassChanges[j]->tclass == CLASS_HRUTYPE)
         {
-          HRU_type typ=StringToHRUType(_pClassChanges[j]->newclass);
-          _pHydroUnits[k]->ChangeHRUType(typ);
+          _pHydroUnits[k]->ChangeHRUType(_pClassChanges[j]->HRUtype);
         }
 
         for(int j=0; j<_nProcesses;j++)// kt
@@ -1998,6 +2178,57 @@ void CModel::UpdateParameter(const class_type &ctype,const string pname,const st
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Returns address of model parameter, resolved once so that it may be updated directly during simulation
+///
+/// \param &ctype [in] parameter class type
+/// \param &pname [in] valid parameter name
+/// \param &cname [in] valid parameter class name (or SBID as string for CLASS_SUBBASIN or gauge ID as string for CLASS_GAUGE)
+/// \return address of parameter value, or NULL if the parameter has no single address (it must then be set using UpdateParameter())
+//
+double *CModel::GetParameterAddress(const class_type &ctype,const string pname,const string cname)
+{
+  if (ctype==CLASS_SOIL)
+  {
+    CSoilClass *pSoil=CSoilClass::StringToSoilClass(cname);
+    if (pSoil!=NULL){return pSoil->GetSoilPropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_VEGETATION)
+  {
+    CVegetationClass *pVeg=CVegetationClass::StringToVegClass(cname);
+    if (pVeg!=NULL){return pVeg->GetVegetationPropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_TERRAIN)
+  {
+    CTerrainClass *pTerr=CTerrainClass::StringToTerrainClass(cname);
+    if (pTerr!=NULL){return pTerr->GetTerrainPropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_LANDUSE)
+  {
+    CLandUseClass *pLU=CLandUseClass::StringToLUClass(cname);
+    if (pLU!=NULL){return pLU->GetSurfacePropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_GLOBAL)
+  {
+    return CGlobalParams::GetGlobalPropertyAddress(pname);
+  }
+  else if(ctype==CLASS_GAUGE)
+  {
+    int g=GetGaugeIndexFromName(cname);
+    if(g!=DOESNT_EXIST) {return _pGauges[g]->GetGaugePropertyAddress(pname);}
+  }
+  else if(ctype==CLASS_SUBBASIN)
+  {
+    long SBID=s_to_l(cname.c_str()); //class name should be SBID in this case
+    if( (strlen(cname.c_str())>8) && //also accept SUBBASIN32 instead of 32
+        (!strcmp(cname.substr(0,8).c_str(),"SUBBASIN")) ) {
+      SBID=s_to_l(cname.substr(8,strlen(cname.c_str())-8).c_str());
+    }
+    CSubBasin *pSB=GetSubBasinByID(SBID);
+    if (pSB!=NULL){return pSB->GetBasinPropertyAddress(pname);}
+  }
+  return NULL;
+}
+//////////////////////////////////////////////////////////////////
 /// \brief overrides global parameters in subbasin groups
 /// \notes called only from solver within HRU loop
 ///
@@ -2098,6 +2329,14 @@ void CModel::ApplyForcingPerturbation(const forcing_type ftype, force_struct &F,
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Clears modeled-value terms accumulated by diagnostic streams
+/// \remark Called at start of each simulation (ensemble member), before modeled time series are restarted
+//
+void CModel::ResetDiagnosticStreams()
+{
+  for (int d=0;d<_nDiagStreams;d++){_pDiagStreams[d]->Reset();}
+}
+//////////////////////////////////////////////////////////////////
 /// \brief Updates values stored in modeled time series of observation data
 /// modifies _pModeledTS[] time series and _aObsIndex array
 /// \param &Options [in] Global model options information
@@ -2111,40 +2350,37 @@ void CModel::UpdateDiagnostics(const optStruct   &Options,
   int n=(int)(floor((tt.model_time+TIME_CORRECTION)/Options.timestep));//current timestep index
 
   double     value, obsTime;
-  string     datatype;
-  sv_type    svtyp;
-  int        layer_ind;
   CSubBasin *pBasin=NULL;
 
   for (int i=0;i<_nObservedTS;i++)
   {
-    datatype=_pObservedTS[i]->GetName();
-    svtyp   =CStateVariable::StringToSVType(datatype,layer_ind,false);
+    const obs_binding &B=_aObsBinding[i];
+    if (B.p!=DOESNT_EXIST){pBasin=_pSubBasins[B.p];}
 
-    if      (datatype=="HYDROGRAPH")//===============================================
+    switch (B.target)
+    {
+    case (OBS_HYDROGRAPH)://============================================================
     {
-      pBasin=GetSubBasinByID (_pObservedTS[i]->GetLocID());
-
       if ((Options.ave_hydrograph) && (tt.model_time!=0)){
         value=pBasin->GetIntegratedOutflow(Options.timestep)/(Options.timestep*SEC_PER_DAY);
       }
       else{
         value=pBasin->GetOutflowRate();
       }
+      break;
     }
-    else if (datatype == "RESERVOIR_STAGE")//=======================================
+    case (OBS_RESERVOIR_STAGE)://=======================================================
     {
-      pBasin=GetSubBasinByID(_pObservedTS[i]->GetLocID());
       value = pBasin->GetReservoir()->GetResStage();
+      break;
     }
-    else if (datatype == "RESERVOIR_INFLOW")//======================================
+    case (OBS_RESERVOIR_INFLOW)://======================================================
     {
-      pBasin =  GetSubBasinByID(_pObservedTS[i]->GetLocID());
       value = pBasin->GetIntegratedReservoirInflow(Options.timestep)/(Options.timestep*SEC_PER_DAY);
+      break;
     }
-    else if (datatype == "RESERVOIR_NETINFLOW")//===================================
+    case (OBS_RESERVOIR_NETINFLOW)://===================================================
     {
-      pBasin = GetSubBasinByID(_pObservedTS[i]->GetLocID());
       CReservoir *pRes= pBasin->GetReservoir();
       double avg_area=0.0;
       if (pRes->GetHRUIndex()!=DOESNT_EXIST){ avg_area = _pHydroUnits[pRes->GetHRUIndex()]->GetArea(); }
@@ -2153,40 +2389,28 @@ void CModel::UpdateDiagnostics(const optStruct   &Options,
       double losses      = pRes->GetReservoirEvapLosses        (Options.timestep) / (Options.timestep*SEC_PER_DAY);
       losses            += pRes->GetReservoirGWLosses          (Options.timestep) / (Options.timestep*SEC_PER_DAY);
       value              = pBasin->GetIntegratedReservoirInflow(Options.timestep) / (Options.timestep*SEC_PER_DAY) + tem_precip1 - losses;
+      break;
     }
-    else if(datatype == "STREAM_CONCENTRATION")//=======================================
-    {
-      int c=_pObservedTS[i]->GetConstitInd();
-      int p=GetSubBasinIndex(_pObservedTS[i]->GetLocID());
-      value = _pTransModel->GetConstituentModel2(c)->GetOutflowConcentration(p);
-    }
-    else if(datatype == "STREAM_TEMPERATURE")//=======================================
-    {
-      int c=_pObservedTS[i]->GetConstitInd();
-      int p=GetSubBasinIndex(_pObservedTS[i]->GetLocID());
-      value = _pTransModel->GetConstituentModel2(c)->GetOutflowConcentration(p);
+    case (OBS_STREAM_CONCENTRATION)://==================================================
+    { //concentration or temperature
+      value = _pTransModel->GetConstituentModel2(B.c)->GetOutflowConcentration(B.p);
+      break;
     }
-    else if(datatype == "WATER_LEVEL")//=======================================
+    case (OBS_WATER_LEVEL)://===========================================================
     {
-      pBasin=GetSubBasinByID(_pObservedTS[i]->GetLocID());
       value = pBasin->GetWaterLevel();
+      break;
     }
-    else if (svtyp!=UNRECOGNIZED_SVTYPE)//==========================================
-    { //State variable
-      CHydroUnit *pHRU=NULL;
-      pHRU=GetHRUByID((int)(_pObservedTS[i]->GetLocID()));
-      string error="CModel::UpdateDiagnostics: Invalid HRU ID specified in observed state variable time series "+_pObservedTS[i]->GetName();
-      ExitGracefullyIf(pHRU==NULL,error.c_str(),BAD_DATA);
-      int sv_index=this->GetStateVarIndex(svtyp,layer_ind);
-      value       =pHRU->GetStateVarValue(sv_index);
+    case (OBS_STATE_VARIABLE)://========================================================
+    {
+      value = _pHydroUnits[B.k]->GetStateVarValue(B.i_sv);
+      break;
     }
-    else// ERROR ===================================================================
+    default:// invalid observation type (warning issued in BindObservation) ===========
     {
-      if (tt.model_time ==0){
-        string warn="CModel::UpdateDiagnostics: invalid tag ("+datatype+")used for specifying Observation type";
-        WriteWarning(warn.c_str(),BAD_DATA);
-      }
       value=0;
+      break;
+    }
     }
 
     _pModeledTS[i]->SetValue(n,value);
@@ -2210,6 +2434,13 @@ void CModel::UpdateDiagnostics(const optStruct   &Options,
       obsTime =_pObservedTS[i]->GetSampledTime(_aObsIndex[i]);
       //if(_pObservedTS[i]->GetType()==CTimeSeriesABC::TS_IRREGULAR) {obsTime+=Options.timestep;}
     }
+
+    //accumulate diagnostic terms of finalized modeled values (processed, and not overwritten by later time steps)
+    if (_pDiagStreams!=NULL){
+      for (int d=0;d<_nDiagPeriods;d++){
+        _pDiagStreams[d*_nObservedTS+i]->Update(_pObservedTS[i],_pModeledTS[i],min(_aObsIndex[i],n+1));
+      }
+    }
   }
 }
 //////////////////////////////////////////////////////////////////
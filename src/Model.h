@@ -28,6 +28,7 @@
 #include "ModelEnsemble.h"
 #include "GroundwaterModel.h"
 #include "GWSWProcesses.h"
+#include "NetCDFOutputBuffer.h"
 
 class CHydroProcessABC;
 class CGauge;
@@ -36,6 +37,221 @@ class CGroundwaterModel;
 class CTransportModel;
 class CEnsemble;
 class CForcingGrid;
+
+const int MAX_PLAN_AUX_GRIDS=9; ///< maximum number of additional (non precip/temp) gridded forcings in forcing plan
+const int N_STATE_BUFFERS   =4; ///< number of model-owned state matrices (current state + solver start-of-step, end-of-step, and previous iteration buffers)
+const int STATE_MATRIX_ALIGN=64;///< [bytes] alignment of state matrix rows (one cache line)
+const int WSHED_AGG_BLOCK   =1024;///< number of HRUs per block summed sequentially in CModel::UpdateWatershedAggregates (block sums are combined pairwise)
+
+////////////////////////////////////////////////////////////////////
+/// \brief Resolved table of gridded forcing sources used by UpdateHRUForcingFunctions
+/// \details Built once after initialization and refreshed only when the set of forcing grids
+/// changes (grids added, or derived grids regenerated when a new chunk is read), so the
+/// per-HRU forcing loop never searches the forcing grid list
+//
+struct forcing_plan
+{
+  bool          valid;            ///< true if plan reflects current forcing grids
+  bool          precip_gridded;   ///< true if precip, rainfall or snowfall is gridded input
+  bool          temp_gridded;     ///< true if temperature (ave, daily ave or daily min/max) is gridded input
+  bool          minmax_gridded;   ///< true if both daily min and max temperature are gridded input
+  bool          pet_gridded;      ///< true if PET is gridded input and used as data
+  bool          owpet_gridded;    ///< true if open water PET is gridded input and used as data
+
+  bool          pre_input;        ///< true if precip grid is read from file (not derived)
+  bool          rain_input;       ///< true if rainfall grid is read from file
+  bool          snow_input;       ///< true if snowfall grid is read from file
+  bool          tave_input;       ///< true if temperature grid is read from file
+  bool          daily_tave_input; ///< true if daily average temperature grid is read from file
+  bool          daily_tmin_input; ///< true if daily minimum temperature grid is read from file
+  bool          daily_tmax_input; ///< true if daily maximum temperature grid is read from file
+
+  CForcingGrid *pGrid_pre;        ///< precipitation grid (input or derived; NULL if unavailable)
+  CForcingGrid *pGrid_rain;       ///< rainfall grid
+  CForcingGrid *pGrid_snow;       ///< snowfall grid
+  CForcingGrid *pGrid_tave;       ///< temperature grid
+  CForcingGrid *pGrid_daily_tave; ///< daily average temperature grid
+  CForcingGrid *pGrid_daily_tmin; ///< daily minimum temperature grid
+  CForcingGrid *pGrid_daily_tmax; ///< daily maximum temperature grid
+
+  double        rain_corr;        ///< gridded rainfall correction factor
+  double        snow_corr;        ///< gridded snowfall correction factor
+  double        temp_corr;        ///< gridded temperature correction [C]
+
+  int           nAuxGrids;                              ///< number of additional gridded forcings (PET, wind, radiation, etc.)
+  CForcingGrid *pAuxGrid [MAX_PLAN_AUX_GRIDS];          ///< additional forcing grids [size: nAuxGrids]
+  double force_struct::*aAuxField[MAX_PLAN_AUX_GRIDS];  ///< force_struct member overwritten by each additional grid [size: nAuxGrids]
+
+  forcing_plan(){valid=false;nAuxGrids=0;}
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Structure-of-arrays store of HRU forcing functions
+/// \details One contiguous array per force_struct field, indexed by HRU. Field f of HRU k is
+/// data[f*nHRUs+k], where the field index of a force_struct member is FORCING_FIELD(member).
+/// Used by UpdateHRUForcingFunctions (with :BatchForcingUpdate) to pass forcings of a block of HRUs between
+/// correction stages; the forcings of each HRU are copied to the HRU (the view used by GetForcingFunctions())
+/// once complete. Without batching, each HRU is processed in a single force_struct and the store is not used
+//
+#define FORCING_FIELD(member) ((int)(offsetof(force_struct,member)/sizeof(double)))
+const int N_FORCING_FIELDS=(int)(sizeof(force_struct)/sizeof(double)); ///< number of fields in force_struct (all doubles)
+static_assert(std::is_standard_layout<force_struct>::value &&
+              (sizeof(force_struct)==N_FORCING_FIELDS*sizeof(double)) && (alignof(force_struct)==alignof(double)),
+              "forcing_store: force_struct must contain only doubles, as it is copied to/from the store as an array of doubles");
+
+struct forcing_store
+{
+  int     nHRUs;            ///< number of HRUs
+  double *data;             ///< forcing values [size: N_FORCING_FIELDS*nHRUs]
+  double *elev;             ///< HRU elevation [size: nHRUs]
+  double *ref_elev_temp;    ///< reference elevation of temperature data [size: nHRUs]
+  double *ref_elev_precip;  ///< reference elevation of precipitation data [size: nHRUs]
+  double *ref_meas_ht;      ///< reference measurement height of gauges [size: nHRUs]
+  int     nActive;          ///< number of enabled HRUs in current block
+  int    *active;           ///< indices of enabled HRUs in current block [size: nActive<=nHRUs]
+
+  forcing_store(){nHRUs=0;data=NULL;elev=ref_elev_temp=ref_elev_precip=ref_meas_ht=NULL;nActive=0;active=NULL;}
+  double *Field(const int f) {return data+f*nHRUs;} ///< contiguous array of field f [size: nHRUs]
+  void    Store(const int k,const force_struct &F){ ///< copies forcings of HRU k into store
+    const double *pF=(const double*)(&F);
+    for(int f=0;f<N_FORCING_FIELDS;f++) { data[f*nHRUs+k]=pF[f]; }
+  }
+  void    Load (const int k,force_struct &F) const{ ///< copies forcings of HRU k out of store
+    double *pF=(double*)(&F);
+    for(int f=0;f<N_FORCING_FIELDS;f++) { pF[f]=data[f*nHRUs+k]; }
+  }
+  void    Allocate(const int n){
+    Clear();
+    nHRUs=n;
+    data           =new double [N_FORCING_FIELDS*n];
+    elev           =new double [n];
+    ref_elev_temp  =new double [n];
+    ref_elev_precip=new double [n];
+    ref_meas_ht    =new double [n];
+    active         =new int    [n];
+  }
+  void    Clear(){
+    delete [] data;            data           =NULL;
+    delete [] elev;            elev           =NULL;
+    delete [] ref_elev_temp;   ref_elev_temp  =NULL;
+    delete [] ref_elev_precip; ref_elev_precip=NULL;
+    delete [] ref_meas_ht;     ref_meas_ht    =NULL;
+    delete [] active;          active         =NULL;
+    nHRUs=0; nActive=0;
+  }
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Watershed-wide aggregates reported in minor output, all computed in one sweep by CModel::UpdateWatershedAggregates
+//
+struct wshed_aggregates
+{
+  int     nStateVars;       ///< size of aAvgStateVar
+  double *aAvgStateVar;     ///< area-weighted average of each state variable [size: nStateVars]
+  double  precip;           ///< area-weighted average precipitation rate [mm/d]
+  double  snowfall;         ///< area-weighted average snowfall rate [mm/d]
+  double  channel_stor;     ///< total channel storage [mm]
+  double  reservoir_stor;   ///< total reservoir storage [mm]
+  double  rivulet_stor;     ///< total rivulet storage [mm]
+
+  wshed_aggregates(){nStateVars=0;aAvgStateVar=NULL;precip=snowfall=channel_stor=reservoir_stor=rivulet_stor=0.0;}
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Modeled quantity sampled by CModel::UpdateDiagnostics for an observation time series
+//
+enum obs_target
+{
+  OBS_HYDROGRAPH,            ///< subbasin outflow ("HYDROGRAPH")
+  OBS_RESERVOIR_STAGE,       ///< reservoir stage ("RESERVOIR_STAGE")
+  OBS_RESERVOIR_INFLOW,      ///< reservoir inflow ("RESERVOIR_INFLOW")
+  OBS_RESERVOIR_NETINFLOW,   ///< reservoir inflow plus precipitation less losses ("RESERVOIR_NETINFLOW")
+  OBS_STREAM_CONCENTRATION,  ///< subbasin outflow concentration or temperature ("STREAM_CONCENTRATION","STREAM_TEMPERATURE")
+  OBS_WATER_LEVEL,           ///< subbasin water level ("WATER_LEVEL")
+  OBS_STATE_VARIABLE,        ///< HRU state variable (e.g., "SNOW")
+  OBS_UNRECOGNIZED           ///< invalid observation type; modeled value is zero
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Binding of observation time series to modeled quantity, resolved once by CModel::InitializeObservations
+/// \details Replaces per-time step parsing of the observation name and subbasin/HRU ID lookup in UpdateDiagnostics
+//
+struct obs_binding
+{
+  obs_target target;   ///< modeled quantity
+  int        p;        ///< subbasin index (subbasin-linked observations, otherwise DOESNT_EXIST)
+  int        k;        ///< HRU index (state variable observations, otherwise DOESNT_EXIST)
+  int        i_sv;     ///< state variable index (state variable observations, otherwise DOESNT_EXIST)
+  int        c;        ///< constituent index (concentration/temperature observations, otherwise DOESNT_EXIST)
+};
+
+////////////////////////////////////////////////////////////////////
+/// \brief Inverse index of process connections, built once by CModel::InitializeFluxIndex
+/// \details Compressed lists of the in-HRU connections (columns js of _aCumulativeBal) to and from each state variable
+/// and of the lateral connections (entries jss of _aCumulativeLatBal) to and from each HRU, used by the cumulative
+/// flux queries (CModel::GetCumulativeFlux, GetCumulFluxBetween). Each list is stored in connection order, such that
+/// sums are accumulated in the same order as a scan of all process connections
+//
+struct flux_index
+{
+  int   nStateVars;  ///< number of state variables
+  int   nConn;       ///< number of in-HRU connections (_nTotalConnections)
+  int  *to_start;    ///< connections to state variable i are to_conn[to_start[i]...to_start[i+1]-1] [size: nStateVars+1]
+  int  *to_conn;     ///< connection index js of connections to each state variable [size: nConn]
+  int  *from_start;  ///< connections from state variable i are from_conn[from_start[i]...from_start[i+1]-1] [size: nStateVars+1]
+  int  *from_conn;   ///< connection index js of connections from each state variable [size: nConn]
+  int  *conn_proc;   ///< process index j of each connection js [size: nConn]
+  int  *conn_from;   ///< 'from' state variable index of each connection js [size: nConn]
+  int  *conn_to;     ///< 'to' state variable index of each connection js [size: nConn]
+
+  int   nHRUs;       ///< number of HRUs
+  int  *lat_start;   ///< lateral connections of HRU k are entries lat_start[k]...lat_start[k+1]-1 [size: nHRUs+1]
+  int  *lat_conn;    ///< lateral connection index jss of each entry [size: 2*_nTotalLatConnections]
+  int  *lat_proc;    ///< process index j of each entry
+  int  *lat_sv;      ///< state variable index (in HRU k) of each entry
+  bool *lat_to;      ///< true if entry is a connection to HRU k, false if from HRU k
+
+  flux_index(){nStateVars=nConn=nHRUs=0;
+    to_start=to_conn=from_start=from_conn=conn_proc=conn_from=conn_to=NULL;
+    lat_start=lat_conn=lat_proc=lat_sv=NULL; lat_to=NULL;}
+  void Clear(){
+    delete [] to_start;   to_start  =NULL;  delete [] to_conn;   to_conn  =NULL;
+    delete [] from_start; from_start=NULL;  delete [] from_conn; from_conn=NULL;
+    delete [] conn_proc;  conn_proc =NULL;  delete [] conn_from; conn_from=NULL;  delete [] conn_to; conn_to=NULL;
+    delete [] lat_start;  lat_start =NULL;  delete [] lat_conn;  lat_conn =NULL;
+    delete [] lat_proc;   lat_proc  =NULL;  delete [] lat_sv;    lat_sv   =NULL;  delete [] lat_to;  lat_to =NULL;
+    nStateVars=nConn=nHRUs=0;
+  }
+};
+
+const int  RVC_SNAPSHOT_VERSION   =1;         ///< version of binary snapshot (.rvc.bin) format
+const char RVC_SNAPSHOT_MAGIC[8]  ="RVNSNAP"; ///< first bytes of every binary snapshot file
+const int  RVC_SNAPSHOT_BYTEORDER =0x01020304;///< written as native int; any other value read back indicates a byte order mismatch
+
+////////////////////////////////////////////////////////////////////
+/// \brief Fixed-size header of binary snapshot (.rvc.bin) file, written/read by CModel::WriteBinarySnapshot/ReadBinarySnapshot
+/// \details The header is followed by a flat array of nValues doubles: the model structure (state variable types and layers,
+/// HRU IDs, subbasin IDs and routing array sizes, constituent types), then the HRU state matrix (nHRUs rows of nStateVars),
+/// then subbasin and constituent routing states. The payload layout is fully determined by the structure block, so the HRU
+/// state block may be read or memory-mapped in place at a fixed offset
+//
+struct snapshot_header
+{
+  char               magic[8];      ///< RVC_SNAPSHOT_MAGIC
+  int                version;       ///< RVC_SNAPSHOT_VERSION
+  int                byte_order;    ///< RVC_SNAPSHOT_BYTEORDER, as written on writing machine
+  int                nHRUs;         ///< number of HRUs
+  int                nStateVars;    ///< number of state variables
+  int                nSubBasins;    ///< number of subbasins
+  int                nConstituents; ///< number of transported constituents
+  int                year;          ///< year of snapshot time stamp
+  int                unused;        ///< padding (zero)
+  double             julian_day;    ///< julian day of snapshot time stamp
+  long long          nValues;       ///< number of doubles in payload
+  unsigned long long checksum;      ///< FNV-1a hash of payload
+  unsigned long long rvc_checksum;  ///< FNV-1a hash of companion .rvc text file written with snapshot
+};
+
 ////////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for water surface model
 /// \details Stores and organizes HRUs and basins, provides access to all
@@ -57,11 +273,17 @@ private:/*------------------------------------------------------*/
   CSubbasinGroup   **_pSBGroups;  ///< Array of pointers to Subbasin groups
 
   int               _nSubBasins;  ///< number of subbasins
+  unordered_map<long,int>    _SBIndexByID;  ///< index p of subbasin with each subbasin ID (first added, if IDs repeated)
+  unordered_map<long,int>   _HRUIndexByID;  ///< global index k of HRU with each HRU ID (first added, if IDs repeated)
+  unordered_map<string,int> _HRUGroupIndex;  ///< index kk of HRU group with each name
+  unordered_map<string,int>  _SBGroupIndex;  ///< index pp of subbasin group with each name
+  unordered_map<string,int>    _GaugeIndex;  ///< index g of gauge with each name
   CSubBasin       **_pSubBasins;  ///< array of pointers to subbasins [size:_nSubBasins]; each subbasin includes multiple HRUs/HydroUnits
   int          *_aSubBasinOrder;  ///< stores order of subbasin for routing [size:_nSubBasins] (may be relegated to local variable in InitializeRoutingNetwork)
   int         _maxSubBasinOrder;  ///< stores maximum subasin order for routing (may be relegated to local variable in InitializeRoutingNetwork)
   int           *_aOrderedSBind;  ///< stores list of subbasin indices ordered upstream to downstream [size:_nSubBasins]
   int         *_aDownstreamInds;  ///< stores list of downstream indices of basins (for speed) [size:_nSubBasins]
+  int             *_aLevelStart;  ///< index in _aOrderedSBind of first basin in each routing level (level 0= highest order) [size:_maxSubBasinOrder+2]
 
   int               _nStateVars;  ///< number of state variables: water and energy storage units, snow density, etc.
   sv_type       *_aStateVarType;  ///< type of state variable in unit i  [size:_nStateVars]
@@ -70,18 +292,24 @@ private:/*------------------------------------------------------*/
 
   int                _nSoilVars;  ///< number of soil layer storage units
 
+  int                 _SVStride;  ///< row length of state matrices, padded to a whole number of cache lines
+  double *_aStateMatrix   [N_STATE_BUFFERS]; ///< contiguous, cache-line-aligned state matrices [_nHydroUnits x _SVStride]; HRU state arrays are views into rows of _aStateMatrix[0]
+  double *_aStateMatrixMem[N_STATE_BUFFERS]; ///< unaligned allocations underlying _aStateMatrix
+
   int               _nProcesses;  ///< number of hydrological processes that move water, mass, or energy from one storage unit to another
   CHydroProcessABC**_pProcesses;  ///< Array of pointers to hydrological processes
   bool   **_aShouldApplyProcess;  ///< array of flags for whether or not each process applies to each HRU [_nProcesses][_nHydroUnits]
 
   int                  _nGauges;  ///< number of precip/temp gauges for forcing interpolation
   CGauge             **_pGauges;  ///< array of pointers to gauges which store time series info [size:_nGauges]
-  double       **_aGaugeWeights;  ///< array of weights for each gauge/HRU pair [_nHydroUnits][_nGauges]
-  double        **_aGaugeWtTemp;
-  double      **_aGaugeWtPrecip;
+  csr_weights     _GaugeWeights;  ///< sparse weights for each HRU/gauge pair [_nHydroUnits][_nGauges] ('other' forcings)
+  csr_weights      _GaugeWtTemp;  ///< sparse weights for each HRU/gauge pair [_nHydroUnits][_nGauges] (temperature)
+  csr_weights    _GaugeWtPrecip;  ///< sparse weights for each HRU/gauge pair [_nHydroUnits][_nGauges] (precipitation)
 
   int            _nForcingGrids;  ///< number of gridded forcing input data
   CForcingGrid **_pForcingGrids;  ///< gridded input data [size: _nForcingGrids]
+  forcing_plan     _ForcingPlan;  ///< resolved gridded forcing sources, rebuilt when forcing grids change
+  forcing_store   _ForcingStore;  ///< structure-of-arrays HRU forcings used during forcing update
 
   int                 _UTM_zone;  ///< model-wide UTM zone used for interpolation
 
@@ -89,6 +317,7 @@ private:/*------------------------------------------------------*/
 
   int                 _nTransParams;  ///< number of transient parameters
   CTransientParam   **_pTransParams;  ///< array of pointers to transient parameters with time series
+  double           **_aTransParamAddr;///< precompiled address of each transient parameter (NULL if updated by name) [size: _nTransParams]
   int                _nClassChanges;  ///< number of HRU Group class changes
   class_change     **_pClassChanges;  ///< array of pointers to class_changes
   int              _nParamOverrides;  ///< number of local parameter overrides
@@ -104,6 +333,7 @@ private:/*------------------------------------------------------*/
   CTimeSeries     **_pModeledTS;  ///< array of pointers of modeled time series corresponding to observations [size: _nObservedTS]
   int              _nObservedTS;  ///< number of observation time series
   int               *_aObsIndex;  ///< index of the next unprocessed observation
+  obs_binding     *_aObsBinding;  ///< modeled quantity corresponding to each observation time series [size: _nObservedTS]
 
   CTimeSeriesABC**_pObsWeightTS;  ///< array of pointers of observation weight time series [size: _nObsWeightTS]
   int             _nObsWeightTS;  ///< number of observation weight time series
@@ -114,6 +344,8 @@ private:/*------------------------------------------------------*/
   int             _nDiagPeriods;  ///< number of diagnostic periods
   agg_diag   **_pAggDiagnostics;  ///< array of pointers to aggregate diagnostic structures [size: _nAggDiagnostics]
   int          _nAggDiagnostics;  ///< number of aggregated diagnostics
+  CDiagnosticStream **_pDiagStreams; ///< streaming diagnostics of each period and observation [d*_nObservedTS+i] [size: _nDiagStreams] (NULL w/o diagnostics)
+  int             _nDiagStreams;  ///< number of diagnostic streams (_nDiagPeriods*_nObservedTS)
 
   //Data Assimilation
   double             *_aDAscale; ///< array of data assimilation flow scaling parameters [size: _nSubBasins] (NULL w/o DA)
@@ -133,9 +365,12 @@ private:/*------------------------------------------------------*/
   double    *_aCumulativeLatBal;  ///< cumulative amount of flowthrough [mm-m2 or MJ or mg] for each lateral process connection [j**]
   double          *_aFlowLatBal;  ///< current time step flowthrough [mm-m2 or MJ or mg] for each lateral process connection [j**]
   int     _nTotalLatConnections;  ///< total number of between-HRU connections in model
+  flux_index         _FluxIndex;  ///< inverse index of process connections by state variable and HRU (see InitializeFluxIndex)
   double            _CumulInput;  ///< cumulative water added to watershed (precipitation, basin inflows, etc.) [mm]
   double           _CumulOutput;  ///< cumulative outflow of water from system [mm]
   double             _initWater;  ///< initial water in system [mm]
+  wshed_aggregates    _WshedAgg;  ///< watershed-wide aggregates of current output time step (see UpdateWatershedAggregates)
+  vector<double>   _aCheckpoint;  ///< in-memory copy of model state (see SaveCheckpoint); empty if none saved
 
   //Output
   CCustomOutput**_pCustomOutputs; ///< Array of pointers to custom output objects
@@ -151,6 +386,13 @@ private:/*------------------------------------------------------*/
   int              _STORAGE_ncid; ///< output file ID for WatershedStorage.nc
   int             _FORCINGS_ncid; ///< output file ID for ForcingFunctions.nc
   int                _RESMB_ncid; ///< output file ID for ReservoirMassBalance.nc
+  CNetCDFOutputBuffer   *_pHYDRO_ncbuf; ///< buffered writer for Hydrographs.nc (or NULL)
+  CNetCDFOutputBuffer*_pRESSTAGE_ncbuf; ///< buffered writer for ReservoirStages.nc (or NULL)
+  CNetCDFOutputBuffer *_pSTORAGE_ncbuf; ///< buffered writer for WatershedStorage.nc (or NULL)
+  CNetCDFOutputBuffer*_pFORCINGS_ncbuf; ///< buffered writer for ForcingFunctions.nc (or NULL)
+  CNetCDFOutputBuffer   *_pRESMB_ncbuf; ///< buffered writer for ReservoirMassBalance.nc (or NULL)
+  int         *_aHydroObsIndex; ///< index of continuous flow observation time series of each gauged basin in Hydrographs.nc (or DOESNT_EXIST) [size: #gauged basins]
+  int         *_aStageObsIndex; ///< index of continuous stage observation time series of each gauged reservoir in ReservoirStages.nc (or DOESNT_EXIST) [size: #gauged reservoirs]
 
   double          *_aOutputTimes; ///< array of model major output times (LOCAL times at which full solution is written)
   int              _nOutputTimes; ///< size of array of model major output times
@@ -168,9 +410,12 @@ private:/*------------------------------------------------------*/
   double          *_PotMeltBlends_wts;
 
   //initialization subroutines:
-  void           GenerateGaugeWeights (double **&aWts, const forcing_type forcing, const optStruct 	 &Options);
+  void           GenerateGaugeWeights (csr_weights &W, const forcing_type forcing, const optStruct 	 &Options);
   void       InitializeRoutingNetwork ();
+  void            InitializeFluxIndex ();
   void         InitializeObservations (const optStruct 	 &Options);
+  obs_binding        BindObservation (const CTimeSeriesABC *pObs, const optStruct &Options) const;
+  void    InitializeDiagnosticStreams (const optStruct   &Options);
   void     InitializeDataAssimilation (const optStruct   &Options);
 
   void      WriteEnsimStandardHeaders (const optStruct 	 &Options);
@@ -180,12 +425,17 @@ private:/*------------------------------------------------------*/
   void         WriteNetcdfMinorOutput (const optStruct   &Options,
                                        const time_struct &tt);
   void    InitializeParameterOverrides();
+  void    InitializeTransientParams   ();
+  double *GetParameterAddress         (const class_type &ctype,
+                                       const string      pname,
+                                       const string      cname);
 
   //private routines used during simulation:
   force_struct      GetAverageForcings() const;
   double       GetTotalChannelStorage () const;
   double      GetTotalReservoirStorage() const;
   double       GetTotalRivuletStorage () const;
+  void      UpdateWatershedAggregates ();
 
   void                     CorrectPET(const optStruct &Options,
                                       force_struct &F,
@@ -241,14 +491,25 @@ private:/*------------------------------------------------------*/
                                       const force_struct* F,
                                       const optStruct& Options);
 
+  //batch versions operating on all active HRUs in _ForcingStore:
+  void               CorrectTempBatch(const optStruct    &Options,
+                                      const time_struct  &tt);
+  void CalculateSubDailyCorrectionBatch(const optStruct  &Options,
+                                      const time_struct  &tt);
+  void      EstimateSnowFractionBatch(const optStruct    &Options);
+
   double       CalculateAggDiagnostic(const int ii, const int j,
                                       const double &starttime, const double &endtime,
                                       const comparison compare,const double &thresh,
                                       const optStruct &Options);
+  double          GetDiagnosticValue (const int d, const int i, const int j, const optStruct &Options) const;
+  void             FindObjFuncTarget (long calib_SBID,diag_type calib_Obj, const string calib_period,
+                                      int &dd, int &ii, int &jj) const;
 
   //Routines for deriving missing data based on gridded data provided
 
   CForcingGrid *ForcingCopyCreate(const CForcingGrid *pGrid, const forcing_type typ, const double &interval, const int nVals, const optStruct &Options);
+  CForcingGrid *ForcingViewCreate(const CForcingGrid *pGrid, const forcing_type typ, const optStruct &Options);
 
 
   void         GenerateAveSubdailyTempFromMinMax        (const optStruct &Options);
@@ -317,12 +578,16 @@ public:/*-------------------------------------------------------*/
   int               GetNumGauges                      () const;
   int               GetNumForcingGrids                () const;
   int               GetNumProcesses                   () const;
+  bool              IsHRULoopThreadSafe               () const;
+  bool              IsRoutingThreadSafe               (const optStruct &Options) const;
   process_type      GetProcessType                    (const int j ) const;
   int               GetNumConnections                 (const int j ) const;
   int               GetNumForcingPerturbations        () const;
   double            GetAveragePrecip                  () const;
   double            GetAverageSnowfall                () const;
   int               GetOrderedSubBasinIndex           (const int pp) const;
+  int               GetNumRoutingLevels               () const;
+  int               GetRoutingLevelStart              (const int L) const;
   int               GetDownstreamBasin                (const int p ) const;
   int               GetSubBasinIndex                  (const long ID) const;
   int               GetGaugeIndexFromName             (const string name) const;
@@ -341,6 +606,7 @@ public:/*-------------------------------------------------------*/
   const CTimeSeriesABC* GetSimulatedTS                (const int i) const;
 
   double            GetObjFuncVal                     (long calib_SBID,diag_type calib_Obj, const string calib_period) const;
+  bool              GetObjFuncBound                   (long calib_SBID,diag_type calib_Obj, const string calib_period, double &bound) const;
 
   const optStruct  *GetOptStruct                      () const;
   CTransportModel  *GetTransportModel                 () const;
@@ -402,6 +668,8 @@ public:/*-------------------------------------------------------*/
   void        WriteOutputFileHeaders     (const optStruct &Options);
   void        GenerateGriddedPrecipVars  (const optStruct &Options);
   void        GenerateGriddedTempVars    (const optStruct &Options);
+  void        BuildForcingPlan           (const optStruct &Options);
+  void        AllocateStateMatrix        ();
   void        ClearTimeSeriesData        (const optStruct &Options);
 
   //called during simulation:
@@ -420,6 +688,7 @@ public:/*-------------------------------------------------------*/
                                           const time_struct &tt); //declaration in UpdateForcings.cpp
   void        UpdateDiagnostics          (const optStruct   &Options,
                                           const time_struct &tt);
+  void        ResetDiagnosticStreams     ();
   void        RecalculateHRUDerivedParams(const optStruct   &Options,
                                           const time_struct &tt);
   bool        ApplyProcess               (const int          j,
@@ -441,10 +710,20 @@ public:/*-------------------------------------------------------*/
                                                 int         *iTo,
                                                 int         &nLatConnections,
                                                 double      *exchange_rates) const;
+  double      *GetStateMatrix            (const int b) const;
+  int          GetStateMatrixStride      () const;
+  void         SwapStateMatrix           (const int b);
   void         AssimilationOverride      (const int p,
                                           const optStruct &Options, const time_struct &tt);
   void         PrepareAssimilation       (const optStruct &Options, const time_struct &tt);
   void         PrepareForcingPerturbation(const optStruct &Options, const time_struct &tt);
+  bool         ReadBinarySnapshot        (const string &filename, const optStruct &Options);
+  void         GetModelState             (vector<double> &aState) const;
+  void         SetModelState             (const double *aState, size_t &i);
+  void         SaveCheckpoint            ();
+  void         RestoreCheckpoint         ();
+  bool         HasCheckpoint             () const;
+  void         ResetCumulativeBalances   ();
   void         ApplyForcingPerturbation  (const forcing_type f, force_struct &F, const int k, const optStruct& Options, const time_struct& tt);
 
   //water/energy/mass balance routines
@@ -461,9 +740,11 @@ public:/*-------------------------------------------------------*/
   void        WriteMinorOutput        (const optStruct &Options, const time_struct &tt);
   void        WriteSimpleOutput       (const optStruct &Options, const time_struct &tt);
   void        WriteMajorOutput        (const optStruct &Options, const time_struct &tt,string solfile,bool final) const;
+  void        WriteBinarySnapshot     (const string &filename, const string &rvc_filename, const time_struct &tt) const;
   void        WriteProgressOutput     (const optStruct &Options, clock_t elapsed_time, int elapsed_steps, int total_steps);
   void        CloseOutputStreams      ();
   void        SummarizeToScreen       (const optStruct &Options) const;
+  void        WriteForcingGridMemoryReport(const optStruct &Options) const;
   void        RunDiagnostics          (const optStruct &Options);
 };
 
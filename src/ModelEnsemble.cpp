@@ -6,7 +6,9 @@ Copyright (c) 2008-2023 the Raven Development Team
 //#include <random>
 //see http://anadoxin.org/blog/c-shooting-yourself-in-the-foot-4.html
 
-bool ParseInitialConditions(CModel *&pModel,const optStruct &Options);
+bool ParseInitialConditions    (CModel *&pModel,const optStruct &Options);
+bool ParseInitialConditionsFile(CModel *&pModel,const optStruct &Options);
+void CheckInitialStateVars     (CModel *&pModel,const optStruct &Options);
 
 //////////////////////////////////////////////////////////////////
 /// \brief returns uniformly distributed random variable between 0 and 1
@@ -59,6 +61,8 @@ CEnsemble::CEnsemble(const int num_members,const optStruct &Options)
   }
 
   _disable_output=false;
+  _nConcurrent=1;
+  _checkpoint_ICs=false;
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Ensemble Default Destructor
@@ -97,6 +101,32 @@ double CEnsemble::GetStartTime(const int e) const {
 bool   CEnsemble::DontWriteOutput() const {
   return _disable_output;
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Accessor - gets number of ensemble members simulated concurrently
+/// \return number of concurrent ensemble members (1 if members are run in sequence)
+//
+int    CEnsemble::GetNumConcurrentMembers() const {
+  return _nConcurrent;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief returns true if two members simulated in the same concurrent batch would write to the same output files
+/// \details members are simulated in batches of _nConcurrent consecutive members; output files are
+/// distinct only if output directory or run name differ (i.e., are set using the '*' wildcard)
+/// \return true if members within a concurrent batch share both output directory and run name
+//
+bool   CEnsemble::ConcurrentMembersShareOutput() const
+{
+  for(int e0=0;e0<_nMembers;e0+=_nConcurrent)
+  {
+    int e1=min(e0+_nConcurrent,_nMembers);
+    for(int e=e0;e<e1;e++) {
+      for(int ee=e+1;ee<e1;ee++) {
+        if((_aOutputDirs[e]==_aOutputDirs[ee]) && (_aRunNames[e]==_aRunNames[ee])) { return true; }
+      }
+    }
+  }
+  return false;
+}
 
 
 //Manipulator Functions
@@ -109,6 +139,14 @@ void CEnsemble::SetRandomSeed(const unsigned int seed)
   srand(seed);
 }
 //////////////////////////////////////////////////////////////////
+/// \brief sets number of ensemble members simulated concurrently
+/// \param nConcurrent [in] number of concurrent ensemble members (>=1)
+//
+void CEnsemble::SetNumConcurrentMembers(const int nConcurrent)
+{
+  _nConcurrent=max(nConcurrent,1);
+}
+//////////////////////////////////////////////////////////////////
 /// \brief sets output directory for ensemble member output
 /// \param OutDirString [in] string with or without '*' random card. If * is present, will be replaced with ensemble ID
 //
@@ -165,6 +203,41 @@ void CEnsemble::UpdateModel(CModel *pModel,optStruct &Options, int e)
   //default does nothing - abstract base class
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief resets model state to initial conditions prior to ensemble member run
+/// \details if _checkpoint_ICs is true, the .rvc file is only parsed for the first member, and the resulting state
+/// is restored from memory for all subsequent members. Parameter-dependent limits on initial state variables
+/// are applied after restoring, as they are after parsing.
+/// Otherwise, initial conditions are re-read from file(s) for every member.
+/// In both cases, cumulative mass balances are zeroed, such that each member starts from zero totals
+/// \param pModel [out] pointer to global model instance
+/// \param &Options [in] Global model options information
+//
+void CEnsemble::ResetInitialConditions(CModel *pModel,const optStruct &Options)
+{
+  if (!_checkpoint_ICs)
+  {
+    if(!ParseInitialConditions(pModel,Options)) {
+      ExitGracefully("Cannot find or read .rvc file",BAD_DATA);
+    }
+  }
+  else
+  {
+    if (pModel->HasCheckpoint()){
+      pModel->RestoreCheckpoint();
+    }
+    else{
+      if(!ParseInitialConditionsFile(pModel,Options)) {
+        ExitGracefully("Cannot find or read .rvc file",BAD_DATA);
+      }
+      pModel->SaveCheckpoint();
+    }
+    CheckInitialStateVars(pModel,Options);
+  }
+  pModel->ResetCumulativeBalances();
+  pModel->CalculateInitialWaterStorage(Options);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // MONTE CARLO CLASS
@@ -221,6 +294,12 @@ void CMonteCarloEnsemble::Initialize(const CModel* pModel,const optStruct &Optio
   for (int i=0;i<_nParamDists;i++){MCOUT<<_pParamDists[i]->param_name+" ("+_pParamDists[i]->class_group+"),";}
   MCOUT<<endl;
   MCOUT.close();
+
+  //- read initial conditions once if they cannot depend upon sampled parameters
+  _checkpoint_ICs=(Options.stateinfo_filename=="") && (Options.flowinfo_filename=="");
+  for (int i=0;i<_nParamDists;i++){
+    if (AffectsInitialConditions(_pParamDists[i])){_checkpoint_ICs=false;}
+  }
 }
 //////////////////////////////////////////////////////////////////
 /// \brief updates model - called prior to each model ensemble run
@@ -255,10 +334,8 @@ void CMonteCarloEnsemble::UpdateModel(CModel *pModel,optStruct &Options, const i
   }
   MCOUT<<endl;
 
-  //- Re-read initial conditions to update state variables----
-  if(!ParseInitialConditions(pModel,Options)) {
-    ExitGracefully("Cannot find or read .rvc file",BAD_DATA);}
-  pModel->CalculateInitialWaterStorage(Options);
+  //- Reset state variables to initial conditions -------------
+  ResetInitialConditions(pModel,Options);
 
   MCOUT.close();
 }
@@ -328,3 +405,14 @@ double SampleFromDistribution(disttype distribution, double distpar[3])
   }
   return value;
 }
+//////////////////////////////////////////////////////////////////
+/// \brief returns true if initial conditions may depend upon the value of a sampled parameter
+/// \details subbasin parameters and AVG_ANNUAL_RUNOFF determine the initial flows and channel/rivulet storage
+/// of basins without initial flow states in the .rvc file
+/// \param *dist [in] parameter distribution
+//
+bool AffectsInitialConditions(const param_dist *dist)
+{
+  return (dist->param_class==CLASS_SUBBASIN) ||
+        ((dist->param_class==CLASS_GLOBAL) && (dist->param_name=="AVG_ANNUAL_RUNOFF"));
+}
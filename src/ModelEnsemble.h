@@ -27,6 +27,7 @@ struct param_dist
 
 };
 double SampleFromDistribution(disttype distribution,double distpar[3]);
+bool   AffectsInitialConditions(const param_dist *dist);
 
 ////////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for model ensemble run
@@ -47,6 +48,12 @@ protected:/*------------------------------------------------------*/
 
   bool          _disable_output; ///< true if output from ensemble should be turned off (default: false)
 
+  int           _nConcurrent;    ///< number of ensemble members simulated concurrently (default: 1)
+
+  bool          _checkpoint_ICs; ///< true if initial conditions are read once and restored from in-memory checkpoint for each member (default: false)
+
+  void          ResetInitialConditions(CModel *pModel,const optStruct &Options);
+
 public:/*-------------------------------------------------------*/
   CEnsemble(const int num_members, const optStruct &Options);
   ~CEnsemble();
@@ -58,18 +65,26 @@ public:/*-------------------------------------------------------*/
   virtual double GetStartTime(const int e) const;
 
   bool           DontWriteOutput() const;
+  int            GetNumConcurrentMembers() const;
+  virtual bool   SupportsConcurrentMembers() const {return false;} //true if members are independent given UpdateModel()
+  bool           ConcurrentMembersShareOutput() const;
+
+  virtual void   GetMemberResult(CModel *pModel,optStruct &Options,const time_struct &tt,const int e,vector<double> &result) {} //called after concurrent member run; result returned to ensemble driver
 
   //Manipulator Functions
   void SetRandomSeed     (const unsigned int seed);
   void SetOutputDirectory(const string OutDirString);
   void SetRunNames       (const string RunNames);
   void SetSolutionFiles  (const string SolFiles);
+  void SetNumConcurrentMembers(const int nConcurrent);
 
   virtual void Initialize       (const CModel* pModel,const optStruct &Options); //called prior to ALL ensemble runs
   virtual void UpdateModel      (CModel *pModel,optStruct &Options,const int e); //called prior to each ensemble run
   virtual void StartTimeStepOps (CModel* pModel,optStruct &Options,const time_struct &tt,const int e) {} //called at start of every timestep
   virtual void CloseTimeStepOps (CModel* pModel,optStruct &Options,const time_struct &tt,const int e) {} //called at end of each timestep
+  virtual bool TerminateMember  (const CModel *pModel) {return false;} //called at end of each timestep; true if member simulation may be stopped
   virtual void FinishEnsembleRun(CModel *pModel,optStruct &Options,const time_struct &tt,const int e) {} //called after all ensembles run
+  virtual void ReceiveMemberResult(CModel *pModel,optStruct &Options,const int e,const vector<double> &result) {} //called in place of FinishEnsembleRun for concurrent members
 };
 
 ////////////////////////////////////////////////////////////////////
@@ -89,6 +104,8 @@ public:
 
   void AddParamDist(const param_dist *dist);
 
+  bool SupportsConcurrentMembers() const {return true;}
+
   void Initialize(const CModel* pModel,const optStruct &Options);
   void UpdateModel(CModel *pModel,optStruct &Options, const int e);
 };
@@ -102,6 +119,7 @@ private:
   double       _r_val;       ///< perturbation value
   double      *_BestParams;  ///< vector of best parameter values
   double      *_TestParams;  ///< vector of test parameter values
+  double     **_aBatchParams;///< test parameter values of each member in concurrent batch [size: _nConcurrent x _nParamDists] (NULL if members are sequential)
   double       _Fbest;       ///< best obj function val
 
   int          _nParamDists; ///< number of parameter distributions for sampling
@@ -111,11 +129,17 @@ private:
   diag_type    _calib_Obj;   ///< diagnostic used as objective function (e.g., DIAG_NASH_SUTCLIFFE)
   string       _calib_Period;///< name of calibration period (e.g., CALIB)
 
+  bool         _early_termination; ///< true if members which cannot improve upon best solution are terminated early (default: false)
+  bool         _terminated;  ///< true if simulation of current member has been terminated early
+  double       _Fbound;      ///< lower bound on obj function val of terminated member
+
   ofstream     _DDSOUT;      ///< output file stream
 
   double PerturbParam(const double &x_best,
                       const double &upperbound,
                       const double &lowerbound);
+  double GetTestObjFuncVal (const CModel *pModel) const;
+  void   UpdateBestSolution(const int e,const double &Ftest);
 
 public:
   CDDSEnsemble(const int num_members,const optStruct &Options);
@@ -123,10 +147,16 @@ public:
 
   void SetPerturbationValue(const double &perturb);
   void SetCalibrationTarget(const long SBID, const diag_type object_diag, const string period);
+  void SetEarlyTermination (const bool terminate);
   void AddParamDist(const param_dist *dist);
 
+  bool   SupportsConcurrentMembers() const {return true;}
+  void   GetMemberResult(CModel *pModel,optStruct &Options,const time_struct &tt,const int e,vector<double> &result);
+
   void Initialize(const CModel* pModel,const optStruct &Options);
   void UpdateModel(CModel *pModel,optStruct &Options,const int e);
+  bool TerminateMember(const CModel *pModel);
   void FinishEnsembleRun(CModel *pModel,optStruct &Options,const time_struct &tt,const int e);
+  void ReceiveMemberResult(CModel *pModel,optStruct &Options,const int e,const vector<double> &result);
 };
 #endif
@@ -7,19 +7,22 @@
 /*****************************************************************
    Routines for generating forcing grids from other forcing grids
    All member functions of CModel
+   -ForcingCopyCreate
+   -ForcingViewCreate
    -GenerateAveSubdailyTempFromMinMax
    -GenerateMinMaxAveTempFromSubdaily
    -GenerateMinMaxSubdailyTempFromAve
    -GeneratePrecipFromSnowRain
    -GetAverageSnowFrac
+   -WriteForcingGridMemoryReport
 ------------------------------------------------------------------
 *****************************************************************/
 
 //////////////////////////////////////////////////////////////////
-/// \brief if forcing grid of type typ doesnt exist, creates full copy of pGrid
-///    but with potentially new time interval specified
+/// \brief if forcing grid of type typ doesnt exist, creates copy of pGrid
+///    but with potentially new time interval specified; weights and cell indices are
+///    shared with pGrid, only values (for nVals time points) are allocated
 ///    otherwise just returns existing grid of type typ
-///    assume
 //
 CForcingGrid *CModel::ForcingCopyCreate(const CForcingGrid *pGrid,
                                         const forcing_type typ,
@@ -29,9 +32,9 @@ CForcingGrid *CModel::ForcingCopyCreate(const CForcingGrid *pGrid,
   static CForcingGrid *pTout;
   if (GetForcingGridIndexFromType(typ) == DOESNT_EXIST )
   { // for the first chunk, the derived grid does not exist and has to be added to the model
-    // all weights, etc., are copied from the base grid
+    // all weights, etc., are shared with the base grid
 
-    pTout = new CForcingGrid(*pGrid);  // copy everything from pGrid; matrices are deep copies
+    pTout = new CForcingGrid(pGrid);  // copy attributes of pGrid; weight matrices are shared
 
     //following values are overwritten:
     int    GridDims[3];
@@ -59,6 +62,30 @@ CForcingGrid *CModel::ForcingCopyCreate(const CForcingGrid *pGrid,
   return pTout;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief if forcing grid of type typ doesnt exist, creates view of pGrid, i.e., a grid with
+///    values identical to those of pGrid (e.g., rainfall derived from precipitation)
+///    which shares values and weights of pGrid, such that nothing is copied when new chunks are read
+///    otherwise just returns existing grid of type typ
+//
+CForcingGrid *CModel::ForcingViewCreate(const CForcingGrid *pGrid,
+                                        const forcing_type typ,
+                                        const optStruct &Options)
+{
+  CForcingGrid *pTout;
+  if (GetForcingGridIndexFromType(typ) == DOESNT_EXIST )
+  {
+    pTout = new CForcingGrid(pGrid);
+    pTout->SetForcingType(typ);
+    pTout->ShareValues(pGrid);
+  }
+  else
+  {
+    pTout=GetForcingGrid(typ);
+  }
+  return pTout;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Creates all missing gridded snow/rain/precip data based on gridded information available,
 ///        precip data are assumed to have the same resolution and hence can be initialized together.
@@ -160,14 +187,7 @@ void CModel::GenerateGriddedTempVars(const optStruct &Options)
   if ((temp_ave_gridded) && (fabs(pGrid_tave->GetInterval()-1.0)<REAL_SMALL)) // (A) daily temperature data provided, labeled as TEMP_AVE - >convert to temp_daily_ave_gridded
   {
 
-    pGrid_daily_tave = ForcingCopyCreate(pGrid_tave,F_TEMP_DAILY_AVE,pGrid_tave->GetInterval(),pGrid_tave->GetChunkSize(),Options);
-    int chunk_size =pGrid_tave->GetChunkSize();
-    int nNonZero   =pGrid_tave->GetNumberNonZeroGridCells();
-    for(int it=0; it<chunk_size; it++) {           // loop over time points in buffer
-      for(int ic=0; ic<nNonZero;ic++) {             // loop over non-zero grid cell indexes
-        pGrid_daily_tave->SetValue(ic,it,pGrid_tave->GetValue(ic,it)); //copy values //\todo[optimize] - is this necessary - should copy in ForcingCopyCreate
-      }
-    }
+    pGrid_daily_tave = ForcingViewCreate(pGrid_tave,F_TEMP_DAILY_AVE,Options); //values are those of pGrid_tave - nothing copied
     AddForcingGrid(pGrid_daily_tave,F_TEMP_DAILY_AVE);
     temp_ave_gridded=false;
     temp_daily_ave_gridded=true;
@@ -198,6 +218,78 @@ void CModel::GenerateGriddedTempVars(const optStruct &Options)
 
   if(Options.noisy) { cout<<"...done generating gridded temperature variables."<<endl; }
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Resolves which forcings are gridded, and the grids and correction factors used for them
+/// \remark Called after initialization and whenever the set of forcing grids changes (i.e., after
+///         derived grids are regenerated); UpdateHRUForcingFunctions then uses _ForcingPlan
+///         instead of searching the forcing grid list for every HRU
+///
+/// \param Options [in]  major options of the model
+//
+void CModel::BuildForcingPlan(const optStruct &Options)
+{
+  forcing_plan &P=_ForcingPlan;
+
+  P.pre_input       =ForcingGridIsInput(F_PRECIP);
+  P.rain_input      =ForcingGridIsInput(F_RAINFALL);
+  P.snow_input      =ForcingGridIsInput(F_SNOWFALL);
+  P.tave_input      =ForcingGridIsInput(F_TEMP_AVE);
+  P.daily_tave_input=ForcingGridIsInput(F_TEMP_DAILY_AVE);
+  P.daily_tmin_input=ForcingGridIsInput(F_TEMP_DAILY_MIN);
+  P.daily_tmax_input=ForcingGridIsInput(F_TEMP_DAILY_MAX);
+
+  P.precip_gridded  =(P.pre_input || P.rain_input || P.snow_input);
+  P.minmax_gridded  =(P.daily_tmin_input && P.daily_tmax_input);
+  P.temp_gridded    =(P.tave_input || P.minmax_gridded || P.daily_tave_input);
+  P.pet_gridded     =ForcingGridIsInput(F_PET)    && (Options.evaporation   ==PET_DATA);
+  P.owpet_gridded   =ForcingGridIsInput(F_OW_PET) && (Options.ow_evaporation==PET_DATA);
+
+  //grids may be derived (available but not input) - these are still used once generated
+  P.pGrid_pre       =ForcingGridIsAvailable(F_PRECIP)        ? GetForcingGrid(F_PRECIP)        : NULL;
+  P.pGrid_rain      =ForcingGridIsAvailable(F_RAINFALL)      ? GetForcingGrid(F_RAINFALL)      : NULL;
+  P.pGrid_snow      =ForcingGridIsAvailable(F_SNOWFALL)      ? GetForcingGrid(F_SNOWFALL)      : NULL;
+  P.pGrid_tave      =ForcingGridIsAvailable(F_TEMP_AVE)      ? GetForcingGrid(F_TEMP_AVE)      : NULL;
+  P.pGrid_daily_tave=ForcingGridIsAvailable(F_TEMP_DAILY_AVE)? GetForcingGrid(F_TEMP_DAILY_AVE): NULL;
+  P.pGrid_daily_tmin=ForcingGridIsAvailable(F_TEMP_DAILY_MIN)? GetForcingGrid(F_TEMP_DAILY_MIN): NULL;
+  P.pGrid_daily_tmax=ForcingGridIsAvailable(F_TEMP_DAILY_MAX)? GetForcingGrid(F_TEMP_DAILY_MAX): NULL;
+
+  //correction factors (temperature correction taken from precip grid, if present)
+  P.rain_corr=P.snow_corr=1.0;
+  P.temp_corr=0.0;
+  if     (P.pGrid_pre !=NULL) {
+    P.rain_corr=P.pGrid_pre->GetRainfallCorr();
+    P.snow_corr=P.pGrid_pre->GetSnowfallCorr();
+    P.temp_corr=P.pGrid_pre->GetTemperatureCorr();
+  }
+  else if(P.pGrid_tave!=NULL) {
+    P.temp_corr=P.pGrid_tave->GetTemperatureCorr();
+  }
+
+  //remaining gridded forcings, each of which directly overwrites a single forcing
+  forcing_type           aux_type [MAX_PLAN_AUX_GRIDS];
+  double force_struct::* aux_field[MAX_PLAN_AUX_GRIDS];
+  bool                   aux_used [MAX_PLAN_AUX_GRIDS];
+  aux_type[0]=F_RECHARGE;      aux_field[0]=&force_struct::recharge;     aux_used[0]=(Options.recharge     ==RECHARGE_DATA);
+  aux_type[1]=F_PRECIP_TEMP;   aux_field[1]=&force_struct::precip_temp;  aux_used[1]=true;
+  aux_type[2]=F_PET;           aux_field[2]=&force_struct::PET;          aux_used[2]=P.pet_gridded;
+  aux_type[3]=F_OW_PET;        aux_field[3]=&force_struct::OW_PET;       aux_used[3]=P.owpet_gridded;
+  aux_type[4]=F_WIND_VEL;      aux_field[4]=&force_struct::wind_vel;     aux_used[4]=(Options.wind_velocity==WINDVEL_DATA);
+  aux_type[5]=F_REL_HUMIDITY;  aux_field[5]=&force_struct::rel_humidity; aux_used[5]=(Options.rel_humidity ==RELHUM_DATA);
+  aux_type[6]=F_SW_RADIA_NET;  aux_field[6]=&force_struct::SW_radia_net; aux_used[6]=(Options.SW_radia_net ==NETSWRAD_DATA);
+  aux_type[7]=F_LW_INCOMING;   aux_field[7]=&force_struct::LW_incoming;  aux_used[7]=(Options.LW_incoming  ==LW_INC_DATA);
+  aux_type[8]=F_SW_RADIA;      aux_field[8]=&force_struct::SW_radia;     aux_used[8]=(Options.SW_radiation ==SW_RAD_DATA);
+
+  P.nAuxGrids=0;
+  for(int j=0;j<MAX_PLAN_AUX_GRIDS;j++) {
+    if(aux_used[j] && ForcingGridIsInput(aux_type[j])) {
+      P.pAuxGrid [P.nAuxGrids]=GetForcingGrid(aux_type[j]);
+      P.aAuxField[P.nAuxGrids]=aux_field[j];
+      P.nAuxGrids++;
+    }
+  }
+  P.valid=true;
+}
 //////////////////////////////////////////////////////////////////
 /// \brief Generates Tave and subhourly time series from daily Tmin & Tmax time series
 /// \note presumes existence of valid F_TEMP_DAILY_MIN and F_TEMP_DAILY_MAX time series
@@ -276,15 +368,7 @@ void CModel::GenerateAveSubdailyTempFromMinMax(const optStruct &Options)
   {
     if(!ForcingGridIsInput(F_TEMP_AVE))
     {
-      int    nVals     = pTave_daily->GetChunkSize();
-      pTave = ForcingCopyCreate(pTave_daily,F_TEMP_AVE,1.0,nVals,Options);
-
-      int nNonZero  =pTave->GetNumberNonZeroGridCells();
-      for(int it=0; it<nVals; it++) {                                 // loop over time points in buffer
-        for(int ic=0; ic<nNonZero; ic++) {                                  // loop over non-zero grid cell indexes
-          pTave->SetValue(ic,it,pTave_daily->GetValue(ic,it));  // --> just copy daily average values
-        }
-      }
+      pTave = ForcingViewCreate(pTave_daily,F_TEMP_AVE,Options); // --> just daily average values
       AddForcingGrid(pTave,F_TEMP_AVE);
     }
   }
@@ -388,6 +472,13 @@ void CModel::GeneratePrecipFromSnowRain(const optStruct &Options)
 
   int nVals = pSnow->GetChunkSize();
 
+  if(!ForcingGridIsInput(F_SNOWFALL)) //snowfall grid is zero (see GenerateZeroSnow) - precipitation is rainfall
+  {
+    pPre = ForcingViewCreate(pRain,F_PRECIP,Options);
+    AddForcingGrid(pPre,F_PRECIP);
+    return;
+  }
+
   pPre = ForcingCopyCreate(pSnow,F_PRECIP,interval_snow,nVals,Options);
 
   int nNonZero  =pPre->GetNumberNonZeroGridCells();
@@ -411,17 +502,7 @@ void CModel::GenerateRainFromPrecip(const optStruct &Options)
 
   pPre->Initialize(Options);  //needed for correct mapping from time series to model time
 
-  int nVals = pPre->GetChunkSize();
-
-  pRain = ForcingCopyCreate(pPre,F_RAINFALL,pPre->GetInterval(),nVals,Options);
-
-  // set forcing values
-  int nNonZero  =pRain->GetNumberNonZeroGridCells();
-  for(int it=0; it<nVals; it++) {                   // loop over time points in buffer
-    for(int ic=0; ic<nNonZero; ic++){                    // loop over non-zero grid cell indexes
-      pRain->SetValue(ic,it,pPre->GetValue(ic,it));      // copies precipitation values
-    }
-  }
+  pRain = ForcingViewCreate(pPre,F_RAINFALL,Options); // rainfall values are precipitation values - nothing copied
 
   AddForcingGrid(pRain,F_RAINFALL);
 }
@@ -439,15 +520,15 @@ void CModel::GenerateZeroSnow(const optStruct &Options)
 
   pPre->Initialize(Options);//needed for correct mapping from time series to model time
 
-  int    nVals     = pPre->GetChunkSize();
-
-  pSnow = ForcingCopyCreate(pPre,F_SNOWFALL,pPre->GetInterval(),nVals,Options);
-
-  int nNonZero  =pSnow->GetNumberNonZeroGridCells();
-  for (int it=0; it<nVals; it++) {                   // loop over time points in buffer
-    for (int ic=0; ic<nNonZero; ic++){                    // loop over non-zero grid cell indexes
-      pSnow->SetValue(ic, it , 0.0);                      // fills everything with 0.0
-    }
+  if (GetForcingGridIndexFromType(F_SNOWFALL) == DOESNT_EXIST )
+  {
+    pSnow = new CForcingGrid(pPre);        // shares weights of precipitation grid
+    pSnow->SetForcingType(F_SNOWFALL);
+    pSnow->AllocateConstantArrays(0.0);    // single row of zeros used for all time points
+  }
+  else
+  {
+    pSnow = GetForcingGrid(F_SNOWFALL);    // constant - nothing to update for new chunk
   }
 
   AddForcingGrid(pSnow,F_SNOWFALL);
@@ -475,3 +556,30 @@ double CModel::GetAverageSnowFrac(const int ic, const double t, const int n) con
   return snow/(snow+rain);
 
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes memory used by each forcing grid to screen
+/// \details values and weights viewed from or shared with another grid (see ForcingCopyCreate, ForcingViewCreate)
+///          are reported as shared, i.e., memory which deep copies of the parent grid would additionally require
+///
+/// \param Options [in]  major options of the model
+//
+void CModel::WriteForcingGridMemoryReport(const optStruct &Options) const
+{
+  if(_nForcingGrids==0) { return; }
+
+  const double MB=1024.0*1024.0;
+  double val_bytes,wt_bytes,shared_bytes;
+  double total=0.0,total_shared=0.0;
+  cout<<"Forcing grid memory usage:"<<endl;
+  for(int f=0;f<_nForcingGrids;f++)
+  {
+    _pForcingGrids[f]->GetMemoryUsage(val_bytes,wt_bytes,shared_bytes);
+    cout<<"  "<<ForcingToString(_pForcingGrids[f]->GetForcingType());
+    cout<<((_pForcingGrids[f]->GetIsDerived()) ? " (derived)" : "");
+    cout<<": values "<<val_bytes/MB<<" MB, weights "<<wt_bytes/MB<<" MB, shared "<<shared_bytes/MB<<" MB"<<endl;
+    total       +=val_bytes+wt_bytes;
+    total_shared+=shared_bytes;
+  }
+  cout<<"  total: "<<total/MB<<" MB ("<<total_shared/MB<<" MB shared rather than copied)"<<endl;
+}
@@ -5,6 +5,8 @@
 #include "Model.h"
 #include "IrregularTimeSeries.h"
 #include "HeatConduction.h"
+#include "Convolution.h"
+#include "KDTree.h"
 
 string FilenamePrepare(string filebase,const optStruct &Options); //defined in StandardOutput.cpp
 
@@ -43,16 +45,11 @@ void CModel::Initialize(const optStruct &Options)
   ExitGracefullyIf(_nProcesses==0,
                     "CModel::Initialize: must have at least one hydrological process included in model",BAD_DATA);
 
-  //Ensure Basins & HRU IDs are unique
-  for (p=0;p<_nSubBasins;p++){
-    for (pp=0;pp<p;pp++){
-      if (_pSubBasins[p]->GetID()==_pSubBasins[pp]->GetID()){
-        ExitGracefully("CModel::Initialize: non-unique (repeated) basin identifier found",BAD_DATA);}}}
-
-  for (k=0;k<_nHydroUnits;k++){
-    for (kk=0;kk<p;kk++){
-      if ((k!=kk) && (_pHydroUnits[k]->GetID()==_pHydroUnits[kk]->GetID())){
-        ExitGracefully("CModel::Initialize: non-unique (repeated) HRU identifier found",BAD_DATA);}}}
+  //Ensure Basins & HRU IDs are unique (ID indexes retain only first of repeated IDs)
+  ExitGracefullyIf((int)(_SBIndexByID.size())!=_nSubBasins,
+                   "CModel::Initialize: non-unique (repeated) basin identifier found",BAD_DATA);
+  ExitGracefullyIf((int)(_HRUIndexByID.size())!=_nHydroUnits,
+                   "CModel::Initialize: non-unique (repeated) HRU identifier found",BAD_DATA);
 
   // initialize process algorithms, initialize water/energy balance arrays to zero
   //--------------------------------------------------------------
@@ -104,6 +101,7 @@ void CModel::Initialize(const optStruct &Options)
       _aFlowLatBal      [jss]=0.0;
     }
   }
+  InitializeFluxIndex();
   _CumulInput   =_CumulOutput  =0.0;
 
   // Identify model UTM_zone for interpolation
@@ -128,6 +126,7 @@ void CModel::Initialize(const optStruct &Options)
   for (pp=0;pp<_nSBGroups; pp++){_pSBGroups   [pp]->Initialize(); } //disables SBs and HRUs
 
   InitializeParameterOverrides();
+  InitializeTransientParams();
 
   // Forcing grids are not "Initialized" here because the derived data have to be populated everytime a new chunk is read
 
@@ -200,11 +199,12 @@ void CModel::Initialize(const optStruct &Options)
       WTS.close();
     }
 
-    GenerateGaugeWeights(_aGaugeWeights ,f_gauge   ,Options);//'other' forcings
-    GenerateGaugeWeights(_aGaugeWtPrecip,F_PRECIP  ,Options);
-    GenerateGaugeWeights(_aGaugeWtTemp  ,F_TEMP_AVE,Options);
+    GenerateGaugeWeights(_GaugeWeights ,f_gauge   ,Options);//'other' forcings
+    GenerateGaugeWeights(_GaugeWtPrecip,F_PRECIP  ,Options);
+    GenerateGaugeWeights(_GaugeWtTemp  ,F_TEMP_AVE,Options);
 
   }
+  BuildForcingPlan(Options);
 
   //Initialize SubBasins, calculate routing orders, topology
   //--------------------------------------------------------------
@@ -244,8 +244,16 @@ void CModel::Initialize(const optStruct &Options)
       CmvHeatConduction *pHC=static_cast<CmvHeatConduction *>(_pProcesses[j]);
       pHC->StoreNumberOfHRUs(GetNumHRUs());
     }
+    else if (_pProcesses[j]->GetProcessType() == CONVOLVE) {
+      CmvConvolution *pConv=static_cast<CmvConvolution *>(_pProcesses[j]);
+      pConv->StoreNumberOfHRUs(GetNumHRUs());
+    }
   }
 
+  // Contiguous state matrix (HRU state arrays become views into its rows)
+  //--------------------------------------------------------------
+  AllocateStateMatrix();
+
   // Precalculate whether individual processes should apply (for speed)
   //--------------------------------------------------------------
   _aShouldApplyProcess = new bool *[_nProcesses];
@@ -285,6 +293,8 @@ void CModel::Initialize(const optStruct &Options)
   CDiagPeriod *pDP=new CDiagPeriod("ALL","0001-01-01","9999-12-31",COMPARE_GREATERTHAN,-ALMOST_INF,Options);
   AddDiagnosticPeriod(pDP);
 
+  InitializeDiagnosticStreams(Options);
+
   //General QA/QC
   //--------------------------------------------------------------
   ExitGracefullyIf((GetNumGauges()<2) && (Options.orocorr_temp==OROCORR_UBCWM2),
@@ -371,6 +381,10 @@ void CModel::Initialize(const optStruct &Options)
   if ((floor(rem_tsteps + TIME_CORRECTION)-rem_tsteps)>REAL_SMALL){
     WriteWarning("CModelInitialize: the model time step and model start time is such that midnight does not correspond to a time step ending. This will cause issues with use of daily temperature forcings (and potentially other errors) throughout the simulation.", Options.noisy);
   }
+  //--Check for multithreading support
+  if ((Options.num_threads>1) && (!IsHRULoopThreadSafe())){
+    WriteWarning("CModelInitialize: one or more hydrologic processes (or local parameter overrides) cannot be simulated concurrently in multiple HRUs. The :NumThreads command will be ignored.",Options.noisy);
+  }
 }
 //////////////////////////////////////////////////////////////////
 /// \brief Calculates initial total system water storage, updates _initWater
@@ -419,6 +433,7 @@ void CModel::InitializeObservations(const optStruct &Options)
   int nModeledValues =(int)(ceil((Options.duration+TIME_CORRECTION)/Options.timestep)+1);
   _pModeledTS=new CTimeSeries * [_nObservedTS];
   _aObsIndex =new int           [_nObservedTS];
+  _aObsBinding=new obs_binding  [_nObservedTS];
   CTimeSeriesABC** tmp = new CTimeSeriesABC *[_nObservedTS];
   for (int i = 0; i < _nObservedTS; i++)
   {
@@ -431,6 +446,7 @@ void CModel::InitializeObservations(const optStruct &Options)
     _pObservedTS[i]->Initialize(Options.julian_start_day, Options.julian_start_year, Options.duration, Options.timestep,true,Options.calendar);
     _pModeledTS [i]->InitializeResample(nModeledValues,Options.timestep);
     _aObsIndex  [i]=0;
+    _aObsBinding[i]=BindObservation(_pObservedTS[i],Options);
 
     //Match weights with observations based on Name, tag and numValues
     tmp[i] = NULL;
@@ -460,6 +476,187 @@ void CModel::InitializeObservations(const optStruct &Options)
   _pObsWeightTS = tmp;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Resolves modeled quantity corresponding to observation time series
+/// \details Parses observation type (e.g., "HYDROGRAPH", state variable name) and finds the
+///     subbasin, HRU, state variable and/or constituent index, so that UpdateDiagnostics does not
+///     repeat these lookups every time step. Called from CModel::InitializeObservations
+///
+/// \param pObs [in] observation time series
+/// \param &Options [in] Global model options information
+/// \return binding of observation to modeled quantity
+//
+obs_binding CModel::BindObservation(const CTimeSeriesABC *pObs,const optStruct &Options) const
+{
+  obs_binding B;
+  int         layer_ind;
+  string      datatype=pObs->GetName();
+  sv_type     svtyp   =CStateVariable::StringToSVType(datatype,layer_ind,false);
+
+  B.target=OBS_UNRECOGNIZED;
+  B.p=B.k=B.i_sv=B.c=DOESNT_EXIST;
+
+  if      (datatype=="HYDROGRAPH"          ){B.target=OBS_HYDROGRAPH;}
+  else if (datatype=="RESERVOIR_STAGE"     ){B.target=OBS_RESERVOIR_STAGE;}
+  else if (datatype=="RESERVOIR_INFLOW"    ){B.target=OBS_RESERVOIR_INFLOW;}
+  else if (datatype=="RESERVOIR_NETINFLOW" ){B.target=OBS_RESERVOIR_NETINFLOW;}
+  else if (datatype=="STREAM_CONCENTRATION"){B.target=OBS_STREAM_CONCENTRATION;}
+  else if (datatype=="STREAM_TEMPERATURE"  ){B.target=OBS_STREAM_CONCENTRATION;}
+  else if (datatype=="WATER_LEVEL"         ){B.target=OBS_WATER_LEVEL;}
+  else if (svtyp!=UNRECOGNIZED_SVTYPE      ){B.target=OBS_STATE_VARIABLE;}
+
+  if (B.target==OBS_STATE_VARIABLE)
+  {
+    CHydroUnit *pHRU=GetHRUByID((int)(pObs->GetLocID()));
+    string error="CModel::UpdateDiagnostics: Invalid HRU ID specified in observed state variable time series "+datatype;
+    ExitGracefullyIf(pHRU==NULL,error.c_str(),BAD_DATA);
+    B.k   =pHRU->GetGlobalIndex();
+    B.i_sv=GetStateVarIndex(svtyp,layer_ind);
+  }
+  else if (B.target!=OBS_UNRECOGNIZED)
+  {
+    B.p=GetSubBasinIndex(pObs->GetLocID());
+    string error="CModel::UpdateDiagnostics: Invalid subbasin ID specified in observation time series "+datatype;
+    ExitGracefullyIf(B.p<0,error.c_str(),BAD_DATA);
+    if (B.target==OBS_STREAM_CONCENTRATION){B.c=pObs->GetConstitInd();}
+  }
+  else
+  {
+    string warn="CModel::UpdateDiagnostics: invalid tag ("+datatype+")used for specifying Observation type";
+    WriteWarning(warn,Options.noisy);
+  }
+  return B;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Initializes streaming diagnostics
+/// \details Creates one diagnostic stream for each diagnostic period and observation time series, which
+///     accumulates the terms of all streamable diagnostics as modeled values are finalized in UpdateDiagnostics()
+///     Called from CModel::Initialize, after all diagnostic periods have been added
+///
+/// \param &Options [in] Global model options information
+//
+void CModel::InitializeDiagnosticStreams(const optStruct &Options)
+{
+  bool any_streamable=false;
+  for (int j=0;j<_nDiagnostics;j++){
+    if (CDiagnosticStream::IsStreamable(_pDiagnostics[j]->GetType())){any_streamable=true;}
+  }
+  if ((_nObservedTS==0) || (!any_streamable)){return;}
+
+  diag_type *aTypes=new diag_type [_nDiagnostics];
+  for (int j=0;j<_nDiagnostics;j++){aTypes[j]=_pDiagnostics[j]->GetType();}
+
+  _nDiagStreams=_nDiagPeriods*_nObservedTS;
+  _pDiagStreams=new CDiagnosticStream *[_nDiagStreams];
+  ExitGracefullyIf(_pDiagStreams==NULL,"CModel::InitializeDiagnosticStreams",OUT_OF_MEMORY);
+  for (int d=0;d<_nDiagPeriods;d++)
+  {
+    for (int i=0;i<_nObservedTS;i++)
+    {
+      _pDiagStreams[d*_nObservedTS+i]=new CDiagnosticStream(_pObservedTS[i],_pObsWeightTS[i],aTypes,_nDiagnostics,
+                                                            _pDiagPeriods[d]->GetStartTime(),_pDiagPeriods[d]->GetEndTime(),
+                                                            _pDiagPeriods[d]->GetComparison(),_pDiagPeriods[d]->GetThreshold(),Options);
+    }
+  }
+  delete [] aTypes;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Builds inverse index of process connections used by cumulative flux queries
+/// \details connection lists of each state variable and HRU are filled in connection order (see flux_index)
+/// \remark Called prior to simulation from CModel::Initialize, after all process connections are set
+//
+void CModel::InitializeFluxIndex()
+{
+  int i,j,k,q,js,jss;
+  flux_index &F=_FluxIndex;
+  F.Clear();
+
+  //in-HRU connections, by 'to' and 'from' state variable
+  F.nStateVars=_nStateVars;
+  F.nConn     =_nTotalConnections;
+  F.to_start  =new int [_nStateVars+1];
+  F.from_start=new int [_nStateVars+1];
+  F.to_conn   =new int [max(_nTotalConnections,1)];
+  F.from_conn =new int [max(_nTotalConnections,1)];
+  F.conn_proc =new int [max(_nTotalConnections,1)];
+  F.conn_from =new int [max(_nTotalConnections,1)];
+  F.conn_to   =new int [max(_nTotalConnections,1)];
+  ExitGracefullyIf(F.conn_to==NULL,"CModel::InitializeFluxIndex",OUT_OF_MEMORY);
+
+  js=0;
+  for (j=0;j<_nProcesses;j++){
+    for (q=0;q<_pProcesses[j]->GetNumConnections();q++){
+      F.conn_proc[js]=j;
+      F.conn_from[js]=_pProcesses[j]->GetFromIndices()[q];
+      F.conn_to  [js]=_pProcesses[j]->GetToIndices()[q];
+      js++;
+    }
+  }
+  for (i=0;i<=_nStateVars;i++){F.to_start[i]=F.from_start[i]=0;}
+  for (js=0;js<_nTotalConnections;js++){
+    i=F.conn_to  [js]; if ((i>=0) && (i<_nStateVars)){F.to_start  [i+1]++;}
+    i=F.conn_from[js]; if ((i>=0) && (i<_nStateVars)){F.from_start[i+1]++;}
+  }
+  for (i=0;i<_nStateVars;i++){F.to_start[i+1]+=F.to_start[i]; F.from_start[i+1]+=F.from_start[i];}
+
+  int *nTo  =new int [_nStateVars];
+  int *nFrom=new int [_nStateVars];
+  for (i=0;i<_nStateVars;i++){nTo[i]=nFrom[i]=0;}
+  for (js=0;js<_nTotalConnections;js++){
+    i=F.conn_to  [js]; if ((i>=0) && (i<_nStateVars)){F.to_conn  [F.to_start  [i]+nTo  [i]]=js; nTo  [i]++;}
+    i=F.conn_from[js]; if ((i>=0) && (i<_nStateVars)){F.from_conn[F.from_start[i]+nFrom[i]]=js; nFrom[i]++;}
+  }
+  delete [] nTo;
+  delete [] nFrom;
+
+  //lateral connections, by HRU (connections within a single HRU appear as both 'to' and 'from' entries)
+  F.nHRUs    =_nHydroUnits;
+  F.lat_start=new int  [_nHydroUnits+1];
+  F.lat_conn =new int  [max(2*_nTotalLatConnections,1)];
+  F.lat_proc =new int  [max(2*_nTotalLatConnections,1)];
+  F.lat_sv   =new int  [max(2*_nTotalLatConnections,1)];
+  F.lat_to   =new bool [max(2*_nTotalLatConnections,1)];
+  ExitGracefullyIf(F.lat_to==NULL,"CModel::InitializeFluxIndex",OUT_OF_MEMORY);
+
+  for (k=0;k<=_nHydroUnits;k++){F.lat_start[k]=0;}
+  for (j=0;j<_nProcesses;j++){
+    if (_pProcesses[j]->GetNumLatConnections()>0){
+      CLateralExchangeProcessABC *pProc=(CLateralExchangeProcessABC*)_pProcesses[j];
+      for (q=0;q<pProc->GetNumLatConnections();q++){
+        k=pProc->GetToHRUIndices  ()[q]; if ((k>=0) && (k<_nHydroUnits)){F.lat_start[k+1]++;}
+        k=pProc->GetFromHRUIndices()[q]; if ((k>=0) && (k<_nHydroUnits)){F.lat_start[k+1]++;}
+      }
+    }
+  }
+  for (k=0;k<_nHydroUnits;k++){F.lat_start[k+1]+=F.lat_start[k];}
+
+  int *nLat=new int [_nHydroUnits];
+  for (k=0;k<_nHydroUnits;k++){nLat[k]=0;}
+  int n;
+  jss=0;
+  for (j=0;j<_nProcesses;j++){
+    if (_pProcesses[j]->GetNumLatConnections()>0){
+      CLateralExchangeProcessABC *pProc=(CLateralExchangeProcessABC*)_pProcesses[j];
+      for (q=0;q<pProc->GetNumLatConnections();q++){
+        k=pProc->GetToHRUIndices()[q];
+        if ((k>=0) && (k<_nHydroUnits)){
+          n=F.lat_start[k]+nLat[k]; nLat[k]++;
+          F.lat_conn[n]=jss; F.lat_proc[n]=j; F.lat_sv[n]=pProc->GetLateralToIndices()[q];   F.lat_to[n]=true;
+        }
+        k=pProc->GetFromHRUIndices()[q];
+        if ((k>=0) && (k<_nHydroUnits)){
+          n=F.lat_start[k]+nLat[k]; nLat[k]++;
+          F.lat_conn[n]=jss; F.lat_proc[n]=j; F.lat_sv[n]=pProc->GetLateralFromIndices()[q]; F.lat_to[n]=false;
+        }
+        jss++;
+      }
+    }
+  }
+  delete [] nLat;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Initializes routing network
 /// \details Calculates sub basin routing order - generates _aOrderedSBind array
@@ -554,6 +751,19 @@ void CModel::InitializeRoutingNetwork()
   }
   if (noisy){cout <<"      number of zero-order outlets: "<<zerocount<<endl;}
 
+  //basins of the same order never drain into one another, so each order forms a
+  //contiguous routing level in _aOrderedSBind which may be routed concurrently
+  //----------------------------------------------------------------------
+  _aLevelStart=new int [_maxSubBasinOrder+2];
+  ExitGracefullyIf(_aLevelStart==NULL,"CModel::InitializeRoutingNetwork(3)",OUT_OF_MEMORY);
+  pp=0;
+  for (ord=_maxSubBasinOrder;ord>=0;ord--)
+  {
+    _aLevelStart[_maxSubBasinOrder-ord]=pp;
+    while ((pp<_nSubBasins) && (_aSubBasinOrder[_aOrderedSBind[pp]]==ord)){pp++;}
+  }
+  _aLevelStart[_maxSubBasinOrder+1]=_nSubBasins;
+
   for (p = 0; p < _nSubBasins; p++)
   {
     // identify headwater basins
@@ -588,6 +798,32 @@ int CModel::GetOrderedSubBasinIndex (const int pp) const
   return _aOrderedSBind[pp];
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns number of routing levels (i.e., maximum subbasin order+1)
+/// \remark subbasins within the same level are independent of one another during routing
+///
+/// \return number of routing levels
+//
+int CModel::GetNumRoutingLevels() const
+{
+  return _maxSubBasinOrder+1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns ordered basin index pp of first subbasin in routing level L
+/// \details level L includes ordered indices GetRoutingLevelStart(L) to GetRoutingLevelStart(L+1)-1;
+/// levels are ordered from upstream (L=0) to downstream
+///
+/// \param L [in] routing level index (0 to GetNumRoutingLevels())
+/// \return ordered subbasin index of first subbasin in level
+//
+int CModel::GetRoutingLevelStart(const int L) const
+{
+  ExitGracefullyIf((L<0) || (L>_maxSubBasinOrder+1),
+                   "CModel::GetRoutingLevelStart: invalid routing level",RUNTIME_ERR);
+  return _aLevelStart[L];
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Initializes basin flows
 /// \details Calculates flow rates in all basins, propagates downstream;
@@ -675,29 +911,28 @@ void CModel::InitializeBasins(const optStruct &Options,const bool re_init)
 void CModel::ClearTimeSeriesData(const optStruct& Options)
 {
   if(DESTRUCTOR_DEBUG) { cout<<"DELETING RVT DATA"<<endl; }
-  int c,f,g,i,j,k,p;
+  int c,f,g,i,j,p;
   for (g=0;g<_nGauges;       g++){delete _pGauges       [g];} delete [] _pGauges;       _pGauges=NULL; _nGauges=0;
+  _GaugeIndex.clear();
   for (f=0;f<_nForcingGrids; f++){delete _pForcingGrids [f];} delete [] _pForcingGrids; _pForcingGrids=NULL; _nForcingGrids=0;
+  _ForcingPlan.valid=false;
   for (i=0;i<_nObservedTS;   i++){delete _pObservedTS   [i];} delete [] _pObservedTS;   _pObservedTS=NULL;
   if (_pModeledTS != NULL){
     for (i = 0; i < _nObservedTS; i++){ delete _pModeledTS[i]; } delete[] _pModeledTS;    _pModeledTS = NULL;
   }
   _nObservedTS=0;
+  for (j=0;j<_nDiagStreams;  j++){delete _pDiagStreams  [j];} delete [] _pDiagStreams;  _pDiagStreams=NULL; _nDiagStreams=0;
   for (i=0;i<_nObsWeightTS;  i++){delete _pObsWeightTS  [i];} delete [] _pObsWeightTS;  _pObsWeightTS=NULL; _nObsWeightTS;
 
-  if (_aGaugeWeights!=NULL){
-    for (k=0;k<_nHydroUnits;   k++){delete [] _aGaugeWeights[k]; } delete [] _aGaugeWeights;  _aGaugeWeights=NULL;
-  }
-  if (_aGaugeWtPrecip!=NULL){
-    for (k=0;k<_nHydroUnits;   k++){delete [] _aGaugeWtPrecip[k]; } delete [] _aGaugeWtPrecip;  _aGaugeWtPrecip=NULL;
-  }
-  if (_aGaugeWtTemp!=NULL){
-    for (k=0;k<_nHydroUnits;   k++){delete [] _aGaugeWtTemp[k]; } delete [] _aGaugeWtTemp;  _aGaugeWtTemp=NULL;
-  }
+  _GaugeWeights.Clear();
+  _GaugeWtPrecip.Clear();
+  _GaugeWtTemp.Clear();
   for (j=0;j<_nTransParams;j++) {delete _pTransParams[j];} delete [] _pTransParams; _pTransParams=NULL; _nTransParams=0;
+  delete [] _aTransParamAddr; _aTransParamAddr=NULL;
   for (j=0;j<_nClassChanges;j++){delete _pClassChanges[j];} delete [] _pClassChanges; _pClassChanges=NULL; _nClassChanges=0;
 
   delete [] _aObsIndex;      _aObsIndex=NULL;
+  delete [] _aObsBinding;    _aObsBinding=NULL;
 
   for(p=0;p<_nSubBasins;p++) {
     _pSubBasins[p]->ClearTimeSeriesData(Options);
@@ -707,6 +942,27 @@ void CModel::ClearTimeSeriesData(const optStruct& Options)
   }
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief precompiles transient parameter updates
+/// \details resolves the parameter class and name of each transient parameter to the address of
+/// the parameter value once, so that UpdateTransientParams() need not search by name every time step.
+/// Parameters without a single address (e.g., monthly parameters) are left NULL and updated by name
+//
+void CModel::InitializeTransientParams()
+{
+  delete [] _aTransParamAddr; _aTransParamAddr=NULL;
+  if (_nTransParams==0){return;}
+
+  _aTransParamAddr=new double *[_nTransParams];
+  ExitGracefullyIf(_aTransParamAddr==NULL,"CModel::InitializeTransientParams",OUT_OF_MEMORY);
+  for (int j=0;j<_nTransParams;j++)
+  {
+    _aTransParamAddr[j]=GetParameterAddress(_pTransParams[j]->GetParameterClassType(),
+                                            _pTransParams[j]->GetParameterName(),
+                                            _pTransParams[j]->GetParameterClass());
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief initializes all paramter override structures
 ///
@@ -747,9 +1003,7 @@ void CModel::InitializeParameterOverrides()
     // Search for SB Group - this is done here so that group can be read in .rvp without knowledge of SB groups
     int pp=DOESNT_EXIST;
     string sbg_name=_pParamOverrides[i]->SBGroup_name;
-    for (int j=0;j<_nSBGroups;j++){
-      if (_pSBGroups[j]->GetName()==sbg_name){pp=j; break;}
-    }
+    if (GetSubBasinGroup(sbg_name)!=NULL){pp=GetSubBasinGroup(sbg_name)->GetGlobalIndex();}
     if (pp==DOESNT_EXIST){
       ExitGracefully("CModel::InitializeParameterOverrides() : Invalid subbasin group in :LocalParameterOverride command",BAD_DATA);
     }
@@ -768,32 +1022,33 @@ void CModel::InitializeParameterOverrides()
 
 //////////////////////////////////////////////////////////////////
 /// \brief Generates gauge weights
-/// \details Populates an array aWts with interpolation weightings for distribution of gauge station data to HRUs
+/// \details Populates sparse (CSR) matrix W with interpolation weightings for distribution of gauge station data to HRUs.
+///  Weights are generated one HRU at a time, so that memory scales with the number of non-zero weights rather than [nHRUs][nGauges]
 /// \remark Called after initialize routing orders
 ///
-/// \param aWts [out] weights matrix [nHRUs][nGauges]
+/// \param W [out] sparse weights matrix [nHRUs][nGauges]
 /// \param forcing [int] forcing type (F_PRECIP or F_TEMP)
 /// \param &Options [in] Global model options information
 //
-void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, const optStruct &Options)
+void CModel::GenerateGaugeWeights(csr_weights &W, const forcing_type forcing, const optStruct &Options)
 {
   int k,g;
   bool *has_data=NULL;
+  double *wt=NULL;        //weights of single HRU [size: _nGauges]
+  double **aFileWts=NULL; //weights read from file [_nHydroUnits][_nGauges] (INTERP_FROM_FILE only)
   location xyh,xyg;
+  vector<int>    cols;
+  vector<double> wts;
 
   //allocate memory
-  aWts=NULL;
-  aWts=new double *[_nHydroUnits];
-  ExitGracefullyIf(aWts==NULL,"GenerateGaugeWeights",OUT_OF_MEMORY);
-
-  for (k=0;k<_nHydroUnits;k++){
-    aWts[k]=NULL;
-    aWts[k]=new double [_nGauges];
-    ExitGracefullyIf(aWts[k]==NULL,"GenerateGaugeWeights(2)",OUT_OF_MEMORY);
-    for (g=0;g<_nGauges;g++){
-      aWts[k][g]=0.0;
-    }
-  }
+  W.Clear();
+  W.nRows=_nHydroUnits;
+  W.rowstart=new int [_nHydroUnits+1];
+  ExitGracefullyIf(W.rowstart==NULL,"GenerateGaugeWeights",OUT_OF_MEMORY);
+  for (k=0;k<=_nHydroUnits;k++){W.rowstart[k]=0;}
+
+  wt=new double [_nGauges];
+  ExitGracefullyIf(wt==NULL,"GenerateGaugeWeights(2)",OUT_OF_MEMORY);
 
   int nGaugesWithData=0;
   has_data=new bool [_nGauges];
@@ -804,126 +1059,22 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
   }
 
   //handle the case that weights are allowed to sum to zero -netCDF is available
-  //still need to allocate all zeros
-  if (ForcingGridIsAvailable(forcing)){ return; }
-  if ((forcing==F_TEMP_AVE) && (ForcingGridIsAvailable(F_TEMP_DAILY_MIN))){return;} //this is also acceptable
-  if ((forcing==F_TEMP_AVE) && (ForcingGridIsAvailable(F_TEMP_DAILY_AVE))){return;} //this is also acceptable
-  if ((forcing==F_PRECIP  ) && (ForcingGridIsAvailable(F_RAINFALL))){return;} //this is also acceptable
+  //(all rows empty)
+  bool all_zero=false;
+  if (ForcingGridIsAvailable(forcing)){ all_zero=true; }
+  if ((forcing==F_TEMP_AVE) && (ForcingGridIsAvailable(F_TEMP_DAILY_MIN))){all_zero=true;} //this is also acceptable
+  if ((forcing==F_TEMP_AVE) && (ForcingGridIsAvailable(F_TEMP_DAILY_AVE))){all_zero=true;} //this is also acceptable
+  if ((forcing==F_PRECIP  ) && (ForcingGridIsAvailable(F_RAINFALL))){all_zero=true;} //this is also acceptable
+  if (all_zero){
+    delete [] has_data;
+    delete [] wt;
+    return;
+  }
 
   string warn="GenerateGaugeWeights: no gauges present with the following data: "+ForcingToString(forcing);
   ExitGracefullyIf(nGaugesWithData==0,warn.c_str(),BAD_DATA_WARN);
 
-  switch(Options.interpolation)
-  {
-  case(INTERP_NEAREST_NEIGHBOR)://---------------------------------------------
-  {
-    //w=1.0 for nearest gauge, 0.0 for all others
-    double distmin,dist;
-    int    g_min=0;
-    for (k=0;k<_nHydroUnits;k++)
-    {
-      xyh=_pHydroUnits[k]->GetCentroid();
-      g_min=0;
-      distmin=ALMOST_INF;
-      for (g=0;g<_nGauges;g++)
-      {
-        if(has_data[g]){
-          xyg=_pGauges[g]->GetLocation();
-          dist=pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2);
-          if(dist<distmin){ distmin=dist;g_min=g; }
-        }
-        aWts[k][g]=0.0;
-      }
-      aWts[k][g_min]=1.0;
-
-    }
-    break;
-  }
-  case(INTERP_AVERAGE_ALL):                   //---------------------------------------------
-  {
-    for (k=0;k<_nHydroUnits;k++){
-      for (g=0;g<_nGauges;g++){
-        if(has_data[g]){aWts[k][g]=1.0/(double)(nGaugesWithData);}
-        else           {aWts[k][g]=0.0;}
-      }
-    }
-    break;
-  }
-  case(INTERP_INVERSE_DISTANCE):                      //---------------------------------------------
-  {
-    //wt_i = (1/r_i^2) / (sum{1/r_j^2})
-    double dist;
-    double denomsum;
-    const double IDW_POWER=2.0;
-    int atop_gauge(DOESNT_EXIST);
-    for (k=0;k<_nHydroUnits;k++)
-    {
-      xyh=_pHydroUnits[k]->GetCentroid();
-      atop_gauge=DOESNT_EXIST;
-      denomsum=0;
-      for (g=0;g<_nGauges;g++)
-      {
-        if(has_data[g]){
-          xyg=_pGauges[g]->GetLocation();
-          dist=sqrt(pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2));
-          denomsum+=pow(dist,-IDW_POWER);
-          if(dist<REAL_SMALL){ atop_gauge=g; }//handles limiting case where weight= large number/large number
-        }
-      }
-
-      for (g=0;g<_nGauges;g++)
-      {
-        aWts[k][g]=0.0;
-        if(has_data[g]){
-          xyg=_pGauges[g]->GetLocation();
-          dist=sqrt(pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2));
-
-          if(atop_gauge!=DOESNT_EXIST){ aWts[k][g]=0.0;aWts[k][atop_gauge]=1.0; }
-          else                        { aWts[k][g]=pow(dist,-IDW_POWER)/denomsum;         }
-        }
-      }
-    }
-
-    break;
-  }
-  case(INTERP_INVERSE_DISTANCE_ELEVATION):                    //---------------------------------------------
-  {
-    //wt_i = (1/r_i^2) / (sum{1/r_j^2})
-    double dist;
-    double elevh,elevg;
-    double denomsum;
-    const double IDW_POWER=2.0;
-    int atop_gauge(DOESNT_EXIST);
-    for(k=0; k<_nHydroUnits; k++)
-    {
-      elevh=_pHydroUnits[k]->GetElevation();
-      atop_gauge=DOESNT_EXIST;
-      denomsum=0;
-      for(g=0; g<_nGauges; g++)
-      {
-        if(has_data[g]){
-          elevg=_pGauges[g]->GetElevation();
-          dist=abs(elevh-elevg);
-          denomsum+=pow(dist,-IDW_POWER);
-          if(dist<REAL_SMALL){ atop_gauge=g; }//handles limiting case where weight= large number/large number
-        }
-      }
-
-      for(g=0; g<_nGauges; g++)
-      {
-        aWts[k][g]=0.0;
-        if(has_data[g]){
-          elevg=_pGauges[g]->GetElevation();
-          dist=abs(elevh-elevg);
-          if(atop_gauge!=DOESNT_EXIST){ aWts[k][g]=0.0; aWts[k][atop_gauge]=1.0; }
-          else                        { aWts[k][g]=pow(dist,-IDW_POWER)/denomsum; }
-        }
-      }
-    }
-
-    break;
-  }
-  case (INTERP_FROM_FILE):                    //---------------------------------------------
+  if (Options.interpolation==INTERP_FROM_FILE)
   {
     //format:
     //:GaugeWeightTable
@@ -945,6 +1096,14 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
     }
     else
     {
+      aFileWts=new double *[_nHydroUnits];
+      ExitGracefullyIf(aFileWts==NULL,"GenerateGaugeWeights(4)",OUT_OF_MEMORY);
+      for (k=0;k<_nHydroUnits;k++){
+        aFileWts[k]=new double [_nGauges];
+        ExitGracefullyIf(aFileWts[k]==NULL,"GenerateGaugeWeights(5)",OUT_OF_MEMORY);
+        for (g=0;g<_nGauges;g++){aFileWts[k][g]=0.0;}
+      }
+
       CParser *p=new CParser(INPUT,Options.interp_file,line);
       bool done(false);
       while (!done)
@@ -961,12 +1120,12 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
         }
       }
       int junk;
-      p->Parse2DArray_dbl(aWts,_nHydroUnits,_nGauges,junk);
+      p->Parse2DArray_dbl(aFileWts,_nHydroUnits,_nGauges,junk);
 
       for (k=0;k<_nHydroUnits;k++){
         double sum=0;
         for (g=0;g<_nGauges;g++){
-          sum+=aWts[k][g];
+          sum+=aFileWts[k][g];
         }
         if(fabs(sum-1.0)>1e-4){
           ExitGracefully("GenerateGaugeWeights: INTERP_FROM_FILE: user-specified weights for gauge don't add up to 1.0",BAD_DATA);
@@ -975,54 +1134,221 @@ void CModel::GenerateGaugeWeights(double **&aWts, const forcing_type forcing, co
       INPUT.close();
       delete p;
     }
-    break;
   }
-  default:
+
+  ofstream WTS;
+  if(Options.write_interp_wts)
   {
-    ExitGracefully("CModel::GenerateGaugeWeights: Invalid interpolation method",BAD_DATA);
+    string tmpFilename=FilenamePrepare("InterpolationWeights.csv",Options);
+    WTS.open(tmpFilename.c_str(),ios::app);
+    WTS<<"Weights for "<<ForcingToString(forcing)<<"--------------------------------------"<<endl;
+    WTS<<"HRU index (k), HRU ID";
+    for(g=0; g<_nGauges;g++) { WTS<<","<<_pGauges[g]->GetName(); }
+    WTS<<endl;
   }
+
+  //spatial index over gauges with data, used to find nearest gauge(s) without searching all gauges for each HRU
+  CKDTree *pGaugeTree=NULL;
+  int     *aNearest  =NULL;  //indices of nearest gauges to HRU [size: nNearest]
+  double  *aNearDist2=NULL;  //squared distances to nearest gauges [size: nNearest]
+  int      nNearest  =nGaugesWithData;
+  if ((Options.interp_max_gauges>0) && (Options.interp_max_gauges<nGaugesWithData)){nNearest=Options.interp_max_gauges;}
+  bool elev_interp=(Options.interpolation==INTERP_INVERSE_DISTANCE_ELEVATION);
+  if ((Options.interpolation==INTERP_NEAREST_NEIGHBOR) ||
+      (((Options.interpolation==INTERP_INVERSE_DISTANCE) || (elev_interp)) && (nNearest<nGaugesWithData)))
+  {
+    double *gx =new double [nGaugesWithData];
+    double *gy =new double [nGaugesWithData];
+    int    *gID=new int    [nGaugesWithData];
+    ExitGracefullyIf(gID==NULL,"GenerateGaugeWeights(7)",OUT_OF_MEMORY);
+    int i=0;
+    for (g=0;g<_nGauges;g++){
+      if (has_data[g]){
+        xyg=_pGauges[g]->GetLocation();
+        if (elev_interp){gx[i]=_pGauges[g]->GetElevation(); gy[i]=0.0;} //1-D index on elevation
+        else            {gx[i]=xyg.UTM_x;                   gy[i]=xyg.UTM_y;}
+        gID[i]=g;
+        i++;
+      }
+    }
+    pGaugeTree=new CKDTree(gx,gy,gID,nGaugesWithData);
+    delete [] gx; delete [] gy; delete [] gID;
+
+    aNearest  =new int    [max(nNearest,1)];
+    aNearDist2=new double [max(nNearest,1)];
+    ExitGracefullyIf(aNearDist2==NULL,"GenerateGaugeWeights(8)",OUT_OF_MEMORY);
   }
 
-  //Override weights where specified
-  for (k = 0; k < _nHydroUnits; k++) {
-    if (_pHydroUnits[k]->GetSpecifiedGaugeIndex() != DOESNT_EXIST) {
+  vector<int> cand; //candidate gauges for inverse distance methods, in order of increasing gauge index
+  vector<int> nz;   //gauges with weights set for current HRU, in order of increasing gauge index
+  for (g=0;g<_nGauges;g++){wt[g]=0.0;}
+
+  for (k=0;k<_nHydroUnits;k++)
+  {
+    cand.clear();
+    if ((Options.interpolation==INTERP_INVERSE_DISTANCE) || (elev_interp))
+    {
+      if (pGaugeTree==NULL){
+        for (g=0;g<_nGauges;g++){if (has_data[g]){cand.push_back(g);}}
+      }
+      else{ //only the nearest Options.interp_max_gauges gauges
+        int nFound;
+        xyh=_pHydroUnits[k]->GetCentroid();
+        if (elev_interp){nFound=pGaugeTree->GetNearest(_pHydroUnits[k]->GetElevation(),0.0,nNearest,aNearest,aNearDist2);}
+        else            {nFound=pGaugeTree->GetNearest(xyh.UTM_x,xyh.UTM_y             ,nNearest,aNearest,aNearDist2);}
+        cand.assign(aNearest,aNearest+nFound);
+        sort(cand.begin(),cand.end());
+      }
+    }
+
+    switch(Options.interpolation)
+    {
+    case(INTERP_NEAREST_NEIGHBOR)://---------------------------------------------
+    {
+      //w=1.0 for nearest gauge, 0.0 for all others
+      int    g_min=0;
+      xyh=_pHydroUnits[k]->GetCentroid();
+      if (pGaugeTree->GetNearest(xyh.UTM_x,xyh.UTM_y,1,aNearest,aNearDist2)>0){g_min=aNearest[0];}
+      wt[g_min]=1.0;
+      nz.push_back(g_min);
+      break;
+    }
+    case(INTERP_AVERAGE_ALL):                   //---------------------------------------------
+    {
       for (g=0;g<_nGauges;g++){
-        aWts[k][g]=0.0;
+        if(has_data[g]){wt[g]=1.0/(double)(nGaugesWithData); nz.push_back(g);}
+      }
+      break;
+    }
+    case(INTERP_INVERSE_DISTANCE):                      //---------------------------------------------
+    {
+      //wt_i = (1/r_i^2) / (sum{1/r_j^2})
+      double dist;
+      double denomsum;
+      const double IDW_POWER=2.0;
+      int atop_gauge(DOESNT_EXIST);
+      xyh=_pHydroUnits[k]->GetCentroid();
+      atop_gauge=DOESNT_EXIST;
+      denomsum=0;
+      for (int i=0;i<(int)(cand.size());i++)
+      {
+        g=cand[i];
+        xyg=_pGauges[g]->GetLocation();
+        dist=sqrt(pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2));
+        denomsum+=pow(dist,-IDW_POWER);
+        if(dist<REAL_SMALL){ atop_gauge=g; }//handles limiting case where weight= large number/large number
+      }
+
+      for (int i=0;i<(int)(cand.size());i++)
+      {
+        g=cand[i];
+        xyg=_pGauges[g]->GetLocation();
+        dist=sqrt(pow(xyh.UTM_x-xyg.UTM_x,2)+pow(xyh.UTM_y-xyg.UTM_y,2));
+
+        if(atop_gauge!=DOESNT_EXIST){ wt[g]=0.0;wt[atop_gauge]=1.0; }
+        else                        { wt[g]=pow(dist,-IDW_POWER)/denomsum;         }
+        nz.push_back(g);
+      }
+      break;
+    }
+    case(INTERP_INVERSE_DISTANCE_ELEVATION):                    //---------------------------------------------
+    {
+      //wt_i = (1/r_i^2) / (sum{1/r_j^2})
+      double dist;
+      double elevh,elevg;
+      double denomsum;
+      const double IDW_POWER=2.0;
+      int atop_gauge(DOESNT_EXIST);
+      elevh=_pHydroUnits[k]->GetElevation();
+      atop_gauge=DOESNT_EXIST;
+      denomsum=0;
+      for (int i=0;i<(int)(cand.size());i++)
+      {
+        g=cand[i];
+        elevg=_pGauges[g]->GetElevation();
+        dist=abs(elevh-elevg);
+        denomsum+=pow(dist,-IDW_POWER);
+        if(dist<REAL_SMALL){ atop_gauge=g; }//handles limiting case where weight= large number/large number
+      }
+
+      for (int i=0;i<(int)(cand.size());i++)
+      {
+        g=cand[i];
+        elevg=_pGauges[g]->GetElevation();
+        dist=abs(elevh-elevg);
+        if(atop_gauge!=DOESNT_EXIST){ wt[g]=0.0; wt[atop_gauge]=1.0; }
+        else                        { wt[g]=pow(dist,-IDW_POWER)/denomsum; }
+        nz.push_back(g);
+      }
+      break;
+    }
+    case (INTERP_FROM_FILE):                    //---------------------------------------------
+    {
+      for (g=0;g<_nGauges;g++){wt[g]=aFileWts[k][g]; nz.push_back(g);}
+      break;
+    }
+    default:
+    {
+      ExitGracefully("CModel::GenerateGaugeWeights: Invalid interpolation method",BAD_DATA);
+    }
+    }
+
+    //Override weights where specified
+    if (_pHydroUnits[k]->GetSpecifiedGaugeIndex() != DOESNT_EXIST) {
+      for (int i=0;i<(int)(nz.size());i++){
+        wt[nz[i]]=0.0;
       }
+      nz.clear();
       g=_pHydroUnits[k]->GetSpecifiedGaugeIndex();
-      aWts[k][g]=1.0;
+      wt[g]=1.0;
+      nz.push_back(g);
     }
-  }
 
-  //check quality - weights for each HRU should add to 1
-  double sum;
-  for (k=0;k<_nHydroUnits;k++){
-    sum=0.0;
-    for (g=0;g<_nGauges;g++){sum+=aWts[k][g];}
+    //check quality - weights for each HRU should add to 1
+    double sum=0.0;
+    for (int i=0;i<(int)(nz.size());i++){sum+=wt[nz[i]];}
 
     ExitGracefullyIf((fabs(sum-1.0)>REAL_SMALL) && (INTERP_FROM_FILE) && (_nGauges>1),
                      "GenerateGaugeWeights: Bad weighting scheme- weights for each HRU must sum to 1",BAD_DATA);
     ExitGracefullyIf((fabs(sum-1.0)>REAL_SMALL) && !(INTERP_FROM_FILE) && (_nGauges>1),
                      "GenerateGaugeWeights: Bad weighting scheme- weights for each HRU must sum to 1",RUNTIME_ERR);
-  }
 
-  if(Options.write_interp_wts)
-  {
-    ofstream WTS;
-    string tmpFilename=FilenamePrepare("InterpolationWeights.csv",Options);
-    WTS.open(tmpFilename.c_str(),ios::app);
-    WTS<<"Weights for "<<ForcingToString(forcing)<<"--------------------------------------"<<endl;
-    WTS<<"HRU index (k), HRU ID";
-    for(g=0; g<_nGauges;g++) { WTS<<","<<_pGauges[g]->GetName(); }
-    WTS<<endl;
-    for(k=0;k<_nHydroUnits;k++) {
+    if(Options.write_interp_wts)
+    {
       WTS<<k<<","<<_pHydroUnits[k]->GetID();
-
-      for(g=0;g<_nGauges;g++) {WTS<<","<<aWts[k][g]; }
+      for(g=0;g<_nGauges;g++) {WTS<<","<<wt[g]; }
       WTS<<endl;
     }
-    WTS.close();
+
+    //compress row k (and reset weights for next HRU)
+    for (int i=0;i<(int)(nz.size());i++){
+      g=nz[i];
+      if (wt[g]!=0.0){
+        cols.push_back(g);
+        wts .push_back(wt[g]);
+      }
+      wt[g]=0.0;
+    }
+    nz.clear();
+    W.rowstart[k+1]=(int)(cols.size());
+  }
+  if(Options.write_interp_wts){WTS.close();}
+
+  W.nNonZero=(int)(cols.size());
+  W.cols=new int    [max(W.nNonZero,1)];
+  W.wts =new double [max(W.nNonZero,1)];
+  ExitGracefullyIf(W.wts==NULL,"GenerateGaugeWeights(6)",OUT_OF_MEMORY);
+  for (int i=0;i<W.nNonZero;i++){
+    W.cols[i]=cols[i];
+    W.wts [i]=wts [i];
   }
 
-  delete[] has_data;
+  if (aFileWts!=NULL){
+    for (k=0;k<_nHydroUnits;k++){delete [] aFileWts[k];} delete [] aFileWts;
+  }
+  delete pGaugeTree;
+  delete [] aNearest;
+  delete [] aNearDist2;
+  delete [] has_data;
+  delete [] wt;
 }
@@ -0,0 +1,330 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------*/
+#include "Model.h"
+#include <cstring>
+
+/*****************************************************************
+   Binary snapshot (.rvc.bin) and in-memory checkpoint routines
+   All member functions of CModel
+   -WriteBinarySnapshot
+   -ReadBinarySnapshot
+   -GetModelState
+   -SetModelState
+   -SaveCheckpoint
+   -RestoreCheckpoint
+   -ResetCumulativeBalances
+------------------------------------------------------------------
+   A binary snapshot holds the same state as the .rvc solution file
+   it is written with (HRU state variables, subbasin routing histories,
+   reservoir states and in-channel constituent mass), at full precision,
+   as a snapshot_header followed by a flat array of doubles.
+   A checkpoint holds the same state in memory, for resetting the
+   model between ensemble members
+*****************************************************************/
+
+const unsigned long long FNV_OFFSET_BASIS=14695981039346656037ULL;
+const unsigned long long FNV_PRIME       =1099511628211ULL;
+
+//////////////////////////////////////////////////////////////////
+/// \brief updates 64-bit FNV-1a hash with nBytes bytes of data
+//
+static void FNVHash(const char *data, const size_t nBytes, unsigned long long &hash)
+{
+  for (size_t b=0;b<nBytes;b++){
+    hash^=(unsigned char)(data[b]);
+    hash*=FNV_PRIME;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief calculates 64-bit FNV-1a hash of file contents
+/// \param &filename [in] file name
+/// \param &hash [out] hash of file contents
+/// \return false if file cannot be opened
+//
+static bool FileChecksum(const string &filename, unsigned long long &hash)
+{
+  ifstream IN(filename.c_str(),ios::binary);
+  if (IN.fail()){return false;}
+  const int BUFSIZE=1<<20;
+  char *buf=new char [BUFSIZE];
+  hash=FNV_OFFSET_BASIS;
+  while (IN.read(buf,BUFSIZE) || (IN.gcount()>0)){
+    FNVHash(buf,(size_t)(IN.gcount()),hash);
+  }
+  delete [] buf;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes binary snapshot of current model state
+/// \details Written alongside the .rvc solution file; the hash of the .rvc file is stored in the header so that
+/// the snapshot is only used in place of the .rvc file if the latter has not since been changed
+///
+/// \param &filename [in] snapshot file name (typically solution.rvc.bin)
+/// \param &rvc_filename [in] name of .rvc solution file just written with the same state
+/// \param &tt [in] time structure of snapshot
+//
+void CModel::WriteBinarySnapshot(const string &filename, const string &rvc_filename, const time_struct &tt) const
+{
+  int nConstits=_pTransModel->GetNumConstituents();
+  vector<double> aSnap;
+
+  //structure block-------------------------------------------
+  for (int i=0;i<_nStateVars;i++){
+    aSnap.push_back((double)(_aStateVarType [i]));
+    aSnap.push_back((double)(_aStateVarLayer[i]));
+  }
+  for (int k=0;k<_nHydroUnits;k++){
+    aSnap.push_back((double)(_pHydroUnits[k]->GetID()));
+  }
+  for (int p=0;p<_nSubBasins;p++){
+    const CReservoir *pRes=_pSubBasins[p]->GetReservoir();
+    aSnap.push_back((double)(_pSubBasins[p]->GetID()));
+    aSnap.push_back((double)(_pSubBasins[p]->GetNumSegments()));
+    aSnap.push_back((double)(_pSubBasins[p]->GetLatHistorySize()));
+    aSnap.push_back((double)(_pSubBasins[p]->GetInflowHistorySize()));
+    aSnap.push_back((double)((pRes==NULL) ? DOESNT_EXIST : pRes->GetNumControlStructures()));
+  }
+  for (int c=0;c<nConstits;c++){
+    aSnap.push_back((double)(_pTransModel->GetConstituentModel2(c)->GetType()));
+  }
+
+  //state-----------------------------------------------------
+  for (int k=0;k<_nHydroUnits;k++){
+    for (int i=0;i<_nStateVars;i++){
+      aSnap.push_back(_pHydroUnits[k]->GetStateVarValue(i));
+    }
+  }
+  for (int p=0;p<_nSubBasins;p++){
+    _pSubBasins[p]->WriteToSnapshot(aSnap);
+  }
+  for (int c=0;c<nConstits;c++){
+    _pTransModel->GetConstituentModel2(c)->WriteToSnapshot(aSnap);
+  }
+
+  //header----------------------------------------------------
+  snapshot_header h;
+  memset(&h,0,sizeof(h));
+  memcpy(h.magic,RVC_SNAPSHOT_MAGIC,sizeof(h.magic));
+  h.version      =RVC_SNAPSHOT_VERSION;
+  h.byte_order   =RVC_SNAPSHOT_BYTEORDER;
+  h.nHRUs        =_nHydroUnits;
+  h.nStateVars   =_nStateVars;
+  h.nSubBasins   =_nSubBasins;
+  h.nConstituents=nConstits;
+  h.year         =tt.year;
+  h.julian_day   =tt.julian_day;
+  h.nValues      =(long long)(aSnap.size());
+  h.checksum     =FNV_OFFSET_BASIS;
+  if (!aSnap.empty()){FNVHash((const char*)(aSnap.data()),aSnap.size()*sizeof(double),h.checksum);}
+  if (!FileChecksum(rvc_filename,h.rvc_checksum)){h.rvc_checksum=0;}
+
+  ofstream SNAP(filename.c_str(),ios::binary);
+  if (SNAP.fail()){
+    WriteWarning(("CModel::WriteBinarySnapshot: Unable to open output file "+filename+" for writing.").c_str(),false);
+    return;
+  }
+  SNAP.write((const char*)(&h),sizeof(h));
+  if (!aSnap.empty()){SNAP.write((const char*)(aSnap.data()),aSnap.size()*sizeof(double));}
+  SNAP.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Reads model state from binary snapshot written by WriteBinarySnapshot
+/// \details The snapshot is only used if its header, checksum and model structure (state variables, HRUs,
+/// subbasin routing array sizes, reservoirs and constituents) match the current model and, if the .rvc file
+/// (Options.rvc_filename) exists, it is unchanged since the snapshot was written. Nothing is modified unless all checks pass.
+/// As with the .rvc file, cumulative precipitation/atmosphere state variables are not restored (set to zero)
+///
+/// \param &filename [in] snapshot file name
+/// \param &Options [in] Global model options information
+/// \return true if model state was read from snapshot; false if the .rvc file must be read instead
+//
+bool CModel::ReadBinarySnapshot(const string &filename, const optStruct &Options)
+{
+  ifstream SNAP(filename.c_str(),ios::binary);
+  if (SNAP.fail()){return false;}
+
+  int nConstits=_pTransModel->GetNumConstituents();
+  string problem="";
+  snapshot_header h;
+  SNAP.read((char*)(&h),sizeof(h));
+  if      (SNAP.fail() || (memcmp(h.magic,RVC_SNAPSHOT_MAGIC,sizeof(h.magic))!=0)){problem="not a Raven binary snapshot";}
+  else if (h.version!=RVC_SNAPSHOT_VERSION)    {problem="unsupported snapshot version "+to_string(h.version);}
+  else if (h.byte_order!=RVC_SNAPSHOT_BYTEORDER){problem="written on machine with different byte order";}
+  else if ((h.nHRUs!=_nHydroUnits) || (h.nStateVars!=_nStateVars) || (h.nSubBasins!=_nSubBasins) || (h.nConstituents!=nConstits)){
+    problem="number of HRUs, state variables, subbasins or constituents differs from model";
+  }
+  else if (h.nValues<0){problem="corrupt header";}
+  else {
+    streampos pos=SNAP.tellg();                  //check value count against file size before allocating
+    SNAP.seekg(0,ios::end);
+    long long nbytes=(long long)(SNAP.tellg()-pos);
+    SNAP.seekg(pos);
+    if      (SNAP.fail())                                    {problem="unable to determine file size";}
+    else if (h.nValues>nbytes/(long long)(sizeof(double))) {problem="file is truncated or header is corrupt";}
+  }
+
+  vector<double> aSnap;
+  if (problem==""){
+    aSnap.resize((size_t)(h.nValues));
+    if (!aSnap.empty()){SNAP.read((char*)(aSnap.data()),aSnap.size()*sizeof(double));}
+    unsigned long long checksum=FNV_OFFSET_BASIS;
+    if (!aSnap.empty()){FNVHash((const char*)(aSnap.data()),aSnap.size()*sizeof(double),checksum);}
+    if      (SNAP.fail())          {problem="file is truncated";}
+    else if (checksum!=h.checksum) {problem="checksum mismatch";}
+  }
+  SNAP.close();
+
+  unsigned long long rvc_checksum;
+  if ((problem=="") && (FileChecksum(Options.rvc_filename,rvc_checksum)) && (rvc_checksum!=h.rvc_checksum)){
+    problem=".rvc file has changed since snapshot was written";
+  }
+
+  //check structure block against model-----------------------
+  size_t i=0;
+  size_t nStruct=2*_nStateVars+_nHydroUnits+5*_nSubBasins+nConstits;
+  if ((problem=="") && (aSnap.size()<nStruct)){problem="file is truncated";}
+  if (problem==""){
+    size_t nState=nStruct+(size_t)(_nHydroUnits)*_nStateVars;
+    for (int j=0;j<_nStateVars;j++,i+=2){
+      if ((aSnap[i]!=(double)(_aStateVarType[j])) || (aSnap[i+1]!=(double)(_aStateVarLayer[j]))){problem="state variables differ from model";}
+    }
+    for (int k=0;k<_nHydroUnits;k++,i++){
+      if (aSnap[i]!=(double)(_pHydroUnits[k]->GetID())){problem="HRU IDs differ from model";}
+    }
+    for (int p=0;p<_nSubBasins;p++,i+=5){
+      const CReservoir *pRes=_pSubBasins[p]->GetReservoir();
+      int nSegs=_pSubBasins[p]->GetNumSegments();
+      int nLat =_pSubBasins[p]->GetLatHistorySize();
+      int nIn  =_pSubBasins[p]->GetInflowHistorySize();
+      int nCS  =(pRes==NULL) ? DOESNT_EXIST : pRes->GetNumControlStructures();
+      if ((aSnap[i  ]!=(double)(_pSubBasins[p]->GetID())) ||
+          (aSnap[i+1]!=(double)(nSegs)) || (aSnap[i+2]!=(double)(nLat)) ||
+          (aSnap[i+3]!=(double)(nIn))   || (aSnap[i+4]!=(double)(nCS))){
+        problem="subbasin IDs, routing history sizes or reservoirs differ from model";
+      }
+      nState+=(nSegs+1)+(nLat+1)+nIn+2;
+      if (pRes!=NULL){nState+=6+2*nCS;}
+    }
+    for (int c=0;c<nConstits;c++,i++){
+      CConstituentModel *pConstit=_pTransModel->GetConstituentModel(c);
+      if (aSnap[i]!=(double)(pConstit->GetType())){problem="constituents differ from model";}
+      for (int p=0;p<_nSubBasins;p++){
+        nState+=(_pSubBasins[p]->GetNumSegments()+1)+(_pSubBasins[p]->GetLatHistorySize()+1)+_pSubBasins[p]->GetInflowHistorySize()+2;
+        if (_pSubBasins[p]->GetReservoir()!=NULL){nState+=6;}
+        if (pConstit->GetType()==ENTHALPY){nState+=1;}
+      }
+    }
+    if ((problem=="") && (aSnap.size()!=nState)){problem="size of state data differs from model";}
+  }
+
+  if (problem!=""){
+    WriteWarning("CModel::ReadBinarySnapshot: "+filename+": "+problem+". Initial conditions will be read from .rvc file instead.",Options.noisy);
+    return false;
+  }
+  if (Options.noisy){cout<<"Reading binary snapshot "<<filename<<endl;}
+
+  if ((Options.julian_start_day!=h.julian_day) || (Options.julian_start_year!=h.year)){
+    WriteWarning("Time stamp of binary snapshot is not consistent with :StartDate command in model (.rvi) file",Options.noisy);
+  }
+
+  //restore state---------------------------------------------
+  for (int k=0;k<_nHydroUnits;k++){
+    for (int j=0;j<_nStateVars;j++,i++){
+      if ((_aStateVarType[j]==ATMOS_PRECIP) || (_aStateVarType[j]==ATMOSPHERE)){_pHydroUnits[k]->SetStateVarValue(j,0.0);}
+      else                                                                     {_pHydroUnits[k]->SetStateVarValue(j,aSnap[i]);}
+    }
+  }
+  for (int p=0;p<_nSubBasins;p++){
+    _pSubBasins[p]->ReadFromSnapshot(aSnap.data(),i);
+  }
+  for (int c=0;c<nConstits;c++){
+    _pTransModel->GetConstituentModel(c)->ReadFromSnapshot(aSnap.data(),i);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Appends current model state to in-memory array
+/// \details Stores the HRU state matrix, subbasin routing histories and reservoir states, and in-channel constituent
+/// mass (i.e., the state held in the .rvc solution file) at full precision; restored by SetModelState()
+/// \param &aState [out] array to which model state is appended
+//
+void CModel::GetModelState(vector<double> &aState) const
+{
+  aState.insert(aState.end(),_aStateMatrix[0],_aStateMatrix[0]+(size_t)(_nHydroUnits)*_SVStride);
+  for (int p=0;p<_nSubBasins;p++){
+    _pSubBasins[p]->WriteToSnapshot(aState);
+  }
+  for (int c=0;c<_pTransModel->GetNumConstituents();c++){
+    _pTransModel->GetConstituentModel(c)->WriteToSnapshot(aState);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Sets model state from in-memory array written by GetModelState()
+/// \param *aState [in] array of model state values
+/// \param &i [in/out] index of first model state value in aState; returned as index after last value read
+/// \remark model structure must be unchanged since state was stored
+//
+void CModel::SetModelState(const double *aState, size_t &i)
+{
+  size_t nHRUState=(size_t)(_nHydroUnits)*_SVStride;
+  memcpy(_aStateMatrix[0],aState+i,nHRUState*sizeof(double)); i+=nHRUState;
+  for (int p=0;p<_nSubBasins;p++){
+    _pSubBasins[p]->ReadFromSnapshot(aState,i);
+  }
+  for (int c=0;c<_pTransModel->GetNumConstituents();c++){
+    _pTransModel->GetConstituentModel(c)->ReadFromSnapshot(aState,i);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Saves in-memory checkpoint of current model state
+/// \details Stores the model state (see GetModelState()), so that the model may be reset to this state by
+/// RestoreCheckpoint() without re-reading initial conditions. Mass balance terms are not stored (see ResetCumulativeBalances()).
+/// Replaces any previously saved checkpoint
+//
+void CModel::SaveCheckpoint()
+{
+  _aCheckpoint.clear();
+  GetModelState(_aCheckpoint);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Resets model state to checkpoint saved by SaveCheckpoint()
+/// \remark model structure must be unchanged since checkpoint was saved
+//
+void CModel::RestoreCheckpoint()
+{
+  ExitGracefullyIf(_aCheckpoint.empty(),"CModel::RestoreCheckpoint: no checkpoint has been saved",RUNTIME_ERR);
+  const double *aC=_aCheckpoint.data();
+  size_t i=0;
+  SetModelState(aC,i);
+  ExitGracefullyIf(i!=_aCheckpoint.size(),"CModel::RestoreCheckpoint: model structure has changed since checkpoint was saved",RUNTIME_ERR);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns true if an in-memory checkpoint has been saved using SaveCheckpoint()
+//
+bool CModel::HasCheckpoint() const{return !_aCheckpoint.empty();}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Zeroes all cumulative and current-time-step mass balance terms, as upon initialization
+/// \remark called prior to each ensemble member run (see CEnsemble::ResetInitialConditions())
+//
+void CModel::ResetCumulativeBalances()
+{
+  for (int k=0;k<_nHydroUnits;k++){
+    for (int js=0;js<_nTotalConnections;js++){_aCumulativeBal[k][js]=0.0; _aFlowBal[k][js]=0.0;}
+  }
+  for (int jss=0;jss<_nTotalLatConnections;jss++){
+    _aCumulativeLatBal[jss]=0.0;
+    _aFlowLatBal      [jss]=0.0;
+  }
+  _CumulInput=_CumulOutput=0.0;
+}
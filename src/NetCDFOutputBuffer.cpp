@@ -0,0 +1,187 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------*/
+#include "NetCDFOutputBuffer.h"
+
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the NetCDF output buffer constructor
+/// \param ncid [in] ID of NetCDF file, already out of define mode
+/// \param capacity [in] maximum number of time steps buffered before values are written to file
+//
+CNetCDFOutputBuffer::CNetCDFOutputBuffer(const int ncid,const int capacity)
+{
+  _ncid    =ncid;
+  _capacity=max(capacity,1);
+  _nVars   =0;
+  _aVarID  =NULL;
+  _aWidth  =NULL;
+  _aBuffer =NULL;
+  _aPadGaps=NULL;
+  _aRowSet =new bool [_capacity];
+  _start   =0;
+  _nRows   =0;
+  _row     =-1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Implementation of the NetCDF output buffer destructor
+/// \remark does not flush; buffer contents are discarded if Flush() has not been called
+//
+CNetCDFOutputBuffer::~CNetCDFOutputBuffer()
+{
+  for (int v=0;v<_nVars;v++){delete [] _aBuffer[v];}
+  delete [] _aBuffer; _aBuffer=NULL;
+  delete [] _aVarID;  _aVarID =NULL;
+  delete [] _aWidth;  _aWidth =NULL;
+  delete [] _aPadGaps;_aPadGaps=NULL;
+  delete [] _aRowSet; _aRowSet =NULL;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief returns ID of NetCDF file written by this buffer
+//
+int CNetCDFOutputBuffer::GetNCID() const{return _ncid;}
+
+//////////////////////////////////////////////////////////////////
+/// \brief registers existing NetCDF variable with buffer
+/// \details NetCDF variable ID, width (length of second dimension, if any) and _FillValue are looked up once here
+/// \param &shortname [in] NetCDF variable name
+/// \return index of variable in buffer, used in SetValue() and SetValues()
+//
+int CNetCDFOutputBuffer::AddVariable(const string &shortname)
+{
+  int  varid(0);
+  int  width(1);
+  bool pad(true);
+#ifdef _RVNETCDF_
+  int    retval;
+  int    ndims;
+  int    dimids[2];
+  size_t len;
+  double fillval;
+  retval = nc_inq_varid   (_ncid,shortname.c_str(),&varid);  HandleNetCDFErrors(retval);
+  retval = nc_inq_varndims(_ncid,varid,&ndims);              HandleNetCDFErrors(retval);
+  ExitGracefullyIf(ndims>2,"CNetCDFOutputBuffer::AddVariable: only (time) or (time,n) variables may be buffered",RUNTIME_ERR);
+  if (ndims==2){
+    retval = nc_inq_vardimid(_ncid,varid,dimids);            HandleNetCDFErrors(retval);
+    retval = nc_inq_dimlen  (_ncid,dimids[1],&len);          HandleNetCDFErrors(retval);
+    width=(int)(len);
+  }
+  pad=((nc_get_att_double(_ncid,varid,"_FillValue",&fillval)==NC_NOERR) && (fillval==NETCDF_BLANK_VALUE));
+#else
+  (void)(shortname); //variables are only looked up in NetCDF file
+#endif
+  ExitGracefullyIf(_nRows>0,"CNetCDFOutputBuffer::AddVariable: variables must be added before first time step",RUNTIME_ERR);
+
+  int    *tmpID =new int     [_nVars+1];
+  int    *tmpW  =new int     [_nVars+1];
+  bool   *tmpPad=new bool    [_nVars+1];
+  double**tmpBuf=new double *[_nVars+1];
+  ExitGracefullyIf(tmpBuf==NULL,"CNetCDFOutputBuffer::AddVariable",OUT_OF_MEMORY);
+  for (int v=0;v<_nVars;v++){
+    tmpID[v]=_aVarID[v]; tmpW[v]=_aWidth[v]; tmpPad[v]=_aPadGaps[v]; tmpBuf[v]=_aBuffer[v];
+  }
+  tmpID [_nVars]=varid;
+  tmpW  [_nVars]=width;
+  tmpPad[_nVars]=pad;
+  tmpBuf[_nVars]=new double [_capacity*max(width,1)];
+  ExitGracefullyIf(tmpBuf[_nVars]==NULL,"CNetCDFOutputBuffer::AddVariable",OUT_OF_MEMORY);
+
+  delete [] _aVarID;  _aVarID =tmpID;
+  delete [] _aWidth;  _aWidth =tmpW;
+  delete [] _aPadGaps;_aPadGaps=tmpPad;
+  delete [] _aBuffer; _aBuffer=tmpBuf;
+  _nVars++;
+  return _nVars-1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief sets all values of buffered rows row1 to row2 (inclusive) to NETCDF_BLANK_VALUE
+//
+void CNetCDFOutputBuffer::ClearRows(const int row1,const int row2)
+{
+  for (int v=0;v<_nVars;v++){
+    for (int i=row1*_aWidth[v];i<(row2+1)*_aWidth[v];i++){_aBuffer[v][i]=NETCDF_BLANK_VALUE;}
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief starts new buffered time step at NetCDF time index time_index
+/// \details time indices after the last buffered time step but within the buffer span (e.g., when output is written
+/// at an interval of several time steps) are padded with blank values, and marked as skipped (see Flush());
+/// otherwise buffer is flushed first
+/// \param time_index [in] NetCDF time index of new time step
+//
+void CNetCDFOutputBuffer::StartTimeStep(const size_t time_index)
+{
+  if ((_nRows>0) && ((time_index<_start+_nRows) || (time_index>=_start+_capacity))){Flush();}
+  if (_nRows==0){_start=time_index;}
+
+  _row=(int)(time_index-_start);
+  ClearRows(_nRows,_row);
+  for (int r=_nRows;r<_row;r++){_aRowSet[r]=false;}
+  _aRowSet[_row]=true;
+  _nRows=_row+1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief sets value of single-valued variable v for current time step
+/// \param v [in] index of variable, as returned by AddVariable()
+/// \param &value [in] value
+//
+void CNetCDFOutputBuffer::SetValue(const int v,const double &value)
+{
+  _aBuffer[v][_row]=value;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief sets k-th value of (time,n) variable v for current time step
+/// \param v [in] index of variable, as returned by AddVariable()
+/// \param k [in] index along second dimension (e.g., gauged basin index), 0<=k<n
+/// \param &value [in] value
+//
+void CNetCDFOutputBuffer::SetValue(const int v,const int k,const double &value)
+{
+  _aBuffer[v][_row*_aWidth[v]+k]=value;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief writes all buffered time steps to file as one hyperslab per variable and empties buffer
+/// \details variables which may not be padded (see AddVariable()) are written as one hyperslab per run of
+/// consecutive buffered time steps, such that skipped time indices are left unwritten
+//
+void CNetCDFOutputBuffer::Flush()
+{
+  if (_nRows==0){return;}
+#ifdef _RVNETCDF_
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex());
+  int    retval;
+  size_t start[2],count[2];
+  start[1]=0;
+  for (int v=0;v<_nVars;v++)
+  {
+    count[1]=_aWidth[v];
+    if (_aPadGaps[v]){
+      start[0]=_start;
+      count[0]=_nRows;
+      retval = nc_put_vara_double(_ncid,_aVarID[v],start,count,_aBuffer[v]); HandleNetCDFErrors(retval);
+    }
+    else {
+      int r1=0,r2;
+      while (r1<_nRows)
+      {
+        if (!_aRowSet[r1]){r1++; continue;}
+        r2=r1;
+        while ((r2+1<_nRows) && (_aRowSet[r2+1])){r2++;}
+        start[0]=_start+r1;
+        count[0]=r2-r1+1;
+        retval = nc_put_vara_double(_ncid,_aVarID[v],start,count,&_aBuffer[v][r1*_aWidth[v]]); HandleNetCDFErrors(retval);
+        r1=r2+1;
+      }
+    }
+  }
+#endif
+  _nRows=0;
+  _row  =-1;
+}
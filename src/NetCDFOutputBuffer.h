@@ -0,0 +1,60 @@
+/*----------------------------------------------------------------
+  Raven Library Source Code
+  Copyright (c) 2008-2023 the Raven Development Team
+  ----------------------------------------------------------------
+  class definitions:
+  CNetCDFOutputBuffer
+  ----------------------------------------------------------------*/
+#ifndef NETCDFOUTPUTBUFFER_H
+#define NETCDFOUTPUTBUFFER_H
+
+#include "RavenInclude.h"
+
+///////////////////////////////////////////////////////////////////
+/// \brief Block-buffered writer for time-indexed variables of an open NetCDF output file
+/// \details Variables are (time) or (time,n) arrays; NetCDF variable IDs and widths are resolved once,
+/// when each variable is registered. Values for up to _capacity consecutive time indices are accumulated
+/// in memory and written with a single nc_put_vara_double() hyperslab per variable when the buffer is full
+/// or Flush() is called. Values not set within a buffered time step are written as NETCDF_BLANK_VALUE
+/// (the _FillValue of all Raven output variables), so skipped entries are identical to unwritten entries.
+/// Time indices skipped between buffered time steps (e.g., with :OutputInterval>1) are likewise padded, except
+/// for variables without this _FillValue (e.g., time), whose buffered time steps are written as one hyperslab
+/// per run of consecutive time steps, leaving skipped time indices unwritten
+/// \remark Flush() must be called before the NetCDF file is closed
+//
+class CNetCDFOutputBuffer
+{
+private:/*------------------------------------------------------*/
+
+  int      _ncid;      ///< NetCDF file ID
+  int      _capacity;  ///< maximum number of time steps held in buffer
+
+  int      _nVars;     ///< number of registered variables
+  int     *_aVarID;    ///< NetCDF variable ID of each registered variable [size: _nVars]
+  int     *_aWidth;    ///< number of values per time step of each variable (1 for time series) [size: _nVars]
+  double **_aBuffer;   ///< buffered values [v][row*_aWidth[v]+k] [size: _nVars x _capacity*_aWidth[v]]
+  bool    *_aPadGaps;  ///< true if variable has _FillValue NETCDF_BLANK_VALUE, so that skipped rows may be written [size: _nVars]
+  bool    *_aRowSet;   ///< true if time step of buffered row was started, false if row was skipped [size: _capacity]
+
+  size_t   _start;     ///< NetCDF time index of first buffered row
+  int      _nRows;     ///< number of buffered rows (time steps), including current row
+  int      _row;       ///< row of current time step (-1 if none started)
+
+  void     ClearRows(const int row1,const int row2);
+
+public:/*-------------------------------------------------------*/
+  //Constructors:
+  CNetCDFOutputBuffer(const int ncid,const int capacity);
+  ~CNetCDFOutputBuffer();
+
+  int  GetNCID      () const;
+
+  int  AddVariable  (const string &shortname);
+
+  void StartTimeStep(const size_t time_index);
+  void SetValue     (const int v,const double &value);
+  void SetValue     (const int v,const int k,const double &value);
+
+  void Flush        ();
+};
+#endif
@@ -184,3 +184,46 @@ void GetTimeVectorFromNetCDF(const int ncid,const int varid_t,const int ntime,do
   }
 #endif
 }
+
+//////////////////////////////////////////////////////////////////
+/// process-wide cache of NetCDF input files opened read-only, by file name
+/// (so that many time series may be read from a single file without re-opening it)
+//
+static unordered_map<string,int> g_NetCDFInputFiles;
+
+//////////////////////////////////////////////////////////////////
+/// returns ID of NetCDF input file, opened read-only; file is only opened upon first request
+/// and remains open until CloseNetCDFInputFiles() is called
+//
+/// \param filename [in] filename of netCDF file
+/// \param &ncid [out] netCDF file ID
+/// \return NetCDF error code (NC_NOERR if file is open)
+//
+int OpenNetCDFInputFile(const string filename,int &ncid)
+{
+  int retval=0;
+  ncid=-1;
+#ifdef _RVNETCDF_
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex());
+  unordered_map<string,int>::const_iterator it=g_NetCDFInputFiles.find(filename);
+  if (it!=g_NetCDFInputFiles.end()){ncid=it->second; return NC_NOERR;}
+
+  retval = nc_open(filename.c_str(),NC_NOWRITE,&ncid);
+  if (retval==NC_NOERR){g_NetCDFInputFiles[filename]=ncid;}
+#endif
+  return retval;
+}
+
+//////////////////////////////////////////////////////////////////
+/// closes all NetCDF input files opened by OpenNetCDFInputFile()
+//
+void CloseNetCDFInputFiles()
+{
+#ifdef _RVNETCDF_
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex());
+  for (unordered_map<string,int>::const_iterator it=g_NetCDFInputFiles.begin();it!=g_NetCDFInputFiles.end();++it){
+    int retval = nc_close(it->second); HandleNetCDFErrors(retval);
+  }
+#endif
+  g_NetCDFInputFiles.clear();
+}
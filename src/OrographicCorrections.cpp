@@ -170,6 +170,59 @@ void   CModel::CorrectTemp(const optStruct   &Options,
   }
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Corrects temperature for elevation effects for all active HRUs in forcing store
+/// \remark simple lapse rate corrections are applied field-by-field across HRUs;
+///  other methods (or local parameter overrides) use CorrectTemp() HRU-by-HRU
+///
+/// \param &Options [in] Global model options information
+/// \param &tt [in] current time strucure
+//
+void CModel::CorrectTempBatch(const optStruct &Options, const time_struct &tt)
+{
+  forcing_store &S=_ForcingStore;
+  int k,kk;
+  if (Options.orocorr_temp==OROCORR_NONE){return;}
+
+  if (((Options.orocorr_temp==OROCORR_SIMPLELAPSE) ||
+       (Options.orocorr_temp==OROCORR_HBV        )) && (_nParamOverrides==0))
+  {
+    double lapse=CGlobalParams::GetParams()->adiabatic_lapse;//[C/km]
+    lapse/=1000.0;//convert to C/m
+
+    double *T=S.Field(FORCING_FIELD(temp_ave));
+    for (kk=0;kk<S.nActive;kk++){
+      k=S.active[kk];
+      T[k]-=lapse*(S.elev[k]-S.ref_elev_temp[k]);
+    }
+    if(tt.day_changed)
+    {
+      const int nFields=(Options.orocorr_temp!=OROCORR_HBV) ? 6 : 5;//monthly average not corrected in HBV
+      const int aFields[6]={FORCING_FIELD(temp_daily_ave),FORCING_FIELD(temp_daily_min),FORCING_FIELD(temp_daily_max),
+                            FORCING_FIELD(temp_month_max),FORCING_FIELD(temp_month_min),FORCING_FIELD(temp_month_ave)};
+      for (int f=0;f<nFields;f++){
+        T=S.Field(aFields[f]);
+        for (kk=0;kk<S.nActive;kk++){
+          k=S.active[kk];
+          T[k]-=lapse*(S.elev[k]-S.ref_elev_temp[k]);
+        }
+      }
+    }
+    return;
+  }
+
+  force_struct F;
+  for (kk=0;kk<S.nActive;kk++)
+  {
+    k=S.active[kk];
+    S.Load(k,F);
+    ApplyLocalParamOverrrides(k,false);
+    CorrectTemp(Options,F,S.elev[k],S.ref_elev_temp[k],tt);
+    ApplyLocalParamOverrrides(k,true);
+    S.Store(k,F);
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Corrects gauge precipitation for elevation effects
 /// \remark UBCWM Orographic Corrections adapted from UBC Watershed model
@@ -340,8 +393,9 @@ void CModel::CorrectPET(const optStruct &Options,
   {
     double sat_vap_max,sat_vap_min,c1,ch;
     double max_month_temp(0.0),min_month_temp(0.0);
-    for (int g=0;g<_nGauges;g++)
+    for (int i=_GaugeWtTemp.RowBegin(k);i<_GaugeWtTemp.RowEnd(k);i++)
     {
+      int g=_GaugeWtTemp.cols[i];
       double max=-ALMOST_INF;
       double min=ALMOST_INF;
       double tmp;
@@ -350,8 +404,8 @@ void CModel::CorrectPET(const optStruct &Options,
         upperswap(max,tmp);
         lowerswap(min,tmp);
       }
-      max_month_temp+=_aGaugeWtTemp[k][g]*max;
-      min_month_temp+=_aGaugeWtTemp[k][g]*min;
+      max_month_temp+=_GaugeWtTemp.wts[i]*max;
+      min_month_temp+=_GaugeWtTemp.wts[i]*min;
     }
 
     sat_vap_max=GetSaturatedVaporPressure(max_month_temp);
@@ -10,6 +10,7 @@ Copyright (c) 2008-2023 the Raven Development Team
 #include "ModelEnsemble.h"
 #include "EnKF.h"
 bool IsContinuousFlowObs2(const CTimeSeriesABC* pObs,long SBID);
+void ImproperFormatWarning(string command, CParser *p, bool noisy);
 //////////////////////////////////////////////////////////////////
 /// \brief Parses Ensemble Model file
 /// \details model.rve: input file that defines ensemble member details for MC, calibration, etc.
@@ -82,6 +83,10 @@ bool ParseEnsembleFile(CModel *&pModel,const optStruct &Options)
     else if(!strcmp(s[0],":ObservationErrorModel"))       { code=16; }
     else if(!strcmp(s[0],":EnKFMode"))                    { code=18; }
     else if(!strcmp(s[0],":ExtraRVTFilename"))            { code=19; }
+    else if(!strcmp(s[0],":ConcurrentMembers"))           { code=20; }
+    else if(!strcmp(s[0],":EarlyTermination"))            { code=21; }
+    else if(!strcmp(s[0],":LocalizationRadius"))          { code=22; }
+    else if(!strcmp(s[0],":InMemoryMembers"))             { code=23; }
     else if(!strcmp(s[0],":AssimilateStreamflow"))        { code=101;}
 
     switch(code)
@@ -466,6 +471,58 @@ bool ParseEnsembleFile(CModel *&pModel,const optStruct &Options)
       }
       break;
     }
+    case(20):  //----------------------------------------------
+    {/*:ConcurrentMembers [number of members simulated at once]*/
+      if(Options.noisy) { cout <<":ConcurrentMembers"<<endl; }
+      if(Len<2) { ImproperFormatWarning(":ConcurrentMembers",pp,Options.noisy); break; }
+      if(pEnsemble->SupportsConcurrentMembers()) {
+        pEnsemble->SetNumConcurrentMembers(s_to_i(s[1]));
+        if((pEnsemble->GetType()==ENSEMBLE_DDS) && (s_to_i(s[1])>1)) {
+          WriteAdvisory(":ConcurrentMembers: all DDS members within a concurrent batch are perturbed from the best solution found before the batch; the search differs from that of sequential DDS.",Options.noisy);
+        }
+      }
+      else {
+        WriteWarning(":ConcurrentMembers command will be ignored; only valid for Monte Carlo, DDS, and EnKF ensemble simulation.",Options.noisy);
+      }
+      break;
+    }
+    case(21):  //----------------------------------------------
+    {/*:EarlyTermination*/
+      if(Options.noisy) { cout <<":EarlyTermination"<<endl; }
+      if(pEnsemble->GetType()==ENSEMBLE_DDS) {
+        CDDSEnsemble *pDDS=((CDDSEnsemble*)(pEnsemble));
+        pDDS->SetEarlyTermination(true);
+      }
+      else {
+        WriteWarning(":EarlyTermination command will be ignored; only valid for DDS ensemble simulation.",Options.noisy);
+      }
+      break;
+    }
+    case(22):  //----------------------------------------------
+    {/*:LocalizationRadius [distance along river network, km]*/
+      if(Options.noisy) { cout <<":LocalizationRadius"<<endl; }
+      if(Len<2) { ImproperFormatWarning(":LocalizationRadius",pp,Options.noisy); break; }
+      if(pEnsemble->GetType()==ENSEMBLE_ENKF) {
+        CEnKFEnsemble* pEnKF=((CEnKFEnsemble*)(pEnsemble));
+        pEnKF->SetLocalizationRadius(s_to_d(s[1]));
+      }
+      else {
+        WriteWarning(":LocalizationRadius command will be ignored; only valid for EnKF ensemble simulation.",Options.noisy);
+      }
+      break;
+    }
+    case(23):  //----------------------------------------------
+    {/*:InMemoryMembers*/
+      if(Options.noisy) { cout <<":InMemoryMembers"<<endl; }
+      if(pEnsemble->GetType()==ENSEMBLE_ENKF) {
+        CEnKFEnsemble* pEnKF=((CEnKFEnsemble*)(pEnsemble));
+        pEnKF->SetInMemoryMembers(true);
+      }
+      else {
+        WriteWarning(":InMemoryMembers command will be ignored; only valid for EnKF ensemble simulation.",Options.noisy);
+      }
+      break;
+    }
     case(101)://----------------------------------------------
     {/*:AssimilateStreamflow  [SBID]*/
       if(Options.noisy) { cout <<"Assimilate streamflow"<<endl; }
@@ -463,8 +463,6 @@ bool ParseHRUPropsFile(CModel *&pModel, const optStruct &Options, bool terrain_r
         else if (!strcmp(s[0],":EndHRUGroup")){}//done
         else
         {
-          int k;
-          int nHRUs=pModel->GetNumHRUs();
           for (i=0;i<Len;i++)
           {
             int ind1,ind2;
@@ -475,12 +473,9 @@ bool ParseHRUPropsFile(CModel *&pModel, const optStruct &Options, bool terrain_r
             for (int ii=ind1;ii<=ind2;ii++)
             {
               found=false;
-              for (k=0;k<nHRUs;k++)
-              {
-                if (pModel->GetHydroUnit(k)->GetID()==ii)
-                {
-                  pHRUGrp->AddHRU(pModel->GetHydroUnit(k));found=true; break;
-                }
+              CHydroUnit *pHRU=pModel->GetHRUByID(ii);
+              if (pHRU!=NULL){
+                pHRUGrp->AddHRU(pHRU);found=true;
               }
               if ((!found) && (ind2-ind1>1)){gaps=true;}
               if((!found) && (ind1==ind2)) {
@@ -642,17 +637,13 @@ bool ParseHRUPropsFile(CModel *&pModel, const optStruct &Options, bool terrain_r
         else if (!strcmp(s[0],":EndSubBasinGroup")){}//done
         else
         {
-          int p;
-          int nSBs=pModel->GetNumSubBasins();
           for(i=0;i<Len;i++)
           {
             long SBID=s_to_l(s[i]);
-            for(p=0;p<nSBs;p++)
+            CSubBasin *pSB=pModel->GetSubBasinByID(SBID);
+            if(pSB!=NULL)
             {
-              if(pModel->GetSubBasin(p)->GetID()==SBID)
-              {
-                pSBGrp->AddSubbasin(pModel->GetSubBasin(p));break;
-              }
+              pSBGrp->AddSubbasin(pSB);
             }
           }
         }
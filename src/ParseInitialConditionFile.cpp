@@ -13,6 +13,7 @@ void SetInitialStateVar(CModel *&pModel,const int SVind,const sv_type typ,const
 //////////////////////////////////////////////////////////////////
 /// \brief Parses Initial conditions file
 /// \details model.rvc: input file that defines HRU and Subbasin initial conditions\n
+/// If :BinarySnapshots is specified, the binary snapshot model.rvc.bin is read instead where valid (see CModel::ReadBinarySnapshot)\n
 ///
 /// \param *&pModel [out] Reference to model object
 /// \param &Options [out] Global model options information
@@ -30,6 +31,11 @@ bool ParseInitialConditionsFile(CModel *&pModel, const optStruct &Options)
   time_struct tt;
   JulianConvert(0.0,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
 
+  //binary snapshot written with .rvc file, if enabled, up to date, and consistent with model
+  if ((Options.binary_snapshots) && (pModel->ReadBinarySnapshot(Options.rvc_filename+".bin",Options))){
+    return true;
+  }
+
   ifstream    IC;
   IC.open(Options.rvc_filename.c_str());
   if (IC.fail()){
@@ -898,8 +904,20 @@ bool ParseInitialConditionsFile(CModel *&pModel, const optStruct &Options)
   } //end while !end_of_file
   IC.close();
 
-  // check quality of initial state variables
-  //======================================================================
+  delete pp;
+  pp=NULL;
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief checks quality of initial state variables, capping those exceeding their (state-independent) maximum
+/// \details called after initial conditions are read or restored; maximum values depend upon current parameter values
+///
+/// \param *&pModel [in/out] Reference to model object
+/// \param &Options [in] Global model options information
+//
+void CheckInitialStateVars(CModel *&pModel,const optStruct &Options)
+{
   CHydroUnit *pHRU;
   double *v=new double [pModel->GetNumStateVars()];
   for (int k=0;k<pModel->GetNumHRUs();k++)
@@ -925,10 +943,6 @@ bool ParseInitialConditionsFile(CModel *&pModel, const optStruct &Options)
     }
   }
   delete [] v;
-
-  delete pp;
-  pp=NULL;
-  return true;
 }
 
 void SetInitialStateVar(CModel *&pModel,const int SVind,const sv_type typ,const int m,const int k,const double &val)
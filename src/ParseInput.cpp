@@ -39,6 +39,7 @@ bool ParseClassPropertiesFile  (CModel *&pModel, const optStruct &Options, bool
 bool ParseHRUPropsFile         (CModel *&pModel, const optStruct &Options, bool terrain_required);
 bool ParseTimeSeriesFile       (CModel *&pModel, const optStruct &Options);
 bool ParseInitialConditionsFile(CModel *&pModel, const optStruct &Options);
+void CheckInitialStateVars     (CModel *&pModel, const optStruct &Options);
 bool ParseEnsembleFile         (CModel *&pModel, const optStruct &Options);
 bool ParseGWFile               (CModel *&pModel, const optStruct &Options);
 bool ParseNetCDFRunInfoFile    (CModel *&pModel, optStruct &Options,bool runname_overridden,bool mode_overridden);
@@ -66,6 +67,7 @@ bool ParseInitialConditions(CModel*& pModel, const optStruct& Options)
   if (!ParseInitialConditionsFile(pModel,Options)){
     ExitGracefully("Cannot find or read .rvc file",BAD_DATA);return false;
   }
+  CheckInitialStateVars(pModel,Options);
   if (!ParseNetCDFStateFile(pModel, Options)) {
     ExitGracefully("Cannot find or read NetCDF state file", BAD_DATA); return false;
   }
@@ -185,6 +187,7 @@ bool ParseMainInputFile (CModel     *&pModel,
   bool              runname_overridden(false);
   bool              runmode_overridden(false);
   bool              rundir_overridden(false);
+  bool              numthreads_overridden(false);
   int               num_ensemble_members=1;
   unsigned int      random_seed=0; //actually random
   ifstream          INPUT;
@@ -222,6 +225,7 @@ bool ParseMainInputFile (CModel     *&pModel,
   if(Options.run_name!=""  ){runname_overridden=true;}
   if(Options.run_mode!=' ' ){runmode_overridden=true;}
   if(Options.output_dir!=""){rundir_overridden =true;}
+  if(Options.num_threads>0 ){numthreads_overridden=true;}
   Options.julian_start_day        =0;//Jan 1
   Options.julian_start_year       =1666;
   Options.duration                =365;
@@ -231,6 +235,10 @@ bool ParseMainInputFile (CModel     *&pModel,
   Options.sol_method              =ORDERED_SERIES;
   Options.convergence_crit        =0.01;
   Options.max_iterations          =30;
+  if (!numthreads_overridden){
+    Options.num_threads           =1;
+  }
+  Options.batch_forcings          =false;
   Options.ensemble                =ENSEMBLE_NONE;
   Options.external_script         ="";
 
@@ -240,6 +248,7 @@ bool ParseMainInputFile (CModel     *&pModel,
 
   Options.interpolation           =INTERP_NEAREST_NEIGHBOR;
   Options.interp_file             ="";
+  Options.interp_max_gauges       =0;
 
   Options.num_soillayers          =-1;//used to check if SoilModel command is used
   Options.soil_representation     =BROOKS_COREY;
@@ -329,6 +338,9 @@ bool ParseMainInputFile (CModel     *&pModel,
   Options.flowinfo_filename       ="";
 
   Options.NetCDF_chunk_mem        =10; //MB
+  Options.NetCDF_out_buffer       =64; //time steps
+  Options.NetCDF_deflate          =0;
+  Options.binary_snapshots        =false;
 
   pModel=NULL;
   pMover=NULL;
@@ -402,6 +414,7 @@ bool ParseMainInputFile (CModel     *&pModel,
     else if  (!strcmp(s[0],":PrecipIceptFract"          )){code=30; }
     else if  (!strcmp(s[0],":OroTempCorrect"            )){code=31; }
     else if  (!strcmp(s[0],":OroPrecipCorrect"          )){code=32; }
+    else if  (!strcmp(s[0],":InterpolationMaxGauges"    )){code=33; }
 
     else if  (!strcmp(s[0],":PotentialMeltMethod"       )){code=34; }
     else if  (!strcmp(s[0],":SubdailyMethod"            )){code=35; }
@@ -470,6 +483,11 @@ bool ParseMainInputFile (CModel     *&pModel,
     else if  (!strcmp(s[0],":FEWSStateInfoFile"         )){code=110;}
     else if  (!strcmp(s[0],":FEWSParamInfoFile"         )){code=111;}
     else if  (!strcmp(s[0],":FEWSBasinStateInfoFile"    )){code=112;}
+    else if  (!strcmp(s[0],":NumThreads"                )){code=113;}
+    else if  (!strcmp(s[0],":BatchForcingUpdate"        )){code=114;}
+    else if  (!strcmp(s[0],":NetCDFOutputBuffer"        )){code=115;}
+    else if  (!strcmp(s[0],":NetCDFDeflateLevel"        )){code=116;}
+    else if  (!strcmp(s[0],":BinarySnapshots"           )){code=117;}
 
     else if  (!strcmp(s[0],":WriteGroundwaterHeads"     )){code=510;}//GWMIGRATE -TO REMOVE
     else if  (!strcmp(s[0],":WriteGroundwaterFlows"     )){code=511;}//GWMIGRATE -TO REMOVE
@@ -1017,6 +1035,15 @@ bool ParseMainInputFile (CModel     *&pModel,
       break;
     }
 
+    case(33): //----------------------------------------------
+    {/*:InterpolationMaxGauges [int max number of gauges] */
+      if(Options.noisy) { cout <<"Maximum number of interpolation gauges"<<endl; }
+      if(Len<2) { ImproperFormatWarning(":InterpolationMaxGauges",p,Options.noisy); break; }
+      Options.interp_max_gauges=s_to_i(s[1]);
+      ExitGracefullyIf(Options.interp_max_gauges<1,
+                       "ParseMainInputFile: :InterpolationMaxGauges must be at least 1",BAD_DATA_WARN);
+      break;
+    }
     case(28): //----------------------------------------------
     {/*:WindspeedMethod [string method] */
       if (Options.noisy) {cout <<"Windspeed estimation Method"<<endl;}
@@ -1850,6 +1877,48 @@ bool ParseMainInputFile (CModel     *&pModel,
       Options.flowinfo_filename = CorrectForRelativePath(s[1], Options.rvi_filename);//with .nc extension!
       break;
     }
+    case(113):  //--------------------------------------------
+    {/*:NumThreads [number of threads]*/
+      if (Options.noisy) { cout << "Number of threads" << endl; }
+      if (Len<2) { ImproperFormatWarning(":NumThreads",p,Options.noisy);  break; }
+      if (!numthreads_overridden){ //command line -nt flag takes precedence
+        Options.num_threads=max(s_to_i(s[1]),1);
+      }
+#ifndef _OPENMP
+      if (Options.num_threads>1){
+        WriteWarning(":NumThreads: Raven was compiled without OpenMP support; simulation will run on a single thread",Options.noisy);
+      }
+#endif
+      break;
+    }
+    case(114):  //--------------------------------------------
+    {/*:BatchForcingUpdate */
+      if (Options.noisy) { cout << "Batch forcing update" << endl; }
+      Options.batch_forcings=true;
+      break;
+    }
+    case(115):  //--------------------------------------------
+    {/*:NetCDFOutputBuffer [number of time steps]*/
+      if (Options.noisy) { cout << "NetCDF output buffer size" << endl; }
+      if (Len<2){ImproperFormatWarning(":NetCDFOutputBuffer",p,Options.noisy); break;}
+      Options.NetCDF_out_buffer=max(s_to_i(s[1]),1);
+      break;
+    }
+    case(116):  //--------------------------------------------
+    {/*:NetCDFDeflateLevel [0-9]*/
+      if (Options.noisy) { cout << "NetCDF output deflate level" << endl; }
+      if (Len<2){ImproperFormatWarning(":NetCDFDeflateLevel",p,Options.noisy); break;}
+      Options.NetCDF_deflate=s_to_i(s[1]);
+      ExitGracefullyIf((Options.NetCDF_deflate<0) || (Options.NetCDF_deflate>9),
+                       "ParseMainInputFile: :NetCDFDeflateLevel must be between 0 and 9",BAD_DATA_WARN);
+      break;
+    }
+    case(117):  //--------------------------------------------
+    {/*:BinarySnapshots*/
+      if (Options.noisy) { cout << "Binary snapshots of solution files" << endl; }
+      Options.binary_snapshots=true;
+      break;
+    }
     case(160):  //--------------------------------------------
     {/*:rvh_Filename [filename.rvh]*/
       if(Options.noisy) { cout <<"rvh filename: "<<s[1]<<endl; }
@@ -234,8 +234,6 @@ void ParseLiveFile(CModel *&pModel,const optStruct &Options, const time_struct &
         else if (!strcmp(s[0],":EndRepopulateHRUGroup")){}//done
         else
         {
-          int k;
-          int nHRUs=pModel->GetNumHRUs();
           for (int i=0;i<Len;i++)
           {
             int ind1,ind2;
@@ -246,12 +244,9 @@ void ParseLiveFile(CModel *&pModel,const optStruct &Options, const time_struct &
             for (int ii=ind1;ii<=ind2;ii++)
             {
               found=false;
-              for (k=0;k<nHRUs;k++)
-              {
-                if (pModel->GetHydroUnit(k)->GetID()==ii)
-                {
-                  pHRUGrp->AddHRU(pModel->GetHydroUnit(k));found=true; break;
-                }
+              CHydroUnit *pHRU=pModel->GetHRUByID(ii);
+              if (pHRU!=NULL){
+                pHRUGrp->AddHRU(pHRU);found=true;
               }
               if ((!found) && (ind2-ind1>1)){gaps=true;}
               if((!found) && (ind1==ind2)) {
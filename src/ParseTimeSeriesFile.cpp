@@ -1963,6 +1963,8 @@ bool ParseTimeSeriesFile(CModel *&pModel, const optStruct &Options)
 
   RVT.close();
 
+  CTimeSeries::ClearNetCDFCache(); //closes NetCDF files shared by :ReadFromNetCDF time series
+
   //QA/QC
   //--------------------------------
   if((has_irrig) && (pModel->GetTransportModel()->GetNumConstituents()>0)) {
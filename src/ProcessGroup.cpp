@@ -156,6 +156,16 @@ int CProcessGroup::GetGroupSize() const
   return _nSubProcesses;
 }
 //////////////////////////////////////////////////////////////////
+/// \brief returns true if all subprocesses may be applied concurrently to different HRUs
+//
+bool CProcessGroup::IsThreadSafe() const
+{
+  for (int i=0;i<_nSubProcesses;i++){
+    if (!_pSubProcesses[i]->IsThreadSafe()){return false;}
+  }
+  return true;
+}
+//////////////////////////////////////////////////////////////////
 /// \brief adds hydrologic process to list of subprocesses
 ///
 /// \param *pProc [in] pointer to hydrologic process to be added
@@ -52,7 +52,8 @@ public:/*-------------------------------------------------------*/
   void        GetParticipatingParamList   (string *aP, class_type *aPC, int &nP) const;
 
   //accessor functions
-  int GetGroupSize() const;
+  int  GetGroupSize() const;
+  bool IsThreadSafe() const;
 
   //manipulator functions
   void AddProcess(CHydroProcessABC *pProc);
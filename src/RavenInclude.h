@@ -22,9 +22,11 @@
 #endif
 #ifdef _RVNETCDF_
 #include <netcdf.h>
+#include <mutex>
 #endif
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <cstring>
 #include <algorithm>
 #include <math.h>
@@ -36,6 +38,9 @@
 #include <string>
 #include <strstream>
 #include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
 
 using namespace std;
 
@@ -242,6 +247,7 @@ const double  USE_TEMPLATE_VALUE      =-55555.5;
 const double  NOT_NEEDED              =-66666.6;                                ///< arbitrary value indicating that a non-auto parameter is not needed for the current model configuration
 const double  NOT_NEEDED_AUTO         =-77777.7;                                ///< arbitrary value indicating that a autogeneratable parameter is not needed for the current model configuration
 const double  NETCDF_BLANK_VALUE      =-9999.0;                                 ///< NetCDF flag for blank value
+const double  NETCDF_REQUEST_COST     =65536;                                   ///< [bytes] estimated fixed cost of one NetCDF hyperslab request, expressed as equivalent bytes read
 const double  RAV_BLANK_DATA          =-1.2345;                                 ///< double corresponding to blank/void data item (also used in input files)
 const double  DIRICHLET_TEMP          =-9999.0;                                 ///< dirichlet concentration flag corresponding to air temperature
 const int     FROM_STATION_VAR        =-55;                                     ///< special flag indicating that NetCDF indices should be looked up from station attribute table
@@ -999,6 +1005,8 @@ struct optStruct
   numerical_method sol_method;                ///< numerical solution method
   double           convergence_crit;          ///< convergence criteria
   double           max_iterations;            ///< maximum number of iterations for iterative solver method
+  int              num_threads;               ///< number of threads used to simulate HRU-scale processes (default: 1)
+  bool             batch_forcings;            ///< true if forcing corrections are calculated for all HRUs at once (structure-of-arrays forcing store)
   double           timestep;                  ///< numerical method timestep (in days)
   double           output_interval;           ///< write to output file every x number of timesteps
   ensemble_type    ensemble;                  ///< ensemble type (or ENSEMBLE_NONE if single model)
@@ -1012,6 +1020,7 @@ struct optStruct
 
   interp_method    interpolation;             ///< Method for interpolating Met Station/Gauge data to HRUs
   string           interp_file;               ///< name of file (in working directory) which stores interpolation weights
+  int              interp_max_gauges;         ///< maximum number of (nearest) gauges used for inverse distance interpolation to each HRU (0 if all gauges are used)
 
   string           run_name;                  ///< prefix to be used for all output files
   char             run_mode;                  ///< run mode - single character used to enable multiple model configs with if statements (default==' ')
@@ -1104,6 +1113,7 @@ struct optStruct
   bool             write_simpleout;           ///< true if simple_out.csv file is to be written (for scripting)
   bool             write_massloading;         ///< true if MassLoadings.csv file is to be written
   bool             write_localflow;           ///< true if local flows are written to Hydrographs file (csv or nc)
+  bool             binary_snapshots;          ///< true if binary snapshots (.rvc.bin) are written with and read in place of .rvc solution files
   bool             benchmarking;              ///< true if benchmarking output - removes version/timestamps in output
   bool             suppressICs;               ///< true if initial conditions are suppressed when writing output time series
   bool             period_ending;             ///< true if period ending convention should be used for reading/writing Ensim files
@@ -1124,6 +1134,8 @@ struct optStruct
   netcdfatt       *aNetCDFattribs;            ///< array of NetCDF attrributes {attribute/value pair}
   int              nNetCDFattribs;            ///< size of array of NetCDF attributes
   int              NetCDF_chunk_mem;          ///< [MB] size of memory chunk for each forcing grid
+  int              NetCDF_out_buffer;         ///< number of time steps of NetCDF minor output buffered in memory (also chunk length along time dimension)
+  int              NetCDF_deflate;            ///< deflate (compression) level of NetCDF minor output, 0-9 (0: uncompressed)
   bool             in_bmi_mode;               ///< true if in BMI mode (no rvt files, no end time)
 };
 
@@ -1138,6 +1150,66 @@ struct location
   double UTM_y;     ///< y-coordinate in Universal Transverse Mercator coordinate system
 };
 
+///////////////////////////////////////////////////////////////////
+/// \brief Compressed sparse row (CSR) storage of an interpolation weight matrix
+/// \details non-zero weights of row k are wts[i] in column cols[i], for i=rowstart[k]...rowstart[k+1]-1
+//
+struct csr_weights
+{
+  int     nRows;    ///< number of rows (e.g., HRUs)
+  int     nNonZero; ///< number of non-zero weights
+  int    *rowstart; ///< index of first non-zero weight of each row [size: nRows+1]
+  int    *cols;     ///< column (e.g., gauge index) of each non-zero weight [size: nNonZero]
+  double *wts;      ///< non-zero weights [size: nNonZero]
+
+  csr_weights(){nRows=0;nNonZero=0;rowstart=NULL;cols=NULL;wts=NULL;}
+  int  RowBegin(const int k) const {return (rowstart==NULL) ? 0 : rowstart[k];  } ///< first non-zero of row k
+  int  RowEnd  (const int k) const {return (rowstart==NULL) ? 0 : rowstart[k+1];} ///< one past last non-zero of row k
+  void Clear(){
+    delete [] rowstart; rowstart=NULL;
+    delete [] cols;     cols    =NULL;
+    delete [] wts;      wts     =NULL;
+    nRows=0; nNonZero=0;
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+/// \brief Time history of flow or mass loading stored as a circular buffer, [0]=most recent value
+/// \details entry n is stored at buf[head+n]; all entries are mirrored (buf[j]==buf[j+N]) so that
+/// Hist() is always a contiguous array ordered from most recent to oldest. Push() is O(1) (no shifting).
+/// \remark after modifying entries through operator[] or Hist(), Mirror() must be called
+//
+struct ring_history
+{
+  int     N;    ///< number of history entries
+  int     head; ///< location of most recent entry in buf [0..N-1]
+  double *buf;  ///< mirrored storage [size: 2*N+1]
+
+  ring_history(){N=0;head=0;buf=NULL;}
+  double       &operator[](const int n)       {return buf[head+n];}
+  const double &operator[](const int n) const {return buf[head+n];}
+  double *Hist() const {return buf+head;}       ///< contiguous history [size: N]
+  void    Push(const double &val){              ///< shifts history back one entry, sets most recent entry to val
+    if (N==0){return;}
+    head=(head==0) ? N-1 : head-1;
+    buf[head]=val; buf[head+N]=val;
+  }
+  void    Mirror(){                             ///< restores mirror copies after entries are modified
+    for (int j=head;j<N;       j++){buf[j+N]=buf[j];}
+    for (int j=N;   j<head+N;  j++){buf[j-N]=buf[j];}
+  }
+  void    Allocate(const int n,const double &val){
+    Clear();
+    N=n; head=0;
+    buf=new double [2*N+1];
+    for (int j=0;j<2*N+1;j++){buf[j]=val;}
+  }
+  void    Clear(){
+    delete [] buf; buf=NULL;
+    N=0; head=0;
+  }
+};
+
 ////////////////////////////////////////////////////////////////////
 /// \brief Stores information describing a specific instance in time
 //
@@ -1558,6 +1630,7 @@ string   StringToUppercase      (const string &s);
 bool     IsComment              (const char *s, const int Len);
 void     WriteWarning           (const string warn, bool noisy);
 void     WriteAdvisory          (const string warn, bool noisy);
+void     BufferWarnings         (vector<string> *pBuffer);
 HRU_type StringToHRUType        (const string s);
 double   fast_s_to_d            (const char *s);
 double   FormatDouble           (const double &d);
@@ -1571,12 +1644,17 @@ void GetTimeInfoFromNetCDF      (const char *unit_t,int calendar,const double *t
                                  double &tstep,double &start_day,int &start_yr,double &time_zone);
 void GetJulianDateFromNetCDFTime(const string unit_t,const int calendar,const double &time,
                                  double &start_day,int &start_yr);
+int  OpenNetCDFInputFile        (const string filename,int &ncid);
+void CloseNetCDFInputFiles      ();
 
 //I/O Functions-----------------------------------------------
 //defined in StandardOutput.cpp
 void   PrepareOutputdirectory    (const optStruct &Options);
 string GetDirectoryName          (const string &fname);
 void   HandleNetCDFErrors        (int error_code);        ///< NetCDF error handling
+#ifdef _RVNETCDF_
+recursive_mutex &GetNetCDFMutex  ();                      ///< lock serializing NetCDF library calls across threads
+#endif
 string CorrectForRelativePath    (const string filename, const string relfile);
 string GetFileExtension          (string filename);
 
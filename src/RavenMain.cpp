@@ -7,6 +7,9 @@
 #include "RavenMain.h"
 #include "Model.h"
 #include "UnitTesting.h"
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
 
 // Main Driver Variables------------------------------------------
 static optStruct   Options;
@@ -34,8 +37,7 @@ static string RavenBuildDate(__DATE__);
 //
 int main(int argc, char* argv[])
 {
-  double      t;
-  clock_t     t0, t1;          //computational time markers
+  clock_t     t0;              //computational time marker
   time_struct tt;
   int         nEnsembleMembers;
 
@@ -93,92 +95,281 @@ int main(int argc, char* argv[])
 
   nEnsembleMembers=pModel->GetEnsemble()->GetNumMembers();
 
-  for(int e=0;e<nEnsembleMembers; e++) //only run once in standard mode
+  if(pModel->GetEnsemble()->GetNumConcurrentMembers()>1)
+  {
+    RunConcurrentEnsemble(t0);
+  }
+  else
   {
+    for(int e=0;e<nEnsembleMembers; e++) //only run once in standard mode
+    {
+      pModel->GetEnsemble()->UpdateModel(pModel,Options,e);
 
-    pModel->GetEnsemble()->UpdateModel(pModel,Options,e);
-    PrepareOutputdirectory(Options); //adds new output folders, if needed
-    pModel->WriteOutputFileHeaders(Options);
+      SimulateModel(e,nEnsembleMembers,t0,tt);
 
-    if(!Options.silent) {
-      cout <<endl<<"======================================================"<<endl;
-      if(nEnsembleMembers>1) { cout<<"Ensemble Member "<<e+1<<" "; g_suppress_warnings=true;}
-      cout <<"Simulation Start..."<<endl;
-    }
+      pModel->GetEnsemble()->FinishEnsembleRun(pModel,Options,tt,e);
+    }/* end ensemble loop*/
+  }
 
-    double t_start=0.0;
-    t_start=pModel->GetEnsemble()->GetStartTime(e);
 
-    //Write initial conditions-------------------------------------
-    JulianConvert(t_start,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
-    pModel->RecalculateHRUDerivedParams(Options,tt);
-    pModel->UpdateHRUForcingFunctions  (Options,tt);
-    pModel->UpdateDiagnostics          (Options,tt);
-    pModel->WriteMinorOutput           (Options,tt);
+  ExitGracefully("Successful Simulation",SIMULATION_DONE);
+  return 0;
+}
 
-    //Solve water/energy balance over time--------------------------------
-    t1=clock();
-    int step=0;
+//////////////////////////////////////////////////////////////////
+/// \brief Simulates model (or single ensemble member) over entire model duration and writes output
+/// \remark ensemble member must already have been set up using CEnsemble::UpdateModel()
+///
+/// \param e [in] ensemble member index
+/// \param nEnsembleMembers [in] total number of ensemble members
+/// \param t0 [in] computational time marker at start of program
+/// \param &tt [out] time structure at end of simulation
+//
+void SimulateModel(const int e, const int nEnsembleMembers, const clock_t t0, time_struct &tt)
+{
+  double  t;
+  clock_t t1;          //computational time marker
 
-    for(t=t_start; t<Options.duration-TIME_CORRECTION; t+=Options.timestep)  // in [d]
-    {
-      pModel->UpdateTransientParams      (Options,tt);
-      pModel->RecalculateHRUDerivedParams(Options,tt);
-      pModel->GetEnsemble()->StartTimeStepOps(pModel,Options,tt,e);
-      pModel->UpdateHRUForcingFunctions  (Options,tt);
-      pModel->PrepareAssimilation        (Options,tt);
-      pModel->WriteSimpleOutput          (Options,tt);
-      CallExternalScript                 (Options,tt);
-      ParseLiveFile                      (pModel,Options,tt);
+  PrepareOutputdirectory(Options); //adds new output folders, if needed
+  pModel->WriteOutputFileHeaders(Options);
 
-      MassEnergyBalance(pModel,Options,tt); //where the magic happens!
+  if(!Options.silent) {
+    cout <<endl<<"======================================================"<<endl;
+    if(nEnsembleMembers>1) { cout<<"Ensemble Member "<<e+1<<" "; g_suppress_warnings=true;}
+    cout <<"Simulation Start..."<<endl;
+  }
 
-      pModel->IncrementCumulInput        (Options,tt);
-      pModel->IncrementCumOutflow        (Options,tt);
+  double t_start=0.0;
+  t_start=pModel->GetEnsemble()->GetStartTime(e);
 
-      JulianConvert(t+Options.timestep,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);//increments time structure
+  //Write initial conditions-------------------------------------
+  JulianConvert(t_start,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);
+  pModel->RecalculateHRUDerivedParams(Options,tt);
+  pModel->UpdateHRUForcingFunctions  (Options,tt);
+  pModel->ResetDiagnosticStreams     ();
+  pModel->UpdateDiagnostics          (Options,tt);
+  pModel->WriteMinorOutput           (Options,tt);
 
-      pModel->WriteMinorOutput           (Options,tt);
-      pModel->WriteProgressOutput        (Options,clock()-t1,step,(int)ceil(Options.duration/Options.timestep));
-      pModel->UpdateDiagnostics          (Options,tt); //required to read stuff!!
-      pModel->GetEnsemble()->CloseTimeStepOps(pModel,Options,tt,e);
+  //Solve water/energy balance over time--------------------------------
+  t1=clock();
+  int  step=0;
+  bool terminated=false; //true if ensemble member is stopped early; its output is incomplete
 
-      if ((Options.use_stopfile) && (CheckForStopfile(step,tt))) { break; }
-      step++;
-    }
+  for(t=t_start; t<Options.duration-TIME_CORRECTION; t+=Options.timestep)  // in [d]
+  {
+    pModel->UpdateTransientParams      (Options,tt);
+    pModel->RecalculateHRUDerivedParams(Options,tt);
+    pModel->GetEnsemble()->StartTimeStepOps(pModel,Options,tt,e);
+    pModel->UpdateHRUForcingFunctions  (Options,tt);
+    pModel->PrepareAssimilation        (Options,tt);
+    pModel->WriteSimpleOutput          (Options,tt);
+    CallExternalScript                 (Options,tt);
+    ParseLiveFile                      (pModel,Options,tt);
+
+    MassEnergyBalance(pModel,Options,tt); //where the magic happens!
+
+    pModel->IncrementCumulInput        (Options,tt);
+    pModel->IncrementCumOutflow        (Options,tt);
+
+    JulianConvert(t+Options.timestep,Options.julian_start_day,Options.julian_start_year,Options.calendar,tt);//increments time structure
 
-    //Finished Solving----------------------------------------------------
+    pModel->WriteMinorOutput           (Options,tt);
+    pModel->WriteProgressOutput        (Options,clock()-t1,step,(int)ceil(Options.duration/Options.timestep));
+    pModel->UpdateDiagnostics          (Options,tt); //required to read stuff!!
+    pModel->GetEnsemble()->CloseTimeStepOps(pModel,Options,tt,e);
+
+    if ((Options.use_stopfile) && (CheckForStopfile(step,tt))) { break; }
+    if (pModel->GetEnsemble()->TerminateMember(pModel))         { terminated=true; break; }
+    step++;
+  }
+
+  //Finished Solving----------------------------------------------------
+  if(!terminated) //diagnostics and end state of terminated member would not be those of complete simulation
+  {
     pModel->UpdateDiagnostics (Options,tt);
     pModel->RunDiagnostics    (Options);
     pModel->WriteMajorOutput  (Options,tt,"solution",true);
-    pModel->CloseOutputStreams();
+  }
+  pModel->CloseOutputStreams();
 
-    if(!Options.silent)
-    {
-      cout <<"======================================================"<<endl;
-      cout <<"...Raven Simulation Complete: "<<Options.run_name<<endl;
-      cout <<"    Parsing & initialization: "<< float(t1     -t0)/CLOCKS_PER_SEC << " seconds elapsed . "<<endl;
-      cout <<"                  Simulation: "<< float(clock()-t1)/CLOCKS_PER_SEC << " seconds elapsed . "<<endl;
-      if(Options.output_dir!="") {
-        cout <<"  Output written to "        << Options.output_dir                                       <<endl;
-      }
-      cout <<"======================================================"<<endl;
-    }
-    if (Options.benchmarking) {
-      cout <<"                              "<< pModel->GetNumHRUs()*(Options.duration/Options.timestep)/(float(clock()-t1)/CLOCKS_PER_SEC)<<" HRU-time steps/second"<<endl;
+  if(!Options.silent)
+  {
+    cout <<"======================================================"<<endl;
+    if(terminated) { cout <<"...Raven Simulation Terminated Early (no diagnostics or solution written): "<<Options.run_name<<endl; }
+    else           { cout <<"...Raven Simulation Complete: "<<Options.run_name<<endl; }
+    cout <<"    Parsing & initialization: "<< float(t1     -t0)/CLOCKS_PER_SEC << " seconds elapsed . "<<endl;
+    cout <<"                  Simulation: "<< float(clock()-t1)/CLOCKS_PER_SEC << " seconds elapsed . "<<endl;
+    if(Options.output_dir!="") {
+      cout <<"  Output written to "        << Options.output_dir                                       <<endl;
     }
+    cout <<"======================================================"<<endl;
+  }
+  if (Options.benchmarking) {
+    cout <<"                              "<< pModel->GetNumHRUs()*(Options.duration/Options.timestep)/(float(clock()-t1)/CLOCKS_PER_SEC)<<" HRU-time steps/second"<<endl;
+  }
+  if ((Options.benchmarking) || (Options.noisy)) {
+    pModel->WriteForcingGridMemoryReport(Options);
+  }
+}
+
+#ifndef _WIN32
+//////////////////////////////////////////////////////////////////
+/// \brief writes nbytes from buf to pipe (large buffers are written in several pieces)
+/// \return true if all bytes were written
+//
+static bool WriteToPipe(const int fd,const void *buf,const size_t nbytes)
+{
+  const char *p=(const char*)(buf);
+  size_t sent=0;
+  while(sent<nbytes) {
+    ssize_t n=write(fd,p+sent,nbytes-sent);
+    if(n<=0) { return false; }
+    sent+=n;
+  }
+  return true;
+}
+//////////////////////////////////////////////////////////////////
+/// \brief reads nbytes from pipe into buf (large buffers arrive in several pieces)
+/// \return true if all bytes were read
+//
+static bool ReadFromPipe(const int fd,void *buf,const size_t nbytes)
+{
+  char *p=(char*)(buf);
+  size_t got=0;
+  while(got<nbytes) {
+    ssize_t n=read(fd,p+got,nbytes-got);
+    if(n<=0) { return false; }
+    got+=n;
+  }
+  return true;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////
+/// \brief Simulates batches of independent ensemble members (Monte Carlo, DDS) concurrently
+/// \details Each member is set up in sequence by CEnsemble::UpdateModel() (so that random
+/// sampling is unchanged), then simulated by a forked child process which holds an independent
+/// copy of the model, class parameters and global variables (e.g., g_current_e). The member result
+/// (e.g., DDS objective function, EnKF member states) is returned to the ensemble driver through a pipe
+/// as an array of doubles, preceded by its length, and received in member order once the whole batch
+/// is complete. Warnings and advisories of each member are buffered by the member process and sent
+/// after the result, then written to Raven_errors.txt by the driver, also in member order.
+/// \remark Limitations:
+///  - not available on Windows, where members are simulated in sequence
+///  - members must write to distinct output files (i.e., '*' wildcard in output directory or run name format)
+///  - member processes exit with _exit(), skipping model cleanup; member output files are closed
+///    by SimulateModel(), but anything written after the member result is sent is lost
+///  - for DDS, all members within a batch are perturbed from the same best solution (the best
+///    solution found before the batch), so that results differ from those of the sequential DDS search
+///
+/// \param t0 [in] computational time marker at start of program
+//
+void RunConcurrentEnsemble(const clock_t t0)
+{
+  CEnsemble  *pEnsemble       =pModel->GetEnsemble();
+  int         nEnsembleMembers=pEnsemble->GetNumMembers();
+  int         nConcurrent     =pEnsemble->GetNumConcurrentMembers();
+  time_struct tt;
 
-    pModel->GetEnsemble()->FinishEnsembleRun(pModel,Options,tt,e);
-  }/* end ensemble loop*/
+#ifdef _WIN32
+  WriteWarning("RunConcurrentEnsemble: concurrent ensemble members are not supported on Windows; members will be simulated in sequence",Options.noisy);
+  for(int e=0;e<nEnsembleMembers; e++)
+  {
+    pEnsemble->UpdateModel(pModel,Options,e);
+    SimulateModel(e,nEnsembleMembers,t0,tt);
+    pEnsemble->FinishEnsembleRun(pModel,Options,tt,e);
+  }
+#else
+  if(pEnsemble->ConcurrentMembersShareOutput()) {
+    ExitGracefully("RunConcurrentEnsemble: concurrent ensemble members would write to the same output files. Use the '*' wildcard in :OutputDirectoryFormat or :RunNameFormat, or remove the :ConcurrentMembers command",BAD_DATA);
+  }
+  int   *aPipe=new int  [nConcurrent]; //read end of pipe from each member process in batch
+  pid_t *aPID =new pid_t[nConcurrent];
 
+  for(int e0=0;e0<nEnsembleMembers; e0+=nConcurrent)
+  {
+    int nBatch=min(nConcurrent,nEnsembleMembers-e0);
 
-  ExitGracefully("Successful Simulation",SIMULATION_DONE);
-  return 0;
+    //launch batch of members--------------------------------------------
+    for(int b=0;b<nBatch;b++)
+    {
+      int e=e0+b;
+      int fd[2];
+      pEnsemble->UpdateModel(pModel,Options,e);
+
+      cout.flush(); //otherwise buffered output is duplicated in child
+      ExitGracefullyIf(pipe(fd)!=0,"RunConcurrentEnsemble: unable to create pipe",RUNTIME_ERR);
+      aPID[b]=fork();
+      ExitGracefullyIf(aPID[b]<0,"RunConcurrentEnsemble: unable to create ensemble member process",RUNTIME_ERR);
+
+      if(aPID[b]==0) //child: simulate member e, send result and warnings to driver
+      {
+        close(fd[0]);
+        for(int bb=0;bb<b;bb++) { close(aPipe[bb]); } //read ends of earlier members in batch, inherited from driver
+        vector<string> warnings;
+        BufferWarnings(&warnings);
+        SimulateModel(e,nEnsembleMembers,t0,tt);
+        vector<double> result;
+        pEnsemble->GetMemberResult(pModel,Options,tt,e,result);
+        BufferWarnings(NULL);
+
+        size_t nVals=result.size();
+        size_t nWarn=warnings.size();
+        bool   ok=WriteToPipe(fd[1],&nVals,sizeof(size_t));
+        ok=ok && WriteToPipe(fd[1],result.data(),nVals*sizeof(double));
+        ok=ok && WriteToPipe(fd[1],&nWarn,sizeof(size_t));
+        for(size_t i=0;(ok) && (i<nWarn);i++) {
+          size_t len=warnings[i].size();
+          ok=WriteToPipe(fd[1],&len,sizeof(size_t)) && WriteToPipe(fd[1],warnings[i].data(),len);
+        }
+        close(fd[1]);
+        cout.flush();
+        _exit(ok ? 0 : 1); //skips model cleanup, handled by parent
+      }
+      close(fd[1]);
+      aPipe[b]=fd[0];
+    }
+
+    //collect member results, in order-----------------------------------
+    for(int b=0;b<nBatch;b++)
+    {
+      int    e=e0+b;
+      int    status;
+      size_t nVals=0,nWarn=0;
+      vector<double> result;
+      vector<string> warnings;
+      bool   ok=ReadFromPipe(aPipe[b],&nVals,sizeof(size_t));
+      if(ok) { result.resize(nVals); ok=ReadFromPipe(aPipe[b],result.data(),nVals*sizeof(double)); }
+      ok=ok && ReadFromPipe(aPipe[b],&nWarn,sizeof(size_t));
+      for(size_t i=0;(ok) && (i<nWarn);i++) {
+        size_t len=0;
+        ok=ReadFromPipe(aPipe[b],&len,sizeof(size_t));
+        if(ok) { string line(len,' '); ok=ReadFromPipe(aPipe[b],&line[0],len); warnings.push_back(line); }
+      }
+      close(aPipe[b]);
+      waitpid(aPID[b],&status,0);
+
+      for(size_t i=0;i+1<warnings.size();i+=2) { //(errors filename, line) pairs
+        ofstream WARNINGS;
+        WARNINGS.open(warnings[i].c_str(),ios::app);
+        WARNINGS<<warnings[i+1]<<endl;
+        WARNINGS.close();
+      }
+      if((!ok) || (!WIFEXITED(status)) || (WEXITSTATUS(status)!=0)) {
+        string warn="RunConcurrentEnsemble: simulation of ensemble member "+to_string(e+1)+" failed";
+        ExitGracefully(warn.c_str(),RUNTIME_ERR);
+      }
+      pEnsemble->ReceiveMemberResult(pModel,Options,e,result);
+    }
+  }
+  delete [] aPipe;
+  delete [] aPID;
+#endif
 }
 
 //////////////////////////////////////////////////////////////////
 /// \param argc [in] number of arguments to executable
-/// \param argv[] [in] executable arguments; Raven.exe [filebase] [-p rvp_file] [-h hru_file] [-t rvt_file] [-c rvc_file] [-o output_dir]
+/// \param argv[] [in] executable arguments; Raven.exe [filebase] [-p rvp_file] [-h hru_file] [-t rvt_file] [-c rvc_file] [-o output_dir] [-nt num_threads]
 /// \details initializes input files and output directory
 /// \details filebase has no extension, all others require .rv* extension
 /// \param Options [in] Global model options
@@ -208,6 +399,7 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
   Options.pause =true;
   Options.forecast_shift=0.0;
   Options.warm_ensemble_run="";
+  Options.num_threads=0;          // 0: not specified on command line
   Options.in_bmi_mode = false;  // "regular mode": Raven called from command line
 
   //Parse argument list
@@ -218,7 +410,7 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
     }
     if ((word=="-p") || (word=="-h") || (word=="-t") || (word=="-e") || (word=="-c") || (word=="-o") ||
         (word=="-s") || (word=="-r") || (word=="-n") || (word=="-l") || (word=="-m") || (word=="-v") ||
-        (word=="-we")|| (word=="-tt")|| (i==argc))
+        (word=="-we")|| (word=="-tt")|| (word=="-nt")|| (i==argc))
     {
       if      (mode==0){
         Options.rvi_filename=argument+".rvi";
@@ -244,6 +436,7 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
       else if (mode==11){Options.run_mode =argument[0]; argument="";}
       else if (mode==12){Options.forecast_shift=s_to_d(argument.c_str()); argument=""; }
       else if (mode==13){Options.warm_ensemble_run=argument; argument=""; }
+      else if (mode==14){Options.num_threads=max(s_to_i(argument.c_str()),1); argument=""; }
 
       if      (word=="-p"){mode=1; }
       else if (word=="-h"){mode=2; }
@@ -259,6 +452,7 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options)
       else if (word=="-m"){mode=11;}
       else if (word=="-tt"){mode=12; }
       else if (word=="-we"){mode=13; }
+      else if (word=="-nt"){mode=14; }
       else if (word=="-v"){Options.pause=false; version_announce=true; mode=10;} //For PAVICS
     }
     else{
@@ -21,5 +21,7 @@ void ProcessExecutableArguments(int argc, char* argv[], optStruct   &Options);
 void CheckForErrorWarnings     (bool quiet);
 bool CheckForStopfile          (const int step, const time_struct &tt);
 void CallExternalScript        (const optStruct &Options, const time_struct &tt);
+void SimulateModel             (const int e, const int nEnsembleMembers, const clock_t t0, time_struct &tt);
+void RunConcurrentEnsemble     (const clock_t t0);
 
 #endif
@@ -1539,6 +1539,34 @@ void CReservoir::WriteToSolutionFile (ofstream &RVC) const
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief appends reservoir state (flow, stage, DA scale factors, control structure flows) to binary snapshot
+/// \param &aSnap [out] snapshot payload
+//
+void CReservoir::WriteToSnapshot(vector<double> &aSnap) const
+{
+  aSnap.push_back(_Qout);         aSnap.push_back(_Qout_last);
+  aSnap.push_back(_stage);        aSnap.push_back(_stage_last);
+  aSnap.push_back(_DAscale);      aSnap.push_back(_DAscale_last);
+  for (int i = 0; i < _nControlStructures; i++) {
+    aSnap.push_back(_aQstruct[i]); aSnap.push_back(_aQstruct_last[i]);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief restores reservoir state written by WriteToSnapshot()
+/// \details unlike :ResFlow in the .rvc file, outflows are restored as stored, never recalculated from the rating curve
+/// \param *aSnap [in] snapshot payload
+/// \param &i [in/out] index of first reservoir value in aSnap; returned as index of next value
+//
+void CReservoir::ReadFromSnapshot(const double *aSnap, size_t &i)
+{
+  _Qout   =aSnap[i++]; _Qout_last   =aSnap[i++];
+  _stage  =aSnap[i++]; _stage_last  =aSnap[i++];
+  _DAscale=aSnap[i++]; _DAscale_last=aSnap[i++];
+  for (int j = 0; j < _nControlStructures; j++) {
+    _aQstruct[j]=aSnap[i++]; _aQstruct_last[j]=aSnap[i++];
+  }
+}
+//////////////////////////////////////////////////////////////////
 /// \brief interpolates the volume from the volume-stage rating curve
 /// \param ht [in] reservoir stage
 /// \returns reservoir volume [m3] corresponding to stage ht
@@ -258,6 +258,8 @@ public:/*-------------------------------------------------------*/
                                               const optStruct   &Options,
                                               const time_struct &tt);
   void              WriteToSolutionFile      (ofstream &OUT) const;
+  void              WriteToSnapshot          (vector<double> &aSnap) const;
+  void              ReadFromSnapshot         (const double *aSnap, size_t &i);
   void              UpdateReservoir          (const time_struct &tt, const optStruct &Options);
   void              UpdateMassBalance        (const time_struct &tt, const double &tstep);
   double            ScaleFlow                (const double &scale, const bool overriding,const double &tstep,const double &t);
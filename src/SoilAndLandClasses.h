@@ -55,6 +55,7 @@ public:/*-------------------------------------------------------*/
   const soil_struct       *GetSoilStruct() const;
   double                   GetSoilProperty(string &param_name) const;
   void                     SetSoilProperty(string param_name, const double &value);
+  double                  *GetSoilPropertyAddress(string param_name);
 
   //routines
   void AutoCalculateSoilProps(const soil_struct &Stmp,const soil_struct &Sdefault,const int nConstit);
@@ -64,6 +65,7 @@ public:/*-------------------------------------------------------*/
   static       CSoilClass *StringToSoilClass(const string s);
   static void              DestroyAllSoilClasses();
   static void              SetSoilProperty         (soil_struct &S, string param_name, const double value);
+  static double           *GetSoilPropertyAddress  (soil_struct &S, string param_name);
   static double            GetSoilProperty         (const soil_struct &S, string param_name, const bool strict=true);
   static void              InitializeSoilProperties(soil_struct &S, bool is_template,int nConstits);
 
@@ -103,6 +105,7 @@ public:/*-------------------------------------------------------*/
   double                   GetParameter(const string param_name) const;//not currently used
   double                   GetVegetationProperty(string param_name) const;
   void                     SetVegetationProperty(const string &param_name, const double &value);
+  double                  *GetVegetationPropertyAddress(const string &param_name);
 
   //routines
   void AutoCalculateVegetationProps(const veg_struct    &Vtmp,
@@ -115,6 +118,7 @@ public:/*-------------------------------------------------------*/
   static void                    DestroyAllVegClasses();
 
   static void                    SetVegetationProperty(veg_struct &V, const string param_name, const double &value);
+  static double                 *GetVegetationPropertyAddress(veg_struct &V, const string param_name);
   static void                    SetVegTransportProperty( int          constit_ind,int          constit_ind2,
                                                           veg_struct  &V,string param_name, const double value);
   static double                  GetVegetationProperty(const veg_struct &V, string param_name, const bool strict=true);
@@ -181,6 +185,7 @@ public:/*-------------------------------------------------------*/
   const surface_struct    *GetSurfaceStruct() const;
   double                   GetSurfaceProperty(string param_name) const;
   void                     SetSurfaceProperty(const string &param_name, const double &value);
+  double                  *GetSurfacePropertyAddress(const string &param_name);
 
   //routines
   void AutoCalculateLandUseProps(const surface_struct &Stmp,
@@ -193,6 +198,7 @@ public:/*-------------------------------------------------------*/
 
   static void                    InitializeSurfaceProperties(string name, surface_struct &S, bool is_template);
   static void                    SetSurfaceProperty         (surface_struct &S, const string param_name, const double value);
+  static double                 *GetSurfacePropertyAddress  (surface_struct &S, const string param_name);
   static double                  GetSurfaceProperty         (const surface_struct &S, string param_name, const bool strict=true);
 
   static void                    SummarizeToScreen();
@@ -224,6 +230,7 @@ public:/*-------------------------------------------------------*/
   const terrain_struct    *GetTerrainStruct() const;
   double                   GetTerrainProperty(string param_name) const;
   void                     SetTerrainProperty(const string &param_name, const double &value);
+  double                  *GetTerrainPropertyAddress(const string &param_name);
 
   //routines
   void AutoCalculateTerrainProps(const terrain_struct &Ttmp, const terrain_struct &Tdefault);
@@ -235,6 +242,7 @@ public:/*-------------------------------------------------------*/
 
   static void                    InitializeTerrainProperties(terrain_struct &T, bool is_template);
   static void                    SetTerrainProperty(terrain_struct &T, const string  param_name, const double value);
+  static double                 *GetTerrainPropertyAddress(terrain_struct &T, const string param_name);
   static double                  GetTerrainProperty(const terrain_struct &T, string param_name);
 
   static void                    SummarizeToScreen();
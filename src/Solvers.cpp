@@ -6,6 +6,333 @@
 #include "RavenInclude.h"
 #include "Model.h"
 #include "GWRiverConnection.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////
+/// \brief Solves system of vertical (HRU-scale) energy and mass balance ODEs for one HRU over one timestep
+/// \remark may be called concurrently for different HRUs: only row k of the state variable
+/// arrays and of the model balance arrays is modified, and all scratch arrays are local
+/// (rate_guess is thread-specific)
+///
+/// \param *pModel [in & out] Model
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Time at start of timestep
+/// \param &tt_end [in] Time at end of timestep
+/// \param k [in] global HRU index
+/// \param **aPhi [in & out] state variable arrays at start of timestep [nHRUs][NS]
+/// \param **aPhinew [in & out] state variable arrays at end of timestep [nHRUs][NS]
+/// \param **aPhiPrevIter [in & out] state variable arrays at previous iteration [nHRUs][NS]
+/// \param **rate_guess [out] scratch rate array [nProcesses][NS*NS] (only used by ITERATED_HEUN)
+//
+static void SolveHRUBalance(      CModel      *pModel,
+                            const optStruct   &Options,
+                            const time_struct &tt,
+                            const time_struct &tt_end,
+                            const int          k,
+                                  double     **aPhi,
+                                  double     **aPhinew,
+                                  double     **aPhiPrevIter,
+                                  double     **rate_guess)
+{
+  int i,j,q,qs;                                //counters
+  int NS,nConnections=0,nProcesses;            //array sizes (local copies)
+  int iAtm;                                    //atmospheric precip index
+
+  int                iFrom          [MAX_CONNECTIONS]; //arrays used to pass values through GetRatesOfChange routines
+  int                iTo            [MAX_CONNECTIONS];
+  double             rates_of_change[MAX_CONNECTIONS];
+
+  double             tstep=Options.timestep;
+
+  CHydroUnit        *pHRU=pModel->GetHydroUnit(k);
+
+  NS        =pModel->GetNumStateVars();
+  nProcesses=pModel->GetNumProcesses();
+  iAtm      =pModel->GetStateVarIndex(ATMOS_PRECIP);
+
+  for (i=0;i<MAX_CONNECTIONS;i++)
+  {
+    iFrom          [i]=DOESNT_EXIST;
+    iTo            [i]=DOESNT_EXIST;
+    rates_of_change[i]=0.0;
+  }
+
+  //=================================================================
+  //==Standard (in series) approach==================================
+  // -order is critical!
+  if (Options.sol_method==ORDERED_SERIES)
+  {
+    pModel->ApplyLocalParamOverrrides(k, false);
+
+    if(pHRU->IsEnabled())
+    {
+      qs=0;
+      for(j=0;j<nProcesses;j++)
+      {
+        nConnections=0;
+        if(pModel->ApplyProcess(j,aPhinew[k],pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change)) //note aPhinew is newest state variable vector
+        {
+#ifdef _STRICTCHECK_
+          if(nConnections>MAX_CONNECTIONS) {
+            cout<<nConnections<<endl;
+            ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR); }
+#endif
+          for(q=0;q<nConnections;q++)//each process may have multiple connections
+          {
+            sv_type typ=pModel->GetStateVarType(iFrom[q]);
+            if(iTo[q]!=iFrom[q]) {
+              aPhinew[k][iFrom[q]]-=rates_of_change[q]*tstep;//mass/energy balance maintained
+              aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//change is an exchange of energy or mass, which must be preserved
+            }
+            else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){
+              rates_of_change[q]=0.0;
+              aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
+            }
+            else {
+              aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//for state vars that are not storage compartments
+            }
+            pModel->IncrementBalance(qs,k,rates_of_change[q]*tstep);   //this is only this easy for Euler/Ordered!
+            qs++;
+          }//end for q=0 to nConnections
+        }// end if (pModel->ApplyProcess
+        else
+        {
+          for(q=0;q<nConnections;q++)
+          {
+            pModel->IncrementBalance(qs,k,0.0);
+            qs++;
+          }
+        }
+      }//end for j=0 to nProcesses
+    }
+    pModel->ApplyLocalParamOverrrides(k, true);
+  }//end if Options.sol_method==ORDERED_SERIES
+
+  //=================================================================
+  //==Simple Euler Method ===========================================
+  // -order of processes doesn't matter
+  else if (Options.sol_method==EULER)
+  {
+    //model all hydrologic processes occuring at HRU scale
+    //-----------------------------------------------------------------
+    qs=0;
+    for (j=0;j<nProcesses;j++)
+    {
+      nConnections=0;
+
+      if (pModel->ApplyProcess(j,aPhi   [k],pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change))//note aPhi is info from start of timestep
+      {
+#ifdef _STRICTCHECK_
+        if(nConnections>MAX_CONNECTIONS) {
+          cout<<nConnections<<endl;
+          ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR);}
+#endif
+        for (q=0;q<nConnections;q++)//each process may have multiple connections
+        {
+          sv_type typ=pModel->GetStateVarType(iFrom[q]);
+          if (iTo[q]!=iFrom[q]){
+            aPhinew[k][iFrom[q]]-=rates_of_change[q]*tstep;//mass/energy balance maintained
+            aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//change is an exchange of energy or mass, which must be preserved
+          }
+          else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){
+            rates_of_change[q]=0.0;
+            aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
+          }
+          else{
+            aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//for state vars that are not storage compartments
+          }
+          pModel->IncrementBalance(qs,k,rates_of_change[q]*tstep);//this is only this easy for Euler/Ordered!
+          qs++;
+        }//end for q=0 to nConnections
+      }
+      else
+      {
+        for(q=0;q<nConnections;q++)
+        {
+          pModel->IncrementBalance(qs,k,0.0);
+          qs++;
+        }
+      }
+    }//end for j=0 to nProcesses
+  }//end if Options.sol_method==EULER
+
+  //===================================================================
+  //==Iterated Heun Method ============================================
+  // -order of processes doesn't matter, converges to specified criteria
+  else if(Options.sol_method==ITERATED_HEUN)
+  {
+    int    iter = 0;              //iteration counter
+    bool   converg = false;
+    double converg_check = 0.0;
+    double rate1[MAX_CONNECTIONS];
+    double rate2[MAX_CONNECTIONS];
+
+    do  //Iterate
+    {
+      iter++;           // iteration counter
+
+      for(i=0;i<NS;i++)  //loop through all state variables
+      {
+        aPhiPrevIter[k][i]=aPhinew[k][i];       //iteration k-1 value
+        aPhinew     [k][i]=aPhi   [k][i];
+      }
+
+      //model all other hydrologic processes occuring at HRU scale
+      //-----------------------------------------------------------------
+      for (j=0;j<nProcesses;j++)
+      {
+        // ROC 1 - uses initial state var values
+        // ROC 2 - uses previous iteration values
+        if (pModel->ApplyProcess(j,aPhi[k]        ,pHRU,Options,tt     ,iFrom,iTo,nConnections,rate1))
+        {
+          pModel->ApplyProcess(j,aPhiPrevIter[k],pHRU,Options,tt_end ,iFrom,iTo,nConnections,rate2);
+
+          if(nConnections>MAX_CONNECTIONS) {
+            cout<<nConnections<<endl;
+            ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR);
+          }
+
+          for (q=0;q<nConnections;q++)//each process may have multiple connections
+          {
+            sv_type typ=pModel->GetStateVarType(iFrom[q]);
+            rate_guess[j][q] = 0.5*(rate1[q] + rate2[q]);
+
+            if(iFrom[q]==iAtm){               //check if water is coming from precipitation
+              rate_guess[j][q] = rate1[q];    //sets the rate of change to be the original (prevents over filling of SV's)
+            }
+
+            if (iTo[q]!=iFrom[q]){
+              aPhinew[k][iFrom[q]]  -= rate_guess[j][q]*tstep;//mass/energy balance maintained
+              aPhinew[k][iTo  [q]]  += rate_guess[j][q]*tstep;//change is an exchange of energy or mass, which must be preserved
+            }
+            else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){
+              rates_of_change[q]=0.0;
+              aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
+            }
+            else{   //correction for state vars that are not storage compartments
+              aPhinew[k][iTo  [q]]  += rate_guess[j][q]*tstep;
+            }
+          }//end for q=0 to nConnections
+        }
+        else
+        {
+          for (q=0;q<nConnections;q++){rate_guess[j][q]=0.0;} //process not applied in this HRU
+        }
+      }//end for j=0 to nProcesses
+
+      //Calculate convegence criterion
+      for(i=0;i<NS;i++)
+      {
+        //converg_check += (2*(fabs(aPhinew[k][i] - aPhiPrevIter[i])/(aPhinew[k][i] + aPhiPrevIter[i]))); //possible converg check #1
+        converg_check += (fabs(aPhinew[k][i] - aPhiPrevIter[k][i])/NS);    //possible converg check #2
+        //converg_check += (fabs(aPhinew[k][i]-aPhiPrevIter[i])/aPhinew[k][i]); //possible converg check #3
+        //converg_check = pow((converg_check + pow((aPhinew[k][i]-aPhiPrecIter[i]),2)),0.5);  //possible converg check #4
+      }
+      converg = false;
+
+      if((converg_check <= Options.convergence_crit) ||
+         (iter          == Options.max_iterations))   //convergence check
+      {
+        qs  =0;
+        iter=0;
+        converg = true;
+
+        for(j=0;j<nProcesses;j++)
+        {
+          nConnections=pModel->GetNumConnections(j);
+          for(q=0;q<nConnections;q++)
+          {
+            pModel->IncrementBalance(qs,k,rate_guess[j][q]*tstep);
+            qs++;
+          }
+        }
+      }//end of (converg_check <=...)
+
+      converg_check = 0.0;
+
+    } while(converg != true);  //end do loop
+  }//end iterated Heun
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Routes water through the reach (and reservoir) of one subbasin over one timestep
+/// \remark may be called concurrently for subbasins in the same routing level, as these do not
+/// drain into one another; only state of subbasin p (and its reservoir HRU) is modified
+///
+/// \param *pModel [in & out] Model
+/// \param &Options [in] Global model options information
+/// \param &tt [in] Time at start of timestep
+/// \param p [in] subbasin index
+/// \param *aQinnew [in] inflow rate to subbasin reaches at t+dt [m3/s] [size=_nSubBasins]
+/// \param *aRouted [in & out] volume of runoff from HRUs to subbasin reaches over timestep [m3] [size=_nSubBasins]
+/// \param **aPhinew [in & out] state variable arrays at end of timestep [nHRUs][NS]
+/// \param *pGW2River [in] GW model river connection (coupled models only)
+/// \param iAET [in] index of AET state variable
+/// \return flow delivered to downstream subbasin at t+dt (outflow less irrigation and diversions) [m3/s]
+//
+static double RouteSubBasin(      CModel             *pModel,
+                            const optStruct          &Options,
+                            const time_struct        &tt,
+                            const int                 p,
+                            const double             *aQinnew,
+                                  double             *aRouted,
+                                  double            **aPhinew,
+                                  CGWRiverConnection *pGW2River,
+                            const int                 iAET)
+{
+  const int MAX_CONTROL_STRUCTURES=10;
+  double aQoutnew   [MAX_RIVER_SEGS];          //[m3/s] final outflow from reach segment seg at time t+dt
+  double res_Qstruct[MAX_CONTROL_STRUCTURES];  //[m3/s] outflow through reservoir control structures
+  double res_ht,res_outflow;
+  double down_Q,irr_Q,div_Q,Qwithdrawn;
+  int    pDivert;
+  res_constraint res_const;
+
+  double     tstep =Options.timestep;
+  double     t     =tt.model_time;
+  CSubBasin *pBasin=pModel->GetSubBasin(p);
+
+  if(!pBasin->IsEnabled()){return 0.0;}
+
+  pBasin->UpdateSubBasin(tt,Options);            // also used to assimilate lake levels and update routing hydrograph for timestep
+
+  pBasin->UpdateInflow(aQinnew[p]);              // from upstream, diversions, and specified flows
+
+  down_Q=pBasin->GetDownstreamInflow(t);         // treated as additional runoff (period starting)
+
+  if (Options.modeltype == MODELTYPE_COUPLED)
+  {
+    aRouted[p]+= pGW2River->CalcRiverFlowBySB(p)*tstep;      // [m3]
+  }
+
+  pBasin->UpdateLateralInflow(aRouted[p]/(tstep*SEC_PER_DAY)+down_Q);//[m3/d]->[m3/s]
+
+  pBasin->RouteWater    (aQoutnew,res_ht,res_outflow,res_const,res_Qstruct,Options,tt);      //Where everything happens!
+
+  Qwithdrawn=0;
+  irr_Q=pBasin->ApplyIrrigationDemand(t+tstep,aQoutnew[pBasin->GetNumSegments()-1]);
+  Qwithdrawn+=irr_Q;
+
+  for(int i=0; i<pBasin->GetNumDiversions();i++) {
+    div_Q=pBasin->GetDiversionFlow(i,pBasin->GetOutflowRate(),Options,tt,pDivert); //diversions based upon flows at start of timestep
+    Qwithdrawn+=div_Q;
+  }
+
+  pBasin->UpdateOutflows(aQoutnew,irr_Q,res_ht,res_outflow,res_const,res_Qstruct,Options,tt,false);//actually updates flow values here
+
+  pModel->AssimilationOverride(p,Options,tt); //modifies flows using assimilation, if needed
+
+  if(pBasin->GetReservoir()!=NULL) {//update AET for reservoir-linked HRUs
+    int k=pBasin->GetReservoir()->GetHRUIndex();
+    if ((k!=DOESNT_EXIST) && (iAET!=DOESNT_EXIST)){
+      aPhinew[k][iAET]=pBasin->GetReservoir()->GetAET();//[mm/d]
+    }
+  }
+  //still need to remove Qwithdrawn from somewhere if downstream outflow doesn't exist!
+  return pBasin->GetOutflowRate()-Qwithdrawn;
+}
 
 ///////////////////////////////////////////////////////////////////
 /// \brief Solves system of energy and mass balance ODEs/PDEs for one timestep
@@ -19,14 +346,14 @@ void MassEnergyBalance( CModel            *pModel,
                         const optStruct   &Options,
                         const time_struct &tt)
 {
-  int i,j,k,p,pp,pTo,q,qs,c;                   //counters
-  int NS,NB,nHRUs,nConnections=0,nProcesses;   //array sizes (local copies)
+  int i,j,k,p,pp,pTo,q,c;                      //counters
+  int NS,NB,nHRUs,nProcesses;                  //array sizes (local copies)
   int nConstituents;                           //
-  int iSW, iAtm, iAET, iGW, iRO;               //Surface water, atmospheric precip, used PET, runoff indices
+  int nThreads;                                //number of threads used in HRU and routing loops
+  int iSW, iAET, iGW, iRO;                     //Surface water, used PET, runoff indices
 
-  int                iFrom          [MAX_CONNECTIONS]; //arrays used to pass values through GetRatesOfChange routines
+  int                iFrom          [MAX_CONNECTIONS]; //arrays used to pass values through ApplyLateralProcess routines
   int                iTo            [MAX_CONNECTIONS];
-  double             rates_of_change[MAX_CONNECTIONS];
 
   double             tstep;       //[d] timestep
   double             t;           //[d] model time
@@ -34,22 +361,24 @@ void MassEnergyBalance( CModel            *pModel,
 
   CHydroUnit        *pHRU;        //pointer to current HRU
   CSubBasin         *pBasin;      //pointer to current SubBasin
-  CGroundwaterModel *pGWModel;    //pointer to GW model
-  CGWRiverConnection*pGW2River;   //pointer to GW model river connection
+  CGroundwaterModel *pGWModel=NULL;  //pointer to GW model
+  CGWRiverConnection*pGW2River=NULL; //pointer to GW model river connection
 
   static double    **aPhi=NULL;   //[mm;C;mg/m2;MJ/m2] state variable arrays at initial, intermediate times;
   static double    **aPhinew;     //[mm;C;mg/m2;MJ/m2] state variable arrays at end of timestep; value after convergence
   static double    **aPhiPrevIter;
+  //(rows of the above point into model-owned state matrices 1,2,3; state matrix 0 is current HRU state)
 
   static double     *aQinnew;     //[m3/s] inflow rate to subbasin reach p at t+dt [size=_nSubBasins]
-  static double     *aQoutnew;    //[m3/s] final outflow from reach segment seg at time t+dt [size=MAX_RIVER_SEGS]
+  static double     *aQdown;      //[m3/s] flow from subbasin p to downstream subbasin at t+dt [size=_nSubBasins]
   static double     *aRouted;     //[m3]
 
   static double     *aMinnew;     //[mg/d] or [MJ/d] mass/energy loading of constituents to subbasin reach p at t+dt [size=_nSubBasins]
   static double     *aMoutnew;    //[mg/d] or [MJ/d] final mass/energy output from reach segment seg at time t+dt [size= MAX_RIVER_SEGS]
   static double     *aRoutedMass; //[mg/d] or [MJ/d] amount of mass/energy [size= _nSubBasins]
 
-  static double    **rate_guess;  //need to set first array to nProcesses
+  static double   ***rate_guess=NULL;  //[thread][process][connection] - one scratch array per thread
+  static int         nRateGuess=0;     //number of thread-specific rate_guess arrays
 
   static int        *kFrom;
   static int        *kTo;
@@ -74,19 +403,13 @@ void MassEnergyBalance( CModel            *pModel,
     aPhi        =new double *[nHRUs];
     aPhinew     =new double *[nHRUs];
     aPhiPrevIter=new double *[nHRUs];
+    ExitGracefullyIf(aPhiPrevIter==NULL,"MassEnergyBalance(1)",OUT_OF_MEMORY);
 
-    for (k=0;k<nHRUs;k++)
-    {
-      aPhi[k]        =new double [NS];
-      aPhinew[k]     =new double [NS];
-      aPhiPrevIter[k]=new double [NS];
-    }
-
-    aQoutnew    =NULL;
+    aQdown      =NULL;
     aQinnew     =new double [NB];
     aRouted     =new double [NB];
-    aQoutnew    =new double [MAX_RIVER_SEGS];
-    ExitGracefullyIf(aQoutnew==NULL,"MassEnergyBalance",OUT_OF_MEMORY);
+    aQdown      =new double [NB];
+    ExitGracefullyIf(aQdown==NULL,"MassEnergyBalance",OUT_OF_MEMORY);
 
     aMinnew     =NULL;
     aMoutnew    =NULL;
@@ -108,9 +431,13 @@ void MassEnergyBalance( CModel            *pModel,
 
     if(Options.sol_method==ITERATED_HEUN)
     {
-      rate_guess = new double *[nProcesses];    //need to set first array to numProcesses
-      for (j=0;j<nProcesses;j++){
-        rate_guess[j]=new double [NS*NS];       //maximum number of connections possible
+      nRateGuess = max(Options.num_threads,1);
+      rate_guess = new double **[nRateGuess];
+      for (int th=0;th<nRateGuess;th++){
+        rate_guess[th] = new double *[nProcesses];    //need to set first array to numProcesses
+        for (j=0;j<nProcesses;j++){
+          rate_guess[th][j]=new double [NS*NS];       //maximum number of connections possible
+        }
       }
     }
     //For lateral flow processes
@@ -130,21 +457,24 @@ void MassEnergyBalance( CModel            *pModel,
   {
     iFrom          [i]=DOESNT_EXIST;
     iTo            [i]=DOESNT_EXIST;
-    rates_of_change[i]=0.0;
+  }
+  //copy current state (state matrix 0) to start/end of timestep work buffers as contiguous blocks
+  int     stride=pModel->GetStateMatrixStride();
+  size_t  nbytes=(size_t)(nHRUs)*(size_t)(stride)*sizeof(double);
+  double *aCurr =pModel->GetStateMatrix(0);
+  memcpy(pModel->GetStateMatrix(1),aCurr,nbytes);
+  memcpy(pModel->GetStateMatrix(2),aCurr,nbytes);
+  if (Options.sol_method==ITERATED_HEUN){
+    memcpy(pModel->GetStateMatrix(3),aCurr,nbytes);
   }
   for (k=0;k<nHRUs;k++)
   {
-    pHRU=pModel->GetHydroUnit(k);
-    for (i=0;i<NS ;i++)
-    {
-      aPhi        [k][i]=pHRU->GetStateVarValue(i);
-      aPhinew     [k][i]=aPhi[k][i];
-      aPhiPrevIter[k][i]=aPhi[k][i];
-    }
+    aPhi        [k]=pModel->GetStateMatrix(1)+k*stride;
+    aPhinew     [k]=pModel->GetStateMatrix(2)+k*stride;
+    aPhiPrevIter[k]=pModel->GetStateMatrix(3)+k*stride;
   }
 
   iSW  =pModel->GetStateVarIndex(SURFACE_WATER);
-  iAtm =pModel->GetStateVarIndex(ATMOS_PRECIP);
 
   // Used PET and runoff reboots to zero every timestep==============
   iAET=pModel->GetStateVarIndex(AET);
@@ -177,220 +507,30 @@ void MassEnergyBalance( CModel            *pModel,
     }
   }
 
-  //=================================================================
-  //==Standard (in series) approach==================================
-  // -order is critical!
-  if (Options.sol_method==ORDERED_SERIES)
+  //-----------------------------------------------------------------
+  //      VERTICAL (HRU-SCALE) PROCESSES
+  //-----------------------------------------------------------------
+  if ((Options.sol_method!=ORDERED_SERIES) && (Options.sol_method!=EULER) && (Options.sol_method!=ITERATED_HEUN))
   {
-    for (k=0;k<nHRUs;k++)
-    {
-      pHRU=pModel->GetHydroUnit(k);
-      pModel->ApplyLocalParamOverrrides(k, false);
-
-      if(pHRU->IsEnabled())
-      {
-        qs=0;
-        for(j=0;j<nProcesses;j++)
-        {
-          nConnections=0;
-          if(pModel->ApplyProcess(j,aPhinew[k],pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change)) //note aPhinew is newest state variable vector
-          {
-#ifdef _STRICTCHECK_
-            if(nConnections>MAX_CONNECTIONS) {
-              cout<<nConnections<<endl;
-              ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR); }
+    ExitGracefully("MassEnergyBalance",STUB);
+  }
+  // HRUs are independent: if all processes support it, HRUs are partitioned across threads
+  // (results are identical to serial run, as each HRU is solved in exactly the same sequence)
+  nThreads=max(Options.num_threads,1);
+  if (Options.sol_method==ITERATED_HEUN){nThreads=min(nThreads,nRateGuess);} //one rate_guess array per thread
+  if (!pModel->IsHRULoopThreadSafe()   ){nThreads=1;}
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(nThreads) schedule(dynamic,32) if(nThreads>1)
 #endif
-            for(q=0;q<nConnections;q++)//each process may have multiple connections
-            {
-              sv_type typ=pModel->GetStateVarType(iFrom[q]);
-              if(iTo[q]!=iFrom[q]) {
-                aPhinew[k][iFrom[q]]-=rates_of_change[q]*tstep;//mass/energy balance maintained
-                aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//change is an exchange of energy or mass, which must be preserved
-              }
-              else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){
-                rates_of_change[q]=0.0;
-                aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
-              }
-              else {
-                aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//for state vars that are not storage compartments
-              }
-              pModel->IncrementBalance(qs,k,rates_of_change[q]*tstep);   //this is only this easy for Euler/Ordered!
-              qs++;
-            }//end for q=0 to nConnections
-          }// end if (pModel->ApplyProcess
-          else
-          {
-            for(q=0;q<nConnections;q++)
-            {
-              pModel->IncrementBalance(qs,k,0.0);
-              qs++;
-            }
-          }
-        }//end for j=0 to nProcesses
-      }
-      pModel->ApplyLocalParamOverrrides(k, true);
-    }//end for k=0 to nHRUs
-
-  }//end if Options.sol_method==ORDERED_SERIES
-
-  //=================================================================
-  //==Simple Euler Method ===========================================
-  // -order of processes doesn't matter
-  else if (Options.sol_method==EULER)
+  for (k=0;k<nHRUs;k++)
   {
-    for (k=0;k<nHRUs;k++)
-    {
-      pHRU=pModel->GetHydroUnit(k);
-
-      //model all hydrologic processes occuring at HRU scale
-      //-----------------------------------------------------------------
-      qs=0;
-      for (j=0;j<nProcesses;j++)
-      {
-        nConnections=0;
-
-        if (pModel->ApplyProcess(j,aPhi   [k],pHRU,Options,tt,iFrom,iTo,nConnections,rates_of_change))//note aPhi is info from start of timestep
-        {
-#ifdef _STRICTCHECK_
-          if(nConnections>MAX_CONNECTIONS) {
-            cout<<nConnections<<endl;
-            ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR);}
+    int th=0;
+#ifdef _OPENMP
+    th=omp_get_thread_num();
 #endif
-          for (q=0;q<nConnections;q++)//each process may have multiple connections
-          {
-            sv_type typ=pModel->GetStateVarType(iFrom[q]);
-            if (iTo[q]!=iFrom[q]){
-              aPhinew[k][iFrom[q]]-=rates_of_change[q]*tstep;//mass/energy balance maintained
-              aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//change is an exchange of energy or mass, which must be preserved
-            }
-            else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){
-              rates_of_change[q]=0.0;
-              aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
-            }
-            else{
-              aPhinew[k][iTo  [q]]+=rates_of_change[q]*tstep;//for state vars that are not storage compartments
-            }
-            pModel->IncrementBalance(qs,k,rates_of_change[q]*tstep);//this is only this easy for Euler/Ordered!
-            qs++;
-          }//end for q=0 to nConnections
-        }
-        else
-        {
-          for(q=0;q<nConnections;q++)
-          {
-            pModel->IncrementBalance(qs,k,0.0);
-            qs++;
-          }
-        }
-      }//end for j=0 to nProcesses
-    }//end for k=0 to nHRUs
-  }//end if Options.sol_method==EULER
-
-  //===================================================================
-  //==Iterated Heun Method ============================================
-  // -order of processes doesn't matter, converges to specified criteria
-  else if(Options.sol_method==ITERATED_HEUN)
-  {
-    qs= 0;
-    int    iter = 0;              //iteration counter
-    bool   converg = false;
-    double converg_check = 0.0;
-    double rate1[MAX_CONNECTIONS];
-    double rate2[MAX_CONNECTIONS];
-
-    //Go through all HRUs
-    for (k=0;k<nHRUs;k++)
-    {
-      pHRU=pModel->GetHydroUnit(k);
-
-      do  //Iterate
-      {
-        iter++;           // iteration counter
-
-        for(i=0;i<NS;i++)  //loop through all state variables
-        {
-          aPhiPrevIter[k][i]=aPhinew[k][i];       //iteration k-1 value
-          aPhinew     [k][i]=aPhi   [k][i];
-        }
-
-        //model all other hydrologic processes occuring at HRU scale
-        //-----------------------------------------------------------------
-        for (j=0;j<nProcesses;j++)
-        {
-          // ROC 1 - uses initial state var values
-          // ROC 2 - uses previous iteration values
-          if (pModel->ApplyProcess(j,aPhi[k]        ,pHRU,Options,tt     ,iFrom,iTo,nConnections,rate1))
-          {
-            pModel->ApplyProcess(j,aPhiPrevIter[k],pHRU,Options,tt_end ,iFrom,iTo,nConnections,rate2);
-
-            if(nConnections>MAX_CONNECTIONS) {
-              cout<<nConnections<<endl;
-              ExitGracefully("MassEnergyBalance:: Maximum number of connections exceeded. Please contact author.",RUNTIME_ERR);
-            }
-
-            for (q=0;q<nConnections;q++)//each process may have multiple connections
-            {
-              sv_type typ=pModel->GetStateVarType(iFrom[q]);
-              rate_guess[j][q] = 0.5*(rate1[q] + rate2[q]);
-
-              if(iFrom[q]==iAtm){               //check if water is coming from precipitation
-                rate_guess[j][q] = rate1[q];    //sets the rate of change to be the original (prevents over filling of SV's)
-              }
-
-              if (iTo[q]!=iFrom[q]){
-                aPhinew[k][iFrom[q]]  -= rate_guess[j][q]*tstep;//mass/energy balance maintained
-                aPhinew[k][iTo  [q]]  += rate_guess[j][q]*tstep;//change is an exchange of energy or mass, which must be preserved
-              }
-              else if (CStateVariable::IsWaterStorage(typ) && (typ!=CONVOLUTION)){
-                rates_of_change[q]=0.0;
-                aPhinew[k][iTo  [q]]+=0.0; //likely from redirect - water moves back to itself
-              }
-              else{   //correction for state vars that are not storage compartments
-                aPhinew[k][iTo  [q]]  += rate_guess[j][q]*tstep;
-              }
-            }//end for q=0 to nConnections
-          }
-        }//end for j=0 to nProcesses
-
-        //Calculate convegence criterion
-        for(i=0;i<NS;i++)
-        {
-          //converg_check += (2*(fabs(aPhinew[k][i] - aPhiPrevIter[i])/(aPhinew[k][i] + aPhiPrevIter[i]))); //possible converg check #1
-          converg_check += (fabs(aPhinew[k][i] - aPhiPrevIter[k][i])/NS);    //possible converg check #2
-          //converg_check += (fabs(aPhinew[k][i]-aPhiPrevIter[i])/aPhinew[k][i]); //possible converg check #3
-          //converg_check = pow((converg_check + pow((aPhinew[k][i]-aPhiPrecIter[i]),2)),0.5);  //possible converg check #4
-        }
-        converg = false;
-
-        if((converg_check <= Options.convergence_crit) ||
-           (iter          == Options.max_iterations))   //convergence check
-        {
-          qs  =0;
-          iter=0;
-          converg = true;
-
-          for(j=0;j<nProcesses;j++)
-          {
-            nConnections=pModel->GetNumConnections(j);
-            for(q=0;q<nConnections;q++)
-            {
-              pModel->IncrementBalance(qs,k,rate_guess[j][q]*tstep);
-              qs++;
-            }
-          }
-        }//end of (converg_check <=...)
-
-        converg_check = 0.0;
-
-      } while(converg != true);  //end do loop
-    }//end of for k=0 to nHRUs
-  }//end iterated Heun
-
-  //==Other Methods Below ============================================
-  else
-  {
-    ExitGracefully("MassEnergyBalance",STUB);
-  }
+    SolveHRUBalance(pModel,Options,tt,tt_end,k,aPhi,aPhinew,aPhiPrevIter,(rate_guess==NULL) ? NULL : rate_guess[th]);
+  }//end for k=0 to nHRUs
 
   //-----------------------------------------------------------------
   //      LATERAL EXCHANGE PROCESSES
@@ -466,12 +606,8 @@ void MassEnergyBalance( CModel            *pModel,
   //-----------------------------------------------------------------
   //      ROUTING
   //-----------------------------------------------------------------
-  double res_ht,res_outflow;
-  double down_Q,irr_Q,div_Q, Qwithdrawn, SWvol;
+  double div_Q, SWvol;
   int    pDivert;
-  res_constraint res_const;
-  const int MAX_CONTROL_STRUCTURES=10;
-  double *res_Qstruct=new double [MAX_CONTROL_STRUCTURES];
   //determine total outflow from HRUs into respective basins (aRouted[p])
   for (p=0;p<NB;p++)
   {
@@ -534,60 +670,35 @@ void MassEnergyBalance( CModel            *pModel,
   // Route water over timestep
   // ----------------------------------------------------------------------------------------
   // calculations performed in order from upstream (pp=0) to downstream (pp=nSubBasins-1)
-  for (pp=0;pp<NB;pp++)
+  // subbasins in the same routing level do not drain into one another and may be routed concurrently;
+  // downstream inflows are then accumulated in ordered sequence, so results do not depend upon thread count
+  nThreads=max(Options.num_threads,1);
+  if (!pModel->IsRoutingThreadSafe(Options)){nThreads=1;}
+
+  for (int L=0;L<pModel->GetNumRoutingLevels();L++)
   {
-    p=pModel->GetOrderedSubBasinIndex(pp); //p refers to actual index of basin, pp is ordered list index upstream to down
+    int ppStart=pModel->GetRoutingLevelStart(L);
+    int ppEnd  =pModel->GetRoutingLevelStart(L+1);
 
-    pBasin=pModel->GetSubBasin(p);
-    if(pBasin->IsEnabled())
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(nThreads) schedule(dynamic,8) if((nThreads>1) && (ppEnd-ppStart>1))
+#endif
+    for (pp=ppStart;pp<ppEnd;pp++)
     {
-      pBasin->UpdateSubBasin(tt,Options);            // also used to assimilate lake levels and update routing hydrograph for timestep
-
-      pBasin->UpdateInflow(aQinnew[p]);              // from upstream, diversions, and specified flows
-
-      down_Q=pBasin->GetDownstreamInflow(t);         // treated as additional runoff (period starting)
-
-      if (Options.modeltype == MODELTYPE_COUPLED)
-	    {
-        aRouted[p]+= pGW2River->CalcRiverFlowBySB(p)*tstep;      // [m3]
-      }
-
-      pBasin->UpdateLateralInflow(aRouted[p]/(tstep*SEC_PER_DAY)+down_Q);//[m3/d]->[m3/s]
-
-      pBasin->RouteWater    (aQoutnew,res_ht,res_outflow,res_const,res_Qstruct,Options,tt);      //Where everything happens!
-
-      Qwithdrawn=0;
-      irr_Q=pBasin->ApplyIrrigationDemand(t+tstep,aQoutnew[pBasin->GetNumSegments()-1]);
-      Qwithdrawn+=irr_Q;
-
-      for(int i=0; i<pBasin->GetNumDiversions();i++) {
-        div_Q=pBasin->GetDiversionFlow(i,pBasin->GetOutflowRate(),Options,tt,pDivert); //diversions based upon flows at start of timestep
-        Qwithdrawn+=div_Q;
-      }
-
-      pBasin->UpdateOutflows(aQoutnew,irr_Q,res_ht,res_outflow,res_const,res_Qstruct,Options,tt,false);//actually updates flow values here
-
-      pModel->AssimilationOverride(p,Options,tt); //modifies flows using assimilation, if needed
+      int pb=pModel->GetOrderedSubBasinIndex(pp); //pb refers to actual index of basin, pp is ordered list index upstream to down
+      aQdown[pb]=RouteSubBasin(pModel,Options,tt,pb,aQinnew,aRouted,aPhinew,pGW2River,iAET);
+    }
 
-      pTo   =pModel->GetDownstreamBasin(p);
-      if(pTo!=DOESNT_EXIST)//update downstream inflows
+    for (pp=ppStart;pp<ppEnd;pp++)//update downstream inflows
+    {
+      p  =pModel->GetOrderedSubBasinIndex(pp);
+      pTo=pModel->GetDownstreamBasin(p);
+      if ((pModel->GetSubBasin(p)->IsEnabled()) && (pTo!=DOESNT_EXIST))
       {
-        aQinnew[pTo]+=pBasin->GetOutflowRate()-Qwithdrawn;
-      }
-      else {
-        //still need to remove Qwithdrawn from somewhere if downstream outflow doesn't exist!
-        //Qdivloss+=Qwithdrawn;
-      }
-
-      if(pBasin->GetReservoir()!=NULL) {//update AET for reservoir-linked HRUs
-        k=pBasin->GetReservoir()->GetHRUIndex();
-        if ((k!=DOESNT_EXIST) && (iAET!=DOESNT_EXIST)){
-          aPhinew[k][iAET]=pBasin->GetReservoir()->GetAET();//[mm/d]
-        }
+        aQinnew[pTo]+=aQdown[p];
       }
     }
-  }//end for pp...
-  delete [] res_Qstruct;
+  }//end for L...
 
   //-----------------------------------------------------------------
   //      CONSTITUENT (MASS OR ENERGY) ROUTING
@@ -652,29 +763,32 @@ void MassEnergyBalance( CModel            *pModel,
   }//end (c=0;c<nConstituents;c++)
 
   //update state variable values=====================================
+  //end of timestep buffer becomes current state by pointer swap; disabled HRUs retain current state
   for (k=0;k<nHRUs;k++){
     pHRU=pModel->GetHydroUnit(k);
-    if(pHRU->IsEnabled())
+    if(!pHRU->IsEnabled())
     {
-      for(i=0;i<NS;i++){
-        pHRU->SetStateVarValue(i,aPhinew[k][i]);
-      }
+      memcpy(aPhinew[k],aCurr+k*stride,NS*sizeof(double));
     }
   }
+  pModel->SwapStateMatrix(2);
 
   //delete static arrays (only called once)=========================
   if(t>=Options.duration-Options.timestep)
   {
     if(DESTRUCTOR_DEBUG) { cout<<"DELETING STATIC ARRAYS IN MASSENERGYBALANCE"<<endl; }
-    for(k=0;k<nHRUs;k++) { delete[] aPhi[k];         } delete[] aPhi;         aPhi=NULL;
-    for(k=0;k<nHRUs;k++) { delete[] aPhinew[k];      } delete[] aPhinew;      aPhinew=NULL;
-    for(k=0;k<nHRUs;k++) { delete[] aPhiPrevIter[k]; } delete[] aPhiPrevIter; aPhiPrevIter=NULL;
+    delete[] aPhi;         aPhi=NULL;
+    delete[] aPhinew;      aPhinew=NULL;
+    delete[] aPhiPrevIter; aPhiPrevIter=NULL;
     if(Options.sol_method == ITERATED_HEUN)
     {
-      for(j=0;j<nProcesses;j++) { delete[] rate_guess[j]; }  delete[] rate_guess; rate_guess=NULL;
+      for(int th=0;th<nRateGuess;th++) {
+        for(j=0;j<nProcesses;j++) { delete[] rate_guess[th][j]; }  delete[] rate_guess[th];
+      }
+      delete[] rate_guess; rate_guess=NULL; nRateGuess=0;
     }
     delete[] aQinnew;      aQinnew     = NULL;
-    delete[] aQoutnew;     aQoutnew    = NULL;
+    delete[] aQdown;       aQdown      = NULL;
     delete[] aRouted;      aRouted     = NULL;
     //delete transport static arrays.
     if(nConstituents>0)
@@ -24,8 +24,11 @@
 #elif defined(__APPLE__)
 #include <sys/stat.h>
 #endif
-int  NetCDFAddMetadata  (const int fileid,const int time_dimid,                  string shortname,string longname,string units);
-int  NetCDFAddMetadata2D(const int fileid,const int time_dimid,int nbasins_dimid,string shortname,string longname,string units);
+int  NetCDFAddMetadata  (const int fileid,const int time_dimid,                  string shortname,string longname,string units,const int chunk_time=0,const int deflate_level=0);
+int  NetCDFAddMetadata2D(const int fileid,const int time_dimid,int nbasins_dimid,string shortname,string longname,string units,const int chunk_time=0,const int deflate_level=0);
+#ifdef _RVNETCDF_
+void NetCDFDefineStorage(const int fileid,const int varid,const int ndims,const int *dimids,const int chunk_time,const int deflate_level);
+#endif
 void WriteNetCDFGlobalAttributes(const int out_ncid,const optStruct &Options,const string descript);
 void AddSingleValueToNetCDF     (const int out_ncid,const string &label,const size_t time_index,const double &value);
 void WriteNetCDFBasinList       (const int ncid,const int varid,const CModel* pModel,bool is_res,const optStruct &Options);
@@ -141,7 +144,14 @@ void CModel::CloseOutputStreams()
 
 #ifdef _RVNETCDF_
 
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex());
   int    retval;      // error value for NetCDF routines
+  //write remaining buffered time steps before closing files
+  if (_pHYDRO_ncbuf    != NULL) {_pHYDRO_ncbuf   ->Flush(); delete _pHYDRO_ncbuf;    _pHYDRO_ncbuf   =NULL;}
+  if (_pRESSTAGE_ncbuf != NULL) {_pRESSTAGE_ncbuf->Flush(); delete _pRESSTAGE_ncbuf; _pRESSTAGE_ncbuf=NULL;}
+  if (_pSTORAGE_ncbuf  != NULL) {_pSTORAGE_ncbuf ->Flush(); delete _pSTORAGE_ncbuf;  _pSTORAGE_ncbuf =NULL;}
+  if (_pFORCINGS_ncbuf != NULL) {_pFORCINGS_ncbuf->Flush(); delete _pFORCINGS_ncbuf; _pFORCINGS_ncbuf=NULL;}
+  if (_pRESMB_ncbuf    != NULL) {_pRESMB_ncbuf   ->Flush(); delete _pRESMB_ncbuf;    _pRESMB_ncbuf   =NULL;}
   if (_HYDRO_ncid != -9)    {retval = nc_close(_HYDRO_ncid);    HandleNetCDFErrors(retval); }
   _HYDRO_ncid    = -9;
   if (_STORAGE_ncid != -9)  {retval = nc_close(_STORAGE_ncid);  HandleNetCDFErrors(retval); }
@@ -638,6 +648,10 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
 
   CSubBasin* pSB;
 
+#ifdef _RVNETCDF_
+  lock_guard<recursive_mutex> nc_lock(GetNetCDFMutex()); //gridded forcings may be read from NetCDF in background
+#endif
+
   string tmpFilename;
 
   if ((tt.model_time==0) && (Options.suppressICs)){return;}
@@ -669,6 +683,10 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
       usetime=tt.model_time-Options.timestep;
     }
 
+    // Watershed-wide averages and storage totals used below (one sweep over HRUs and subbasins)
+    //----------------------------------------------------------------
+    UpdateWatershedAggregates();
+
     // Console output
     //----------------------------------------------------------------
     if ((quiet) && (!Options.silent) && (tt.day_of_month==1) && ((tt.julian_day)-floor(tt.julian_day+TIME_CORRECTION)<Options.timestep/2))
@@ -678,7 +696,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
     if(!silent)
     {
       cout <<thisdate<<" "<<thishour<<":";
-      if (t!=0){cout <<" | P: "<< setw(6)<<setiosflags(ios::fixed) << setprecision(2)<<GetAveragePrecip();}
+      if (t!=0){cout <<" | P: "<< setw(6)<<setiosflags(ios::fixed) << setprecision(2)<<_WshedAgg.precip;}
       else     {cout <<" | P: ------";}
     }
 
@@ -688,11 +706,11 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
     {
       if (Options.write_watershed_storage)
       {
-        double snowfall      =GetAverageSnowfall();
-        double precip        =GetAveragePrecip();
-        double channel_stor  =GetTotalChannelStorage();
-        double reservoir_stor=GetTotalReservoirStorage();
-        double rivulet_stor  =GetTotalRivuletStorage();
+        double snowfall      =_WshedAgg.snowfall;
+        double precip        =_WshedAgg.precip;
+        double channel_stor  =_WshedAgg.channel_stor;
+        double reservoir_stor=_WshedAgg.reservoir_stor;
+        double rivulet_stor  =_WshedAgg.rivulet_stor;
 
         _STORAGE<<tt.model_time <<","<<thisdate<<","<<thishour; //instantaneous, so thishour rather than usehour used.
 
@@ -705,7 +723,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
         {
           if ((CStateVariable::IsWaterStorage(_aStateVarType[i])) && (i!=iCumPrecip))
           {
-            S=GetAvgStateVar(i);
+            S=_WshedAgg.aAvgStateVar[i];
             if (!silent){cout<<"  |"<< setw(6)<<setiosflags(ios::fixed) << setprecision(2)<<S;}
             _STORAGE<<","<<FormatDouble(S);
             currentWater+=S;
@@ -733,7 +751,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
       if (Options.ave_hydrograph)
       {
         _HYDRO<<usetime<<","<<usedate<<","<<usehour;
-        if(t!=0) { _HYDRO<<","<<GetAveragePrecip(); }//watershed-wide precip
+        if(t!=0) { _HYDRO<<","<<_WshedAgg.precip; }//watershed-wide precip
         else     { _HYDRO<<",---";                  }
 
         for (int p=0;p<_nSubBasins;p++)
@@ -776,7 +794,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
         if((Options.period_starting) && (t==0)){}//don't write anything at time zero
         else{
           _HYDRO<<t<<","<<thisdate<<","<<thishour;
-          if(t!=0){ _HYDRO<<","<<GetAveragePrecip(); }//watershed-wide precip
+          if(t!=0){ _HYDRO<<","<<_WshedAgg.precip; }//watershed-wide precip
           else    { _HYDRO<<",---";                  }
           for(int p=0;p<_nSubBasins;p++)
           {
@@ -892,7 +910,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
       if((Options.period_starting) && (t==0)){}//don't write anything at time zero
       else{
         _LEVELS<<t<<","<<thisdate<<","<<thishour;
-        if(t!=0){ _LEVELS<<","<<GetAveragePrecip(); }//watershed-wide precip
+        if(t!=0){ _LEVELS<<","<<_WshedAgg.precip; }//watershed-wide precip
         else    { _LEVELS<<",---";                  }
         for(int p=0;p<_nSubBasins;p++)
         {
@@ -923,7 +941,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
     {
       if((Options.period_starting) && (t==0)){}//don't write anything at time zero
       else{
-	      _RESSTAGE<< t<<","<<thisdate<<","<<thishour<<","<<GetAveragePrecip();
+	      _RESSTAGE<< t<<","<<thisdate<<","<<thishour<<","<<_WshedAgg.precip;
 	      for (int p=0;p<_nSubBasins;p++)
         {
           pSB=_pSubBasins[p];
@@ -984,7 +1002,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
           ExitGracefully(("CModel::WriteOutputFileHeaders: Unable to open output file "+tmpFilename+" for writing.").c_str(),FILE_OPEN_ERR);
         }
 
-        RES_MB<< usetime<<","<<usedate<<","<<usehour<<","<<GetAveragePrecip();
+        RES_MB<< usetime<<","<<usedate<<","<<usehour<<","<<_WshedAgg.precip;
         double in,out,loss,stor,oldstor,precip,evap,seepage,stage;
         for(int p=0;p<_nSubBasins;p++)
         {
@@ -1103,7 +1121,7 @@ void CModel::WriteMinorOutput(const optStruct &Options,const time_struct &tt)
 
             //Cumulative, storage, error
             double Initial_i=0.0; //< \todo [bug] need to evaluate and store initial storage actross watershed!!!
-            MB<<","<<cumsum<<","<<GetAvgStateVar(i)<<","<<cumsum-GetAvgStateVar(i)-Initial_i;
+            MB<<","<<cumsum<<","<<_WshedAgg.aAvgStateVar[i]<<","<<cumsum-_WshedAgg.aAvgStateVar[i]-Initial_i;
           }
         }
         MB<<endl;
@@ -1292,6 +1310,11 @@ void CModel::WriteMajorOutput(const optStruct &Options, const time_struct &tt, s
 
   RVC.close();
 
+  // WRITE {RunName}_solution.rvc.bin - binary snapshot of same state
+  if (Options.binary_snapshots){
+    WriteBinarySnapshot(tmpFilename+".bin",tmpFilename,tt);
+  }
+
   // SubbasinProperties.csv
   //--------------------------------------------------------------
   if (Options.write_basinfile){
@@ -1501,7 +1524,7 @@ void CModel::RunDiagnostics(const optStruct &Options)
 
         DIAG<<_pObservedTS[i]->GetName()<<"_"<<_pDiagPeriods[d]->GetName()<<"["<<_pObservedTS[i]->GetLocID()<<"],"<<_pObservedTS[i]->GetSourceFile() <<",";//append to end of name for backward compatibility
         for(int j=0; j<_nDiagnostics;j++) {
-          DIAG<<_pDiagnostics[j]->CalculateDiagnostic(_pModeledTS[i],_pObservedTS[i],_pObsWeightTS[i],starttime,endtime,compare,thresh,Options)<<",";
+          DIAG<<GetDiagnosticValue(d,i,j,Options)<<",";
         }
         DIAG<<endl;
       }
@@ -1770,6 +1793,8 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
   string      tmpFilename;
   int         p;                                     // loop over all sub-basins
   string      tmp,tmp2,tmp3;
+  const int   chunk=Options.NetCDF_out_buffer;       // chunk length along time = number of time steps written per buffer flush
+  const int   dfl  =Options.NetCDF_deflate;          // deflate level (0: uncompressed)
 
   // initialize all potential file IDs with -9 == "not existing and hence not opened"
   _HYDRO_ncid    = -9;   // output file ID for Hydrographs.nc         (-9 --> not opened)
@@ -1809,12 +1834,13 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
   /// Define the time variable. Assign units attributes to the netCDF VARIABLES.
   dimids1[0] = time_dimid;
   retval = nc_def_var(_HYDRO_ncid, "time", NC_DOUBLE, ndims1,dimids1, &varid_time); HandleNetCDFErrors(retval);
+  NetCDFDefineStorage(_HYDRO_ncid,varid_time,ndims1,dimids1,chunk,dfl);
   retval = nc_put_att_text(_HYDRO_ncid, varid_time, "units"   ,      strlen(starttime)  , starttime);   HandleNetCDFErrors(retval);
   retval = nc_put_att_text(_HYDRO_ncid, varid_time, "calendar",      strlen("gregorian"), "gregorian"); HandleNetCDFErrors(retval);
   retval = nc_put_att_text(_HYDRO_ncid, varid_time, "standard_name", strlen("time"),      "time");      HandleNetCDFErrors(retval);
 
   // define precipitation variable
-  varid_pre= NetCDFAddMetadata(_HYDRO_ncid, time_dimid,"precip","Precipitation","mm d**-1");
+  varid_pre= NetCDFAddMetadata(_HYDRO_ncid, time_dimid,"precip","Precipitation","mm d**-1",chunk,dfl);
 
   // ----------------------------------------------------------
   // simulated/observed outflows
@@ -1840,11 +1866,11 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     retval = nc_put_att_text(_HYDRO_ncid, varid_bsim, "cf_role"  , tmp2.length(),tmp2.c_str());    HandleNetCDFErrors(retval);
     retval = nc_put_att_text(_HYDRO_ncid, varid_bsim, "units"    , tmp3.length(),tmp3.c_str());    HandleNetCDFErrors(retval);
 
-    varid_qsim= NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_sim","Simulated outflows","m**3 s**-1");
-    varid_qobs= NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_obs","Observed outflows" ,"m**3 s**-1");
-    varid_qin = NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_in" ,"Simulated reservoir inflows"  ,"m**3 s**-1");
+    varid_qsim= NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_sim","Simulated outflows","m**3 s**-1",chunk,dfl);
+    varid_qobs= NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_obs","Observed outflows" ,"m**3 s**-1",chunk,dfl);
+    varid_qin = NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_in" ,"Simulated reservoir inflows"  ,"m**3 s**-1",chunk,dfl);
     if (Options.write_localflow){
-    varid_qloc= NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_loc" ,"Local inflow contribution"  ,"m**3 s**-1");
+    varid_qloc= NetCDFAddMetadata2D(_HYDRO_ncid, time_dimid,nbasins_dimid,"q_loc" ,"Local inflow contribution"  ,"m**3 s**-1",chunk,dfl);
     }
   }// end if nSim>0
 
@@ -1856,6 +1882,35 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     WriteNetCDFBasinList(_HYDRO_ncid,varid_bsim,this,false,Options);
   }
 
+  // (b) create buffered writer (order of variables used in WriteNetcdfMinorOutput)
+  _pHYDRO_ncbuf=new CNetCDFOutputBuffer(_HYDRO_ncid,chunk);
+  _pHYDRO_ncbuf->AddVariable("time");
+  _pHYDRO_ncbuf->AddVariable("precip");
+  if (nSim>0){
+    _pHYDRO_ncbuf->AddVariable("q_sim");
+    _pHYDRO_ncbuf->AddVariable("q_obs");
+    _pHYDRO_ncbuf->AddVariable("q_in");
+    if (Options.write_localflow){
+    _pHYDRO_ncbuf->AddVariable("q_loc");
+    }
+  }
+
+  // (c) identify continuous flow observations of each gauged basin
+  delete [] _aHydroObsIndex; _aHydroObsIndex=NULL;
+  if (nSim>0){
+    _aHydroObsIndex=new int [nSim];
+    int iSim=0;
+    for (p=0;p<_nSubBasins;p++){
+      if (_pSubBasins[p]->IsGauged()  && (_pSubBasins[p]->IsEnabled())){
+        _aHydroObsIndex[iSim]=DOESNT_EXIST;
+        for (int i=0;i<_nObservedTS;i++){
+          if (IsContinuousFlowObs(_pObservedTS[i],_pSubBasins[p]->GetID())){_aHydroObsIndex[iSim]=i;} //last one, if duplicated
+        }
+        iSim++;
+      }
+    }
+  }
+
   //====================================================================
   //  ReservoirStages.nc
   //====================================================================
@@ -1880,12 +1935,13 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     /// Define the time variable. Assign units attributes to the netCDF VARIABLES.
     dimids1[0] = time_dimid;
     retval = nc_def_var     (_RESSTAGE_ncid,"time",NC_DOUBLE,ndims1,dimids1,&varid_time);           HandleNetCDFErrors(retval);
+    NetCDFDefineStorage(_RESSTAGE_ncid,varid_time,ndims1,dimids1,chunk,dfl);
     retval = nc_put_att_text(_RESSTAGE_ncid,varid_time,"units",strlen(starttime),starttime);        HandleNetCDFErrors(retval);
     retval = nc_put_att_text(_RESSTAGE_ncid,varid_time,"calendar",strlen("gregorian"),"gregorian"); HandleNetCDFErrors(retval);
     retval = nc_put_att_text(_RESSTAGE_ncid,varid_time,"standard_name",strlen("time"),"time");      HandleNetCDFErrors(retval);
 
     // define precipitation variable
-    varid_pre= NetCDFAddMetadata(_RESSTAGE_ncid,time_dimid,"precip","Precipitation","mm d**-1");
+    varid_pre= NetCDFAddMetadata(_RESSTAGE_ncid,time_dimid,"precip","Precipitation","mm d**-1",chunk,dfl);
 
     // ----------------------------------------------------------
     // simulated/observed stages
@@ -1911,8 +1967,8 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
       retval = nc_put_att_text(_RESSTAGE_ncid,varid_bsim,"cf_role",  tmp2.length(),tmp2.c_str());    HandleNetCDFErrors(retval);
       retval = nc_put_att_text(_RESSTAGE_ncid,varid_bsim,"units",    tmp3.length(),tmp3.c_str());    HandleNetCDFErrors(retval);
 
-      varid_qsim= NetCDFAddMetadata2D(_RESSTAGE_ncid,time_dimid,nbasins_dimid,"h_sim","Simulated stage","m");
-      varid_qobs= NetCDFAddMetadata2D(_RESSTAGE_ncid,time_dimid,nbasins_dimid,"h_obs","Observed stage","m");
+      varid_qsim= NetCDFAddMetadata2D(_RESSTAGE_ncid,time_dimid,nbasins_dimid,"h_sim","Simulated stage","m",chunk,dfl);
+      varid_qobs= NetCDFAddMetadata2D(_RESSTAGE_ncid,time_dimid,nbasins_dimid,"h_obs","Observed stage","m",chunk,dfl);
 
     }// end if nSim>0
 
@@ -1924,6 +1980,31 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     if (nSim>0){
       WriteNetCDFBasinList(_RESSTAGE_ncid,varid_bsim,this,true,Options);
     }
+
+    // (b) create buffered writer
+    _pRESSTAGE_ncbuf=new CNetCDFOutputBuffer(_RESSTAGE_ncid,chunk);
+    _pRESSTAGE_ncbuf->AddVariable("time");
+    _pRESSTAGE_ncbuf->AddVariable("precip");
+    if (nSim>0){
+      _pRESSTAGE_ncbuf->AddVariable("h_sim");
+      _pRESSTAGE_ncbuf->AddVariable("h_obs");
+    }
+
+    // (c) identify continuous stage observations of each gauged reservoir
+    delete [] _aStageObsIndex; _aStageObsIndex=NULL;
+    if (nSim>0){
+      _aStageObsIndex=new int [nSim];
+      int iSim=0;
+      for (p=0;p<_nSubBasins;p++){
+        if((_pSubBasins[p]->IsGauged())  && (_pSubBasins[p]->IsEnabled())  && (_pSubBasins[p]->GetReservoir()!=NULL)) {
+          _aStageObsIndex[iSim]=DOESNT_EXIST;
+          for (int i=0;i<_nObservedTS;i++){
+            if (IsContinuousStageObs(_pObservedTS[i],_pSubBasins[p]->GetID())){_aStageObsIndex[iSim]=i;} //last one, if duplicated
+          }
+          iSim++;
+        }
+      }
+    }
   }
 
   //====================================================================
@@ -1949,6 +2030,7 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     /// Define the time variable.
     dimids1[0] = time_dimid;
     retval = nc_def_var(_STORAGE_ncid, "time", NC_DOUBLE, ndims1,dimids1, &varid_time); HandleNetCDFErrors(retval);
+    NetCDFDefineStorage(_STORAGE_ncid,varid_time,ndims1,dimids1,chunk,dfl);
     retval = nc_put_att_text(_STORAGE_ncid, varid_time, "units"   , strlen(starttime)  , starttime);   HandleNetCDFErrors(retval);
     retval = nc_put_att_text(_STORAGE_ncid, varid_time, "calendar", strlen("gregorian"), "gregorian"); HandleNetCDFErrors(retval);
 
@@ -1956,26 +2038,44 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     // precipitation / channel storage / state vars / MB diagnostics
     // ----------------------------------------------------------
     int varid;
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"rainfall","rainfall","mm d**-1");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"snowfall","snowfall","mm d**-1");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"channel_storage","Channel Storage","mm");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"reservoir_storage","Reservoir Storage","mm");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"rivulet_storage","Rivulet Storage","mm");
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"rainfall","rainfall","mm d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"snowfall","snowfall","mm d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"channel_storage","Channel Storage","mm",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"reservoir_storage","Reservoir Storage","mm",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"rivulet_storage","Rivulet Storage","mm",chunk,dfl);
 
     int iAtmPrecip=GetStateVarIndex(ATMOS_PRECIP);
     for(int i=0;i<_nStateVars;i++){
       if((CStateVariable::IsWaterStorage(_aStateVarType[i])) && (i!=iAtmPrecip)){
 	      string name =CStateVariable::GetStateVarLongName(_aStateVarType[i],_aStateVarLayer[i]);
-	      varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,name,name,"mm");
+	      varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,name,name,"mm",chunk,dfl);
       }
     }
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"total","total water storage","mm");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"cum_input","cumulative water input","mm");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"cum_outflow","cumulative water output","mm");
-    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"MB_error","mass balance error","mm");
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"total","total water storage","mm",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"cum_input","cumulative water input","mm",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"cum_outflow","cumulative water output","mm",chunk,dfl);
+    varid= NetCDFAddMetadata(_STORAGE_ncid, time_dimid,"MB_error","mass balance error","mm",chunk,dfl);
 
     // End define mode. This tells netCDF we are done defining metadata.
     retval = nc_enddef(_STORAGE_ncid);  HandleNetCDFErrors(retval);
+
+    // create buffered writer (same order as variable definitions)
+    _pSTORAGE_ncbuf=new CNetCDFOutputBuffer(_STORAGE_ncid,chunk);
+    _pSTORAGE_ncbuf->AddVariable("time");
+    _pSTORAGE_ncbuf->AddVariable("rainfall");
+    _pSTORAGE_ncbuf->AddVariable("snowfall");
+    _pSTORAGE_ncbuf->AddVariable("channel_storage");
+    _pSTORAGE_ncbuf->AddVariable("reservoir_storage");
+    _pSTORAGE_ncbuf->AddVariable("rivulet_storage");
+    for(int i=0;i<_nStateVars;i++){
+      if((CStateVariable::IsWaterStorage(_aStateVarType[i])) && (i!=iAtmPrecip)){
+        _pSTORAGE_ncbuf->AddVariable(CStateVariable::GetStateVarLongName(_aStateVarType[i],_aStateVarLayer[i]));
+      }
+    }
+    _pSTORAGE_ncbuf->AddVariable("total");
+    _pSTORAGE_ncbuf->AddVariable("cum_input");
+    _pSTORAGE_ncbuf->AddVariable("cum_outflow");
+    _pSTORAGE_ncbuf->AddVariable("MB_error");
   }
 
   //====================================================================
@@ -1995,34 +2095,43 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     retval = nc_def_dim(_FORCINGS_ncid,"time",NC_UNLIMITED,&time_dimid);  HandleNetCDFErrors(retval);
     dimids1[0] = time_dimid;
     retval = nc_def_var(_FORCINGS_ncid,"time",NC_DOUBLE,ndims1,dimids1,&varid_time); HandleNetCDFErrors(retval);
+    NetCDFDefineStorage(_FORCINGS_ncid,varid_time,ndims1,dimids1,chunk,dfl);
     retval = nc_put_att_text(_FORCINGS_ncid,varid_time,"units",strlen(starttime),starttime);   HandleNetCDFErrors(retval);
     retval = nc_put_att_text(_FORCINGS_ncid,varid_time,"calendar",strlen("gregorian"),"gregorian"); HandleNetCDFErrors(retval);
 
     // ----------------------------------------------------------
     int varid;
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"rainfall","rainfall","mm d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"snowfall","snowfall","mm d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp","temp","C");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp_daily_min","temp_daily_min","C");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp_daily_max","temp_daily_max","C");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp_daily_ave","temp_daily_ave","C");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"air_density","air density","kg m**-3");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"air_pressure","air pressure","kPa");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"relative_humidity","relative humidity","");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"cloud_cover","cloud cover","");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"ET_radiation","ET radiation","MJ m**-2 d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"SW_radiation","SW radiation","MJ m**-2 d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"net_SW_radiation","net SW radiation","MJ m**-2 d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"LW_radiation","LW radiation","MJ m**-2 d**-1");
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"rainfall","rainfall","mm d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"snowfall","snowfall","mm d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp","temp","C",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp_daily_min","temp_daily_min","C",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp_daily_max","temp_daily_max","C",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"temp_daily_ave","temp_daily_ave","C",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"air_density","air density","kg m**-3",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"air_pressure","air pressure","kPa",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"relative_humidity","relative humidity","",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"cloud_cover","cloud cover","",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"ET_radiation","ET radiation","MJ m**-2 d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"SW_radiation","SW radiation","MJ m**-2 d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"net_SW_radiation","net SW radiation","MJ m**-2 d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"LW_radiation","LW radiation","MJ m**-2 d**-1",chunk,dfl);
     //varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"LW_radia_inc","LW incoming","MJ m**-2 d**-1");
     //varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"SW_radia_subcan","SW subcanopy","MJ m**-2 d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"wind_velocity","wind velocity","m s**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"PET","PET","mm d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"OW_PET","OW PET","mm d**-1");
-    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"potential_melt","potential melt","mm d**-1");
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"wind_velocity","wind velocity","m s**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"PET","PET","mm d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"OW_PET","OW PET","mm d**-1",chunk,dfl);
+    varid= NetCDFAddMetadata(_FORCINGS_ncid,time_dimid,"potential_melt","potential melt","mm d**-1",chunk,dfl);
 
     // End define mode. This tells netCDF we are done defining metadata.
     retval = nc_enddef(_FORCINGS_ncid);  HandleNetCDFErrors(retval);
+
+    // create buffered writer (same order as variable definitions)
+    const string forcing_names[18]={"rainfall","snowfall","temp","temp_daily_min","temp_daily_max","temp_daily_ave",
+                                    "air_density","air_pressure","relative_humidity","cloud_cover","ET_radiation","SW_radiation",
+                                    "net_SW_radiation","LW_radiation","wind_velocity","PET","OW_PET","potential_melt"};
+    _pFORCINGS_ncbuf=new CNetCDFOutputBuffer(_FORCINGS_ncid,chunk);
+    _pFORCINGS_ncbuf->AddVariable("time");
+    for (int i=0;i<18;i++){_pFORCINGS_ncbuf->AddVariable(forcing_names[i]);}
   }
 
   //====================================================================
@@ -2042,12 +2151,13 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     retval = nc_def_dim(_RESMB_ncid,"time",NC_UNLIMITED,&time_dimid);  HandleNetCDFErrors(retval);
     dimids1[0] = time_dimid;
     retval = nc_def_var(_RESMB_ncid,"time",NC_DOUBLE,ndims1,dimids1,&varid_time);                HandleNetCDFErrors(retval);
+    NetCDFDefineStorage(_RESMB_ncid,varid_time,ndims1,dimids1,chunk,dfl);
     retval = nc_put_att_text(_RESMB_ncid,varid_time,"units",strlen(starttime),starttime);        HandleNetCDFErrors(retval);
     retval = nc_put_att_text(_RESMB_ncid,varid_time,"calendar",strlen("gregorian"),"gregorian"); HandleNetCDFErrors(retval);
 
     // ----------------------------------------------------------
     int varid;
-    varid= NetCDFAddMetadata(_RESMB_ncid,time_dimid,"precip","Precipitation","mm d**-1");
+    varid= NetCDFAddMetadata(_RESMB_ncid,time_dimid,"precip","Precipitation","mm d**-1",chunk,dfl);
 
     // (a) count number of simulated reservoirs "nSim"
     nSim = 0;
@@ -2070,15 +2180,15 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
       retval = nc_put_att_text(_RESMB_ncid,varid_bsim,"cf_role",  tmp2.length(),tmp2.c_str());    HandleNetCDFErrors(retval);
       retval = nc_put_att_text(_RESMB_ncid,varid_bsim,"units",    tmp3.length(),tmp3.c_str());    HandleNetCDFErrors(retval);
 
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"stage",    "stage",  "m");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"inflow",   "inflow", "m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"outflow",  "outflow","m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"precip_m3","precip", "m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"evap",     "evap",   "m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"seepage",  "seepage","m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"volume",   "volume", "m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"losses",   "losses", "m3");
-      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"MB_error","Mass balance error","m3");
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"stage",    "stage",  "m",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"inflow",   "inflow", "m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"outflow",  "outflow","m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"precip_m3","precip", "m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"evap",     "evap",   "m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"seepage",  "seepage","m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"volume",   "volume", "m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"losses",   "losses", "m3",chunk,dfl);
+      varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"MB_error","Mass balance error","m3",chunk,dfl);
       //varid= NetCDFAddMetadata2D(_RESMB_ncid,time_dimid,nbasins_dimid,"constraint","constraint","");
 
       //NetCDF DOES NOT Report control structure outflow details (see .csv)
@@ -2093,6 +2203,15 @@ void CModel::WriteNetcdfStandardHeaders(const optStruct &Options)
     if (nSim>0){
       WriteNetCDFBasinList(_RESMB_ncid,varid_bsim,this,true,Options);
     }
+
+    // (b) create buffered writer (order of variables used in WriteNetcdfMinorOutput)
+    _pRESMB_ncbuf=new CNetCDFOutputBuffer(_RESMB_ncid,chunk);
+    _pRESMB_ncbuf->AddVariable("time");
+    _pRESMB_ncbuf->AddVariable("precip");
+    if (nSim>0){
+      const string resMB_names[9]={"stage","inflow","outflow","evap","seepage","volume","MB_error","losses","precip_m3"};
+      for (int i=0;i<9;i++){_pRESMB_ncbuf->AddVariable(resMB_names[i]);}
+    }
   }
 #endif   // end compilation if NetCDF library is available
 }
@@ -2113,11 +2232,11 @@ void  CModel::WriteEnsimMinorOutput (const optStruct &Options,
   int i;
   int iCumPrecip=GetStateVarIndex(ATMOS_PRECIP);
 
-  double snowfall      =GetAverageSnowfall();
-  double precip        =GetAveragePrecip();
-  double channel_stor  =GetTotalChannelStorage();
-  double reservoir_stor=GetTotalReservoirStorage();
-  double rivulet_stor  =GetTotalRivuletStorage();
+  double snowfall      =_WshedAgg.snowfall;
+  double precip        =_WshedAgg.precip;
+  double channel_stor  =_WshedAgg.channel_stor;
+  double reservoir_stor=_WshedAgg.reservoir_stor;
+  double rivulet_stor  =_WshedAgg.rivulet_stor;
 
   if ((tt.model_time==0) && (Options.suppressICs==true) && (Options.period_ending)){return;}
 
@@ -2134,7 +2253,7 @@ void  CModel::WriteEnsimMinorOutput (const optStruct &Options,
     currentWater=0.0;
     for (i=0;i<GetNumStateVars();i++){
       if ((CStateVariable::IsWaterStorage(_aStateVarType[i])) &&  (i!=iCumPrecip)){
-	      S=GetAvgStateVar(i);_STORAGE<<" "<<FormatDouble(S);currentWater+=S;
+	      S=_WshedAgg.aAvgStateVar[i];_STORAGE<<" "<<FormatDouble(S);currentWater+=S;
       }
     }
     currentWater+=channel_stor+rivulet_stor;
@@ -2156,7 +2275,7 @@ void  CModel::WriteEnsimMinorOutput (const optStruct &Options,
   //Write hydrographs for gauged watersheds (ALWAYS DONE) (Hydrographs.tb0)
   if (Options.ave_hydrograph)
   {
-    if(tt.model_time!=0) { _HYDRO<<" "<<GetAveragePrecip(); }
+    if(tt.model_time!=0) { _HYDRO<<" "<<_WshedAgg.precip; }
     else                 { _HYDRO<<" 0.0"; }
     for (int p=0;p<_nSubBasins;p++){
       if (_pSubBasins[p]->IsGauged()  && (_pSubBasins[p]->IsEnabled()))
@@ -2168,7 +2287,7 @@ void  CModel::WriteEnsimMinorOutput (const optStruct &Options,
   }
   else
   {
-    if (tt.model_time!=0){_HYDRO<<" "<<GetAveragePrecip();}
+    if (tt.model_time!=0){_HYDRO<<" "<<_WshedAgg.precip;}
     else                 {_HYDRO<<" 0.0";}
     for (int p=0;p<_nSubBasins;p++){
       if (_pSubBasins[p]->IsGauged() && (_pSubBasins[p]->IsEnabled()))
@@ -2191,202 +2310,84 @@ void  CModel::WriteNetcdfMinorOutput ( const optStruct   &Options,
 {
 #ifdef _RVNETCDF_
 
-  int    retval;                // error value for NetCDF routines
-  int    time_id;               // variable id in NetCDF for time
-  size_t time_index[1], count1[1];  // determines where and how much will be written to NetCDF; 1D variable (pre, time)
-  size_t start2[2], count2[2];  // determines where and how much will be written to NetCDF; 2D variable (qsim, qobs, qin)
-  double current_time[1];       // current time in hours since start time
-  double current_prec[1];       // precipitation of current time step
-  size_t time_ind2;
-  current_time[0] = tt.model_time*HR_PER_DAY;
-  current_time[0]=RoundToNearestMinute(current_time[0]);
+  CNetCDFOutputBuffer *pBuf;    // buffered writer of current file (variable order set in WriteNetcdfStandardHeaders)
+  size_t time_ind;              // element of NetCDF array that will be written
+  double current_time;          // current time in hours since start time
+  double current_prec;          // precipitation of current time step
+  double val;
+  int    v,iSim;
 
-  time_index [0] = int(rvn_round(tt.model_time/Options.timestep));   // element of NetCDF array that will be written
-  time_ind2       =int(rvn_round(tt.model_time/Options.timestep));
-  count1[0] = 1;                                                 // writes exactly one time step
+  current_time=tt.model_time*HR_PER_DAY;
+  current_time=RoundToNearestMinute(current_time);
+  time_ind    =int(rvn_round(tt.model_time/Options.timestep));
+
+  current_prec = NETCDF_BLANK_VALUE; // was originally '---'
+  if(tt.model_time != 0.0) { current_prec = _WshedAgg.precip; } //watershed-wide precip
 
   //====================================================================
   //  Hydrographs.nc
   //====================================================================
-  int    precip_id;             // variable id in NetCDF for precipitation
-  int    qsim_id;               // variable id in NetCDF for simulated outflow
-  int    qobs_id;               // variable id in NetCDF for observed outflow
-  int    qin_id;                // variable id in NetCDF for observed inflow
-
-  // (a) count how many values need to be written for q_obs, q_sim, q_in
-  int iSim, nSim; // current and total # of sub-basins with simulated outflows
-  nSim = 0;
-  for (int p=0;p<_nSubBasins;p++){
-    if (_pSubBasins[p]->IsGauged()  && (_pSubBasins[p]->IsEnabled())){nSim++;}
-  }
+  // variables: time, precip, q_sim, q_obs, q_in, [q_loc]
+  pBuf=_pHYDRO_ncbuf;
+  pBuf->StartTimeStep(time_ind);
+  pBuf->SetValue(0,current_time);
+  pBuf->SetValue(1,current_prec);
 
-  // (b) allocate memory if necessary
-  double *outflow_obs=NULL;   // q_obs
-  double *outflow_sim=NULL;   // q_sim
-  double *inflow_obs =NULL;   // q_in
-  double *outflow_loc=NULL;   // q_loc
-  if(nSim>0){
-    outflow_sim=new double[nSim];
-    outflow_obs=new double[nSim];
-    inflow_obs =new double[nSim];
-    outflow_loc=new double[nSim];
-  }
-
-  // (c) obtain data
   iSim = 0;
-  current_prec[0] = NETCDF_BLANK_VALUE;
-  if (Options.ave_hydrograph)
+  for (int p=0;p<_nSubBasins;p++)
   {
-    if(tt.model_time != 0.0) { current_prec[0] = GetAveragePrecip(); } //watershed-wide precip
-    else                     { current_prec[0] = NETCDF_BLANK_VALUE; } // was originally '---'
-    for (int p=0;p<_nSubBasins;p++)
+    CSubBasin *pSB=_pSubBasins[p];
+    if (pSB->IsGauged() && (pSB->IsEnabled()))
     {
-      if (_pSubBasins[p]->IsGauged() && (_pSubBasins[p]->IsEnabled())){
-        outflow_sim[iSim] = _pSubBasins[p]->GetIntegratedOutflow(Options.timestep)/(Options.timestep*SEC_PER_DAY);
-        outflow_obs[iSim] = NETCDF_BLANK_VALUE;
-        for (int i = 0; i < _nObservedTS; i++){
-          if (IsContinuousFlowObs(_pObservedTS[i],_pSubBasins[p]->GetID()))
-          {
-            double val = _pObservedTS[i]->GetAvgValue(tt.model_time,Options.timestep); //time shift handled in CTimeSeries::Parse
-            if ((val != RAV_BLANK_DATA) && (tt.model_time>0)){ outflow_obs[iSim] = val;    }
-          }
-        }
-        outflow_loc[iSim] =_pSubBasins[p]->GetIntegratedLocalOutflow(Options.timestep)/(Options.timestep*SEC_PER_DAY);
-
-        inflow_obs[iSim] =NETCDF_BLANK_VALUE;
-        if (_pSubBasins[p]->GetReservoir() != NULL){
-          inflow_obs[iSim] = _pSubBasins[p]->GetIntegratedReservoirInflow(Options.timestep)/(Options.timestep*SEC_PER_DAY);
-        }
-        iSim++;
+      if (Options.ave_hydrograph){
+        pBuf->SetValue(2,iSim,pSB->GetIntegratedOutflow(Options.timestep)/(Options.timestep*SEC_PER_DAY));
       }
-    }
-  }
-  else {  // point-value hydrograph
-    if (tt.model_time != 0.0){current_prec[0] = GetAveragePrecip();} //watershed-wide precip
-    else                     {current_prec[0] = NETCDF_BLANK_VALUE;} // was originally '---'
-    for (int p=0;p<_nSubBasins;p++)
-    {
-      if (_pSubBasins[p]->IsGauged() && (_pSubBasins[p]->IsEnabled())){
-        outflow_sim[iSim] = _pSubBasins[p]->GetOutflowRate();
-        outflow_obs[iSim] = NETCDF_BLANK_VALUE;
-        for (int i = 0; i < _nObservedTS; i++){
-          if (IsContinuousFlowObs(_pObservedTS[i],_pSubBasins[p]->GetID()))
-          {
-            double val = _pObservedTS[i]->GetAvgValue(tt.model_time,Options.timestep);
-            if ((val != RAV_BLANK_DATA) && (tt.model_time>0)){ outflow_obs[iSim] = val;    }
-          }
-        }
-        outflow_loc[iSim] =_pSubBasins[p]->GetLocalOutflowRate();
-
-        inflow_obs[iSim] =NETCDF_BLANK_VALUE;
-        if (_pSubBasins[p]->GetReservoir() != NULL){
-          inflow_obs[iSim] = _pSubBasins[p]->GetReservoirInflow();
-        }
-        iSim++;
+      else { // point-value hydrograph
+        pBuf->SetValue(2,iSim,pSB->GetOutflowRate());
       }
+      if ((_aHydroObsIndex[iSim]!=DOESNT_EXIST) && (tt.model_time>0))
+      {
+        val = _pObservedTS[_aHydroObsIndex[iSim]]->GetAvgValue(tt.model_time,Options.timestep); //time shift handled in CTimeSeries::Parse
+        if (val != RAV_BLANK_DATA){ pBuf->SetValue(3,iSim,val); }
+      }
+      if (pSB->GetReservoir() != NULL){
+        if (Options.ave_hydrograph){pBuf->SetValue(4,iSim,pSB->GetIntegratedReservoirInflow(Options.timestep)/(Options.timestep*SEC_PER_DAY));}
+        else                       {pBuf->SetValue(4,iSim,pSB->GetReservoirInflow());}
+      }
+      if (Options.write_localflow){
+        if (Options.ave_hydrograph){pBuf->SetValue(5,iSim,pSB->GetIntegratedLocalOutflow(Options.timestep)/(Options.timestep*SEC_PER_DAY));}
+        else                       {pBuf->SetValue(5,iSim,pSB->GetLocalOutflowRate());}
+      }
+      iSim++;
     }
   }
 
-  // write new time step
-  retval = nc_inq_varid      (_HYDRO_ncid, "time",   &time_id);                            HandleNetCDFErrors(retval);
-  retval = nc_put_vara_double(_HYDRO_ncid, time_id, time_index, count1, &current_time[0]); HandleNetCDFErrors(retval);
-
-  // write precipitation values
-  retval = nc_inq_varid      (_HYDRO_ncid, "precip", &precip_id);                          HandleNetCDFErrors(retval);
-  retval = nc_put_vara_double(_HYDRO_ncid,precip_id,time_index,count1,&current_prec[0]);   HandleNetCDFErrors(retval);
-
-  // write simulated outflow/obs outflow/obs inflow values
-  if (nSim > 0){
-    start2[0] = int(rvn_round(tt.model_time/Options.timestep)); // element of NetCDF array that will be written
-    start2[1] = 0;                                              // element of NetCDF array that will be written
-    count2[0] = 1;      // writes exactly one time step
-    count2[1] = nSim;   // writes exactly nSim elements
-    retval = nc_inq_varid (_HYDRO_ncid, "q_sim", &qsim_id);                             HandleNetCDFErrors(retval);
-    retval = nc_inq_varid (_HYDRO_ncid, "q_obs", &qobs_id);                             HandleNetCDFErrors(retval);
-    retval = nc_inq_varid (_HYDRO_ncid, "q_in",  &qin_id);                              HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_HYDRO_ncid, qsim_id, start2, count2, &outflow_sim[0]); HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_HYDRO_ncid, qobs_id, start2, count2, &outflow_obs[0]); HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_HYDRO_ncid, qin_id,  start2, count2, &inflow_obs[0]);  HandleNetCDFErrors(retval);
-    if (Options.write_localflow){
-      int qloc_id;
-      retval = nc_inq_varid (_HYDRO_ncid, "q_loc",  &qloc_id);                            HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_HYDRO_ncid, qloc_id, start2, count2, &outflow_loc[0]); HandleNetCDFErrors(retval);
-    }
-  }
-
-  delete[] outflow_obs;
-  delete[] outflow_sim;
-  delete[] inflow_obs;
-  delete[] outflow_loc;
-
   //====================================================================
   //  ReservoirStages.nc
   //====================================================================
   if(Options.write_reservoir)
   {
-    int    precip_id;             // variable id in NetCDF for precipitation
-    int    hsim_id;               // variable id in NetCDF for simulated stage
-    int    hobs_id;               // variable id in NetCDF for observed stage
-
-    // (a) count how many values need to be written for h_obs, h_sim
-    int iSim,nSim; // current and total # of sub-basins with simulated stages
-    nSim = 0;
-    for(int p=0;p<_nSubBasins;p++) {
-      if(_pSubBasins[p]->IsGauged()  && (_pSubBasins[p]->IsEnabled()) && (_pSubBasins[p]->GetReservoir()!=NULL)) { nSim++; }
-    }
-
-    // (b) allocate memory if necessary
-    double* stage_obs=NULL;   // h_obs
-    double* stage_sim=NULL;   // h_sim
-    if(nSim>0) {
-      stage_sim=new double[nSim];
-      stage_obs=new double[nSim];
-    }
+    // variables: time, precip, h_sim, h_obs
+    pBuf=_pRESSTAGE_ncbuf;
+    pBuf->StartTimeStep(time_ind);
+    pBuf->SetValue(0,current_time);
+    pBuf->SetValue(1,current_prec);
 
-    // (c) obtain data
     iSim = 0;
-    current_prec[0] = NETCDF_BLANK_VALUE;
-    if(tt.model_time != 0.0) { current_prec[0] = GetAveragePrecip(); } //watershed-wide precip
-
     for(int p=0;p<_nSubBasins;p++)
     {
-      if(_pSubBasins[p]->IsGauged() && (_pSubBasins[p]->IsEnabled()) && (_pSubBasins[p]->GetReservoir()!=NULL))
+      CSubBasin *pSB=_pSubBasins[p];
+      if(pSB->IsGauged() && (pSB->IsEnabled()) && (pSB->GetReservoir()!=NULL))
       {
-        stage_sim[iSim] = _pSubBasins[p]->GetReservoir()->GetResStage();
-        stage_obs[iSim] = NETCDF_BLANK_VALUE;
-        for(int i = 0; i < _nObservedTS; i++) {
-          if(IsContinuousStageObs(_pObservedTS[i],_pSubBasins[p]->GetID()))
-          {
-            double val = _pObservedTS[i]->GetAvgValue(tt.model_time,Options.timestep); //time shift handled in CTimeSeries::Parse
-            if((val != RAV_BLANK_DATA) && (tt.model_time>0)) { stage_obs[iSim] = val; }
-          }
+        pBuf->SetValue(2,iSim,pSB->GetReservoir()->GetResStage());
+        if((_aStageObsIndex[iSim]!=DOESNT_EXIST) && (tt.model_time>0))
+        {
+          val = _pObservedTS[_aStageObsIndex[iSim]]->GetAvgValue(tt.model_time,Options.timestep); //time shift handled in CTimeSeries::Parse
+          if(val != RAV_BLANK_DATA) { pBuf->SetValue(3,iSim,val); }
         }
         iSim++;
       }
     }
-
-    // write new time step
-    retval = nc_inq_varid      (_RESSTAGE_ncid,"time",&time_id);                              HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_RESSTAGE_ncid,time_id,time_index,count1,&current_time[0]);   HandleNetCDFErrors(retval);
-
-    // write precipitation values
-    retval = nc_inq_varid      (_RESSTAGE_ncid,"precip",&precip_id);                          HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_RESSTAGE_ncid,precip_id,time_index,count1,&current_prec[0]); HandleNetCDFErrors(retval);
-
-    // write simulated stage/obs stage values
-    if(nSim > 0) {
-      start2[0] = int(rvn_round(tt.model_time/Options.timestep)); // element of NetCDF array that will be written
-      start2[1] = 0;                                              // element of NetCDF array that will be written
-      count2[0] = 1;      // writes exactly one time step
-      count2[1] = nSim;   // writes exactly nSim elements
-      retval = nc_inq_varid(_RESSTAGE_ncid,"h_sim",&hsim_id);                          HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESSTAGE_ncid,"h_obs",&hobs_id);                          HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESSTAGE_ncid,hsim_id,start2,count2,&stage_sim[0]); HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESSTAGE_ncid,hobs_id,start2,count2,&stage_obs[0]); HandleNetCDFErrors(retval);
-    }
-
-    delete[] stage_obs;
-    delete[] stage_sim;
   }
 
   //====================================================================
@@ -2394,36 +2395,37 @@ void  CModel::WriteNetcdfMinorOutput ( const optStruct   &Options,
   //====================================================================
   if (Options.write_watershed_storage)
   {
-    double snowfall      =GetAverageSnowfall();
-    double precip        =GetAveragePrecip();
-    double channel_stor  =GetTotalChannelStorage();
-    double reservoir_stor=GetTotalReservoirStorage();
-    double rivulet_stor  =GetTotalRivuletStorage();
+    double snowfall      =_WshedAgg.snowfall;
+    double precip        =_WshedAgg.precip;
+    double channel_stor  =_WshedAgg.channel_stor;
+    double reservoir_stor=_WshedAgg.reservoir_stor;
+    double rivulet_stor  =_WshedAgg.rivulet_stor;
 
-    // write new time step
-    retval = nc_inq_varid (_STORAGE_ncid, "time",   &time_id);                                 HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_STORAGE_ncid, time_id, time_index, count1, &current_time[0]); HandleNetCDFErrors(retval);
+    // variables: time, rainfall, snowfall, channel_storage, reservoir_storage, rivulet_storage, [water storage state vars], total, cum_input, cum_outflow, MB_error
+    pBuf=_pSTORAGE_ncbuf;
+    pBuf->StartTimeStep(time_ind);
+    pBuf->SetValue(0,current_time);
 
     if(tt.model_time!=0){
-      AddSingleValueToNetCDF(_STORAGE_ncid,"rainfall"       ,time_ind2,precip-snowfall);
-      AddSingleValueToNetCDF(_STORAGE_ncid,"snowfall"       ,time_ind2,snowfall);
+      pBuf->SetValue(1,precip-snowfall);
+      pBuf->SetValue(2,snowfall);
     }
-    AddSingleValueToNetCDF(_STORAGE_ncid,"channel_storage"  ,time_ind2,channel_stor);
-    AddSingleValueToNetCDF(_STORAGE_ncid,"reservoir_storage",time_ind2,reservoir_stor);
-    AddSingleValueToNetCDF(_STORAGE_ncid,"rivulet_storage"  ,time_ind2,rivulet_stor);
+    pBuf->SetValue(3,channel_stor);
+    pBuf->SetValue(4,reservoir_stor);
+    pBuf->SetValue(5,rivulet_stor);
 
+    v=6;
     double currentWater=0.0;
-    double S;string short_name;
+    double S;
     int iAtmPrecip=GetStateVarIndex(ATMOS_PRECIP);
     for (int i=0;i<GetNumStateVars();i++)
     {
       if ((CStateVariable::IsWaterStorage(_aStateVarType[i])) && (i!=iAtmPrecip))
-	  {
-	    S=FormatDouble(GetAvgStateVar(i));
-	    short_name=CStateVariable::GetStateVarLongName(_aStateVarType[i],_aStateVarLayer[i]);
-	    AddSingleValueToNetCDF(_STORAGE_ncid, short_name.c_str(),time_ind2,S);
-	    currentWater+=S;
-	  }
+      {
+        S=FormatDouble(_WshedAgg.aAvgStateVar[i]);
+        pBuf->SetValue(v,S); v++;
+        currentWater+=S;
+      }
     }
 
     currentWater+=channel_stor+rivulet_stor+reservoir_stor;
@@ -2431,16 +2433,16 @@ void  CModel::WriteNetcdfMinorOutput ( const optStruct   &Options,
       // \todo [fix]: this fixes a mass balance bug in reservoir simulations, but there is certainly a more proper way to do it
       // JRC: I think somehow this is being double counted in the delta V calculations in the first timestep
       for(int p=0;p<_nSubBasins;p++){
-	      if(_pSubBasins[p]->GetReservoir()!=NULL){
-	        currentWater+=_pSubBasins[p]->GetIntegratedReservoirInflow(Options.timestep)/2.0/_WatershedArea*MM_PER_METER/M2_PER_KM2;
-	        currentWater-=_pSubBasins[p]->GetIntegratedOutflow        (Options.timestep)/2.0/_WatershedArea*MM_PER_METER/M2_PER_KM2;
-	      }
+        if(_pSubBasins[p]->GetReservoir()!=NULL){
+          currentWater+=_pSubBasins[p]->GetIntegratedReservoirInflow(Options.timestep)/2.0/_WatershedArea*MM_PER_METER/M2_PER_KM2;
+          currentWater-=_pSubBasins[p]->GetIntegratedOutflow        (Options.timestep)/2.0/_WatershedArea*MM_PER_METER/M2_PER_KM2;
+        }
       }
     }
-    AddSingleValueToNetCDF(_STORAGE_ncid,"total"        ,time_ind2,currentWater);
-    AddSingleValueToNetCDF(_STORAGE_ncid,"cum_input"    ,time_ind2,_CumulInput);
-    AddSingleValueToNetCDF(_STORAGE_ncid,"cum_outflow"  ,time_ind2,_CumulOutput);
-    AddSingleValueToNetCDF(_STORAGE_ncid,"MB_error"     ,time_ind2,FormatDouble((currentWater-_initWater)+(_CumulOutput-_CumulInput)));
+    pBuf->SetValue(v  ,currentWater);
+    pBuf->SetValue(v+1,_CumulInput);
+    pBuf->SetValue(v+2,_CumulOutput);
+    pBuf->SetValue(v+3,FormatDouble((currentWater-_initWater)+(_CumulOutput-_CumulInput)));
   }
 
   //====================================================================
@@ -2452,31 +2454,28 @@ void  CModel::WriteNetcdfMinorOutput ( const optStruct   &Options,
     force_struct faveStruct = GetAverageForcings();
     pFave = &faveStruct;
 
-    // write new time step
-    retval = nc_inq_varid      (_FORCINGS_ncid, "time",   &time_id);                            HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_FORCINGS_ncid, time_id, time_index, count1, &current_time[0]); HandleNetCDFErrors(retval);
-
-    // write data
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"rainfall"         ,time_ind2,pFave->precip*(1.0-pFave->snow_frac));
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"snowfall"         ,time_ind2,pFave->precip*(    pFave->snow_frac));
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"temp"             ,time_ind2,pFave->temp_ave);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"temp_daily_min"   ,time_ind2,pFave->temp_daily_min);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"temp_daily_max"   ,time_ind2,pFave->temp_daily_max);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"temp_daily_ave"   ,time_ind2,pFave->temp_daily_ave);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"air_density"      ,time_ind2,pFave->air_dens);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"air_pressure"     ,time_ind2,pFave->air_pres);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"relative_humidity",time_ind2,pFave->rel_humidity);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"cloud_cover"      ,time_ind2,pFave->cloud_cover);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"ET_radiation"     ,time_ind2,pFave->ET_radia);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"SW_radiation"     ,time_ind2,pFave->SW_radia);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"net_SW_radiation" ,time_ind2,pFave->SW_radia_net);
-    //AddSingleValueToNetCDF(_FORCINGS_ncid,"SW_radia_subcan"  ,time_ind2,pFave->SW_rad_subcanopy);
-    //AddSingleValueToNetCDF(_FORCINGS_ncid,"LW_incoming"      ,time_ind2,pFave->LW_incoming);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"LW_radiation"     ,time_ind2,pFave->cloud_cover);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"wind_velocity"    ,time_ind2,pFave->wind_vel);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"PET"              ,time_ind2,pFave->PET);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"OW_PET"           ,time_ind2,pFave->OW_PET);
-    AddSingleValueToNetCDF(_FORCINGS_ncid,"potential_melt"   ,time_ind2,pFave->potential_melt);
+    // variables: time, then forcings in order of definition in WriteNetcdfStandardHeaders
+    pBuf=_pFORCINGS_ncbuf;
+    pBuf->StartTimeStep(time_ind);
+    pBuf->SetValue( 0,current_time);
+    pBuf->SetValue( 1,pFave->precip*(1.0-pFave->snow_frac)); //rainfall
+    pBuf->SetValue( 2,pFave->precip*(    pFave->snow_frac)); //snowfall
+    pBuf->SetValue( 3,pFave->temp_ave);
+    pBuf->SetValue( 4,pFave->temp_daily_min);
+    pBuf->SetValue( 5,pFave->temp_daily_max);
+    pBuf->SetValue( 6,pFave->temp_daily_ave);
+    pBuf->SetValue( 7,pFave->air_dens);
+    pBuf->SetValue( 8,pFave->air_pres);
+    pBuf->SetValue( 9,pFave->rel_humidity);
+    pBuf->SetValue(10,pFave->cloud_cover);
+    pBuf->SetValue(11,pFave->ET_radia);
+    pBuf->SetValue(12,pFave->SW_radia);
+    pBuf->SetValue(13,pFave->SW_radia_net);
+    pBuf->SetValue(14,pFave->cloud_cover); //LW_radiation
+    pBuf->SetValue(15,pFave->wind_vel);
+    pBuf->SetValue(16,pFave->PET);
+    pBuf->SetValue(17,pFave->OW_PET);
+    pBuf->SetValue(18,pFave->potential_melt);
   }
 
   //====================================================================
@@ -2484,110 +2483,40 @@ void  CModel::WriteNetcdfMinorOutput ( const optStruct   &Options,
   //====================================================================
   if(Options.write_reservoirMB)
   {
+    // variables: time, precip, stage, inflow, outflow, evap, seepage, volume, MB_error, losses, precip_m3
+    pBuf=_pRESMB_ncbuf;
+    pBuf->StartTimeStep(time_ind);
+    pBuf->SetValue(0,current_time);
+    pBuf->SetValue(1,current_prec);
 
-    int    this_id;
-
-    // (a) count how many values need to be written
-    int iSim,nSim; // current and total # of sub-basins with simulated stages
-    nSim = 0;
-    for(int p=0;p<_nSubBasins;p++) {
-      if(_pSubBasins[p]->IsGauged()  && (_pSubBasins[p]->IsEnabled()) && (_pSubBasins[p]->GetReservoir()!=NULL)) { nSim++; }
-    }
-
-    // (b) allocate memory if necessary
-    double* stage=NULL;
-    double* inflow=NULL;
-    double* outflow=NULL;
-    double* evap=NULL;
-    double* seepage=NULL;
-    double *stor=NULL;
-    double* MBerr=NULL;
-    double* losses=NULL;
-    double* precip=NULL;
-    if(nSim>0) {
-      stage  =new double [nSim];
-      inflow =new double [nSim];
-      outflow=new double [nSim];
-      evap   =new double [nSim];
-      seepage=new double [nSim];
-      stor   =new double [nSim];
-      MBerr  =new double [nSim];
-      losses =new double [nSim];
-      precip =new double [nSim];
-    }
-
-    // (c) obtain data
+    double inflow,outflow,losses,precip,stor,oldstor;
     iSim = 0;
-    current_prec[0] = NETCDF_BLANK_VALUE;
-    if(tt.model_time != 0.0) { current_prec[0] = GetAveragePrecip(); } //watershed-wide precip
-    double oldstor;
     for(int p=0;p<_nSubBasins;p++)
     {
       CSubBasin *pSB=_pSubBasins[p];
       if(pSB->IsGauged() && (pSB->IsEnabled()) && (pSB->GetReservoir()!=NULL))
       {
-        stage  [iSim]=pSB->GetReservoir()->GetResStage();
-        inflow [iSim]=pSB->GetIntegratedReservoirInflow(Options.timestep);//m3
-        outflow[iSim]=pSB->GetIntegratedOutflow        (Options.timestep);//m3
-        evap   [iSim]=pSB->GetReservoir()->GetReservoirEvapLosses (Options.timestep);//m3
-        seepage[iSim]=pSB->GetReservoir()->GetReservoirGWLosses   (Options.timestep);//m3
-        stor   [iSim]=pSB->GetReservoir()->GetStorage             ();//m3
-        oldstor      =pSB->GetReservoir()->GetOldStorage          ();//m3
-        losses [iSim]=pSB->GetReservoir()->GetReservoirLosses     (Options.timestep);//m3 = GW+ET
-        precip [iSim]=pSB->GetReservoir()->GetReservoirPrecipGains(Options.timestep);//m3
-        MBerr  [iSim]=inflow[iSim]-outflow[iSim]-losses[iSim]+precip[iSim]-(stor[iSim]-oldstor);
-        //constraint_str[iSim]=pSB->GetReservoir()->GetCurrentConstraint   ();
-        if(tt.model_time==0.0){ inflow[iSim]=0.0; }
-
+        inflow =pSB->GetIntegratedReservoirInflow(Options.timestep);//m3
+        outflow=pSB->GetIntegratedOutflow        (Options.timestep);//m3
+        stor   =pSB->GetReservoir()->GetStorage             ();//m3
+        oldstor=pSB->GetReservoir()->GetOldStorage          ();//m3
+        losses =pSB->GetReservoir()->GetReservoirLosses     (Options.timestep);//m3 = GW+ET
+        precip =pSB->GetReservoir()->GetReservoirPrecipGains(Options.timestep);//m3
+
+        pBuf->SetValue( 2,iSim,pSB->GetReservoir()->GetResStage());
+        pBuf->SetValue( 4,iSim,outflow);
+        pBuf->SetValue( 5,iSim,pSB->GetReservoir()->GetReservoirEvapLosses(Options.timestep));//m3
+        pBuf->SetValue( 6,iSim,pSB->GetReservoir()->GetReservoirGWLosses  (Options.timestep));//m3
+        pBuf->SetValue( 7,iSim,stor);
+        pBuf->SetValue( 8,iSim,inflow-outflow-losses+precip-(stor-oldstor));
+        pBuf->SetValue( 9,iSim,losses);
+        pBuf->SetValue(10,iSim,precip);
+        if(tt.model_time==0.0){ inflow=0.0; }
+        pBuf->SetValue( 3,iSim,inflow);
 
         iSim++;
       }
     }
-
-    // write new time step
-    retval = nc_inq_varid      (_RESMB_ncid,"time",&time_id);                              HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_RESMB_ncid,time_id,time_index,count1,&current_time[0]);   HandleNetCDFErrors(retval);
-
-    // write precipitation values
-    retval = nc_inq_varid      (_RESMB_ncid,"precip",&this_id);                          HandleNetCDFErrors(retval);
-    retval = nc_put_vara_double(_RESMB_ncid,this_id,time_index,count1,&current_prec[0]); HandleNetCDFErrors(retval);
-
-    // write simulated stage/obs stage values
-    if(nSim > 0) {
-      start2[0] = int(rvn_round(tt.model_time/Options.timestep)); // element of NetCDF array that will be written
-      start2[1] = 0;                                              // element of NetCDF array that will be written
-      count2[0] = 1;      // writes exactly one time step
-      count2[1] = nSim;   // writes exactly nSim elements
-      retval = nc_inq_varid(_RESMB_ncid,"stage",&this_id);                          HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&stage[0]);     HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"inflow",&this_id);                         HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&inflow[0]);    HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"outflow",&this_id);                        HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&outflow[0]);   HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"evap",&this_id);                           HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&evap[0]);      HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"seepage",&this_id);                        HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&seepage[0]);   HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"volume",&this_id);                         HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&stor[0]);      HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"MB_error",&this_id);                          HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&MBerr[0]);     HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"losses",&this_id);                         HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&losses[0]);    HandleNetCDFErrors(retval);
-      retval = nc_inq_varid(_RESMB_ncid,"precip_m3",&this_id);                      HandleNetCDFErrors(retval);
-      retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&precip[0]);    HandleNetCDFErrors(retval);
-      //retval = nc_inq_varid(_RESMB_ncid,"constraint",&this_id);                      HandleNetCDFErrors(retval);
-      //retval = nc_put_vara_double(_RESMB_ncid,this_id,start2,count2,&constraint[0]); HandleNetCDFErrors(retval);
-    }
-    delete [] stage;
-    delete [] inflow;
-    delete [] outflow;
-    delete [] evap;
-    delete [] seepage;
-    delete [] stor;
-    delete [] MBerr;
-    delete [] losses;
-    delete [] precip;
   }
 #endif
 }
@@ -2676,6 +2605,32 @@ string CorrectForRelativePath(const string filename,const string relfile)
   return filename;
 }
 
+#ifdef _RVNETCDF_
+//////////////////////////////////////////////////////////////////
+/// \brief sets chunked storage and (optional) compression of a time-indexed NetCDF output variable
+/// \details chunks span chunk_time time steps (one flush of the output buffer) and the full second dimension, if any,
+/// so that each buffered write covers whole chunks
+/// \param fileid [in] NetCDF output file id (in define mode)
+/// \param varid [in] variable id
+/// \param ndims [in] number of dimensions, 1 (time) or 2 (time,nbasins)
+/// \param *dimids [in] dimension ids [size: ndims]
+/// \param chunk_time [in] chunk length along time dimension (0: library default storage)
+/// \param deflate_level [in] deflate level, 0-9 (0: uncompressed)
+//
+void NetCDFDefineStorage(const int fileid,const int varid,const int ndims,const int *dimids,const int chunk_time,const int deflate_level)
+{
+  int    retval;
+  size_t chunks[2];
+  if (chunk_time>0){
+    chunks[0]=chunk_time;
+    if (ndims==2){retval = nc_inq_dimlen(fileid,dimids[1],&chunks[1]);   HandleNetCDFErrors(retval);}
+    retval = nc_def_var_chunking(fileid,varid,NC_CHUNKED,chunks);         HandleNetCDFErrors(retval);
+  }
+  if (deflate_level>0){
+    retval = nc_def_var_deflate(fileid,varid,NC_SHUFFLE,1,deflate_level); HandleNetCDFErrors(retval);
+  }
+}
+#endif
 //////////////////////////////////////////////////////////////////
 /// \brief adds metadata of attribute to NetCDF file
 /// \param fileid [in] NetCDF output file id
@@ -2683,8 +2638,10 @@ string CorrectForRelativePath(const string filename,const string relfile)
 /// \param shortname [in] attribute short name
 /// \param longname [in] attribute long name
 /// \param units [in] attribute units as string
+/// \param chunk_time [in] chunk length along time dimension (0: library default storage)
+/// \param deflate_level [in] deflate level, 0-9 (0: uncompressed)
 //
-int NetCDFAddMetadata(const int fileid,const int time_dimid,string shortname,string longname,string units)
+int NetCDFAddMetadata(const int fileid,const int time_dimid,string shortname,string longname,string units,const int chunk_time,const int deflate_level)
 {
  int varid(0);
 #ifdef _RVNETCDF_
@@ -2697,12 +2654,15 @@ int NetCDFAddMetadata(const int fileid,const int time_dimid,string shortname,str
 
   // (a) create variable precipitation
   retval = nc_def_var(fileid,shortname.c_str(),NC_DOUBLE,1,dimids,&varid); HandleNetCDFErrors(retval);
+  NetCDFDefineStorage(fileid,varid,1,dimids,chunk_time,deflate_level);
 
   // (b) add attributes to variable
   retval = nc_put_att_text  (fileid,varid,"units",units.length(),units.c_str());              HandleNetCDFErrors(retval);
   retval = nc_put_att_text  (fileid,varid,"long_name",longname.length(),longname.c_str());    HandleNetCDFErrors(retval);
   retval = nc_put_att_double(fileid,varid,"_FillValue",NC_DOUBLE,1,fill_val);                 HandleNetCDFErrors(retval);
   retval = nc_put_att_double(fileid,varid,"missing_value",NC_DOUBLE,1,miss_val);              HandleNetCDFErrors(retval);
+#else
+  (void)(chunk_time); (void)(deflate_level); //storage options only apply to NetCDF output
 #endif
   return varid;
 }
@@ -2714,8 +2674,10 @@ int NetCDFAddMetadata(const int fileid,const int time_dimid,string shortname,str
 /// \param shortname [in] attribute short name
 /// \param longname [in] attribute long name
 /// \param units [in] attribute units as string
+/// \param chunk_time [in] chunk length along time dimension (0: library default storage)
+/// \param deflate_level [in] deflate level, 0-9 (0: uncompressed)
 //
-int NetCDFAddMetadata2D(const int fileid,const int time_dimid,int nbasins_dimid,string shortname,string longname,string units)
+int NetCDFAddMetadata2D(const int fileid,const int time_dimid,int nbasins_dimid,string shortname,string longname,string units,const int chunk_time,const int deflate_level)
 {
   int    varid(0);
 #ifdef _RVNETCDF_
@@ -2731,6 +2693,7 @@ int NetCDFAddMetadata2D(const int fileid,const int time_dimid,int nbasins_dimid,
 
   // (a) create variable
   retval = nc_def_var(fileid,shortname.c_str(),NC_DOUBLE,2,dimids2,&varid); HandleNetCDFErrors(retval);
+  NetCDFDefineStorage(fileid,varid,2,dimids2,chunk_time,deflate_level);
 
   tmp = "basin_name";
 
@@ -2741,6 +2704,8 @@ int NetCDFAddMetadata2D(const int fileid,const int time_dimid,int nbasins_dimid,
   retval = nc_put_att_double(fileid,varid,"missing_value", NC_DOUBLE,1,      miss_val);         HandleNetCDFErrors(retval);
   retval = nc_put_att_text(  fileid,varid,"coordinates",   tmp.length(),     tmp.c_str());      HandleNetCDFErrors(retval);
 
+#else
+  (void)(chunk_time); (void)(deflate_level); //storage options only apply to NetCDF output
 #endif
   return varid;
 }
@@ -2829,31 +2794,41 @@ void WriteNetCDFBasinList(const int ncid,const int varid,const CModel* pModel,bo
 
 //JRC \todo[clean] - find a best place to put this. Might eventually require separate file?
 //////////////////////////////////////////////////////////////////
-/// \brief return calibration objective function
-/// \notes right now only supports hydrograph goodness of fit metrics at one subbasin
+/// \brief returns value of diagnostic j for observation time series i over diagnostic period d
+/// \details streamable diagnostics are evaluated from the terms accumulated by their diagnostic stream
+/// during simulation; all others are calculated by rescanning the modeled and observed time series
+/// \param d [in] diagnostic period index
+/// \param i [in] observation time series index
+/// \param j [in] diagnostic index
+/// \param &Options [in] global model options
+//
+double CModel::GetDiagnosticValue(const int d,const int i,const int j,const optStruct &Options) const
+{
+  if ((_pDiagStreams!=NULL) && (CDiagnosticStream::IsStreamable(_pDiagnostics[j]->GetType()))) {
+    return _pDiagStreams[d*_nObservedTS+i]->GetDiagnostic(j,_pObservedTS[i],_pModeledTS[i],Options);
+  }
+  return _pDiagnostics[j]->CalculateDiagnostic(_pModeledTS[i],_pObservedTS[i],_pObsWeightTS[i],
+                                               _pDiagPeriods[d]->GetStartTime(),_pDiagPeriods[d]->GetEndTime(),
+                                               _pDiagPeriods[d]->GetComparison(),_pDiagPeriods[d]->GetThreshold(),Options);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief finds diagnostic period, observation time series and diagnostic of calibration objective function
 /// \param &calib_SBID [in] target subbasin ID
 /// \param &calib_Obj [in] calibration objective diagnostics (e.g., NSE)
+/// \param calib_period [in] name of calibration diagnostic period
+/// \param &dd [out] diagnostic period index
+/// \param &ii [out] observation time series index
+/// \param &jj [out] diagnostic index
 //
-double CModel::GetObjFuncVal(long calib_SBID,diag_type calib_Obj, const string calib_period) const
+void CModel::FindObjFuncTarget(long calib_SBID,diag_type calib_Obj,const string calib_period,int &dd,int &ii,int &jj) const
 {
-  double starttime=0.0;
-  double endtime  =0.0;
-  comparison compare=COMPARE_GREATERTHAN;
-  double thresh=-ALMOST_INF;
-  double objval;
-  int ii=DOESNT_EXIST; // observation index
-  int jj=DOESNT_EXIST; // diagnostic measure
+  dd=DOESNT_EXIST; // diagnostic period
+  ii=DOESNT_EXIST; // observation index
+  jj=DOESNT_EXIST; // diagnostic measure
 
-  //- grab diagnostic information -----------------------------------
   for(int d=0;d<_nDiagPeriods;d++) {
-    if(_pDiagPeriods[d]->GetName()==calib_period) {
-      starttime=_pDiagPeriods[d]->GetStartTime();
-      endtime  =_pDiagPeriods[d]->GetEndTime();
-      compare  =_pDiagPeriods[d]->GetComparison();
-      thresh   =_pDiagPeriods[d]->GetThreshold();
-    }
+    if(_pDiagPeriods[d]->GetName()==calib_period) { dd=d; }
   }
-
   for(int i=0;i<_nObservedTS;i++)
   {
     if((_pObservedTS[i]->GetName()=="HYDROGRAPH") && (_pObservedTS[i]->GetLocID()==calib_SBID)) { ii=i; }
@@ -2863,10 +2838,26 @@ double CModel::GetObjFuncVal(long calib_SBID,diag_type calib_Obj, const string c
   }
   ExitGracefullyIf(ii==DOESNT_EXIST,"GetObjFuncVal: unable to find calibration target time series (hydrograph in basin :CalibrationSBID)",BAD_DATA);
   ExitGracefullyIf(jj==DOESNT_EXIST,"GetObjFuncVal: unable to find calibration target diagnostic ",BAD_DATA);
-  ExitGracefullyIf(endtime==0.0,    "GetObjFuncVal: unable to find calibration period with this name ",BAD_DATA);
+  ExitGracefullyIf(dd==DOESNT_EXIST,"GetObjFuncVal: unable to find calibration period with this name ",BAD_DATA);
+}
+
+//JRC \todo[clean] - find a best place to put this. Might eventually require separate file?
+//////////////////////////////////////////////////////////////////
+/// \brief return calibration objective function
+/// \notes right now only supports hydrograph goodness of fit metrics at one subbasin
+/// \param &calib_SBID [in] target subbasin ID
+/// \param &calib_Obj [in] calibration objective diagnostics (e.g., NSE)
+//
+double CModel::GetObjFuncVal(long calib_SBID,diag_type calib_Obj, const string calib_period) const
+{
+  double objval;
+  int dd,ii,jj;
+
+  //- grab diagnostic information -----------------------------------
+  FindObjFuncTarget(calib_SBID,calib_Obj,calib_period,dd,ii,jj);
 
   //- Calculate objective function -----------------------------------
-  objval=_pDiagnostics[jj]->CalculateDiagnostic(_pModeledTS[ii],_pObservedTS[ii],_pObsWeightTS[ii],starttime,endtime,compare,thresh,*_pOptStruct);
+  objval=GetDiagnosticValue(dd,ii,jj,*_pOptStruct);
 
   if((calib_Obj==DIAG_NASH_SUTCLIFFE) ||
      (calib_Obj==DIAG_KLING_GUPTA))
@@ -2875,3 +2866,26 @@ double CModel::GetObjFuncVal(long calib_SBID,diag_type calib_Obj, const string c
   }
   return objval;
 }
+//////////////////////////////////////////////////////////////////
+/// \brief returns lower bound on calibration objective function from the modeled values simulated so far
+/// \details available only for objectives which cannot improve as further observations are compared (e.g., NSE, RMSE),
+/// so that a simulation whose bound exceeds the best objective found so far may be terminated early
+/// \param &calib_SBID [in] target subbasin ID
+/// \param &calib_Obj [in] calibration objective diagnostics (e.g., NSE)
+/// \param calib_period [in] name of calibration diagnostic period
+/// \param &bound [out] lower bound on value returned by GetObjFuncVal() at end of simulation
+/// \return true if bound is available
+//
+bool CModel::GetObjFuncBound(long calib_SBID,diag_type calib_Obj,const string calib_period,double &bound) const
+{
+  int dd,ii,jj;
+  if(_pDiagStreams==NULL) { return false; }
+
+  FindObjFuncTarget(calib_SBID,calib_Obj,calib_period,dd,ii,jj);
+
+  if(!_pDiagStreams[dd*_nObservedTS+ii]->GetPartialBound(jj,bound)) { return false; }
+
+  if     (calib_Obj==DIAG_NASH_SUTCLIFFE) { bound*=-1; }
+  else if(calib_Obj==DIAG_NSE4)           { return false; } //not negated in objective function, partial value is an upper bound
+  return true;
+}
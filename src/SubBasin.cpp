@@ -116,8 +116,8 @@ CSubBasin::CSubBasin( const long           Identifier,
   _QirrLast=0.0;
 
   //Below are initialized in GenerateCatchmentHydrograph, GenerateRoutingHydrograph
-  _aQlatHist     =NULL;  _nQlatHist     =0;
-  _aQinHist      =NULL;  _nQinHist      =0;
+  _nQlatHist     =0;
+  _nQinHist      =0;
   _aUnitHydro    =NULL;
   _aRouteHydro   =NULL;
   _c_hist        =NULL;
@@ -153,8 +153,8 @@ CSubBasin::~CSubBasin()
   if (DESTRUCTOR_DEBUG){cout<<"  DELETING SUBBASIN"<<endl;}
   delete [] _pHydroUnits;_pHydroUnits=NULL; //just deletes pointer array, not hydrounits
   delete [] _aQout;      _aQout      =NULL;
-  delete [] _aQlatHist;  _aQlatHist  =NULL;
-  delete [] _aQinHist;   _aQinHist   =NULL;
+  _aQlatHist.Clear();
+  _aQinHist.Clear();
   delete [] _aUnitHydro; _aUnitHydro =NULL;
   delete [] _aRouteHydro;_aRouteHydro=NULL;
   delete [] _c_hist;     _c_hist     =NULL;
@@ -263,7 +263,7 @@ const double        *CSubBasin::GetRoutingHydrograph () const{return _aRouteHydr
 /// \brief returns historical inflow hydrograph as array pointer
 /// \return historical inflow hydrograph as array pointer
 //
-const double        *CSubBasin::GetInflowHistory     () const{return _aQinHist;}
+const double        *CSubBasin::GetInflowHistory     () const{return _aQinHist.Hist();}
 
 //////////////////////////////////////////////////////////////////
 /// \brief returns outflow array
@@ -927,32 +927,9 @@ bool CSubBasin::SetBasinProperties(const string label,
                                    const double &value)
 {
   string label_n = StringToUppercase(label);
-  if      (!label_n.compare("TIME_CONC"     ))  {_t_conc=value;}
-  else if (!label_n.compare("TIME_TO_PEAK"  ))  {_t_peak=value;}
-  else if (!label_n.compare("TIME_LAG"      ))  {_t_lag=value;}
-  else if (!label_n.compare("RES_CONSTANT"  ))  {_reservoir_constant=value;}
-  else if (!label_n.compare("NUM_RESERVOIRS"))  {_num_reservoirs=(int)(value);}
-  else if (!label_n.compare("GAMMA_SHAPE"   ))  {_gamma_shape=value;}
-  else if (!label_n.compare("GAMMA_SCALE"   ))  {_gamma_scale=value;}
-
-  else if (!label_n.compare("Q_REFERENCE"   ))  {_Q_ref=value;}
-  else if (!label_n.compare("MANNINGS_N"    ))  {_mannings_n=value;}
-  else if (!label_n.compare("SLOPE"         ))  {_slope=value;}
-  else if (!label_n.compare("DIFFUSIVITY"   ))  {_diffusivity=value; }
-  else if (!label_n.compare("CELERITY"      ))  {_c_ref=value; }
-
-  else if (!label_n.compare("RAIN_CORR"     ))  {_rain_corr=value;}
-  else if (!label_n.compare("SNOW_CORR"     ))  {_snow_corr=value;}
-  else if (!label_n.compare("TEMP_CORR"     ))  {_temperature_corr=value; }
-
+  if      (!label_n.compare("NUM_RESERVOIRS"))  {_num_reservoirs=(int)(value);}
   else if (!label_n.compare("REACH_HRU_ID"  ))  { _reach_HRUindex=(int)(value); }
-  else if (!label_n.compare("HYPORHEIC_FLUX"))  { _hyporheic_flux=value; }
-  else if (!label_n.compare("CONVECT_COEFF" ))  { _convect_coeff=value; }
-
-  else if (!label_n.compare("RIVERBED_CONDUCTIVITY")){ _bed_conductivity = value; }
-  else if (!label_n.compare("RIVERBED_THICKNESS"   )){ _bed_thickness = value; }
   else if (!label_n.compare("RESERVOIR_DISABLED"  )) { _res_disabled=(bool)(value); }
-  else if (!label_n.compare("CORR_REACH_LENGTH"   )) { _reach_length2=value; }
   else if (!label_n.compare("LAKEBED_CONDUCTIVITY")) {
     if (_pReservoir != NULL) {_pReservoir->SetLakebedConductivity(value); }
   }
@@ -966,10 +943,48 @@ bool CSubBasin::SetBasinProperties(const string label,
     if (_pReservoir != NULL) { _pReservoir->SetCrestWidth(value);}
   }
   else{
-    return false;//bad string
+    double *px=GetBasinPropertyAddress(label_n);
+    if (px==NULL){return false;}//bad string
+    *px=value;
   }
   return true;
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns address of basin property
+/// \note used to resolve parameters once (e.g., transient parameters) rather than by name every time step;
+/// integer, boolean, and reservoir properties have no address and return NULL
+/// \param label [in] String property identifier
+/// \return pointer to basin property, or NULL if label is not a floating point basin property
+//
+double *CSubBasin::GetBasinPropertyAddress(const string label)
+{
+  string label_n = StringToUppercase(label);
+  if      (!label_n.compare("TIME_CONC"     )){return &(_t_conc);}
+  else if (!label_n.compare("TIME_TO_PEAK"  )){return &(_t_peak);}
+  else if (!label_n.compare("TIME_LAG"      )){return &(_t_lag);}
+  else if (!label_n.compare("RES_CONSTANT"  )){return &(_reservoir_constant);}
+  else if (!label_n.compare("GAMMA_SHAPE"   )){return &(_gamma_shape);}
+  else if (!label_n.compare("GAMMA_SCALE"   )){return &(_gamma_scale);}
+
+  else if (!label_n.compare("Q_REFERENCE"   )){return &(_Q_ref);}
+  else if (!label_n.compare("MANNINGS_N"    )){return &(_mannings_n);}
+  else if (!label_n.compare("SLOPE"         )){return &(_slope);}
+  else if (!label_n.compare("DIFFUSIVITY"   )){return &(_diffusivity);}
+  else if (!label_n.compare("CELERITY"      )){return &(_c_ref);}
+
+  else if (!label_n.compare("RAIN_CORR"     )){return &(_rain_corr);}
+  else if (!label_n.compare("SNOW_CORR"     )){return &(_snow_corr);}
+  else if (!label_n.compare("TEMP_CORR"     )){return &(_temperature_corr);}
+
+  else if (!label_n.compare("HYPORHEIC_FLUX")){return &(_hyporheic_flux);}
+  else if (!label_n.compare("CONVECT_COEFF" )){return &(_convect_coeff);}
+
+  else if (!label_n.compare("RIVERBED_CONDUCTIVITY")){return &(_bed_conductivity);}
+  else if (!label_n.compare("RIVERBED_THICKNESS"   )){return &(_bed_thickness);}
+  else if (!label_n.compare("CORR_REACH_LENGTH"   )){return &(_reach_length2);}
+  return NULL;
+}
 //////////////////////////////////////////////////////////////////
 /// \brief Gets basin properties
 /// \param label [in] String property identifier
@@ -1118,6 +1133,7 @@ void CSubBasin::SetQlatHist(const int N, const double *aQl, const double QlLast)
   }
   if(N==0) { return; }
   for (int i=0;i<min(_nQlatHist,N);i++){_aQlatHist[i]=aQl[i];}
+  _aQlatHist.Mirror();
   _QlatLast=QlLast;
 }
 
@@ -1134,6 +1150,7 @@ void CSubBasin::SetQinHist          (const int N, const double *aQi)
   }
   if(N==0) { return; }
   for (int i=0;i<min(_nQinHist,N);i++){_aQinHist[i]=aQi[i];}
+  _aQinHist.Mirror();
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1149,10 +1166,7 @@ void CSubBasin::SetQinHist          (const int N, const double *aQi)
 //
 void CSubBasin::UpdateInflow    (const double &Qin)//[m3/s]
 {
-  for (int n=_nQinHist-1;n>0;n--){
-    _aQinHist[n]=_aQinHist[n-1];
-  }
-  _aQinHist[0]=Qin;
+  _aQinHist.Push(Qin);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1165,10 +1179,7 @@ void CSubBasin::UpdateInflow    (const double &Qin)//[m3/s]
 //
 void CSubBasin::UpdateLateralInflow    (const double &Qlat)//[m3/s]
 {
-  for (int n=_nQlatHist-1;n>0;n--){
-    _aQlatHist[n]=_aQlatHist[n-1];
-  }
-  _aQlatHist[0]=Qlat;
+  _aQlatHist.Push(Qlat);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1203,6 +1214,8 @@ double CSubBasin::ScaleAllFlows(const double &scale, const bool overriding, cons
       _aQinHist[n]*=scale; upperswap(_aQinHist[n],0.0);
       va+=_aQinHist[n]*sf*tstep*SEC_PER_DAY;
     }
+    _aQlatHist.Mirror();
+    _aQinHist.Mirror();
     for(int i=0;i<_nSegments;i++) {
       _aQout[i]*=scale; upperswap(_aQout[i],0.0);
       va+=0.5*(_aQout[i]+_aQout[i+1])*sf*tstep*SEC_PER_DAY;
@@ -1566,8 +1579,7 @@ void CSubBasin::GenerateRoutingHydrograph(const double &Qin_avg,
   }
 
   //reserve memory, initialize
-  _aQinHist   =new double [_nQinHist+1 ];
-  for (n=0;n<_nQinHist;n++){_aQinHist[n]=Qin_avg; }
+  _aQinHist.Allocate(_nQinHist,Qin_avg);
 
   _aRouteHydro=new double [_nQinHist+1 ];
   for (n=0;n<_nQinHist;n++){_aRouteHydro[n]=0.0;}
@@ -1688,8 +1700,7 @@ void CSubBasin::GenerateCatchmentHydrograph(const double    &Qlat_avg,
   }
 
   //reserve memory, initialize
-  _aQlatHist  =new double [_nQlatHist];
-  for (n=0;n<_nQlatHist;n++){_aQlatHist [n]=Qlat_avg;}//set to initial (steady-state) conditions
+  _aQlatHist.Allocate(_nQlatHist,Qlat_avg);//set to initial (steady-state) conditions
 
   _aUnitHydro =new double [_nQlatHist];
   for (n=0;n<_nQlatHist;n++){_aUnitHydro[n]=0.0;}
@@ -2064,7 +2075,7 @@ void CSubBasin::RouteWater(double *aQout_new,//[m3/s][size:_nSegments]
     dt=min(K,tstep);
     //dt=tstep;
 
-    static double aQoutStored[MAX_RIVER_SEGS];
+    double aQoutStored[MAX_RIVER_SEGS]; //local (not static) so that subbasins may be routed concurrently
     for (seg=0;seg<_nSegments;seg++){aQoutStored[seg]=_aQout[seg];}
     //cout<<"check: "<< 2*K*X<<" < "<<dt<< " < " << 2*K*(1-X)<<" K="<<K<<" X="<<X<<" dt="<<dt<<endl;
     for (double t=0;t<tstep;t+=dt)//Local time-stepping
@@ -2332,6 +2343,41 @@ void CSubBasin::WriteToSolutionFile (ofstream &RVC) const
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief appends routing state (storage, outflow, lateral and inflow histories, reservoir state) to binary snapshot
+/// \details same contents as WriteToSolutionFile(), at full precision; array sizes are stored in the snapshot structure block
+/// \param &aSnap [out] snapshot payload
+//
+void CSubBasin::WriteToSnapshot(vector<double> &aSnap) const
+{
+  aSnap.push_back(_channel_storage);
+  aSnap.push_back(_rivulet_storage);
+  for (int i=0;i<_nSegments;i++){aSnap.push_back(_aQout    [i]);} aSnap.push_back(_QoutLast);
+  for (int i=0;i<_nQlatHist;i++){aSnap.push_back(_aQlatHist[i]);} aSnap.push_back(_QlatLast);
+  for (int i=0;i<_nQinHist; i++){aSnap.push_back(_aQinHist [i]);}
+  if (_pReservoir!=NULL){
+    _pReservoir->WriteToSnapshot(aSnap);
+  }
+}
+//////////////////////////////////////////////////////////////////
+/// \brief restores routing state written by WriteToSnapshot()
+/// \remark array sizes must already have been checked against snapshot structure block
+/// \param *aSnap [in] snapshot payload
+/// \param &i [in/out] index of first value of this basin in aSnap; returned as index of next value
+//
+void CSubBasin::ReadFromSnapshot(const double *aSnap, size_t &i)
+{
+  _channel_storage=aSnap[i++];
+  _rivulet_storage=aSnap[i++];
+  for (int j=0;j<_nSegments;j++){_aQout    [j]=aSnap[i++];} _QoutLast=aSnap[i++];
+  for (int j=0;j<_nQlatHist;j++){_aQlatHist[j]=aSnap[i++];} _QlatLast=aSnap[i++];
+  for (int j=0;j<_nQinHist; j++){_aQinHist [j]=aSnap[i++];}
+  _aQlatHist.Mirror();
+  _aQinHist .Mirror();
+  if (_pReservoir!=NULL){
+    _pReservoir->ReadFromSnapshot(aSnap,i);
+  }
+}
+//////////////////////////////////////////////////////////////////
 /// \brief clears all time series data for re-read of .rvt file
 /// \remark Called only in ensemble mode
 ///
@@ -97,7 +97,7 @@ private:/*------------------------------------------------------*/
 
   //state variables:
   double               *_aQout;   ///< downstream river (out)flow [m3/s] at start of time step at end of each channel segment [size=_nSegments]
-  double           *_aQlatHist;   ///< history of lateral runoff into surface water [m3/s][size:_nQlatHist] - uniform (time-averaged) over timesteps
+  ring_history      _aQlatHist;   ///< history of lateral runoff into surface water [m3/s][size:_nQlatHist] - uniform (time-averaged) over timesteps
   //                              ///  if Ql=Ql(t), aQlatHist[0]=Qlat(t to t+dt), aQlatHist[1]=Qlat(t-dt to t)...
   int               _nQlatHist;   ///< size of _aQlatHist array
   double      _channel_storage;   ///< water storage in channel [m3]
@@ -111,7 +111,7 @@ private:/*------------------------------------------------------*/
   double             _QirrLast;   ///< Qirr (irrigation/diversion flow) at start of timestep [m3/s] (for MB accounting)
 
   //Hydrograph Memory
-  double            *_aQinHist;   ///< history of inflow from upstream into primary channel [m3/s][size:nQinHist] (aQinHist[n] = Qin(t-ndt))
+  ring_history       _aQinHist;   ///< history of inflow from upstream into primary channel [m3/s][size:nQinHist] (aQinHist[n] = Qin(t-ndt))
   //                              ///  _aQinHist[0]=Qin(t), _aQinHist[1]=Qin(t-dt), _aQinHist[2]=Qin(t-2dt)...
   int                _nQinHist;   ///< size of _aQinHist array
   double              *_c_hist;   ///< reach celerity history [size: _nQinHist] (used for ROUTE_DIFFUSIVE_VARY only)
@@ -240,6 +240,7 @@ public:/*-------------------------------------------------------*/
   void            AddHRU                   (CHydroUnit *pHRU);
   void            AddReservoir             (CReservoir *pReservoir);
   bool            SetBasinProperties       (const string label,const double &value);
+  double         *GetBasinPropertyAddress  (const string label);
   void            SetAsNonHeadwater        ();
   double          CalculateBasinArea       ();
   void            Initialize               (const double    &Qin_avg,          //[m3/s]
@@ -299,6 +300,8 @@ public:/*-------------------------------------------------------*/
                                             const time_struct &tt) const;
 
   void            WriteToSolutionFile      (ofstream &OUT) const;
+  void            WriteToSnapshot          (vector<double> &aSnap) const;
+  void            ReadFromSnapshot         (const double *aSnap, size_t &i);
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -175,14 +175,40 @@ void  CTerrainClass::SetTerrainProperty(terrain_struct &T,
   string name;
   name = StringToUppercase(param_name);
 
-  if      (!name.compare("HILLSLOPE_LENGTH"  )){T.hillslope_length=value;}
-  else if (!name.compare("DRAINAGE_DENSITY"  )){T.drainage_density=value;}
-  else if (!name.compare("TOPMODEL_LAMBDA"   )){T.topmodel_lambda=value; }
+  double *px=GetTerrainPropertyAddress(T,name);
+  if (px!=NULL){*px=value;}
   else{
     WriteWarning("CTerrainClass::SetTerrainProperty: Unrecognized/invalid terrain parameter name ("+name+") in .rvp file",false);
   }
 }
 //////////////////////////////////////////////////////////////////
+/// \brief Returns the address of the terrain property corresponding to param_name
+/// \param param_name [in] Parameter identifier
+/// \return pointer to terrain property of this class, or NULL if param_name is not a terrain property
+//
+double *CTerrainClass::GetTerrainPropertyAddress(const string &param_name)
+{
+  return GetTerrainPropertyAddress(T,param_name);
+}
+//////////////////////////////////////////////////////////////////
+/// \brief Returns the address of the terrain property corresponding to param_name
+/// \param &T [in] Terrain properties structure
+/// \param param_name [in] Parameter identifier
+/// \return pointer to terrain property in T, or NULL if param_name is not a terrain property
+//
+double *CTerrainClass::GetTerrainPropertyAddress(terrain_struct &T,
+                                                 const string    param_name)
+{
+  string name;
+  name = StringToUppercase(param_name);
+
+  if      (!name.compare("HILLSLOPE_LENGTH"  )){return &(T.hillslope_length);}
+  else if (!name.compare("DRAINAGE_DENSITY"  )){return &(T.drainage_density);}
+  else if (!name.compare("TOPMODEL_LAMBDA"   )){return &(T.topmodel_lambda);}
+
+  return NULL;
+}
+//////////////////////////////////////////////////////////////////
 /// \brief gets terrain property corresponding to param_name
 /// \param param_name [in] Parameter identifier
 /// \returns value of parameter
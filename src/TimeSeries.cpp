@@ -1256,72 +1256,72 @@ CTimeSeries **CTimeSeries::ParseEnsimTb0(string filename, int &nTS, forcing_type
   return NULL;
 }
 
+#ifdef _RVNETCDF_
 //////////////////////////////////////////////////////////////////
-/// \brief Reads a time series from a NetCDF file
-/// \note  Will return just a vector that needs to be converted into TimeSeries object afterwards
-///
-/// \param  Options             [in] global model otions such as simulation period
-/// \param  name                [in] forcing type
-/// \param  loc_ID              [in] location information about timeseries, e.g. subbasin ID or HRU ID
-/// \param  FileNameNC          [in] file name of NetCDF
-/// \param  VarNameNC           [in] name of variable in NetCDF
-/// \param  DimNamesNC_stations [in] name of station dimension (optional; default=None)
-/// \param  DimNamesNC_time     [in] name of time dimension (mandatory)
-/// \param  StationIdx          [in] idx of station to be read (or -1 if to be determined from FEWS station_id variable via FROM_STATION_VAR) (only used if DimNamesNC:stations not None)
-/// \param  TimeShift           [in] time shift of data (fractional day by which read data should be shifted)
-/// \param  LinTrans_a,         [in] linear transformation: a in new = a*data+b
-/// \param  LinTrans_b          [in] linear transformation: b in new = a*data+b
-/// \return array (size nTS) of pointers to time series
+/// \brief NetCDF variable from which one or more time series are read
+/// \details attributes, dimensions, and time axis are read once, when the first time series is read from the
+/// variable. Upon the second request for a station time series, the complete (stations x time) block of raw
+/// values is read in a single call, and all subsequent station time series are sliced out of it
 //
-CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, string name,
-                                                   long loc_ID, string gauge_name,bool shift_to_per_ending, bool shift_from_per_ending, string FileNameNC, string VarNameNC,
-                                                   string DimNamesNC_stations, string DimNamesNC_time,
-                                                   int StationIdx, double TimeShift, double LinTrans_a, double LinTrans_b)
+struct netcdf_ts_source
 {
-  CTimeSeries *pTimeSeries=NULL; // time series of data
+  int     ncid;          ///< NetCDF file ID (shared by all variables in file)
+  int     varid;         ///< variable ID
+  double  fillval;       ///< value of "_FillValue" attribute
+  double  missval;       ///< value of "missing_value" attribute
+  double  add_offset;    ///< value of "add_offset" attribute
+  double  scale_factor;  ///< value of "scale_factor" attribute
+  int     ntime;         ///< length of time dimension
+  int     nstations;     ///< length of station dimension (0 if variable is 1D)
+  int     dim_order;     ///< 1 if dimensions are (x,t) or (t), 2 if (t,x)
+  int     calendar;      ///< calendar of time variable
+  double  tstep;         ///< time interval between data points [d]
+  double  start_day;     ///< julian start day of data
+  int     start_yr;      ///< start year of data
+  long   *aStations;     ///< station IDs from station_id variable (NULL until needed by FROM_STATION_VAR)
+  string *aStat_strings; ///< station names from station_id variable
+  int     nStatVar;      ///< size of aStations array
+  int     nReads;        ///< number of time series read from variable
+  double *aBlock;        ///< raw values of all stations, in file order [size: nstations*ntime] (NULL until read)
+};
+static unordered_map<string,netcdf_ts_source*> g_NetCDFTSSources; ///< NetCDF time series variables, by file, variable, and dimension names
 
-#ifdef _RVNETCDF_
-  int    ncid;                  // file unit
-  int    retval;                // error value for NetCDF routines
-  int    dimid_x;               // id of x dimension
-  int    dimid_t;               // id of time dimension
-  size_t dummy;                 // special type for GridDims required by nc routine
-  int    nstations;             // length of x dimension (columns)
-  int    ntime;                 // length of t dimension (time)
-  int    varid_t;               // id of time variable
-  int    varid_f;               // id of VarNameNC variable
-  char * unit_t;                // special type for string of variable's unit     required by nc routine
-  size_t att_len;               // length of the attribute's text
+//////////////////////////////////////////////////////////////////
+/// \brief returns NetCDF time series variable description, reading attributes, dimensions and time axis upon first request
+//
+static netcdf_ts_source *GetNetCDFTimeSeriesSource(const optStruct &Options,const string &FileNameNC,const string &VarNameNC,
+                                                   const string &DimNamesNC_stations,const string &DimNamesNC_time)
+{
+  string key=FileNameNC+"|"+VarNameNC+"|"+DimNamesNC_stations+"|"+DimNamesNC_time;
+  unordered_map<string,netcdf_ts_source*>::const_iterator it=g_NetCDFTSSources.find(key);
+  if (it!=g_NetCDFTSSources.end()){return it->second;}
+
+  netcdf_ts_source *src=new netcdf_ts_source;
+  src->aStations    =NULL;
+  src->aStat_strings=NULL;
+  src->nStatVar     =0;
+  src->nReads       =0;
+  src->aBlock       =NULL;
+
+  int     ncid;                 // file unit
+  int     retval;               // error value for NetCDF routines
+  int     dimid_x;              // id of x dimension
+  int     dimid_t;              // id of time dimension
+  size_t  dummy;                // special type for GridDims required by nc routine
+  int     varid_t;              // id of time variable
+  int     varid_f;              // id of VarNameNC variable
+  char   *unit_t;               // special type for string of variable's unit     required by nc routine
+  size_t  att_len;              // length of the attribute's text
   nc_type att_type;             // type of attribute
-  int    calendar;              // enum int of calendar
-  string dash;                  // to check format of time unit string
-  string colon;                 // to check format of time unit string
-  string unit_t_str;            // to check format of time unit string
-
-  // handling variable dimension orders
-  int    dimids_var[2];         // ids of dimensions of a NetCDF variable
-  int    dim1;                  // length of 1st dimension in NetCDF data
-  int    dim2;                  // length of 2nd dimension in NetCDF data
-  int    dim_order;             // order of dimensions of variable to read
-
-  // some netcdf attributes
-  double  missval;              // value of "missing_value" attribute of forcing variable
-  double  fillval;              // value of "_FillValue"    attribute of forcing variable
-  double  add_offset;           // value of "add_offset"    attribute of forcing variable
-  double  scale_factor;         // value of "scale_factor"  attribute of forcing variable
-
-  // final variables to create time series object
-  int    nMeasurements;         // number of data points read
-  double start_day=0.0;         // start day of time series
-  int    start_yr=1900;         // start year of time series
-  double tstep=1.0;             // time difference between two data points
-  bool   is_pulse;              // if data are pulses
+  string  unit_t_str;           // to check format of time unit string
+  int     dimids_var[2];        // ids of dimensions of a NetCDF variable
+  int     ndim;                 // number of dimensions of NetCDF variable
 
   // -------------------------------
-  // (1) open NetCDF read-only (get ncid)
+  // (1) open NetCDF read-only (get ncid), shared by all variables read from file
   // -------------------------------
   if (Options.noisy){ cout<<"Start reading time series for "<< VarNameNC << " from NetCDF file "<< FileNameNC << endl; }
-  retval = nc_open(FileNameNC.c_str(), NC_NOWRITE, &ncid);
+  retval = OpenNetCDFInputFile(FileNameNC,ncid);
   if (retval != NC_NOERR) {
     string warn="ReadTimeSeriesFromNetCDF : unable to open file "+FileNameNC +" (NetCDF error: "+to_string(nc_strerror(retval))+")";
     ExitGracefully(warn.c_str(),BAD_DATA);
@@ -1331,62 +1331,39 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
     string warn="ReadTimeSeriesFromNetCDF : unable to find variable "+VarNameNC+" in file "+FileNameNC;
     ExitGracefully(warn.c_str(),BAD_DATA);
   }
+  HandleNetCDFErrors(retval);
+  src->ncid =ncid;
+  src->varid=varid_f;
 
   // -------------------------------
-  // find "_FillValue" of forcing data
+  // find "_FillValue", "missing_value", "add_offset" and "scale_factor" of forcing data
   // -------------------------------
   retval = nc_inq_att(ncid,varid_f,"_FillValue",&att_type,&att_len);
-  if (retval == NC_ENOTATT) {
-    // if not found, set to NETCDF_BLANK_VALUE
-    fillval = NETCDF_BLANK_VALUE;
-  }
+  if (retval == NC_ENOTATT) { src->fillval = NETCDF_BLANK_VALUE; }// if not found, set to NETCDF_BLANK_VALUE
   else {
     HandleNetCDFErrors(retval);
-    retval = nc_get_att_double(ncid,varid_f,"_FillValue",&fillval);       HandleNetCDFErrors(retval);// read attribute value
+    retval = nc_get_att_double(ncid,varid_f,"_FillValue",&src->fillval);           HandleNetCDFErrors(retval);// read attribute value
   }
-
-  // -------------------------------
-  // find "missing_value" of forcing data
-  // -------------------------------
   retval = nc_inq_att(ncid, varid_f, "missing_value", &att_type, &att_len);
-  if (retval == NC_ENOTATT) {
-    // if not found, set to NETCDF_BLANK_VALUE
-    missval = NETCDF_BLANK_VALUE;
-  }
+  if (retval == NC_ENOTATT) { src->missval = NETCDF_BLANK_VALUE; }// if not found, set to NETCDF_BLANK_VALUE
   else {
     HandleNetCDFErrors(retval);
-    retval = nc_get_att_double(ncid, varid_f, "missing_value", &missval);     HandleNetCDFErrors(retval);// read attribute value
+    retval = nc_get_att_double(ncid, varid_f, "missing_value", &src->missval);     HandleNetCDFErrors(retval);// read attribute value
   }
-
-  // -------------------------------
-  // check for attributes "add_offset" of forcing data
-  // -------------------------------
   retval = nc_inq_att(ncid, varid_f, "add_offset", &att_type, &att_len);
-  if (retval == NC_ENOTATT) {
-    // if not found, set add_offset = 0.0
-    add_offset = 0.0;
-  }
+  if (retval == NC_ENOTATT) { src->add_offset = 0.0; }
   else {
-    // found, set add_offset to value
     HandleNetCDFErrors(retval);
-    retval = nc_get_att_double(ncid, varid_f, "add_offset", &add_offset);       HandleNetCDFErrors(retval);// read attribute value
+    retval = nc_get_att_double(ncid, varid_f, "add_offset", &src->add_offset);     HandleNetCDFErrors(retval);// read attribute value
   }
-  if (Options.noisy){ cout << "  add_offset = " << add_offset << endl; }
-
-  // -------------------------------
-  // check for attributes "scale_factor" of forcing data
-  // -------------------------------
+  if (Options.noisy){ cout << "  add_offset = " << src->add_offset << endl; }
   retval = nc_inq_att(ncid, varid_f, "scale_factor", &att_type, &att_len);
-  if (retval == NC_ENOTATT) {
-    // if not found, set scale_factor = 1.0
-    scale_factor = 1.0;
-  }
+  if (retval == NC_ENOTATT) { src->scale_factor = 1.0; }
   else {
-    // found, set scale_factor to value
     HandleNetCDFErrors(retval);
-    retval = nc_get_att_double(ncid, varid_f, "scale_factor", &scale_factor);       HandleNetCDFErrors(retval);// read attribute value
+    retval = nc_get_att_double(ncid, varid_f, "scale_factor", &src->scale_factor); HandleNetCDFErrors(retval);// read attribute value
   }
-  if (Options.noisy){ cout << "  scale_factor = " << scale_factor << endl; }
+  if (Options.noisy){ cout << "  scale_factor = " << src->scale_factor << endl; }
 
   // -------------------------------
   // (2) get dimension lengths
@@ -1394,17 +1371,22 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
   //     (a) time dimension
   retval = nc_inq_dimid (ncid, DimNamesNC_time.c_str(), &dimid_t);  HandleNetCDFErrors(retval);
   retval = nc_inq_dimlen(ncid, dimid_t, &dummy);                    HandleNetCDFErrors(retval);
-  ntime  = static_cast<int>(dummy);  // convert returned 'size_t' to 'int'
+  src->ntime = static_cast<int>(dummy);  // convert returned 'size_t' to 'int'
   //     (b) other dimension (optional)
+  dimid_x=DOESNT_EXIST;
+  src->nstations=0;
   if ( strcmp(DimNamesNC_stations.c_str(),"None") ) {
     retval = nc_inq_dimid (ncid, DimNamesNC_stations.c_str(), &dimid_x);  HandleNetCDFErrors(retval);
     retval = nc_inq_dimlen(ncid, dimid_x, &dummy);                        HandleNetCDFErrors(retval);
-    nstations  = static_cast<int>(dummy);  // convert returned 'size_t' to 'int'
-  }
-  else {
-    nstations = 0;
+    src->nstations = static_cast<int>(dummy);  // convert returned 'size_t' to 'int'
+
+    retval = nc_inq_varndims(ncid,varid_f,&ndim);   HandleNetCDFErrors(retval);
+    if (ndim > 2) {
+      string warn="ReadTimeSeriesFromNetCDF: dataset within " +FileNameNC + " has more than 2 dimensions. Individual time series must be read from a 1D (time) or 2D (time x nstations) NetCDF variable";
+      ExitGracefully(warn.c_str(), BAD_DATA);
+    }
   }
-  if (Options.noisy){ cout << "  nstations = " << nstations << endl; }
+  if (Options.noisy){ cout << "  nstations = " << src->nstations << endl; }
 
   // -------------------------------
   // (3) time values and unit
@@ -1426,108 +1408,129 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
   if (Options.noisy){ cout << "  time unit = " << unit_t_str << endl; }
 
   //     (c) calendar
-  calendar=GetCalendarFromNetCDF(ncid,varid_t,FileNameNC,Options);
+  src->calendar=GetCalendarFromNetCDF(ncid,varid_t,FileNameNC,Options);
 
   //     (d) allocate and extract array of time values
-  double *my_time=new double[ntime];
+  double *my_time=new double[src->ntime];
   ExitGracefullyIf(my_time==NULL,"CTimeSeries::ReadTimeSeriesFromNetCDF",OUT_OF_MEMORY);
-  GetTimeVectorFromNetCDF(ncid,varid_t,ntime,my_time);
+  GetTimeVectorFromNetCDF(ncid,varid_t,src->ntime,my_time);
 
   // -------------------------------
-  // (5) determine tstep, start_day and start_yr depending on time unit
-  // sets tstep, start_day, start_year, time_zone properties
+  // (4) determine tstep, start_day and start_yr depending on time unit
   // -------------------------------
   double time_zone=0;
-  GetTimeInfoFromNetCDF(unit_t,calendar,my_time,ntime,FileNameNC,tstep,start_day,start_yr,time_zone);
+  src->tstep    =1.0;
+  src->start_day=0.0;
+  src->start_yr =1900;
+  GetTimeInfoFromNetCDF(unit_t,src->calendar,my_time,src->ntime,FileNameNC,src->tstep,src->start_day,src->start_yr,time_zone);
 
   delete [] my_time;
-
-  // if data are period ending, need to shift by data interval
-  if (shift_to_per_ending) {
-    AddTime(start_day,start_yr,tstep,calendar,start_day,start_yr);
-  }
-  if(shift_from_per_ending) {
-    AddTime(start_day,start_yr,-tstep,calendar,start_day,start_yr);
-  }
+  delete [] unit_t;
 
   // -------------------------------
-  // (6) set n (= number of datapoints)
+  // (5) determine dimension order in variable
   // -------------------------------
-  nMeasurements = ntime;
-
-  // -------------------------------
-  // (7) determine dimension order in variable
-  // -------------------------------
-  //     (a) Get the id of the data variable based on its name; varid will be set
-  retval = nc_inq_varid(ncid, VarNameNC.c_str(), &varid_f);       HandleNetCDFErrors(retval);
-  //     (b) determine in which order the dimensions are in variable
-  retval = nc_inq_vardimid(ncid, varid_f, dimids_var);          HandleNetCDFErrors(retval);
-  //     (c) determine order
+  src->dim_order=1;                                                  // dimensions are (t)
   if ( strcmp(DimNamesNC_stations.c_str(),"None") ) {
-    if      ((dimids_var[0] == dimid_x) && (dimids_var[1] == dimid_t))  {  // dimensions are (x,t)
-      dim_order = 1;
-      dim1 = nstations;
-      dim2 = ntime;
-    }
-    else {                                                                 // dimensions are (t,x)
-      dim_order = 2;
-      dim1 = ntime;
-      dim2 = nstations;
-    }
+    retval = nc_inq_vardimid(ncid, varid_f, dimids_var);           HandleNetCDFErrors(retval);
+    if ((dimids_var[0] == dimid_x) && (dimids_var[1] == dimid_t)){ src->dim_order = 1; } // dimensions are (x,t)
+    else                                                         { src->dim_order = 2; } // dimensions are (t,x)
   }
-  else {                                                                   // dimensions are (t)
-    dim_order = 1;
-    dim1 = ntime;
-    dim2 = 1;
+  if (Options.noisy){ cout << "  dim order = " << src->dim_order << endl; }
+
+  g_NetCDFTSSources[key]=src;
+  return src;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////
+/// \brief Releases all cached NetCDF time series data and closes NetCDF input files
+/// \remark called once all time series in an .rvt file have been read
+//
+void CTimeSeries::ClearNetCDFCache()
+{
+#ifdef _RVNETCDF_
+  for (unordered_map<string,netcdf_ts_source*>::iterator it=g_NetCDFTSSources.begin();it!=g_NetCDFTSSources.end();++it){
+    delete [] it->second->aStations;
+    delete [] it->second->aStat_strings;
+    delete [] it->second->aBlock;
+    delete it->second;
   }
-  if (Options.noisy){ cout << "  dim order = " << dim_order << endl; }
+  g_NetCDFTSSources.clear();
+#endif
+  CloseNetCDFInputFiles();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Reads a time series from a NetCDF file
+/// \details file handles, attributes and time axis are shared by all time series read from the same NetCDF
+/// variable; if more than one station time series is read from a (stations x time) variable, all stations
+/// are read at once and subsequent time series are sliced from memory (see netcdf_ts_source)
+///
+/// \param  Options             [in] global model otions such as simulation period
+/// \param  name                [in] forcing type
+/// \param  loc_ID              [in] location information about timeseries, e.g. subbasin ID or HRU ID
+/// \param  FileNameNC          [in] file name of NetCDF
+/// \param  VarNameNC           [in] name of variable in NetCDF
+/// \param  DimNamesNC_stations [in] name of station dimension (optional; default=None)
+/// \param  DimNamesNC_time     [in] name of time dimension (mandatory)
+/// \param  StationIdx          [in] idx of station to be read (or -1 if to be determined from FEWS station_id variable via FROM_STATION_VAR) (only used if DimNamesNC:stations not None)
+/// \param  TimeShift           [in] time shift of data (fractional day by which read data should be shifted)
+/// \param  LinTrans_a,         [in] linear transformation: a in new = a*data+b
+/// \param  LinTrans_b          [in] linear transformation: b in new = a*data+b
+/// \return pointer to time series
+//
+CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, string name,
+                                                   long loc_ID, string gauge_name,bool shift_to_per_ending, bool shift_from_per_ending, string FileNameNC, string VarNameNC,
+                                                   string DimNamesNC_stations, string DimNamesNC_time,
+                                                   int StationIdx, double TimeShift, double LinTrans_a, double LinTrans_b)
+{
+  CTimeSeries *pTimeSeries=NULL; // time series of data
+
+#ifdef _RVNETCDF_
+  int    retval;                // error value for NetCDF routines
 
   // -------------------------------
-  // (8) Initialize data array (data type that is needed by NetCDF library)
+  // (1) get (shared) file handle, attributes, dimensions and time axis
   // -------------------------------
-  double *aVec=new double[dim1*dim2];//stores actual data
-  ExitGracefullyIf(aVec==NULL,"CTimeSeries::ReadTimeSeriesFromNetCDF: aVec",OUT_OF_MEMORY);
-  for(int i=0; i<dim1*dim2; i++) {
-    aVec[i]=NETCDF_BLANK_VALUE;
-  }
+  netcdf_ts_source *src=GetNetCDFTimeSeriesSource(Options,FileNameNC,VarNameNC,DimNamesNC_stations,DimNamesNC_time);
 
-  double **aTmp2D=NULL; //stores pointers to rows/columns of 2D data (ntime x nstations)
-  double  *aTmp1D=NULL; //stores pointers to rows/columns of 1D data (ntime)
-  if ( strcmp(DimNamesNC_stations.c_str(),"None") ) {
-    aTmp2D=new double *[dim1];
-    ExitGracefullyIf(aTmp2D==NULL,"CTimeSeries::ReadTimeSeriesFromNetCDF: aTmp2D(0)",OUT_OF_MEMORY);
-    for(int it=0;it<dim1;it++){
-      aTmp2D[it]=&aVec[it*dim2]; //points to correct location in aVec data storage
-    }
+  int    ntime    =src->ntime;
+  int    calendar =src->calendar;
+  double tstep    =src->tstep;
+  double start_day=src->start_day;
+  int    start_yr =src->start_yr;
+
+  // if data are period ending, need to shift by data interval
+  if (shift_to_per_ending) {
+    AddTime(start_day,start_yr,tstep,calendar,start_day,start_yr);
   }
-  else {
-    aTmp1D=new double [dim1];
-    ExitGracefullyIf(aTmp1D==NULL,"CTimeSeries::ReadTimeSeriesFromNetCDF: aTmp1D(0)",OUT_OF_MEMORY);
+  if(shift_from_per_ending) {
+    AddTime(start_day,start_yr,-tstep,calendar,start_day,start_yr);
   }
 
   // -------------------------------
-  // (9) Read data
+  // (2) Read raw data of station (or 1D variable)
   // -------------------------------
+  double *aVec=new double[ntime];//stores actual data
+  ExitGracefullyIf(aVec==NULL,"CTimeSeries::ReadTimeSeriesFromNetCDF: aVec",OUT_OF_MEMORY);
+
   if ( strcmp(DimNamesNC_stations.c_str(),"None") )
   {
-
     // Handling of FROM_STATION_VAR indexing - used predominantly for Deltares FEWS support
     //----------------------------------------------------------------------------------------
     if (StationIdx == FROM_STATION_VAR)
     { //special indicator that station index determined via subbasin/HRUID/gauge name and station_id NetCDF variable array
-      int     stat_dimid;
-      int     stat_varid;
-      int     nStations;
-      long   *aStations    =NULL;
-      string *aStat_strings=NULL;
-      GetNetCDFStationArray(ncid, FileNameNC,stat_dimid,stat_varid, aStations,aStat_strings, nStations);
+      if (src->aStations==NULL){
+        int stat_dimid,stat_varid;
+        GetNetCDFStationArray(src->ncid, FileNameNC,stat_dimid,stat_varid, src->aStations,src->aStat_strings, src->nStatVar);
+      }
       if (loc_ID!=DOESNT_EXIST) // Time series linked to SubBasin or HRU
       {
         StationIdx=DOESNT_EXIST;
-        for (int i = 0; i < nStations; i++) {
-          if (aStations[i]==loc_ID){StationIdx=i+1;}
+        for (int i = 0; i < src->nStatVar; i++) {
+          if (src->aStations[i]==loc_ID){StationIdx=i+1;}
         }
-
         if(StationIdx==DOESNT_EXIST) {
           string warn="ReadTimeSeriesFromNetCDF: :StationIdx FROM_STATION_VAR - can't find station with SubBasin or HRU ID="+to_string(loc_ID)+" for time series "+name;
           ExitGracefully(warn.c_str(),BAD_DATA);
@@ -1537,8 +1540,8 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
       else if(gauge_name!="none") // Time Series linked to gauge
       {
         StationIdx=DOESNT_EXIST;
-        for(int i = 0; i < nStations; i++) {
-          if(!strcmp(aStat_strings[i].c_str(),gauge_name.c_str())) { StationIdx=i+1;}
+        for(int i = 0; i < src->nStatVar; i++) {
+          if(!strcmp(src->aStat_strings[i].c_str(),gauge_name.c_str())) { StationIdx=i+1;}
         }
         if(StationIdx==DOESNT_EXIST) {
           string warn="ReadTimeSeriesFromNetCDF: :StationIdx FROM_STATION_VAR - can't find station with gauge name="+gauge_name;
@@ -1551,42 +1554,49 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
         ExitGracefully(warn.c_str(),BAD_DATA);
         return NULL;
       }
-      delete[] aStations;
-      delete[] aStat_strings;
-
       if (Options.noisy){ cout << " FROM_STATION_VAR station index = " << StationIdx << endl; }
     }
     //----------------------------------------------------------------------------------------
-    if (Options.noisy){cout<<"  Reading vars_double..."<<endl;}
-
-    size_t    nc_start [2];
-    size_t    nc_length[2];
-    ptrdiff_t nc_stride[2];
-
-    int ndim;
-    retval = nc_inq_varndims(ncid,varid_f,&ndim);   HandleNetCDFErrors(retval);
-    if (ndim > 2) {
-      string warn="ReadTimeSeriesFromNetCDF: dataset within " +FileNameNC + " has more than 2 dimensions. Individual time series must be read from a 1D (time) or 2D (time x nstations) NetCDF variable";
-      ExitGracefully(warn.c_str(), BAD_DATA);
+    if ((StationIdx<1) || (StationIdx>src->nstations)) {
+      string warn="ReadTimeSeriesFromNetCDF: station index "+to_string(StationIdx)+" is outside of station dimension "+DimNamesNC_stations+" of file "+FileNameNC;
+      ExitGracefully(warn.c_str(),BAD_DATA);
+      return NULL;
     }
 
-    if(dim_order==1) {// dimensions are (x,t)
-      nc_start[0]  = StationIdx-1; nc_length[0] = (size_t)(1);      nc_stride[0] = 1; //-1 is because station index is provided as integer starting from one, not zero
-      nc_start[1]  = 0;            nc_length[1] = (size_t)(ntime);  nc_stride[1] = 1;
-      retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp2D[0][0]);   HandleNetCDFErrors(retval);
+    //second and later stations: read all stations at once, slice from memory
+    if ((src->aBlock==NULL) && (src->nReads>0))
+    {
+      if (Options.noisy){cout<<"  Reading all "<<src->nstations<<" stations of "<<VarNameNC<<"..."<<endl;}
+      src->aBlock=new double [(size_t)(src->nstations)*ntime];
+      ExitGracefullyIf(src->aBlock==NULL,"CTimeSeries::ReadTimeSeriesFromNetCDF: aBlock",OUT_OF_MEMORY);
+      retval=nc_get_var_double(src->ncid,src->varid,src->aBlock);   HandleNetCDFErrors(retval);
     }
-    else             {// dimensions are (t,x)
-      nc_start[0]  = 0;            nc_length[0] = (size_t)(ntime);  nc_stride[0] = 1;
-      nc_start[1]  = StationIdx-1; nc_length[1] = (size_t)(1);      nc_stride[1] = 1;
-      retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp2D[0][0]);   HandleNetCDFErrors(retval);
+
+    if (src->aBlock!=NULL)
+    {
+      if(src->dim_order==1) {// dimensions are (x,t)
+        const double *row=src->aBlock+(size_t)(StationIdx-1)*ntime;
+        for (int it=0;it<ntime;it++){aVec[it]=row[it];}
+      }
+      else                  {// dimensions are (t,x)
+        for (int it=0;it<ntime;it++){aVec[it]=src->aBlock[(size_t)(it)*src->nstations+StationIdx-1];}
+      }
     }
-    if (Options.noisy) {
-      cout<<" CForcingGrid::ReadTimeSeriesFromNetCDF - !none"<<endl;
-      printf("  Dim of chunk read: dim1 = %i   dim2 = %i\n",dim1,dim2);
-      printf("  start  chunk: (%zu, %zu)\n", nc_start[0], nc_start[1]);
-      printf("  length chunk: (%zu, %zu)\n", nc_length[0],nc_length[1]);
-      printf("  stride chunk: (%zu, %zu)\n", nc_stride[0],nc_stride[1]);
-      printf("  Data read: [%.4f, %.4f, %.4f ... %.4f]\n",aTmp2D[0][0], aTmp2D[0][1], aTmp2D[0][2], aTmp2D[0][ntime-1]);
+    else
+    {
+      if (Options.noisy){cout<<"  Reading vars_double..."<<endl;}
+      size_t    nc_start [2];
+      size_t    nc_length[2];
+      ptrdiff_t nc_stride[2];
+      if(src->dim_order==1) {// dimensions are (x,t)
+        nc_start[0]  = StationIdx-1; nc_length[0] = (size_t)(1);      nc_stride[0] = 1; //-1 is because station index is provided as integer starting from one, not zero
+        nc_start[1]  = 0;            nc_length[1] = (size_t)(ntime);  nc_stride[1] = 1;
+      }
+      else                  {// dimensions are (t,x)
+        nc_start[0]  = 0;            nc_length[0] = (size_t)(ntime);  nc_stride[0] = 1;
+        nc_start[1]  = StationIdx-1; nc_length[1] = (size_t)(1);      nc_stride[1] = 1;
+      }
+      retval=nc_get_vars_double(src->ncid,src->varid,nc_start,nc_length,nc_stride,aVec);   HandleNetCDFErrors(retval);
     }
   }
   else
@@ -1596,90 +1606,43 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
     size_t    nc_length[1];
     ptrdiff_t nc_stride[1];
     nc_start [0] = 0;  nc_length[0] = (size_t)(ntime);  nc_stride[0] = 1;
-    retval=nc_get_vars_double(ncid,varid_f,nc_start,nc_length,nc_stride,&aTmp1D[0]);    HandleNetCDFErrors(retval);
-    if (Options.noisy) {
-      cout<<" CForcingGrid::ReadTimeSeriesFromNetCDF - none"<<endl;
-      printf("  Dim of chunk read: dim1 = %i \n",dim1);
-      printf("  start  chunk: (%zu)\n", nc_start[0]);
-      printf("  length chunk: (%zu)\n", nc_length[0]);
-      printf("  stride chunk: (%zu)\n", nc_stride[0]);
-      printf("  Data read: [%.4f, %.4f, %.4f ... %.4f]\n",aTmp1D[0], aTmp1D[1], aTmp1D[2], aTmp1D[ntime-1]);
-    }
+    retval=nc_get_vars_double(src->ncid,src->varid,nc_start,nc_length,nc_stride,aVec);    HandleNetCDFErrors(retval);
+  }
+  src->nReads++;
+  if (Options.noisy) {
+    printf("  Data read: [%.4f, %.4f, %.4f ... %.4f]\n",aVec[0], aVec[1], aVec[2], aVec[ntime-1]);
   }
 
   // -------------------------------
-  // (10) close NetCDF
-  // -------------------------------
-  retval = nc_close(ncid);
-  HandleNetCDFErrors(retval);
-
-  // -------------------------------
-  // (11) Re-scale NetCDF variables based on their internal add-offset and scale_factor
+  // (3) Re-scale NetCDF variables based on their internal add-offset and scale_factor
   //      MANDATORY to do before any value of these data are used
   // -------------------------------
-  if ( strcmp(DimNamesNC_stations.c_str(),"None") ) {
-    for (int it=0;it<dim1;it++){
-      for (int ir=0;ir<dim2;ir++){
-        if ((aTmp2D[it][ir]!=fillval)  && (aTmp2D[it][ir] != missval)) {
-           aTmp2D[it][ir] = aTmp2D[it][ir] * scale_factor + add_offset;
-        }
-      }
-    }
-  }
-  else {
-    for (int it=0;it<dim1;it++){
-      if ((aTmp1D[it]!=fillval)  && (aTmp1D[it] != missval)) {
-        aTmp1D[it] = aTmp1D[it] * scale_factor + add_offset;
-      }
+  for (int it=0;it<ntime;it++){
+    if ((aVec[it]!=src->fillval) && (aVec[it]!=src->missval)) {
+      aVec[it] = aVec[it] * src->scale_factor + src->add_offset;
     }
   }
 
   // -------------------------------
-  // (12) Initialize data array (data type that is needed by RAVEN)
+  // (4) Convert into RAVEN data array and apply linear transformation: new = a*data+b
   // -------------------------------
   double *aVal = new double [ntime];
-  for (int it=0; it<ntime; it++) {               // loop over time points in buffer
-      aVal[it]=RAV_BLANK_DATA;                   // initialize
-  }
-
-  // -------------------------------
-  // (13) Convert into RAVEN data array and apply linear transformation: new = a*data+b
-  // -------------------------------
-  if ( strcmp(DimNamesNC_stations.c_str(),"None") )
-  {
-    // no switch of dim_order required because aTmp2D already points to
-    // correct location in aVec data storage (see step 9)
-    for (int it=0; it<ntime; it++){                     // loop over time points read
-      for (int ic=0; ic<1; ic++) {                       // loop over stations
-        if ((aTmp2D[ic][it]!=fillval) && (aTmp2D[ic][it]!=missval)) {
-          aVal[it] = LinTrans_a * aTmp2D[ic][it] + LinTrans_b;
-        }
-        else {
-          aVal[it]=RAV_BLANK_DATA;
-        }
-      }
+  for (int it=0; it<ntime; it++){                     // loop over time points read
+    if ((aVec[it]!=src->fillval) && (aVec[it]!=src->missval)) {
+      aVal[it] = LinTrans_a * aVec[it] + LinTrans_b;
     }
-  }
-  else
-  {
-    // no switch of dim_order required because aTmp2D already points to
-    // correct location in aVec data storage (see step 9)
-    for (int it=0; it<ntime; it++){                     // loop over time points read
-      if ((aTmp1D[it]!=fillval) && (aTmp1D[it]!=missval)) {
-        aVal[it] = LinTrans_a * aTmp1D[it] + LinTrans_b;
-      }
-      else {
-        aVal[it]=RAV_BLANK_DATA;
-      }
+    else {
+      aVal[it]=RAV_BLANK_DATA;
     }
   }
+  delete [] aVec;
 
   if (Options.noisy) {
     printf("  aVal: [%.4f, %.4f, %.4f ... %.4f]\n",aVal[0], aVal[1], aVal[2], aVal[ntime-1]);
   }
 
   // -------------------------------
-  // (14) add time shift to data
+  // (5) add time shift to data
   //      --> only applied when tstep < 1.0 (daily)
   //      --> otherwise ignored and warning written to RavenErrors.txt
   // -------------------------------
@@ -1697,15 +1660,12 @@ CTimeSeries *CTimeSeries::ReadTimeSeriesFromNetCDF(const optStruct &Options, str
   }
 
   // -------------------------------
-  // (15) convert to time series object
+  // (6) convert to time series object
   // -------------------------------
-  is_pulse = true;
+  bool is_pulse = true;
 
-  pTimeSeries=new CTimeSeries(name,loc_ID,FileNameNC.c_str(),start_day,start_yr,tstep,aVal,nMeasurements,is_pulse);
+  pTimeSeries=new CTimeSeries(name,loc_ID,FileNameNC.c_str(),start_day,start_yr,tstep,aVal,ntime,is_pulse);
 
-  // -------------------------------
-  // (16) delete dynamic memory
-  // -------------------------------
   delete [] aVal;  aVal =NULL;
 #endif   // ends #ifdef _RVNETCDF_
 
@@ -141,6 +141,7 @@ public:/*-------------------------------------------------------*/
                                                double LinTrans_a,           // linear transformation: a in new = a*data+b
                                                double LinTrans_b            // linear transformation: b in new = a*data+b
                                                );
+  static void         ClearNetCDFCache();
 };
 
 class CConstTimeSeries : public CTimeSeries
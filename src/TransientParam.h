@@ -22,6 +22,10 @@ struct class_change
   class_type tclass;      // type of class (e.g., CLASS_LANDUSE)
   string     newclass;    // new class tag
   double     modeltime;   // modeltime of shift
+
+  CLandUseClass    *pLUClass;  // new land use class (if tclass==CLASS_LANDUSE)
+  CVegetationClass *pVegClass; // new vegetation class (if tclass==CLASS_VEGETATION)
+  HRU_type          HRUtype;   // new HRU type (if tclass==CLASS_HRUTYPE)
 };
 ///////////////////////////////////////////////////////////////////
 /// \brief Data abstraction for global model parameters
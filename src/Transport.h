@@ -200,8 +200,8 @@ protected:
   bool                 _is_passive;  ///< doesn't transport via advection (default: false)
 
   // Routing/state var storage
-  double               **_aMinHist;  ///< array used for storing routing upstream loading history [mg/d] or [MJ/d] [size: nSubBasins x nMinhist(p)]
-  double              **_aMlatHist;  ///< array used for storing routing lateral loading history [mg/d] or [MJ/d] [size: nSubBasins  x nMlathist(p)]
+  ring_history          *_aMinHist;  ///< array used for storing routing upstream loading history [mg/d] or [MJ/d] [size: nSubBasins x nMinhist(p)]
+  ring_history         *_aMlatHist;  ///< array used for storing routing lateral loading history [mg/d] or [MJ/d] [size: nSubBasins  x nMlathist(p)]
   double                  **_aMout;  ///< array storing current mass flow at points along channel [mg/d] or [MJ/d] [size: nSubBasins x _nSegments(p)]
   double              *_aMout_last;  ///< array used for storing mass outflow from channel at start of timestep [mg/d] or [MJ/d] [size: nSubBasins ]
   double              *_aMlat_last;  ///< array storing mass/energy outflow from start of timestep [size: nSubBasins]
@@ -313,6 +313,8 @@ public:/*-------------------------------------------------------*/
   virtual void   WriteNetCDFOutputFileHeaders(const optStruct &Options);
   virtual void   WriteNetCDFMinorOutput      (const optStruct &Options,const time_struct& tt);
           void   WriteMajorOutput            (ofstream& RVC) const;
+          void   WriteToSnapshot             (vector<double> &aSnap) const;
+          void   ReadFromSnapshot            (const double *aSnap, size_t &i);
   virtual void   CloseOutputFiles            ();
 };
 
@@ -34,7 +34,7 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
   static force_struct *Fg=NULL;
   double              elev;
   int                 mo,yr;
-  int                 k,g,nn;
+  int                 k,g,i,nn;
   double              mid_day,model_day, time_shift;
   double              wt;
   bool                rvt_file_provided = (strcmp(Options.rvt_filename.c_str(), "") != 0);
@@ -53,48 +53,55 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
   model_day = floor(tt.model_time+time_shift+TIME_CORRECTION); //model time of 00:00 of current day
   mid_day   = floor(tt.julian_day+TIME_CORRECTION)+0.5;//mid day
 
-  CForcingGrid *pGrid_pre        = NULL;            // forcing grids
-  CForcingGrid *pGrid_rain       = NULL;
-  CForcingGrid *pGrid_snow       = NULL;
-  CForcingGrid *pGrid_pet        = NULL;
-  CForcingGrid *pGrid_owpet      = NULL;
-  CForcingGrid *pGrid_windspeed  = NULL;
-  CForcingGrid *pGrid_relhum     = NULL;
-  CForcingGrid *pGrid_SW_net     = NULL;
-  CForcingGrid *pGrid_LW_inc     = NULL;
-  CForcingGrid *pGrid_SW         = NULL;
-  CForcingGrid *pGrid_tave       = NULL;
-  CForcingGrid *pGrid_daily_tmin = NULL;
-  CForcingGrid *pGrid_daily_tmax = NULL;
-  CForcingGrid *pGrid_daily_tave = NULL;
-  CForcingGrid *pGrid_recharge   = NULL;
-  CForcingGrid *pGrid_precip_temp= NULL;
-
-  // see if gridded forcing is read from a NetCDF
-  bool pre_gridded            = ForcingGridIsInput(F_PRECIP)         ;
-  bool rain_gridded           = ForcingGridIsInput(F_RAINFALL)       ;
-  bool snow_gridded           = ForcingGridIsInput(F_SNOWFALL)       ;
-  bool temp_ave_gridded       = ForcingGridIsInput(F_TEMP_AVE)       ;
-  bool temp_daily_min_gridded = ForcingGridIsInput(F_TEMP_DAILY_MIN) ;
-  bool temp_daily_max_gridded = ForcingGridIsInput(F_TEMP_DAILY_MAX) ;
-  bool temp_daily_ave_gridded = ForcingGridIsInput(F_TEMP_DAILY_AVE) ;
-  bool precip_temp_gridded    = ForcingGridIsInput(F_PRECIP_TEMP)    ;
-
-  bool pet_gridded            = ForcingGridIsInput(F_PET)            && (Options.evaporation   ==PET_DATA);
-  bool owpet_gridded          = ForcingGridIsInput(F_OW_PET)         && (Options.ow_evaporation==PET_DATA);
-  bool windspeed_gridded      = ForcingGridIsInput(F_WIND_VEL)       && (Options.wind_velocity ==WINDVEL_DATA);
-  bool relhum_gridded         = ForcingGridIsInput(F_REL_HUMIDITY)   && (Options.rel_humidity  ==RELHUM_DATA);
-  bool SWnet_gridded          = ForcingGridIsInput(F_SW_RADIA_NET)   && (Options.SW_radia_net  ==NETSWRAD_DATA);
-  bool LWinc_gridded          = ForcingGridIsInput(F_LW_INCOMING)    && (Options.LW_incoming   ==LW_INC_DATA);
-  bool SW_gridded             = ForcingGridIsInput(F_SW_RADIA)       && (Options.SW_radiation  ==SW_RAD_DATA);
-  bool recharge_gridded       = ForcingGridIsInput(F_RECHARGE)       && (Options.recharge      ==RECHARGE_DATA);
+  //resolve gridded forcing sources (only rebuilt if forcing grids have changed)
+  if(!_ForcingPlan.valid) { BuildForcingPlan(Options); }
+  const forcing_plan &P=_ForcingPlan;
+
+  //-------------------------------------------------------------------
+  //  Read gridded data
+  //  (actually new chunk is only read if timestep is not covered by old chunk anymore)
+  //-------------------------------------------------------------------
+  bool new_chunk1,new_chunk2,new_chunk3,new_chunk4; // true if new chunk was read, otherwise false
+  if(P.precip_gridded)
+  {
+    new_chunk1 = new_chunk2 = new_chunk3 = false;
+    if(P.pre_input)  { new_chunk1 = P.pGrid_pre-> ReadData(Options,t); }
+    if(P.snow_input) { new_chunk2 = P.pGrid_snow->ReadData(Options,t); }
+    if(P.rain_input) { new_chunk3 = P.pGrid_rain->ReadData(Options,t); }
+
+    // populate derived data from the ones just read (e.g., precip -> (rain,snow), or (rain,snow)->(precip)
+    if(new_chunk1 || new_chunk2 || new_chunk3) {
+      GenerateGriddedPrecipVars(Options);//only call if new data chunk found
+      BuildForcingPlan(Options);
+    }
+  }
+  if(P.temp_gridded)
+  {
+    new_chunk1 = new_chunk2 = new_chunk3 = new_chunk4 = false;
+    if(P.tave_input)       { new_chunk1 =       P.pGrid_tave->ReadData(Options,t); }
+    if(P.daily_tave_input) { new_chunk2 = P.pGrid_daily_tave->ReadData(Options,t); }
+    if(P.daily_tmin_input) { new_chunk3 = P.pGrid_daily_tmin->ReadData(Options,t); }
+    if(P.daily_tmax_input) { new_chunk4 = P.pGrid_daily_tmax->ReadData(Options,t); }
+
+    // populate derived data from the ones just read
+    if(new_chunk1 || new_chunk2 || new_chunk3 || new_chunk4) {
+      GenerateGriddedTempVars(Options);//only generate if new data chunk found
+      BuildForcingPlan(Options);
+    }
+    if(new_chunk3!=new_chunk4) {
+      ExitGracefully("CModel::UpdateHRUForcingFunctions: Gridded Min and max temperature have to have same time discretization.",BAD_DATA);
+    }
+  }
+  for(i=0;i<P.nAuxGrids;i++) {
+    P.pAuxGrid[i]->ReadData(Options,t);
+  }
 
   //Extract data from gauge time series
   for (g=0;g<_nGauges;g++)
   {
     ZeroOutForcings(Fg[g]);
 
-    if ( !(pre_gridded || snow_gridded || rain_gridded) )
+    if (!P.precip_gridded)
     {
       if(_pGauges[g]->TimeSeriesExists(F_PRECIP)){//if precip exists, others exist
         Fg[g].precip          =_pGauges[g]->GetForcingValue(F_PRECIP,nn);     //mm/d
@@ -103,7 +110,7 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
         Fg[g].snow_frac       =_pGauges[g]->GetAverageSnowFrac(nn);
       }
     }
-    if ( !(temp_daily_min_gridded && temp_daily_max_gridded) )
+    if (!P.minmax_gridded)
     {
       if(_pGauges[g]->TimeSeriesExists(F_TEMP_AVE)){//if temp_ave exists, others exist
         Fg[g].temp_ave        =_pGauges[g]->GetForcingValue(F_TEMP_AVE,nn);
@@ -148,37 +155,54 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
   if (_nGauges > 0) {g_debug_vars[4]=_pGauges[0]->GetElevation(); }//UBCWM RFS Emulation cheat
 
   //Generate HRU-specific forcings from gauge data
+  // HRUs are processed in blocks (one HRU at a time or, with :BatchForcingUpdate, all HRUs at once).
+  // Forcings of the block are held in the structure-of-arrays forcing store between stages,
+  // so that temperature, sub-daily and snow fraction corrections treat the whole block in one pass
   //---------------------------------------------------------------------
-  double ref_elev_temp;
-  double ref_elev_precip;
-  double ref_measurement_ht; //m above land surface
-  for (k = 0; k < _nHydroUnits; k++)
+  double ref_elev_temp     =0.0;
+  double ref_elev_precip   =0.0;
+  double ref_measurement_ht=0.0; //m above land surface
+  int    kk,kstart,kend;
+  forcing_store &S=_ForcingStore;
+  if(S.nHRUs!=_nHydroUnits) { S.Allocate(_nHydroUnits); }
+  bool batch=Options.batch_forcings; //otherwise, each HRU is processed in F alone and store is not used
+  int  block_size=(batch) ? _nHydroUnits : 1;
+
+  for (kstart = 0; kstart < _nHydroUnits; kstart+=block_size)
   {
-    elev  = _pHydroUnits[k]->GetElevation();
-
-    ZeroOutForcings(F);
-    ref_elev_temp=ref_elev_precip=0.0;
-    ref_measurement_ht=0.0;
+    kend=min(kstart+block_size,_nHydroUnits);
+    S.nActive=0;
 
-    //not gauge-based
-    if(tt.day_changed)
+    //-------------------------------------------------------------------
+    //  Interpolation from gauges/grids, gauge temperature corrections
+    //-------------------------------------------------------------------
+    for (k = kstart; k < kend; k++)
     {
-      F.day_angle  = CRadiation::DayAngle(mid_day,yr,Options.calendar);
-      F.day_length = CRadiation::DayLength(_pHydroUnits[k]->GetLatRad(),CRadiation::SolarDeclination(F.day_angle));
-    }
+      elev  = _pHydroUnits[k]->GetElevation();
 
-    if(_pHydroUnits[k]->IsEnabled())
-    {
-      ApplyLocalParamOverrrides(k,false);
+      ZeroOutForcings(F);
+      ref_elev_temp=ref_elev_precip=0.0;
+      ref_measurement_ht=0.0;
 
-      //interpolate forcing values from gauges
-      //-------------------------------------------------------------------
-      for(g = 0; g < _nGauges; g++)
+      //not gauge-based
+      if(tt.day_changed)
       {
-        wt=_aGaugeWtPrecip[k][g];
-        if(wt != 0.0) {
-          if(!(pre_gridded || snow_gridded || rain_gridded))
+        F.day_angle  = CRadiation::DayAngle(mid_day,yr,Options.calendar);
+        F.day_length = CRadiation::DayLength(_pHydroUnits[k]->GetLatRad(),CRadiation::SolarDeclination(F.day_angle));
+      }
+
+      if(_pHydroUnits[k]->IsEnabled())
+      {
+        ApplyLocalParamOverrrides(k,false);
+
+        //interpolate forcing values from gauges (only non-zero weights are stored)
+        //-------------------------------------------------------------------
+        if(!P.precip_gridded)
+        {
+          for(i = _GaugeWtPrecip.RowBegin(k); i < _GaugeWtPrecip.RowEnd(k); i++)
           {
+            g =_GaugeWtPrecip.cols[i];
+            wt=_GaugeWtPrecip.wts [i];
             F.precip           += wt * Fg[g].precip;
             F.precip_daily_ave += wt * Fg[g].precip_daily_ave;
             F.precip_5day      += wt * Fg[g].precip_5day;
@@ -186,10 +210,12 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
             ref_elev_precip    += wt * _pGauges[g]->GetElevation();
           }
         }
-        wt=_aGaugeWtTemp[k][g];
-        if(wt != 0.0) {
-          if(!(temp_ave_gridded || (temp_daily_min_gridded && temp_daily_max_gridded) || temp_daily_ave_gridded))
+        if(!P.temp_gridded)
+        {
+          for(i = _GaugeWtTemp.RowBegin(k); i < _GaugeWtTemp.RowEnd(k); i++)
           {
+            g =_GaugeWtTemp.cols[i];
+            wt=_GaugeWtTemp.wts [i];
             F.temp_ave         += wt * Fg[g].temp_ave;
             F.temp_daily_ave   += wt * Fg[g].temp_daily_ave;
             F.temp_daily_min   += wt * Fg[g].temp_daily_min;
@@ -200,8 +226,10 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
             ref_elev_temp      += wt * _pGauges[g]->GetElevation();
           }
         }
-        wt=_aGaugeWeights[k][g];
-        if(wt != 0.0) {
+        for(i = _GaugeWeights.RowBegin(k); i < _GaugeWeights.RowEnd(k); i++)
+        {
+          g =_GaugeWeights.cols[i];
+          wt=_GaugeWeights.wts [i];
           F.rel_humidity   += wt * Fg[g].rel_humidity;
           F.air_pres       += wt * Fg[g].air_pres;
           F.air_dens       += wt * Fg[g].air_dens;
@@ -221,232 +249,115 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
           F.precip_temp    += wt * Fg[g].precip_temp;
           ref_measurement_ht+=wt*_pGauges[g]->GetMeasurementHt();
         }
-      }
-
-      // if in BMI without RVT file, precip and temp values are expected to have been given before this point
-      if (Options.in_bmi_mode && !rvt_file_provided) {
-        F.precip           = _pHydroUnits[k]->GetForcingFunctions()->precip + 0.0;
-        F.precip_daily_ave = _pHydroUnits[k]->GetForcingFunctions()->precip + 0.0;  // TODO: check
-        F.precip_5day      = F.precip * 5;                                          // TODO: check
-        F.temp_ave         = _pHydroUnits[k]->GetForcingFunctions()->temp_ave + 0.0;
-      }
 
-      //-------------------------------------------------------------------
-      //  Gridded data support
-      //-------------------------------------------------------------------
-      bool   new_chunk1;                                // true if new chunk was read, otherwise false
-      bool   new_chunk2;                                // true if new chunk was read, otherwise false
-      bool   new_chunk3;                                // true if new chunk was read, otherwise false
-      bool   new_chunk4;                                // true if new chunk was read, otherwise false
-
-      //Override forcing functions with gridded data, if present
-      // see if gridded forcing is available (either from NetCDF or derived)
-      pre_gridded            = ForcingGridIsInput(F_PRECIP);
-      rain_gridded           = ForcingGridIsInput(F_RAINFALL);
-      snow_gridded           = ForcingGridIsInput(F_SNOWFALL);
-      pet_gridded            = ForcingGridIsInput(F_PET);
-      owpet_gridded          = ForcingGridIsInput(F_OW_PET);
-      windspeed_gridded      = ForcingGridIsInput(F_WIND_VEL);
-      relhum_gridded         = ForcingGridIsInput(F_REL_HUMIDITY);
-      SWnet_gridded          = ForcingGridIsInput(F_SW_RADIA_NET);
-      LWinc_gridded          = ForcingGridIsInput(F_LW_INCOMING);
-      SW_gridded             = ForcingGridIsInput(F_SW_RADIA);
-      temp_ave_gridded       = ForcingGridIsInput(F_TEMP_AVE);
-      temp_daily_min_gridded = ForcingGridIsInput(F_TEMP_DAILY_MIN);
-      temp_daily_max_gridded = ForcingGridIsInput(F_TEMP_DAILY_MAX);
-      temp_daily_ave_gridded = ForcingGridIsInput(F_TEMP_DAILY_AVE);
-      recharge_gridded       = ForcingGridIsInput(F_RECHARGE);
-      precip_temp_gridded    = ForcingGridIsInput(F_PRECIP_TEMP);
-
-      // find the correct grid
-      if(pre_gridded)             { pGrid_pre         = GetForcingGrid(F_PRECIP); }
-      if(rain_gridded)            { pGrid_rain        = GetForcingGrid(F_RAINFALL); }
-      if(snow_gridded)            { pGrid_snow        = GetForcingGrid(F_SNOWFALL); }
-      if(pet_gridded)             { pGrid_pet         = GetForcingGrid(F_PET); }
-      if(owpet_gridded)           { pGrid_owpet       = GetForcingGrid(F_OW_PET); }
-      if(windspeed_gridded)       { pGrid_windspeed   = GetForcingGrid(F_WIND_VEL); }
-      if(relhum_gridded)          { pGrid_relhum      = GetForcingGrid(F_REL_HUMIDITY); }
-      if(SWnet_gridded)           { pGrid_SW_net      = GetForcingGrid(F_SW_RADIA_NET); }
-      if(LWinc_gridded)           { pGrid_LW_inc      = GetForcingGrid(F_LW_INCOMING); }
-      if(SW_gridded)              { pGrid_SW          = GetForcingGrid(F_SW_RADIA); }
-      if(temp_ave_gridded)        { pGrid_tave        = GetForcingGrid(F_TEMP_AVE); }
-      if(temp_daily_min_gridded)  { pGrid_daily_tmin  = GetForcingGrid(F_TEMP_DAILY_MIN); }
-      if(temp_daily_max_gridded)  { pGrid_daily_tmax  = GetForcingGrid(F_TEMP_DAILY_MAX); }
-      if(temp_daily_ave_gridded)  { pGrid_daily_tave  = GetForcingGrid(F_TEMP_DAILY_AVE); }
-      if(recharge_gridded)        { pGrid_recharge    = GetForcingGrid(F_RECHARGE); }
-      if(precip_temp_gridded)     { pGrid_precip_temp = GetForcingGrid(F_PRECIP_TEMP); }
-
-      // ---------------------
-      // (1A) read gridded precip/snowfall/rainfall and populate additional time series
-      // ---------------------
-      if(pre_gridded || snow_gridded || rain_gridded)
-      {
-        // read data (actually new chunk is only read if timestep is not covered by old chunk anymore)
-        new_chunk1 = false; new_chunk2 = false; new_chunk3 = false;
-        if(pre_gridded)  { new_chunk1 = pGrid_pre-> ReadData(Options,tt.model_time); }
-        if(snow_gridded) { new_chunk2 = pGrid_snow->ReadData(Options,tt.model_time); }
-        if(rain_gridded) { new_chunk3 = pGrid_rain->ReadData(Options,tt.model_time); }
-
-        // populate derived data from the ones just read (e.g., precip -> (rain,snow), or (rain,snow)->(precip)
-        if(new_chunk1 || new_chunk2 || new_chunk3) {
-          GenerateGriddedPrecipVars(Options);//only call if new data chunk found
+        // if in BMI without RVT file, precip and temp values are expected to have been given before this point
+        if (Options.in_bmi_mode && !rvt_file_provided) {
+          F.precip           = _pHydroUnits[k]->GetForcingFunctions()->precip + 0.0;
+          F.precip_daily_ave = _pHydroUnits[k]->GetForcingFunctions()->precip + 0.0;  // TODO: check
+          F.precip_5day      = F.precip * 5;                                          // TODO: check
+          F.temp_ave         = _pHydroUnits[k]->GetForcingFunctions()->temp_ave + 0.0;
         }
 
-        pGrid_pre  = GetForcingGrid((F_PRECIP));
-        pGrid_rain = GetForcingGrid((F_RAINFALL));
-        pGrid_snow = GetForcingGrid((F_SNOWFALL));
+        //-------------------------------------------------------------------
+        //  Gridded data support (grids already read above)
+        //-------------------------------------------------------------------
+        if(P.precip_gridded)
+        {
+          F.precip           = P.pGrid_pre->GetWeightedValue(k,t,Options.timestep);
+          F.precip_daily_ave = P.pGrid_pre->GetDailyWeightedValue(k,t,Options.timestep,Options);
+          F.snow_frac        = P.pGrid_snow->GetWeightedAverageSnowFrac(k,t,Options.timestep,P.pGrid_rain);
+          F.precip_5day      = NETCDF_BLANK_VALUE;
 
-        F.precip           = pGrid_pre->GetWeightedValue(k,tt.model_time,Options.timestep);
-        F.precip_daily_ave = pGrid_pre->GetDailyWeightedValue(k,tt.model_time,Options.timestep,Options);
-        F.snow_frac        = pGrid_snow->GetWeightedAverageSnowFrac(k,tt.model_time,Options.timestep,pGrid_rain);
-        F.precip_5day      = NETCDF_BLANK_VALUE;
+          ref_elev_precip    = P.pGrid_pre->GetRefElevation(k);
+          if(ref_elev_precip==RAV_BLANK_DATA) { ref_elev_precip = elev; } //disabling orographic effects if no elevation given (warning in Forcing grid init)
+        }
+        if(P.temp_gridded)
+        {
+          F.temp_ave         = P.pGrid_tave      ->GetWeightedValue(k,t,Options.timestep);
+          F.temp_daily_ave   = P.pGrid_daily_tave->GetWeightedValue(k,t,Options.timestep);
+          F.temp_daily_min   = P.pGrid_daily_tmin->GetWeightedValue(k,t,Options.timestep);
+          F.temp_daily_max   = P.pGrid_daily_tmax->GetWeightedValue(k,t,Options.timestep);
 
-        ref_elev_precip    = pGrid_pre->GetRefElevation(k);
-        if(ref_elev_precip==RAV_BLANK_DATA) { ref_elev_precip = _pHydroUnits[k]->GetElevation(); } //disabling orographic effects if no elevation given (warning in Forcing grid init)
-      }
+          F.temp_month_ave   = NOT_SPECIFIED;
+          F.temp_month_min   = NOT_SPECIFIED;
+          F.temp_month_max   = NOT_SPECIFIED;
 
-      // ---------------------
-      // (2a) read gridded temperature (average or min/max) and populate additional time series
-      // ---------------------
-      if(temp_ave_gridded || (temp_daily_min_gridded && temp_daily_max_gridded) || temp_daily_ave_gridded)
-      {
-        // read data (actually new chunk is only read if timestep is not covered by old chunk anymore)
-        new_chunk1 = new_chunk2 = new_chunk3 = new_chunk4 = false;
-        if(temp_ave_gridded)       { new_chunk1 =       pGrid_tave->ReadData(Options,tt.model_time); }
-        if(temp_daily_ave_gridded) { new_chunk2 = pGrid_daily_tave->ReadData(Options,tt.model_time); }
-        if(temp_daily_min_gridded) { new_chunk3 = pGrid_daily_tmin->ReadData(Options,tt.model_time); }
-        if(temp_daily_max_gridded) { new_chunk4 = pGrid_daily_tmax->ReadData(Options,tt.model_time); }
-
-        // populate derived data from the ones just read
-        if(new_chunk1 || new_chunk2 || new_chunk3 || new_chunk4) {
-          GenerateGriddedTempVars(Options);//only generate if new data chunk found
+          ref_elev_temp      = P.pGrid_tave->GetRefElevation(k);
+          if(ref_elev_temp==RAV_BLANK_DATA) { ref_elev_temp = elev; } //disabling orographic effects if no elevation given (warning in Forcing grid init)
         }
-        if(new_chunk3!=new_chunk4) {
-          ExitGracefully("CModel::UpdateHRUForcingFunctions: Gridded Min and max temperature have to have same time discretization.",BAD_DATA);
+        for(i=0;i<P.nAuxGrids;i++) { //recharge, PET, radiation, etc.
+          F.*(P.aAuxField[i]) = P.pAuxGrid[i]->GetWeightedValue(k,t,Options.timestep);
         }
 
-        pGrid_tave       = GetForcingGrid((F_TEMP_AVE));
-        pGrid_daily_tave = GetForcingGrid((F_TEMP_DAILY_AVE));
-        pGrid_daily_tmin = GetForcingGrid((F_TEMP_DAILY_MIN));
-        pGrid_daily_tmax = GetForcingGrid((F_TEMP_DAILY_MAX));
-
-        F.temp_ave         = pGrid_tave      ->GetWeightedValue(k,tt.model_time,Options.timestep);
-        F.temp_daily_ave   = pGrid_daily_tave->GetWeightedValue(k,tt.model_time,Options.timestep);
-        F.temp_daily_min   = pGrid_daily_tmin->GetWeightedValue(k,tt.model_time,Options.timestep);
-        F.temp_daily_max   = pGrid_daily_tmax->GetWeightedValue(k,tt.model_time,Options.timestep);
+        //-------------------------------------------------------------------
+        //  Temperature Corrections
+        //-------------------------------------------------------------------
+        double tc;
+        int p = _pHydroUnits[k]->GetSubBasinIndex();
+        tc = _pSubBasins[p]->GetTemperatureCorrection();
 
-        F.temp_month_ave   = NOT_SPECIFIED;
-        F.temp_month_min   = NOT_SPECIFIED;
-        F.temp_month_max   = NOT_SPECIFIED;
+        //--Gauge Corrections------------------------------------------------
+        if (Options.in_bmi_mode && !rvt_file_provided)  // temperature was given by the BMI and no gauge corrections are to be applied
+        {
+          F.temp_daily_ave = F.temp_daily_max = F.temp_daily_min = F.temp_ave;  // TODO: check if this is acceptable
+        }
+        else if (!P.temp_gridded) //Gauge Data
+        {
+            double gauge_corr;
+            F.temp_ave = F.temp_daily_ave = F.temp_daily_max = F.temp_daily_min = 0.0; // leave out monthly for now
+            for (i = _GaugeWtTemp.RowBegin(k); i < _GaugeWtTemp.RowEnd(k); i++)
+            {
+                g  = _GaugeWtTemp.cols[i];
+                wt = _GaugeWtTemp.wts [i];
+                gauge_corr = tc + _pGauges[g]->GetTemperatureCorr();
+
+                F.temp_ave       += wt * (gauge_corr + Fg[g].temp_ave);
+                F.temp_daily_ave += wt * (gauge_corr + Fg[g].temp_daily_ave);
+                F.temp_daily_max += wt * (gauge_corr + Fg[g].temp_daily_max);
+                F.temp_daily_min += wt * (gauge_corr + Fg[g].temp_daily_min);
+
+            }
+        }
+        else //Gridded Data
+        {
+            double grid_corr = tc + P.temp_corr;
+            if (grid_corr!=0.0){
+              F.temp_ave       += grid_corr;
+              F.temp_daily_ave += grid_corr;
+              F.temp_daily_max += grid_corr;
+              F.temp_daily_min += grid_corr;
+            }
+        }
 
-        ref_elev_temp      = pGrid_tave->GetRefElevation(k);
-        if(ref_elev_temp==RAV_BLANK_DATA) { ref_elev_temp = _pHydroUnits[k]->GetElevation(); } //disabling orographic effects if no elevation given (warning in Forcing grid init)
-      }
+        F.temp_ave_unc = F.temp_daily_ave;
+        F.temp_min_unc = F.temp_daily_min;
+        F.temp_max_unc = F.temp_daily_max;
 
-      // ---------------------
-      // (3) read gridded recharge
-      // ---------------------
-      if(recharge_gridded)
-      {
-        pGrid_recharge   = GetForcingGrid(F_RECHARGE);
-        pGrid_recharge-> ReadData(Options,tt.model_time);
-        F.recharge   = pGrid_recharge->GetWeightedValue(k,tt.model_time,Options.timestep);
-      }
-      // ---------------------
-      // (4) read gridded precipitation temperature
-      // ---------------------
-      if(precip_temp_gridded)
-      {
-        pGrid_precip_temp   = GetForcingGrid(F_PRECIP_TEMP);
-        pGrid_precip_temp-> ReadData(Options,tt.model_time);
-        F.precip_temp   = pGrid_precip_temp->GetWeightedValue(k,tt.model_time,Options.timestep);
-      }
-      // ---------------------
-      // (5) read gridded PET, Others
-      // ---------------------
-      if(pet_gridded)
-      {
-        pGrid_pet   = GetForcingGrid(F_PET);
-        pGrid_pet-> ReadData(Options,tt.model_time);
-        F.PET   = pGrid_pet->GetWeightedValue(k,tt.model_time,Options.timestep);
-        cout<<"reading gridded PET"<<endl;
-      }
-      if(owpet_gridded) {
-        pGrid_owpet   = GetForcingGrid(F_OW_PET);
-        pGrid_owpet-> ReadData(Options,tt.model_time);
-        F.OW_PET   = pGrid_owpet->GetWeightedValue(k,tt.model_time,Options.timestep);
-      }
-      if (windspeed_gridded) {
-        pGrid_windspeed = GetForcingGrid(F_WIND_VEL);
-        pGrid_windspeed->ReadData(Options, tt.model_time);
-        F.wind_vel = pGrid_windspeed->GetWeightedValue(k, tt.model_time, Options.timestep);
-      }
-      if (relhum_gridded) {
-        pGrid_relhum = GetForcingGrid(F_REL_HUMIDITY);
-        pGrid_relhum->ReadData(Options, tt.model_time);
-        F.rel_humidity = pGrid_relhum->GetWeightedValue(k, tt.model_time, Options.timestep);
-      }
-      if (SWnet_gridded) {
-        pGrid_SW_net = GetForcingGrid(F_SW_RADIA_NET);
-        pGrid_SW_net->ReadData(Options, tt.model_time);
-        F.SW_radia_net = pGrid_SW_net->GetWeightedValue(k, tt.model_time, Options.timestep);
-      }
-      if (LWinc_gridded) {
-        pGrid_LW_inc = GetForcingGrid(F_LW_INCOMING);
-        pGrid_LW_inc->ReadData(Options, tt.model_time);
-        F.LW_incoming = pGrid_LW_inc->GetWeightedValue(k, tt.model_time, Options.timestep);
+        ApplyLocalParamOverrrides(k,true);
+        S.active[S.nActive]=k;
+        S.nActive++;
       }
-      if (SW_gridded) {
-        pGrid_SW = GetForcingGrid(F_SW_RADIA);
-        pGrid_SW->ReadData(Options, tt.model_time);
-        F.SW_radia = pGrid_SW->GetWeightedValue(k, tt.model_time, Options.timestep);
+      if(batch) {
+        S.elev           [k]=elev;
+        S.ref_elev_temp  [k]=ref_elev_temp;
+        S.ref_elev_precip[k]=ref_elev_precip;
+        S.ref_meas_ht    [k]=ref_measurement_ht;
+        S.Store(k,F);
       }
+    }
 
-      //-------------------------------------------------------------------
-      //  Temperature Corrections
-      //-------------------------------------------------------------------
-      double tc;
-      int p = _pHydroUnits[k]->GetSubBasinIndex();
-      tc = _pSubBasins[p]->GetTemperatureCorrection();
-
-      //--Gauge Corrections------------------------------------------------
-      if (Options.in_bmi_mode && !rvt_file_provided)  // temperature was given by the BMI and no gauge corrections are to be applied
-      {
-        F.temp_daily_ave = F.temp_daily_max = F.temp_daily_min = F.temp_ave;  // TODO: check if this is acceptable
-      }
-      else if (!(temp_ave_gridded || (temp_daily_min_gridded && temp_daily_max_gridded) || temp_daily_ave_gridded)) //Gauge Data
-      {
-          double gauge_corr;
-          F.temp_ave = F.temp_daily_ave = F.temp_daily_max = F.temp_daily_min = 0.0; // leave out monthly for now
-          for (g = 0; g < _nGauges; g++)
-          {
-              gauge_corr = tc + _pGauges[g]->GetTemperatureCorr();
-              wt = _aGaugeWtTemp[k][g];
-
-              F.temp_ave       += wt * (gauge_corr + Fg[g].temp_ave);
-              F.temp_daily_ave += wt * (gauge_corr + Fg[g].temp_daily_ave);
-              F.temp_daily_max += wt * (gauge_corr + Fg[g].temp_daily_max);
-              F.temp_daily_min += wt * (gauge_corr + Fg[g].temp_daily_min);
-
-          }
-      }
-      else //Gridded Data
-      {
-          double grid_corr;
-          grid_corr = pGrid_pre->GetTemperatureCorr();
-          if ((tc+grid_corr)!=0.0){
-            F.temp_ave       += tc + grid_corr;
-            F.temp_daily_ave += tc + grid_corr;
-            F.temp_daily_max += tc + grid_corr;
-            F.temp_daily_min += tc + grid_corr;
-          }
-      }
+    //-------------------------------------------------------------------
+    //  Orographic temperature corrections
+    //-------------------------------------------------------------------
+    if(batch) { CorrectTempBatch(Options,tt); }
 
-      F.temp_ave_unc = F.temp_daily_ave;
-      F.temp_min_unc = F.temp_daily_min;
-      F.temp_max_unc = F.temp_daily_max;
+    for (kk = 0; kk < S.nActive; kk++)
+    {
+      k=S.active[kk];
+      if(batch) { S.Load(k,F); }
+      ApplyLocalParamOverrrides(k,false);
 
-      CorrectTemp(Options,F,elev,ref_elev_temp,tt);
+      if(!batch) { CorrectTemp(Options,F,elev,ref_elev_temp,tt); }
 
       ApplyForcingPerturbation(F_TEMP_AVE, F, k, Options, tt);
 
@@ -458,148 +369,178 @@ void CModel::UpdateHRUForcingFunctions(const optStruct &Options,
         _pHydroUnits[k]->CopyDailyForcings(F);
       }
 
-      //-------------------------------------------------------------------
-      //  Subdaily Corrections
-      //-------------------------------------------------------------------
-      // always calculated, never from gauge
-      F.subdaily_corr = CalculateSubDailyCorrection(F,Options,elev,ref_elev_temp,tt,k);
+      ApplyLocalParamOverrrides(k,true);
+      if(batch) { S.Store(k,F); }
+    }
+
+    //-------------------------------------------------------------------
+    //  Subdaily Corrections
+    //-------------------------------------------------------------------
+    // always calculated, never from gauge
+    if(batch) { CalculateSubDailyCorrectionBatch(Options,tt); }
+
+    //-------------------------------------------------------------------
+    //  Air Pressure, Density, relative humidity
+    //-------------------------------------------------------------------
+    for (kk = 0; kk < S.nActive; kk++)
+    {
+      k=S.active[kk];
+      if(batch) { S.Load(k,F); elev=S.elev[k]; }
+      ApplyLocalParamOverrrides(k,false);
+
+      if(!batch) { F.subdaily_corr = CalculateSubDailyCorrection(F,Options,elev,ref_elev_temp,tt,k); }
 
-      //-------------------------------------------------------------------
-      //  Air Pressure, Density, relative humidity
-      //-------------------------------------------------------------------
       F.air_pres = EstimateAirPressure(Options.air_pressure,F,elev);
 
       F.air_dens = GetAirDensity(F.temp_ave,F.air_pres);
 
       F.rel_humidity = EstimateRelativeHumidity(Options.rel_humidity,F);
 
-      //-------------------------------------------------------------------
-      // Snow fraction Calculations
-      //-------------------------------------------------------------------
-      F.snow_frac =EstimateSnowFraction(Options.rainsnow,_pHydroUnits[k],&F,Options);
+      ApplyLocalParamOverrrides(k,true);
+      if(batch) { S.Store(k,F); }
+    }
 
-      //-------------------------------------------------------------------
-      //  Precip Corrections
-      //-------------------------------------------------------------------
-      double rc,sc;
-      // int p=_pHydroUnits[k]->GetSubBasinIndex(); // defined for temp correction already
-      rc=_pSubBasins[p]->GetRainCorrection();
-      sc=_pSubBasins[p]->GetSnowCorrection();
+    //-------------------------------------------------------------------
+    // Snow fraction Calculations
+    //-------------------------------------------------------------------
+    if(batch) { EstimateSnowFractionBatch(Options); }
 
-      //--Gauge Corrections------------------------------------------------
-      if(!(pre_gridded || snow_gridded || rain_gridded)) //Gauge or BMI-injected Data
+    for (k = kstart; k < kend; k++)
+    {
+      if(batch) { S.Load(k,F); }
+      if(_pHydroUnits[k]->IsEnabled())
       {
-        double gauge_corr;
-        F.precip=F.precip_5day=F.precip_daily_ave=0.0;
-        if ((!Options.in_bmi_mode) || rvt_file_provided) {
-          // Gauge-based precip and snowfall correction
-          for(g=0; g<_nGauges; g++)
-          {
-            gauge_corr= F.snow_frac*sc*_pGauges[g]->GetSnowfallCorr() + (1.0-F.snow_frac)*rc*_pGauges[g]->GetRainfallCorr();
-            wt=_aGaugeWtPrecip[k][g];
-            F.precip         += wt*gauge_corr*Fg[g].precip;
-            F.precip_daily_ave+=wt*gauge_corr*Fg[g].precip_daily_ave;
-            F.precip_5day    += wt*gauge_corr*Fg[g].precip_5day;
+        if(batch) {
+          elev              =S.elev           [k];
+          ref_elev_temp     =S.ref_elev_temp  [k];
+          ref_elev_precip   =S.ref_elev_precip[k];
+          ref_measurement_ht=S.ref_meas_ht    [k];
+        }
+        ApplyLocalParamOverrrides(k,false);
+
+        if(!batch) { F.snow_frac = EstimateSnowFraction(Options.rainsnow,_pHydroUnits[k],&F,Options); }
+
+        //-------------------------------------------------------------------
+        //  Precip Corrections
+        //-------------------------------------------------------------------
+        double rc,sc;
+        int p=_pHydroUnits[k]->GetSubBasinIndex();
+        rc=_pSubBasins[p]->GetRainCorrection();
+        sc=_pSubBasins[p]->GetSnowCorrection();
+
+        //--Gauge Corrections------------------------------------------------
+        if(!P.precip_gridded) //Gauge or BMI-injected Data
+        {
+          double gauge_corr;
+          F.precip=F.precip_5day=F.precip_daily_ave=0.0;
+          if ((!Options.in_bmi_mode) || rvt_file_provided) {
+            // Gauge-based precip and snowfall correction
+            for(i=_GaugeWtPrecip.RowBegin(k); i<_GaugeWtPrecip.RowEnd(k); i++)
+            {
+              g =_GaugeWtPrecip.cols[i];
+              wt=_GaugeWtPrecip.wts [i];
+              gauge_corr= F.snow_frac*sc*_pGauges[g]->GetSnowfallCorr() + (1.0-F.snow_frac)*rc*_pGauges[g]->GetRainfallCorr();
+              F.precip         += wt*gauge_corr*Fg[g].precip;
+              F.precip_daily_ave+=wt*gauge_corr*Fg[g].precip_daily_ave;
+              F.precip_5day    += wt*gauge_corr*Fg[g].precip_5day;
+            }
+          }
+  		else {
+            // Gauge-less precip and snowfall correction
+            gauge_corr         = (F.snow_frac * sc) + ((1.0-F.snow_frac)*rc);
+            F.precip           = gauge_corr * _pHydroUnits[k]->GetForcingFunctions()->precip;
+            F.precip_daily_ave = gauge_corr * _pHydroUnits[k]->GetForcingFunctions()->precip;  // TODO: check if this is acceptable
+            F.precip_5day      = gauge_corr * _pHydroUnits[k]->GetForcingFunctions()->precip * 5;   // TODO: check if this is acceptable
           }
         }
-		else {
-          // Gauge-less precip and snowfall correction
-          gauge_corr         = (F.snow_frac * sc) + ((1.0-F.snow_frac)*rc);
-          F.precip           = gauge_corr * _pHydroUnits[k]->GetForcingFunctions()->precip;
-          F.precip_daily_ave = gauge_corr * _pHydroUnits[k]->GetForcingFunctions()->precip;  // TODO: check if this is acceptable
-          F.precip_5day      = gauge_corr * _pHydroUnits[k]->GetForcingFunctions()->precip * 5;   // TODO: check if this is acceptable
+        else //Gridded Data
+        {
+          double grid_corr;
+          grid_corr= F.snow_frac*sc*P.snow_corr + (1.0-F.snow_frac)*rc*P.rain_corr;
+
+          F.precip          *=grid_corr;
+          F.precip_daily_ave*=grid_corr;
+          F.precip_5day      =NETCDF_BLANK_VALUE;
         }
-      }
-      else //Gridded Data
-      {
-        double grid_corr;
-        double rain_corr=pGrid_pre->GetRainfallCorr();
-        double snow_corr=pGrid_pre->GetSnowfallCorr();
-        grid_corr= F.snow_frac*sc*snow_corr + (1.0-F.snow_frac)*rc*rain_corr;
-
-        F.precip          *=grid_corr;
-        F.precip_daily_ave*=grid_corr;
-        F.precip_5day      =NETCDF_BLANK_VALUE;
-      }
 
-      //--Orographic corrections-------------------------------------------
-      CorrectPrecip(Options,F,elev,ref_elev_precip,k,tt);
+        //--Orographic corrections-------------------------------------------
+        CorrectPrecip(Options,F,elev,ref_elev_precip,k,tt);
 
-      ApplyForcingPerturbation(F_PRECIP  , F, k, Options, tt);
-      ApplyForcingPerturbation(F_RAINFALL, F, k, Options, tt);
-      ApplyForcingPerturbation(F_SNOWFALL, F, k, Options, tt);
+        ApplyForcingPerturbation(F_PRECIP  , F, k, Options, tt);
+        ApplyForcingPerturbation(F_RAINFALL, F, k, Options, tt);
+        ApplyForcingPerturbation(F_SNOWFALL, F, k, Options, tt);
 
-      //-------------------------------------------------------------------
-      //  Wind Velocity
-      //-------------------------------------------------------------------
+        //-------------------------------------------------------------------
+        //  Wind Velocity
+        //-------------------------------------------------------------------
 
-      F.wind_vel = EstimateWindVelocity(Options,_pHydroUnits[k],F,ref_measurement_ht,k);
+        F.wind_vel = EstimateWindVelocity(Options,_pHydroUnits[k],F,ref_measurement_ht,k);
 
-      //ApplyForcingPerturbation(F_WIND_VEL, F, k, Options, tt);
+        //ApplyForcingPerturbation(F_WIND_VEL, F, k, Options, tt);
 
-      //-------------------------------------------------------------------
-      //  Cloud Cover
-      //-------------------------------------------------------------------
+        //-------------------------------------------------------------------
+        //  Cloud Cover
+        //-------------------------------------------------------------------
 
-      F.cloud_cover = EstimateCloudCover(Options,F,k);
+        F.cloud_cover = EstimateCloudCover(Options,F,k);
 
-      //-------------------------------------------------------------------
-      //  Radiation Calculations
-      //-------------------------------------------------------------------
+        //-------------------------------------------------------------------
+        //  Radiation Calculations
+        //-------------------------------------------------------------------
 
-      F.SW_radia = CRadiation::EstimateShortwaveRadiation(Options,&F,_pHydroUnits[k],tt,F.ET_radia,F.ET_radia_flat);
-      F.SW_radia_unc = F.SW_radia;
-      F.SW_radia *= CRadiation::SWCloudCoverCorrection(Options,&F,elev);
+        F.SW_radia = CRadiation::EstimateShortwaveRadiation(Options,&F,_pHydroUnits[k],tt,F.ET_radia,F.ET_radia_flat);
+        F.SW_radia_unc = F.SW_radia;
+        F.SW_radia *= CRadiation::SWCloudCoverCorrection(Options,&F,elev);
 
-      F.SW_radia_subcan = F.SW_radia * CRadiation::SWCanopyCorrection(Options,_pHydroUnits[k]);
+        F.SW_radia_subcan = F.SW_radia * CRadiation::SWCanopyCorrection(Options,_pHydroUnits[k]);
 
-      if(Options.SW_radia_net == NETSWRAD_CALC) //(default)
-      {
-        F.SW_radia_net        = F.SW_radia       *(1-_pHydroUnits[k]->GetTotalAlbedo());
-//      F.SW_radia_subcan_net = F.SW_radia_subcan*(1-_pHydroUnits[k]->GetLandAlbedo());
-      }//otherwise, uses data
+        if(Options.SW_radia_net == NETSWRAD_CALC) //(default)
+        {
+          F.SW_radia_net        = F.SW_radia       *(1-_pHydroUnits[k]->GetTotalAlbedo());
+  //      F.SW_radia_subcan_net = F.SW_radia_subcan*(1-_pHydroUnits[k]->GetLandAlbedo());
+        }//otherwise, uses data
 
-      F.LW_radia_net=CRadiation::EstimateLongwaveRadiation(GetStateVarIndex(SNOW),Options,&F,_pHydroUnits[k],F.LW_incoming);
+        F.LW_radia_net=CRadiation::EstimateLongwaveRadiation(GetStateVarIndex(SNOW),Options,&F,_pHydroUnits[k],F.LW_incoming);
 
-      //-------------------------------------------------------------------
-      //  Potential Melt Rate
-      //-------------------------------------------------------------------
+        //-------------------------------------------------------------------
+        //  Potential Melt Rate
+        //-------------------------------------------------------------------
 
-      F.potential_melt=EstimatePotentialMelt(&F,Options.pot_melt,Options,_pHydroUnits[k],tt);
+        F.potential_melt=EstimatePotentialMelt(&F,Options.pot_melt,Options,_pHydroUnits[k],tt);
 
-      //-------------------------------------------------------------------
-      //  PET Calculations
-      //-------------------------------------------------------------------
-      // last but not least - needs all of the forcing params calculated above
-      if(!pet_gridded) //Gauge Data
-      {
-        F.PET   =EstimatePET(F,_pHydroUnits[k],ref_measurement_ht,ref_elev_temp,Options.evaporation,Options,tt,false);
-      }
-      if (!owpet_gridded)
-      {
-        F.OW_PET=EstimatePET(F,_pHydroUnits[k],ref_measurement_ht,ref_elev_temp,Options.ow_evaporation,Options,tt,true);
-      }
-      CorrectPET(Options,F,_pHydroUnits[k],elev,ref_elev_temp,k);
+        //-------------------------------------------------------------------
+        //  PET Calculations
+        //-------------------------------------------------------------------
+        // last but not least - needs all of the forcing params calculated above
+        if(!P.pet_gridded) //Gauge Data
+        {
+          F.PET   =EstimatePET(F,_pHydroUnits[k],ref_measurement_ht,ref_elev_temp,Options.evaporation,Options,tt,false);
+        }
+        if (!P.owpet_gridded)
+        {
+          F.OW_PET=EstimatePET(F,_pHydroUnits[k],ref_measurement_ht,ref_elev_temp,Options.ow_evaporation,Options,tt,true);
+        }
+        CorrectPET(Options,F,_pHydroUnits[k],elev,ref_elev_temp,k);
+
+        //-------------------------------------------------------------------
+        // Direct evaporation of rainfall
+        //-------------------------------------------------------------------
+        if(Options.direct_evap) {
+          double reduce=min(F.PET,F.precip*(1.0-F.snow_frac));
+          if(F.precip-reduce>0.0) { F.snow_frac=1.0-(F.precip*(1.0-F.snow_frac)-reduce)/(F.precip-reduce); }
+          F.precip-=reduce;
+          F.PET   -=reduce;
+        }
+
+        ApplyLocalParamOverrrides(k,true);
+      }//end if (!_pHydroUnits[k]->IsDisabled())
 
       //-------------------------------------------------------------------
-      // Direct evaporation of rainfall
+      // Update
       //-------------------------------------------------------------------
-      if(Options.direct_evap) {
-        double reduce=min(F.PET,F.precip*(1.0-F.snow_frac));
-        if(F.precip-reduce>0.0) { F.snow_frac=1.0-(F.precip*(1.0-F.snow_frac)-reduce)/(F.precip-reduce); }
-        F.precip-=reduce;
-        F.PET   -=reduce;
-      }
-
-      ApplyLocalParamOverrrides(k,true);
-    }//end if (!_pHydroUnits[k]->IsDisabled())
-
-    //-------------------------------------------------------------------
-    // Update
-    //-------------------------------------------------------------------
-    _pHydroUnits[k]->UpdateForcingFunctions(F);
-
-  }//end for k=0; k<nHRUs...
+      _pHydroUnits[k]->UpdateForcingFunctions(F);
+    }
+  }//end for kstart=0; kstart<nHRUs...
 
    //delete static arrays (only called once)=========================
   if(t>=Options.duration-Options.timestep)
@@ -864,9 +805,10 @@ double CModel::EstimateCloudCover  (const optStruct &Options,
     double range=(F.temp_max_unc-F.temp_min_unc); //uses uncorrected station temperature
     double cloud_min_range(0.0),cloud_max_range(0.0);
 
-    for (int g=0;g<_nGauges;g++){
-      cloud_min_range+=_aGaugeWtTemp[k][g]*_pGauges[g]->GetCloudMinRange();//[C] A0FOGY in UBC_WM
-      cloud_max_range+=_aGaugeWtTemp[k][g]*_pGauges[g]->GetCloudMaxRange();//[C] A0SUNY in UBC_WM
+    for (int i=_GaugeWtTemp.RowBegin(k);i<_GaugeWtTemp.RowEnd(k);i++){
+      int g=_GaugeWtTemp.cols[i];
+      cloud_min_range+=_GaugeWtTemp.wts[i]*_pGauges[g]->GetCloudMinRange();//[C] A0FOGY in UBC_WM
+      cloud_max_range+=_GaugeWtTemp.wts[i]*_pGauges[g]->GetCloudMaxRange();//[C] A0SUNY in UBC_WM
     }
     cover=1.0-(range-cloud_min_range)/(cloud_max_range-cloud_min_range);
     lowerswap(cover,1.0);
@@ -876,6 +818,29 @@ double CModel::EstimateCloudCover  (const optStruct &Options,
   }
   return cover;
 }
+//////////////////////////////////////////////////////////////////
+/// \brief Returns SUBDAILY_SIMPLE sub-daily correction (fraction of daylight over time step, normalized by time step)
+/// \param DL [in] day length [d]
+/// \param t [in] time of day at start of time step [d]
+/// \param dt [in] time step [d]
+//
+inline double SimpleSubDailyCorrection(const double DL,const double t,const double dt)
+{
+  double dawn=0.5-0.5*DL;
+  double dusk=0.5+0.5*DL;
+
+  if      ((t>dawn) && (t+dt<=dusk)){
+    return -0.5*(cos(PI*(t+dt-dawn)/DL)-cos(PI*(t-dawn)/DL))/dt;
+  }
+  else if ((t<dawn) && (t+dt>=dawn)){
+    return -0.5*(cos(PI*(t+dt-dawn)/DL)-1                  )/dt;
+  }
+  else if ((t<dusk) && (t+dt>=dusk)){
+    return -0.5*(-1                   -cos(PI*(t-dawn)/DL))/dt;
+  }
+  return 0.0;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns sub-daily correction for daily snowmelt or PET calculations
 /// \param &Options [in] Global model options information
@@ -903,22 +868,8 @@ double CModel::CalculateSubDailyCorrection(const force_struct &F,
   //-----------------------------------------------------
   else if (Options.subdaily==SUBDAILY_SIMPLE)
   { //tested and working - simple and elegant
-    double DL=F.day_length;
-    double dawn=0.5-0.5*DL;
-    double dusk=0.5+0.5*DL;
     double t=tt.julian_day-floor(tt.julian_day); //time of day [d]
-    double dt=Options.timestep;
-
-    if      ((t>dawn) && (t+dt<=dusk)){
-      return -0.5*(cos(PI*(t+dt-dawn)/DL)-cos(PI*(t-dawn)/DL))/Options.timestep;
-    }
-    else if ((t<dawn) && (t+dt>=dawn)){
-      return -0.5*(cos(PI*(t+dt-dawn)/DL)-1                  )/Options.timestep;
-    }
-    else if ((t<dusk) && (t+dt>=dusk)){
-      return -0.5*(-1                   -cos(PI*(t-dawn)/DL))/Options.timestep;
-    }
-    return 0.0;
+    return SimpleSubDailyCorrection(F.day_length,t,Options.timestep);
   }
   //-----------------------------------------------------
   else if (Options.subdaily==SUBDAILY_UBC)
@@ -946,13 +897,17 @@ double CModel::CalculateSubDailyCorrection(const force_struct &F,
 
       start_of_day=floor(tt_tmp.model_time+time_shift);
       ZeroOutForcings(Ftmp);
-      for (int g=0;g<_nGauges;g++)
+      for (int i=_GaugeWtPrecip.RowBegin(k);i<_GaugeWtPrecip.RowEnd(k);i++)
       {
-        Ftmp.precip_daily_ave+=_aGaugeWtPrecip[k][g]*_pGauges[g]->GetForcingValue(F_PRECIP,start_of_day,1);
-
-        Ftmp.temp_ave        +=_aGaugeWtTemp[k][g]*_pGauges[g]->GetForcingValue(F_TEMP_AVE,nnn);
-        Ftmp.temp_daily_max  +=_aGaugeWtTemp[k][g]*_pGauges[g]->GetForcingValue(F_TEMP_DAILY_MAX,nnn);
-        Ftmp.temp_daily_min  +=_aGaugeWtTemp[k][g]*_pGauges[g]->GetForcingValue(F_TEMP_DAILY_MIN,nnn);
+        int g=_GaugeWtPrecip.cols[i];
+        Ftmp.precip_daily_ave+=_GaugeWtPrecip.wts[i]*_pGauges[g]->GetForcingValue(F_PRECIP,start_of_day,1);
+      }
+      for (int i=_GaugeWtTemp.RowBegin(k);i<_GaugeWtTemp.RowEnd(k);i++)
+      {
+        int g=_GaugeWtTemp.cols[i];
+        Ftmp.temp_ave        +=_GaugeWtTemp.wts[i]*_pGauges[g]->GetForcingValue(F_TEMP_AVE,nnn);
+        Ftmp.temp_daily_max  +=_GaugeWtTemp.wts[i]*_pGauges[g]->GetForcingValue(F_TEMP_DAILY_MAX,nnn);
+        Ftmp.temp_daily_min  +=_GaugeWtTemp.wts[i]*_pGauges[g]->GetForcingValue(F_TEMP_DAILY_MIN,nnn);
       }
       CorrectTemp(Options,Ftmp,elev,ref_elev_temp,tt_tmp);
       sum+=max(Ftmp.temp_ave,0.0);
@@ -964,6 +919,45 @@ double CModel::CalculateSubDailyCorrection(const force_struct &F,
   return 1.0;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Calculates sub-daily correction for all active HRUs in forcing store
+/// \remark SUBDAILY_UBC (and unrecognized methods) use CalculateSubDailyCorrection() HRU-by-HRU
+///
+/// \param &Options [in] Global model options information
+/// \param &tt [in] current time structure
+//
+void CModel::CalculateSubDailyCorrectionBatch(const optStruct &Options,const time_struct &tt)
+{
+  forcing_store &S=_ForcingStore;
+  int k,kk;
+  double *corr=S.Field(FORCING_FIELD(subdaily_corr));
+
+  if ((Options.timestep>=1.0) || (Options.subdaily==SUBDAILY_NONE))
+  {
+    for (kk=0;kk<S.nActive;kk++){corr[S.active[kk]]=1.0;}
+  }
+  else if (Options.subdaily==SUBDAILY_SIMPLE)
+  {
+    const double *DL=S.Field(FORCING_FIELD(day_length));
+    double t=tt.julian_day-floor(tt.julian_day); //time of day [d]
+    for (kk=0;kk<S.nActive;kk++){
+      k=S.active[kk];
+      corr[k]=SimpleSubDailyCorrection(DL[k],t,Options.timestep);
+    }
+  }
+  else
+  {
+    force_struct F;
+    for (kk=0;kk<S.nActive;kk++){
+      k=S.active[kk];
+      S.Load(k,F);
+      ApplyLocalParamOverrrides(k,false);
+      corr[k]=CalculateSubDailyCorrection(F,Options,S.elev[k],S.ref_elev_temp[k],tt,k);
+      ApplyLocalParamOverrrides(k,true);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Checks whether a forcing grid (by name) is read actually
 ///        from a NetCDF or is a derived grid.
@@ -1127,3 +1121,71 @@ double CModel::EstimateSnowFraction(const rainsnow_method method,
   //Stefan W. Kienzle,A new temperature based method to separate rain and snow,
   ///< Hydrological Processes 22(26),p5067-5085,2008,http://dx.doi.org/10.1002/hyp.7131 \cite kienzle2008HP
 }
+
+//////////////////////////////////////////////////////////////////
+/// \brief Estimates fraction of precipitation that is snow for all active HRUs in forcing store
+/// \remark temperature-threshold methods are evaluated field-by-field across HRUs; other methods
+///  (or local parameter overrides) use EstimateSnowFraction() HRU-by-HRU
+///
+/// \param &Options [in] Global model options information
+//
+void CModel::EstimateSnowFractionBatch(const optStruct &Options)
+{
+  forcing_store &S=_ForcingStore;
+  int k,kk;
+  rainsnow_method method=Options.rainsnow;
+  double *sf=S.Field(FORCING_FIELD(snow_frac));
+
+  if (method==RAINSNOW_DATA){return;} //snow fraction unchanged
+
+  if (_nParamOverrides==0)
+  {
+    double temp =CGlobalParams::GetParams()->rainsnow_temp;
+    if (method==RAINSNOW_DINGMAN)
+    {
+      const double *Tmin=S.Field(FORCING_FIELD(temp_daily_min));
+      const double *Tmax=S.Field(FORCING_FIELD(temp_daily_max));
+      for (kk=0;kk<S.nActive;kk++){
+        k=S.active[kk];
+        if      (Tmax[k]<=temp){sf[k]=1.0;}
+        else if (Tmin[k]>=temp){sf[k]=0.0;}
+        else                   {sf[k]=(temp-Tmin[k])/(Tmax[k]-Tmin[k]);}
+      }
+      return;
+    }
+    else if (method==RAINSNOW_THRESHOLD)
+    {
+      const double *T=S.Field(FORCING_FIELD(temp_ave));
+      for (kk=0;kk<S.nActive;kk++){
+        k=S.active[kk];
+        sf[k]=(T[k]<=temp) ? 1.0 : 0.0;
+      }
+      return;
+    }
+    else if ((method==RAINSNOW_HBV) || (method==RAINSNOW_UBCWM))
+    {
+      double delta=CGlobalParams::GetParams()->rainsnow_delta;
+      double frac;
+      const double *T=S.Field(FORCING_FIELD(temp_daily_ave));
+      for (kk=0;kk<S.nActive;kk++){
+        k=S.active[kk];
+        if      (T[k] <= (temp - 0.5 * delta)) { frac = 1.0; }
+        else if (T[k] >= (temp + 0.5 * delta)) { frac = 0.0; }
+        else                                   { frac = 0.5 + (temp - T[k]) / delta; }
+        if (method==RAINSNOW_UBCWM){sf[k]=frac;}
+        else                       {sf[k]=frac * (1.0 - sf[k]) + sf[k];}
+      }
+      return;
+    }
+  }
+
+  force_struct F;
+  for (kk=0;kk<S.nActive;kk++)
+  {
+    k=S.active[kk];
+    S.Load(k,F);
+    ApplyLocalParamOverrrides(k,false);
+    sf[k]=EstimateSnowFraction(method,_pHydroUnits[k],&F,Options);
+    ApplyLocalParamOverrrides(k,true);
+  }
+}